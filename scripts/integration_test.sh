@@ -214,6 +214,7 @@ echo "[*] Launch client 2"
 $tool ../DDNet \
 	"cl_input_fifo client2.fifo;
 	player_name client2;
+	player_skin beast;
 	logfile client2.log;
 	$client_args
 	connect localhost:$port" > stdout_client2.txt 2> stderr_client2.txt || fail client2 "$?" &
@@ -255,6 +256,10 @@ unban_all;
 EOF
 sleep 1
 
+echo "[*] Benchmark particles"
+echo "bench_particles 8192 60" > client1.fifo
+sleep 1
+
 echo "[*] Stop demo recording"
 echo "stoprecord" > server.fifo
 echo "stoprecord" > client1.fifo
@@ -295,6 +300,25 @@ then
 	echo "[-] Error: did not find output of /cmdlist command"
 fi
 
+if ! grep -qE 'skins: loaded [0-9]+ skins and indexed [0-9]+ more' client1.log
+then
+	touch fail_skins.txt
+	echo "[-] Error: skin loading summary not found in client log"
+fi
+
+if ! grep -q "skins: loaded skin 'beast' on demand" client1.log || \
+	! grep -q "skins: loaded skin 'beast' on demand" client2.log
+then
+	touch fail_skins.txt
+	echo "[-] Error: skin 'beast' was not loaded on demand"
+fi
+
+if ! grep -qE 'particles: bench: 8192 particles, 60 frames' client1.log
+then
+	touch fail_particles.txt
+	echo "[-] Error: particle benchmark result not found in client log"
+fi
+
 if ! grep -q "hello from admin" server.log
 then
 	touch fail_rcon.txt
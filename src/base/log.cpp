@@ -3,7 +3,9 @@
 #include "color.h"
 #include "system.h"
 
+#include <algorithm>
 #include <atomic>
+#include <cinttypes>
 #include <cstdio>
 #include <memory>
 
@@ -86,7 +88,8 @@ void log_log_impl(LEVEL level, bool have_color, LOG_COLOR color, const char *sys
 	{
 		scope_logger = global_logger.load(std::memory_order_acquire);
 	}
-	if(!scope_logger)
+	// Skip formatting messages that no logger is interested in.
+	if(!scope_logger || !scope_logger->Enabled(level))
 	{
 		in_logger = false;
 		return;
@@ -206,6 +209,21 @@ public:
 			pLogger->GlobalFinish();
 		}
 	}
+	bool Enabled(LEVEL Level) override
+	{
+		if(!ILogger::Enabled(Level))
+		{
+			return false;
+		}
+		for(auto &pLogger : m_vpLoggers)
+		{
+			if(pLogger->Enabled(Level))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
 };
 
 std::unique_ptr<ILogger> log_logger_collection(std::vector<std::shared_ptr<ILogger>> &&vpLoggers)
@@ -280,6 +298,201 @@ std::unique_ptr<ILogger> log_logger_file(IOHANDLE logfile)
 	return std::make_unique<CLoggerAsync>(logfile, false, true);
 }
 
+CLogQueue::CLogQueue(int Capacity)
+{
+	// a single slot cannot tell a full queue from an empty one
+	uint64_t Size = 2;
+	while(Size < (uint64_t)Capacity)
+		Size *= 2;
+	m_pSlots = std::make_unique<CSlot[]>(Size);
+	m_Mask = Size - 1;
+	for(uint64_t i = 0; i < Size; i++)
+		m_pSlots[i].m_Sequence.store(i, std::memory_order_relaxed);
+}
+
+bool CLogQueue::Push(const CLogMessage *pMessage)
+{
+	uint64_t Pos = m_EnqueuePos.load(std::memory_order_relaxed);
+	while(true)
+	{
+		CSlot &Slot = m_pSlots[Pos & m_Mask];
+		const int64_t Diff = (int64_t)Slot.m_Sequence.load(std::memory_order_acquire) - (int64_t)Pos;
+		if(Diff == 0)
+		{
+			if(m_EnqueuePos.compare_exchange_weak(Pos, Pos + 1, std::memory_order_relaxed))
+			{
+				// Only copy the used part of the line, it's mostly empty.
+				CLogMessage *pSlotMessage = &Slot.m_Message;
+				pSlotMessage->m_Level = pMessage->m_Level;
+				pSlotMessage->m_HaveColor = pMessage->m_HaveColor;
+				pSlotMessage->m_Color = pMessage->m_Color;
+				mem_copy(pSlotMessage->m_aTimestamp, pMessage->m_aTimestamp, sizeof(pSlotMessage->m_aTimestamp));
+				mem_copy(pSlotMessage->m_aSystem, pMessage->m_aSystem, sizeof(pSlotMessage->m_aSystem));
+				const int LineLength = std::min(pMessage->m_LineLength, (int)sizeof(pSlotMessage->m_aLine) - 1);
+				mem_copy(pSlotMessage->m_aLine, pMessage->m_aLine, LineLength);
+				pSlotMessage->m_aLine[LineLength] = '\0';
+				pSlotMessage->m_TimestampLength = pMessage->m_TimestampLength;
+				pSlotMessage->m_SystemLength = pMessage->m_SystemLength;
+				pSlotMessage->m_LineLength = LineLength;
+				pSlotMessage->m_LineMessageOffset = pMessage->m_LineMessageOffset;
+				Slot.m_Sequence.store(Pos + 1, std::memory_order_release);
+				return true;
+			}
+		}
+		else if(Diff < 0)
+		{
+			m_NumDropped.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+		else
+		{
+			Pos = m_EnqueuePos.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+bool CLogQueue::DroppedMessage(CLogMessage *pMessage)
+{
+	const int64_t NumDropped = m_NumDropped.load(std::memory_order_relaxed);
+	if(NumDropped == m_NumDroppedReported)
+	{
+		return false;
+	}
+	pMessage->m_Level = LEVEL_WARN;
+	pMessage->m_HaveColor = false;
+	pMessage->m_Color = LOG_COLOR{0, 0, 0};
+	str_timestamp_format(pMessage->m_aTimestamp, sizeof(pMessage->m_aTimestamp), FORMAT_SPACE);
+	pMessage->m_TimestampLength = str_length(pMessage->m_aTimestamp);
+	str_copy(pMessage->m_aSystem, "logger");
+	pMessage->m_SystemLength = str_length(pMessage->m_aSystem);
+	str_format(pMessage->m_aLine, sizeof(pMessage->m_aLine), "%s W %s: ", pMessage->m_aTimestamp, pMessage->m_aSystem);
+	pMessage->m_LineMessageOffset = str_length(pMessage->m_aLine);
+	str_format(pMessage->m_aLine + pMessage->m_LineMessageOffset, sizeof(pMessage->m_aLine) - pMessage->m_LineMessageOffset, "dropped %" PRId64 " messages, the log queue was full", NumDropped - m_NumDroppedReported);
+	pMessage->m_LineLength = str_length(pMessage->m_aLine);
+	m_NumDroppedReported = NumDropped;
+	return true;
+}
+
+class CQueueLogger : public ILogger
+{
+	std::shared_ptr<ILogger> m_pLogger;
+	CLogQueue m_Queue;
+	SEMAPHORE m_Semaphore;
+	void *m_pThread;
+	std::atomic<bool> m_Sleeping{false};
+	std::atomic<bool> m_Shutdown{false};
+	std::atomic<bool> m_Finished{false};
+	// threads inside `Log`, `Stop` waits for them before the semaphore is
+	// destroyed and the last messages are drained
+	std::atomic<int> m_NumLogging{0};
+
+	static void ThreadMain(void *pUser)
+	{
+		CQueueLogger *pSelf = (CQueueLogger *)pUser;
+		while(true)
+		{
+			pSelf->Drain();
+			if(pSelf->m_Shutdown.load())
+			{
+				break;
+			}
+			// Producers only signal the semaphore if we are about to sleep.
+			pSelf->m_Sleeping.store(true);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if(pSelf->m_Queue.Pop([pSelf](const CLogMessage *pMessage) { pSelf->m_pLogger->Log(pMessage); }))
+			{
+				pSelf->m_Sleeping.store(false);
+				continue;
+			}
+			sphore_wait(&pSelf->m_Semaphore);
+		}
+		pSelf->Drain();
+	}
+
+	void Drain()
+	{
+		while(m_Queue.Pop([this](const CLogMessage *pMessage) { m_pLogger->Log(pMessage); }))
+		{
+		}
+
+		CLogMessage Msg;
+		if(m_Queue.DroppedMessage(&Msg))
+		{
+			m_pLogger->Log(&Msg);
+		}
+	}
+
+	void Stop()
+	{
+		m_Finished.store(true);
+		while(m_NumLogging.load() != 0)
+		{
+			thread_yield();
+		}
+		if(m_Shutdown.exchange(true))
+		{
+			return;
+		}
+		sphore_signal(&m_Semaphore);
+		thread_wait(m_pThread);
+		sphore_destroy(&m_Semaphore);
+	}
+
+public:
+	CQueueLogger(std::shared_ptr<ILogger> pLogger, int Capacity) :
+		m_pLogger(std::move(pLogger)),
+		m_Queue(Capacity)
+	{
+		m_Filter.m_MaxLevel.store(LEVEL_TRACE, std::memory_order_relaxed);
+		sphore_init(&m_Semaphore);
+		m_pThread = thread_init(ThreadMain, this, "logger");
+	}
+	~CQueueLogger() override
+	{
+		Stop();
+	}
+	void Log(const CLogMessage *pMessage) override
+	{
+		if(m_Filter.Filters(pMessage) || !m_pLogger->Enabled(pMessage->m_Level))
+		{
+			return;
+		}
+		m_NumLogging.fetch_add(1);
+		if(!m_Finished.load())
+		{
+			m_Queue.Push(pMessage);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if(m_Sleeping.load(std::memory_order_relaxed) && m_Sleeping.exchange(false))
+			{
+				sphore_signal(&m_Semaphore);
+			}
+		}
+		m_NumLogging.fetch_sub(1);
+	}
+	void GlobalFinish() override
+	{
+		if(m_Shutdown.load())
+		{
+			return;
+		}
+		Stop();
+		m_pLogger->GlobalFinish();
+	}
+	void OnFilterChange() override
+	{
+		m_pLogger->SetFilter(m_Filter);
+	}
+	bool Enabled(LEVEL Level) override
+	{
+		return m_pLogger->Enabled(Level);
+	}
+};
+
+std::unique_ptr<ILogger> log_logger_queue(std::shared_ptr<ILogger> pLogger, int Capacity)
+{
+	return std::make_unique<CQueueLogger>(std::move(pLogger), Capacity);
+}
+
 #if defined(CONF_FAMILY_WINDOWS)
 static int color_hsv_to_windows_console_color(const ColorHSVA &Hsv)
 {
@@ -489,6 +702,17 @@ void CFutureLogger::GlobalFinish()
 	}
 }
 
+bool CFutureLogger::Enabled(LEVEL Level)
+{
+	auto pLogger = std::atomic_load_explicit(&m_pLogger, std::memory_order_acquire);
+	if(pLogger)
+	{
+		return pLogger->Enabled(Level);
+	}
+	// Messages are kept until the logger is set.
+	return true;
+}
+
 void CFutureLogger::OnFilterChange()
 {
 	auto pLogger = std::atomic_load_explicit(&m_pLogger, std::memory_order_acquire);
@@ -107,6 +107,17 @@ public:
 	 * Notifies the logger of a changed `m_Filter`.
 	 */
 	virtual void OnFilterChange() {}
+	/**
+	 * Whether messages of the given level would be logged at all. This is
+	 * checked before a message is formatted, loggers that don't filter by
+	 * `m_Filter` alone need to override it.
+	 *
+	 * @param Level Severity of the message.
+	 */
+	virtual bool Enabled(LEVEL Level)
+	{
+		return Level <= m_Filter.m_MaxLevel.load(std::memory_order_relaxed);
+	}
 };
 
 /**
@@ -200,6 +211,20 @@ std::unique_ptr<ILogger> log_logger_file(IOHANDLE file);
  * Logger for writing logs to the standard output (stdout).
  */
 std::unique_ptr<ILogger> log_logger_stdout();
+/**
+ * @ingroup Log
+ *
+ * Logger passing messages on to another logger from a dedicated thread.
+ * Logging threads only format the message and push it into a `CLogQueue`,
+ * they never wait for locks or I/O of the wrapped logger.
+ *
+ * Messages dropped because the queue was full are reported to the wrapped
+ * logger once the queue drains.
+ *
+ * @param pLogger Logger to pass the messages to.
+ * @param Capacity Maximum number of queued messages.
+ */
+std::unique_ptr<ILogger> log_logger_queue(std::shared_ptr<ILogger> pLogger, int Capacity);
 
 /**
  * @ingroup Log
@@ -238,6 +263,76 @@ public:
 	void Log(const CLogMessage *pMessage) override REQUIRES(!m_PendingLock);
 	void GlobalFinish() override;
 	void OnFilterChange() override;
+	bool Enabled(LEVEL Level) override;
+};
+
+/**
+ * @ingroup Log
+ *
+ * Bounded lock-free queue of log messages with multiple producers and a
+ * single consumer. Producers never block, messages are dropped and counted
+ * if the queue is full.
+ */
+class CLogQueue
+{
+	struct CSlot
+	{
+		std::atomic<uint64_t> m_Sequence;
+		CLogMessage m_Message;
+	};
+
+	std::unique_ptr<CSlot[]> m_pSlots;
+	uint64_t m_Mask;
+	alignas(64) std::atomic<uint64_t> m_EnqueuePos{0};
+	alignas(64) std::atomic<uint64_t> m_DequeuePos{0};
+	std::atomic<int64_t> m_NumDropped{0};
+	int64_t m_NumDroppedReported = 0;
+
+public:
+	/**
+	 * @param Capacity Maximum number of queued messages, rounded up to a
+	 * power of two.
+	 */
+	CLogQueue(int Capacity);
+
+	/**
+	 * Copies the message into the queue. Can be called from any thread.
+	 *
+	 * @return `false` if the queue was full and the message was dropped.
+	 */
+	bool Push(const CLogMessage *pMessage);
+
+	/**
+	 * Passes the oldest message to `Consume` and removes it. Must only be
+	 * called from one thread at a time.
+	 *
+	 * @return `false` if the queue was empty.
+	 */
+	template<typename F>
+	bool Pop(F &&Consume)
+	{
+		const uint64_t Pos = m_DequeuePos.load(std::memory_order_relaxed);
+		CSlot &Slot = m_pSlots[Pos & m_Mask];
+		if(Slot.m_Sequence.load(std::memory_order_acquire) != Pos + 1)
+			return false;
+		Consume(&Slot.m_Message);
+		Slot.m_Sequence.store(Pos + m_Mask + 1, std::memory_order_release);
+		m_DequeuePos.store(Pos + 1, std::memory_order_relaxed);
+		return true;
+	}
+
+	/**
+	 * Number of messages dropped because the queue was full.
+	 */
+	int64_t NumDropped() const { return m_NumDropped.load(std::memory_order_relaxed); }
+
+	/**
+	 * Fills in a warning about the messages dropped since the last call.
+	 * Must only be called from the consuming thread.
+	 *
+	 * @return `false` if no messages were dropped since the last call.
+	 */
+	bool DroppedMessage(CLogMessage *pMessage);
 };
 
 /**
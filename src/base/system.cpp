@@ -10,6 +10,7 @@
 #include <cstdio>
 #include <cstring>
 #include <iterator> // std::size
+#include <limits>
 #include <string_view>
 
 #include "lock.h"
@@ -24,7 +25,9 @@
 
 #if defined(CONF_FAMILY_UNIX)
 #include <csignal>
+#include <fcntl.h>
 #include <locale>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/time.h>
 #include <sys/utsname.h>
@@ -381,6 +384,59 @@ char *io_read_all_str(IOHANDLE io)
 	return (char *)buffer;
 }
 
+bool io_map_file(const char *filename, const void **result, unsigned *result_len)
+{
+#if defined(CONF_FAMILY_WINDOWS)
+	const std::wstring wide_filename = windows_utf8_to_wide(filename);
+	HANDLE file = CreateFileW(wide_filename.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if(file == INVALID_HANDLE_VALUE)
+		return false;
+	LARGE_INTEGER size;
+	if(!GetFileSizeEx(file, &size) || size.QuadPart <= 0 || size.QuadPart > (LONGLONG)std::numeric_limits<unsigned>::max())
+	{
+		CloseHandle(file);
+		return false;
+	}
+	HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	CloseHandle(file);
+	if(mapping == nullptr)
+		return false;
+	const void *data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mapping);
+	if(data == nullptr)
+		return false;
+	*result = data;
+	*result_len = (unsigned)size.QuadPart;
+	return true;
+#else
+	const int fd = open(filename, O_RDONLY);
+	if(fd < 0)
+		return false;
+	struct stat file_stat;
+	if(fstat(fd, &file_stat) != 0 || file_stat.st_size <= 0 || (uint64_t)file_stat.st_size > std::numeric_limits<unsigned>::max())
+	{
+		close(fd);
+		return false;
+	}
+	void *data = mmap(nullptr, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if(data == MAP_FAILED)
+		return false;
+	*result = data;
+	*result_len = (unsigned)file_stat.st_size;
+	return true;
+#endif
+}
+
+void io_unmap_file(const void *data, unsigned len)
+{
+#if defined(CONF_FAMILY_WINDOWS)
+	UnmapViewOfFile(data);
+#else
+	munmap((void *)data, len);
+#endif
+}
+
 int io_skip(IOHANDLE io, int size)
 {
 	return io_seek(io, size, IOSEEK_CUR);
@@ -1708,6 +1764,58 @@ int net_udp_send(NETSOCKET sock, const NETADDR *addr, const void *data, int size
 	return d;
 }
 
+int net_udp_send_multi(NETSOCKET sock, const NETADDR *addr, const void *const *datas, const int *sizes, int num)
+{
+	int sent = 0;
+#if defined(CONF_PLATFORM_LINUX)
+	// websockets and broadcasts take the slow path below
+	const bool ipv4 = addr->type == NETTYPE_IPV4 && sock->ipv4sock >= 0;
+	const bool ipv6 = addr->type == NETTYPE_IPV6 && sock->ipv6sock >= 0;
+	if(ipv4 || ipv6)
+	{
+		struct sockaddr_in sa4;
+		struct sockaddr_in6 sa6;
+		if(ipv4)
+			netaddr_to_sockaddr_in(addr, &sa4);
+		else
+			netaddr_to_sockaddr_in6(addr, &sa6);
+
+		struct mmsghdr msgs[16];
+		struct iovec iovecs[16];
+		mem_zero(msgs, sizeof(msgs));
+		while(sent < num)
+		{
+			const int batch = num - sent < (int)std::size(msgs) ? num - sent : (int)std::size(msgs);
+			for(int i = 0; i < batch; i++)
+			{
+				iovecs[i].iov_base = (void *)datas[sent + i];
+				iovecs[i].iov_len = sizes[sent + i];
+				msgs[i].msg_hdr.msg_iov = &iovecs[i];
+				msgs[i].msg_hdr.msg_iovlen = 1;
+				msgs[i].msg_hdr.msg_name = ipv4 ? (void *)&sa4 : (void *)&sa6;
+				msgs[i].msg_hdr.msg_namelen = ipv4 ? sizeof(sa4) : sizeof(sa6);
+			}
+			const int result = sendmmsg(ipv4 ? sock->ipv4sock : sock->ipv6sock, msgs, batch, 0);
+			if(result <= 0)
+				break;
+			for(int i = 0; i < result; i++)
+			{
+				network_stats.sent_bytes += sizes[sent + i];
+				network_stats.sent_packets++;
+			}
+			sent += result;
+		}
+		return sent;
+	}
+#endif
+	for(int i = 0; i < num; i++)
+	{
+		if(net_udp_send(sock, addr, datas[i], sizes[i]) >= 0)
+			sent++;
+	}
+	return sent;
+}
+
 void net_buffer_init(NETSOCKET_BUFFER *buffer)
 {
 #if defined(CONF_PLATFORM_LINUX)
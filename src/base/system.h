@@ -291,6 +291,33 @@ void io_read_all(IOHANDLE io, void **result, unsigned *result_len);
  */
 char *io_read_all_str(IOHANDLE io);
 
+/**
+ * Maps a whole file read-only into memory.
+ *
+ * @ingroup File-IO
+ *
+ * @param filename Name of the file to map.
+ * @param result Receives the start of the mapped file contents.
+ * @param result_len Receives the length of the file.
+ *
+ * @return true on success, false on failure.
+ *
+ * @remark Empty files cannot be mapped.
+ * @remark The mapping stays valid after the file is removed.
+ * @remark The result must be released with @link io_unmap_file @endlink.
+ */
+bool io_map_file(const char *filename, const void **result, unsigned *result_len);
+
+/**
+ * Releases a file mapping created with @link io_map_file @endlink.
+ *
+ * @ingroup File-IO
+ *
+ * @param data The start of the mapping.
+ * @param len The length of the mapping.
+ */
+void io_unmap_file(const void *data, unsigned len);
+
 /**
  * Skips data in a file.
  *
@@ -932,6 +959,22 @@ NETSOCKET net_udp_create(NETADDR bindaddr);
  */
 int net_udp_send(NETSOCKET sock, const NETADDR *addr, const void *data, int size);
 
+/**
+ * Sends multiple packets to the same address over an UDP socket, using a
+ * single system call where the platform supports it.
+ *
+ * @ingroup Network-UDP
+ *
+ * @param sock Socket to use.
+ * @param addr Where to send the packets.
+ * @param datas Pointers to the data of the packets.
+ * @param sizes Sizes of the packets.
+ * @param num Number of packets.
+ *
+ * @return The number of packets sent.
+ */
+int net_udp_send_multi(NETSOCKET sock, const NETADDR *addr, const void *const *datas, const int *sizes, int num);
+
 /*
 	Function: net_udp_recv
 		Receives a packet over an UDP socket.
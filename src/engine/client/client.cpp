@@ -3062,6 +3062,7 @@ void CClient::Run()
 
 	GameClient()->OnShutdown();
 	Disconnect();
+	HttpShutdown();
 
 	// close socket
 	for(unsigned int i = 0; i < std::size(m_aNetClient); i++)
@@ -0,0 +1,131 @@
+#include "demo_index.h"
+
+#include <engine/console.h>
+#include <engine/sqlite.h>
+
+#include <sqlite3.h>
+
+class CDemoIndex : public IDemoIndex
+{
+public:
+	CDemoIndex(IConsole *pConsole, IStorage *pStorage);
+	~CDemoIndex() override;
+
+	bool Get(const char *pPath, int64_t Size, time_t TimeModified, CEntry *pEntry) override;
+	void Store(const char *pPath, int64_t Size, time_t TimeModified, const CEntry &Entry) override;
+	void Commit() override;
+
+private:
+	IConsole *m_pConsole;
+
+	CSqlite m_pDisk;
+	CSqliteStmt m_pGetStmt;
+	CSqliteStmt m_pStoreStmt;
+	bool m_InTransaction = false;
+};
+
+CDemoIndex::CDemoIndex(IConsole *pConsole, IStorage *pStorage) :
+	m_pConsole(pConsole)
+{
+	m_pDisk = SqliteOpen(pConsole, pStorage, "ddnet-cache.sqlite3");
+	if(!m_pDisk)
+	{
+		pConsole->Print(IConsole::OUTPUT_LEVEL_STANDARD, "demo_index", "failed to open ddnet-cache.sqlite3");
+		return;
+	}
+	sqlite3 *pSqlite = m_pDisk.get();
+	static const char TABLE[] = "CREATE TABLE IF NOT EXISTS demo_index (path TEXT PRIMARY KEY NOT NULL, size INTEGER NOT NULL, modified INTEGER NOT NULL, valid INTEGER NOT NULL, header BLOB NOT NULL, timeline_markers BLOB NOT NULL, map_info BLOB NOT NULL, utc_timestamp TEXT NOT NULL)";
+	if(SQLITE_HANDLE_ERROR(sqlite3_exec(pSqlite, TABLE, nullptr, nullptr, nullptr)))
+	{
+		m_pDisk = nullptr;
+		pConsole->Print(IConsole::OUTPUT_LEVEL_STANDARD, "demo_index", "failed to create demo_index table");
+		return;
+	}
+	// Entries of deleted demos are never looked up again, forget them after
+	// a while. Demos that still exist are simply parsed and stored again.
+	SQLITE_HANDLE_ERROR(sqlite3_exec(pSqlite, "DELETE FROM demo_index WHERE utc_timestamp < datetime('now', '-90 days')", nullptr, nullptr, nullptr));
+	m_pGetStmt = SqlitePrepare(pConsole, pSqlite, "SELECT valid, header, timeline_markers, map_info FROM demo_index WHERE path = ? AND size = ? AND modified = ?");
+	m_pStoreStmt = SqlitePrepare(pConsole, pSqlite, "INSERT OR REPLACE INTO demo_index (path, size, modified, valid, header, timeline_markers, map_info, utc_timestamp) VALUES (?, ?, ?, ?, ?, ?, ?, datetime('now'))");
+}
+
+CDemoIndex::~CDemoIndex()
+{
+	Commit();
+}
+
+bool CDemoIndex::Get(const char *pPath, int64_t Size, time_t TimeModified, CEntry *pEntry)
+{
+	if(!m_pDisk || !m_pGetStmt)
+		return false;
+
+	sqlite3 *pSqlite = m_pDisk.get();
+	IConsole *pConsole = m_pConsole;
+	sqlite3_stmt *pStmt = m_pGetStmt.get();
+	bool Found = false;
+	bool Error = false;
+	Error = Error || SQLITE_HANDLE_ERROR(sqlite3_bind_text(pStmt, 1, pPath, -1, SQLITE_STATIC));
+	Error = Error || SQLITE_HANDLE_ERROR(sqlite3_bind_int64(pStmt, 2, Size));
+	Error = Error || SQLITE_HANDLE_ERROR(sqlite3_bind_int64(pStmt, 3, TimeModified));
+	if(!Error && SQLITE_HANDLE_ERROR(sqlite3_step(pStmt)) == SQLITE_ROW &&
+		sqlite3_column_bytes(pStmt, 1) == sizeof(pEntry->m_Info) &&
+		sqlite3_column_bytes(pStmt, 2) == sizeof(pEntry->m_TimelineMarkers) &&
+		sqlite3_column_bytes(pStmt, 3) == sizeof(pEntry->m_MapInfo))
+	{
+		pEntry->m_Valid = sqlite3_column_int(pStmt, 0) != 0;
+		mem_copy(&pEntry->m_Info, sqlite3_column_blob(pStmt, 1), sizeof(pEntry->m_Info));
+		mem_copy(&pEntry->m_TimelineMarkers, sqlite3_column_blob(pStmt, 2), sizeof(pEntry->m_TimelineMarkers));
+		mem_copy(&pEntry->m_MapInfo, sqlite3_column_blob(pStmt, 3), sizeof(pEntry->m_MapInfo));
+		// the map name isn't checked like the header strings on the way in
+		Found = mem_has_null(pEntry->m_MapInfo.m_aName, sizeof(pEntry->m_MapInfo.m_aName)) && (!pEntry->m_Valid || pEntry->m_Info.Valid());
+	}
+	sqlite3_reset(pStmt);
+	sqlite3_clear_bindings(pStmt);
+	return Found;
+}
+
+void CDemoIndex::Store(const char *pPath, int64_t Size, time_t TimeModified, const CEntry &Entry)
+{
+	if(!m_pDisk || !m_pStoreStmt)
+		return;
+
+	sqlite3 *pSqlite = m_pDisk.get();
+	IConsole *pConsole = m_pConsole;
+	if(!m_InTransaction)
+	{
+		if(SQLITE_HANDLE_ERROR(sqlite3_exec(pSqlite, "BEGIN", nullptr, nullptr, nullptr)))
+			return;
+		m_InTransaction = true;
+	}
+
+	sqlite3_stmt *pStmt = m_pStoreStmt.get();
+	bool Error = false;
+	Error = Error || SQLITE_HANDLE_ERROR(sqlite3_bind_text(pStmt, 1, pPath, -1, SQLITE_STATIC));
+	Error = Error || SQLITE_HANDLE_ERROR(sqlite3_bind_int64(pStmt, 2, Size));
+	Error = Error || SQLITE_HANDLE_ERROR(sqlite3_bind_int64(pStmt, 3, TimeModified));
+	Error = Error || SQLITE_HANDLE_ERROR(sqlite3_bind_int(pStmt, 4, Entry.m_Valid));
+	Error = Error || SQLITE_HANDLE_ERROR(sqlite3_bind_blob(pStmt, 5, &Entry.m_Info, sizeof(Entry.m_Info), SQLITE_STATIC));
+	Error = Error || SQLITE_HANDLE_ERROR(sqlite3_bind_blob(pStmt, 6, &Entry.m_TimelineMarkers, sizeof(Entry.m_TimelineMarkers), SQLITE_STATIC));
+	Error = Error || SQLITE_HANDLE_ERROR(sqlite3_bind_blob(pStmt, 7, &Entry.m_MapInfo, sizeof(Entry.m_MapInfo), SQLITE_STATIC));
+	Error = Error || SQLITE_HANDLE_ERROR(sqlite3_step(pStmt)) != SQLITE_DONE;
+	if(Error)
+	{
+		pConsole->Print(IConsole::OUTPUT_LEVEL_STANDARD, "demo_index", "failed to store demo info");
+	}
+	sqlite3_reset(pStmt);
+	sqlite3_clear_bindings(pStmt);
+}
+
+void CDemoIndex::Commit()
+{
+	if(!m_InTransaction)
+		return;
+	m_InTransaction = false;
+	sqlite3 *pSqlite = m_pDisk.get();
+	IConsole *pConsole = m_pConsole;
+	SQLITE_HANDLE_ERROR(sqlite3_exec(pSqlite, "COMMIT", nullptr, nullptr, nullptr));
+}
+
+IDemoIndex *CreateDemoIndex(IConsole *pConsole, IStorage *pStorage)
+{
+	return new CDemoIndex(pConsole, pStorage);
+}
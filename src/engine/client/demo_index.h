@@ -0,0 +1,37 @@
+#ifndef ENGINE_CLIENT_DEMO_INDEX_H
+#define ENGINE_CLIENT_DEMO_INDEX_H
+#include <base/types.h>
+
+#include <engine/demo.h>
+
+#include <cstdint>
+
+class IConsole;
+class IStorage;
+
+// Remembers the parsed headers of demo files, so the demo browser only needs
+// to parse demos that are new or changed since it last saw them.
+class IDemoIndex
+{
+public:
+	class CEntry
+	{
+	public:
+		bool m_Valid;
+		CDemoHeader m_Info;
+		CTimelineMarkers m_TimelineMarkers;
+		CMapInfo m_MapInfo;
+	};
+
+	virtual ~IDemoIndex() {}
+
+	// Returns false if the demo isn't indexed or has changed since.
+	virtual bool Get(const char *pPath, int64_t Size, time_t TimeModified, CEntry *pEntry) = 0;
+	// Stores are batched in a transaction until the next `Commit`, so they
+	// should be done right before it to keep the database locked briefly.
+	virtual void Store(const char *pPath, int64_t Size, time_t TimeModified, const CEntry &Entry) = 0;
+	virtual void Commit() = 0;
+};
+
+IDemoIndex *CreateDemoIndex(IConsole *pConsole, IStorage *pStorage);
+#endif // ENGINE_CLIENT_DEMO_INDEX_H
@@ -1,5 +1,6 @@
 #include "ghost.h"
 
+#include <base/math.h>
 #include <base/system.h>
 
 #include <engine/console.h>
@@ -9,8 +10,8 @@
 #include <engine/storage.h>
 
 static const unsigned char gs_aHeaderMarker[8] = {'T', 'W', 'G', 'H', 'O', 'S', 'T', 0};
-static const unsigned char gs_CurVersion = 6;
-static const int gs_NumTicksOffset = 93;
+static const unsigned char gs_CurVersion = 7;
+static const int gs_IndexOffsetOffset = 89;
 
 static const ColorRGBA gs_GhostPrintColor{0.65f, 0.6f, 0.6f, 1.0f};
 
@@ -50,6 +51,8 @@ int CGhostRecorder::Start(const char *pFilename, const char *pMap, SHA256_DIGEST
 
 	m_LastItem.Reset();
 	ResetBuffer();
+	m_vChunks.clear();
+	mem_zero(m_aNumItemsOfType, sizeof(m_aNumItemsOfType));
 
 	char aBuf[256];
 	str_format(aBuf, sizeof(aBuf), "ghost recording to '%s'", pFilename);
@@ -126,6 +129,13 @@ void CGhostRecorder::FlushChunk()
 	aChunk[2] = (Size >> 8) & 0xff;
 	aChunk[3] = (Size)&0xff;
 
+	CGhostChunkInfo Chunk;
+	Chunk.m_Offset = io_tell(m_File);
+	Chunk.m_Type = aChunk[0];
+	Chunk.m_FirstItem = m_aNumItemsOfType[aChunk[0]];
+	m_vChunks.push_back(Chunk);
+	m_aNumItemsOfType[aChunk[0]] += m_BufferNumItems;
+
 	io_write(m_File, aChunk, sizeof(aChunk));
 	io_write(m_File, s_aBuffer2, Size);
 
@@ -142,8 +152,14 @@ int CGhostRecorder::Stop(int Ticks, int Time)
 
 	FlushChunk();
 
-	// write down num shots and time
-	io_seek(m_File, gs_NumTicksOffset, IOSEEK_START);
+	// the index follows the last chunk
+	unsigned char aIndexOffset[sizeof(int32_t)];
+	uint_to_bytes_be(aIndexOffset, io_tell(m_File));
+	WriteIndex();
+
+	// write down index offset, num shots and time
+	io_seek(m_File, gs_IndexOffsetOffset, IOSEEK_START);
+	io_write(m_File, aIndexOffset, sizeof(aIndexOffset));
 
 	unsigned char aNumTicks[sizeof(int32_t)];
 	uint_to_bytes_be(aNumTicks, Ticks);
@@ -158,12 +174,33 @@ int CGhostRecorder::Stop(int Ticks, int Time)
 	return 0;
 }
 
+void CGhostRecorder::WriteIndex()
+{
+	unsigned char aNumChunks[sizeof(int32_t)];
+	uint_to_bytes_be(aNumChunks, m_vChunks.size());
+	io_write(m_File, aNumChunks, sizeof(aNumChunks));
+
+	for(const CGhostChunkInfo &Chunk : m_vChunks)
+	{
+		CGhostChunkIndexEntry Entry;
+		uint_to_bytes_be(Entry.m_aOffset, Chunk.m_Offset);
+		uint_to_bytes_be(Entry.m_aFirstItem, Chunk.m_FirstItem);
+		Entry.m_Type = Chunk.m_Type;
+		io_write(m_File, &Entry, sizeof(Entry));
+	}
+}
+
 CGhostLoader::CGhostLoader()
 {
 	m_File = 0;
 	ResetBuffer();
 }
 
+CGhostLoader::~CGhostLoader()
+{
+	Close();
+}
+
 void CGhostLoader::Init()
 {
 	m_pConsole = Kernel()->RequestInterface<IConsole>();
@@ -254,12 +291,63 @@ int CGhostLoader::Load(const char *pFilename, const char *pMap, SHA256_DIGEST Ma
 	}
 
 	m_Info = m_Header.ToGhostInfo();
+	m_DataOffset = io_tell(m_File);
 	m_LastItem.Reset();
 	ResetBuffer();
 
+	m_vChunks.clear();
+	if(m_Header.GetIndexOffset() != 0 && !ReadIndex())
+	{
+		char aBuf[256];
+		str_format(aBuf, sizeof(aBuf), "invalid chunk index in '%s'", pFilename);
+		m_pConsole->Print(IConsole::OUTPUT_LEVEL_STANDARD, "ghost_loader", aBuf);
+		io_close(m_File);
+		m_File = 0;
+		return -1;
+	}
+
 	return 0;
 }
 
+bool CGhostLoader::ReadIndex()
+{
+	const unsigned IndexOffset = m_Header.GetIndexOffset();
+	if(IndexOffset < m_DataOffset || io_seek(m_File, IndexOffset, IOSEEK_START) != 0)
+		return false;
+
+	unsigned char aNumChunks[sizeof(int32_t)];
+	if(io_read(m_File, aNumChunks, sizeof(aNumChunks)) != sizeof(aNumChunks))
+		return false;
+	const unsigned NumChunks = bytes_be_to_uint(aNumChunks);
+	if(NumChunks > (IndexOffset - m_DataOffset) / 4) // every chunk has a 4 byte header
+		return false;
+
+	m_vChunks.reserve(NumChunks);
+	for(unsigned i = 0; i < NumChunks; i++)
+	{
+		CGhostChunkIndexEntry Entry;
+		if(io_read(m_File, &Entry, sizeof(Entry)) != sizeof(Entry))
+		{
+			m_vChunks.clear();
+			return false;
+		}
+		CGhostChunkInfo Chunk;
+		Chunk.m_Offset = bytes_be_to_uint(Entry.m_aOffset);
+		Chunk.m_Type = Entry.m_Type;
+		Chunk.m_FirstItem = bytes_be_to_uint(Entry.m_aFirstItem);
+		// the chunks are written one after another
+		const unsigned MinOffset = m_vChunks.empty() ? m_DataOffset : m_vChunks.back().m_Offset + 4;
+		if(Chunk.m_Offset < MinOffset || Chunk.m_Offset >= IndexOffset || Chunk.m_FirstItem < 0)
+		{
+			m_vChunks.clear();
+			return false;
+		}
+		m_vChunks.push_back(Chunk);
+	}
+
+	return io_seek(m_File, m_DataOffset, IOSEEK_START) == 0;
+}
+
 int CGhostLoader::ReadChunk(int *pType)
 {
 	static char s_aCompresseddata[MAX_ITEM_SIZE * NUM_ITEMS_PER_CHUNK];
@@ -270,6 +358,11 @@ int CGhostLoader::ReadChunk(int *pType)
 		m_LastItem.Reset();
 	ResetBuffer();
 
+	// the chunk index is not part of the data
+	const unsigned IndexOffset = m_Header.GetIndexOffset();
+	if(IndexOffset != 0 && io_tell(m_File) >= IndexOffset)
+		return -1;
+
 	if(io_read(m_File, aChunk, sizeof(aChunk)) != sizeof(aChunk))
 		return -1;
 
@@ -355,12 +448,130 @@ bool CGhostLoader::ReadData(int Type, void *pData, int Size)
 	return true;
 }
 
+int CGhostLoader::SeekItem(int Type, int Index)
+{
+	if(!m_File || Index < 0)
+		return -1;
+
+	// the chunks of one type are ordered by their first item
+	unsigned Offset = m_DataOffset;
+	int FirstItem = 0;
+	for(const CGhostChunkInfo &Chunk : m_vChunks)
+	{
+		if(Chunk.m_Type != Type)
+			continue;
+		if(Chunk.m_FirstItem > Index)
+			break;
+		Offset = Chunk.m_Offset;
+		FirstItem = Chunk.m_FirstItem;
+	}
+
+	if(io_seek(m_File, Offset, IOSEEK_START) != 0)
+		return -1;
+	m_LastItem.Reset();
+	ResetBuffer();
+	return FirstItem;
+}
+
+std::unique_ptr<IGhostLoader> CGhostLoader::OpenStream(const char *pFilename, const char *pMap, SHA256_DIGEST MapSha256, unsigned MapCrc)
+{
+	std::unique_ptr<CGhostLoader> pStream = std::make_unique<CGhostLoader>();
+	pStream->m_pConsole = m_pConsole;
+	pStream->m_pStorage = m_pStorage;
+	if(pStream->Load(pFilename, pMap, MapSha256, MapCrc) != 0)
+		return nullptr;
+	return pStream;
+}
+
+void CGhostItemWindow::Init(IGhostLoader *pLoader, int Type, int ItemSize, int NumItems, int WindowSize)
+{
+	dbg_assert(0 < ItemSize && ItemSize <= MAX_ITEM_SIZE, "invalid ghost item size");
+	Reset();
+	m_pLoader = pLoader;
+	m_Type = Type;
+	m_ItemSize = ItemSize;
+	m_NumItems = NumItems;
+	m_WindowSize = WindowSize;
+	m_vData.resize((size_t)ItemSize * WindowSize);
+}
+
+void CGhostItemWindow::Reset()
+{
+	m_pLoader = nullptr;
+	m_Type = -1;
+	m_ItemSize = 0;
+	m_WindowSize = 0;
+	m_NumItems = 0;
+	m_vData.clear();
+	m_Start = 0;
+	m_Size = 0;
+	m_ReadPos = -1;
+}
+
+const void *CGhostItemWindow::Get(int Index)
+{
+	if(!m_pLoader || Index < 0 || Index >= m_NumItems)
+		return nullptr;
+	if(Index < m_Start || Index >= m_Start + m_Size)
+	{
+		if(!Fill(Index))
+			return nullptr;
+	}
+	return &m_vData[(size_t)(Index - m_Start) * m_ItemSize];
+}
+
+bool CGhostItemWindow::Fill(int Index)
+{
+	// the previous item stays, it is needed for interpolation
+	const int Start = maximum(0, Index - 1);
+	const int End = m_Start + m_Size;
+	if(m_ReadPos == End && Start >= m_Start && Start < End)
+	{
+		const int Keep = End - Start;
+		mem_move(m_vData.data(), &m_vData[(size_t)(Start - m_Start) * m_ItemSize], (size_t)Keep * m_ItemSize);
+		m_Size = Keep;
+	}
+	else
+	{
+		m_Size = 0;
+		// only seek if the items were already passed or are far ahead
+		if(m_ReadPos < 0 || Start < m_ReadPos || Start - m_ReadPos > m_WindowSize)
+		{
+			m_ReadPos = m_pLoader->SeekItem(m_Type, Start);
+			if(m_ReadPos < 0)
+				return false;
+		}
+	}
+	m_Start = Start;
+
+	unsigned char aItem[MAX_ITEM_SIZE];
+	int Type;
+	while(m_Size < m_WindowSize && m_ReadPos < m_NumItems && m_pLoader->ReadNextType(&Type))
+	{
+		if(Type != m_Type)
+			continue;
+
+		unsigned char *pItem = m_ReadPos >= Start ? &m_vData[(size_t)m_Size * m_ItemSize] : aItem;
+		if(!m_pLoader->ReadData(Type, pItem, m_ItemSize))
+		{
+			m_ReadPos = -1;
+			break;
+		}
+		if(m_ReadPos >= Start)
+			m_Size++;
+		m_ReadPos++;
+	}
+
+	return Index < m_Start + m_Size;
+}
+
 void CGhostLoader::Close()
 {
 	if(!m_File)
 		return;
 	io_close(m_File);
 	m_File = 0;
+	m_vChunks.clear();
 }
 
 bool CGhostLoader::GetGhostInfo(const char *pFilename, CGhostInfo *pGhostInfo, const char *pMap, SHA256_DIGEST MapSha256, unsigned MapCrc)
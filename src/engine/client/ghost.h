@@ -3,20 +3,22 @@
 
 #include <engine/ghost.h>
 
+#include <vector>
+
 enum
 {
 	MAX_ITEM_SIZE = 128,
 	NUM_ITEMS_PER_CHUNK = 50,
 };
 
-// version 4-6
+// version 4-7
 struct CGhostHeader
 {
 	unsigned char m_aMarker[8];
 	unsigned char m_Version;
 	char m_aOwner[MAX_NAME_LENGTH];
 	char m_aMap[64];
-	unsigned char m_aZeroes[sizeof(int32_t)]; // Crc before version 6
+	unsigned char m_aZeroes[sizeof(int32_t)]; // Crc before version 6, offset of the chunk index since version 7
 	unsigned char m_aNumTicks[sizeof(int32_t)];
 	unsigned char m_aTime[sizeof(int32_t)];
 	SHA256_DIGEST m_MapSha256;
@@ -31,6 +33,11 @@ struct CGhostHeader
 		return bytes_be_to_uint(m_aTime);
 	}
 
+	unsigned GetIndexOffset() const
+	{
+		return m_Version >= 7 ? bytes_be_to_uint(m_aZeroes) : 0;
+	}
+
 	CGhostInfo ToGhostInfo() const
 	{
 		CGhostInfo Result;
@@ -43,6 +50,22 @@ struct CGhostHeader
 	}
 };
 
+// entry of the chunk index at the end of the file, since version 7
+struct CGhostChunkIndexEntry
+{
+	unsigned char m_aOffset[sizeof(int32_t)];
+	unsigned char m_aFirstItem[sizeof(int32_t)]; // number of items of the type before the chunk
+	unsigned char m_Type;
+};
+
+class CGhostChunkInfo
+{
+public:
+	unsigned m_Offset;
+	int m_Type;
+	int m_FirstItem;
+};
+
 class CGhostItem
 {
 public:
@@ -68,8 +91,12 @@ class CGhostRecorder : public IGhostRecorder
 	char *m_pBufferPos;
 	int m_BufferNumItems;
 
+	std::vector<CGhostChunkInfo> m_vChunks;
+	int m_aNumItemsOfType[256];
+
 	void ResetBuffer();
 	void FlushChunk();
+	void WriteIndex();
 
 public:
 	CGhostRecorder();
@@ -91,6 +118,8 @@ class CGhostLoader : public IGhostLoader
 
 	CGhostHeader m_Header;
 	CGhostInfo m_Info;
+	unsigned m_DataOffset;
+	std::vector<CGhostChunkInfo> m_vChunks;
 
 	CGhostItem m_LastItem;
 
@@ -102,9 +131,11 @@ class CGhostLoader : public IGhostLoader
 
 	void ResetBuffer();
 	int ReadChunk(int *pType);
+	bool ReadIndex();
 
 public:
 	CGhostLoader();
+	~CGhostLoader();
 
 	void Init();
 
@@ -115,6 +146,11 @@ public:
 	bool ReadNextType(int *pType) override;
 	bool ReadData(int Type, void *pData, int Size) override;
 
+	bool IsIndexed() const override { return !m_vChunks.empty(); }
+	int SeekItem(int Type, int Index) override;
+
+	std::unique_ptr<IGhostLoader> OpenStream(const char *pFilename, const char *pMap, SHA256_DIGEST MapSha256, unsigned MapCrc) override;
+
 	bool GetGhostInfo(const char *pFilename, CGhostInfo *pGhostInfo, const char *pMap, SHA256_DIGEST MapSha256, unsigned MapCrc) override;
 };
 #endif
@@ -39,6 +39,9 @@ CSqlite SqliteOpen(IConsole *pConsole, IStorage *pStorage, const char *pPath)
 	{
 		return nullptr;
 	}
+	// the cache is written by background jobs and other clients as well,
+	// wait for their locks instead of failing right away
+	sqlite3_busy_timeout(pSqlite, 1000);
 	bool Error = false;
 	Error = Error || SQLITE_HANDLE_ERROR(sqlite3_exec(pSqlite, "PRAGMA journal_mode = WAL", nullptr, nullptr, nullptr));
 	Error = Error || SQLITE_HANDLE_ERROR(sqlite3_exec(pSqlite, "PRAGMA synchronous = NORMAL", nullptr, nullptr, nullptr));
@@ -0,0 +1,260 @@
+#include "texture_cache.h"
+
+#include <base/hash_ctxt.h>
+#include <base/log.h>
+#include <base/system.h>
+
+#include <engine/storage.h>
+
+#include <algorithm>
+#include <vector>
+
+static const char TEXTURE_CACHE_DIR[] = "texturecache";
+static const char TEXTURE_CACHE_MAGIC[4] = {'D', 'D', 'T', 'C'};
+
+void CTextureCache::Init(IStorage *pStorage, int MaxSizeMiB)
+{
+	m_pStorage = nullptr;
+	if(MaxSizeMiB <= 0)
+		return;
+	if(!pStorage->CreateFolder(TEXTURE_CACHE_DIR, IStorage::TYPE_SAVE))
+	{
+		log_error("texturecache", "failed to create folder '%s', texture cache disabled", TEXTURE_CACHE_DIR);
+		return;
+	}
+	m_pStorage = pStorage;
+	Prune((int64_t)MaxSizeMiB * 1024 * 1024);
+}
+
+void CTextureCache::Path(const SHA256_DIGEST &Key, char *pBuffer, int BufferSize) const
+{
+	char aKey[SHA256_MAXSTRSIZE];
+	sha256_str(Key, aKey, sizeof(aKey));
+	str_format(pBuffer, BufferSize, "%s/%s.ddtc", TEXTURE_CACHE_DIR, aKey);
+}
+
+bool CTextureCache::FileKey(const char *pFilename, int StorageType, SHA256_DIGEST *pFileKey) const
+{
+	// much cheaper than hashing the contents, a changed file gets a new key
+	// and its old entries are pruned eventually
+	char aCompletePath[IO_MAX_PATH_LENGTH];
+	IOHANDLE File = m_pStorage->OpenFile(pFilename, IOFLAG_READ, StorageType, aCompletePath, sizeof(aCompletePath));
+	if(!File)
+		return false;
+	const int64_t Size = io_length(File);
+	io_close(File);
+	time_t Created;
+	time_t Modified;
+	if(Size < 0 || fs_file_time(aCompletePath, &Created, &Modified) != 0)
+		return false;
+	const int64_t ModifiedInt = Modified;
+
+	SHA256_CTX Sha256Ctxt;
+	sha256_init(&Sha256Ctxt);
+	sha256_update(&Sha256Ctxt, aCompletePath, str_length(aCompletePath) + 1);
+	sha256_update(&Sha256Ctxt, &Size, sizeof(Size));
+	sha256_update(&Sha256Ctxt, &ModifiedInt, sizeof(ModifiedInt));
+	*pFileKey = sha256_finish(&Sha256Ctxt);
+	return true;
+}
+
+SHA256_DIGEST CTextureCache::Key(const SHA256_DIGEST &FileKey, const char *pVariant)
+{
+	SHA256_CTX Sha256Ctxt;
+	sha256_init(&Sha256Ctxt);
+	sha256_update(&Sha256Ctxt, FileKey.data, sizeof(FileKey.data));
+	sha256_update(&Sha256Ctxt, pVariant, str_length(pVariant));
+	return sha256_finish(&Sha256Ctxt);
+}
+
+bool CTextureCache::Load(const SHA256_DIGEST &Key, CImage *pImage)
+{
+	if(!Enabled())
+		return false;
+
+	char aPath[IO_MAX_PATH_LENGTH];
+	Path(Key, aPath, sizeof(aPath));
+	char aCompletePath[IO_MAX_PATH_LENGTH];
+	m_pStorage->GetCompletePath(IStorage::TYPE_SAVE, aPath, aCompletePath, sizeof(aCompletePath));
+
+	const void *pData;
+	unsigned DataSize;
+	if(!io_map_file(aCompletePath, &pData, &DataSize))
+		return false;
+
+	const SHeader *pHeader = (const SHeader *)pData;
+	const CImageInfo::EImageFormat Format = DataSize >= sizeof(SHeader) ? CImageInfo::ImageFormatFromInt(pHeader->m_Format) : CImageInfo::FORMAT_ERROR;
+	if(Format == CImageInfo::FORMAT_ERROR ||
+		mem_comp(pHeader->m_aMagic, TEXTURE_CACHE_MAGIC, sizeof(TEXTURE_CACHE_MAGIC)) != 0 ||
+		pHeader->m_Version != VERSION ||
+		pHeader->m_Width <= 0 || pHeader->m_Height <= 0 ||
+		DataSize - sizeof(SHeader) != (size_t)pHeader->m_Width * pHeader->m_Height * CImageInfo::PixelSize(Format))
+	{
+		log_error("texturecache", "removing invalid cache entry '%s'", aPath);
+		io_unmap_file(pData, DataSize);
+		m_pStorage->RemoveFile(aPath, IStorage::TYPE_SAVE);
+		return false;
+	}
+
+	pImage->m_Width = pHeader->m_Width;
+	pImage->m_Height = pHeader->m_Height;
+	pImage->m_Format = Format;
+	pImage->m_pData = (uint8_t *)pData + sizeof(SHeader);
+	pImage->m_Mapped = true;
+	return true;
+}
+
+void CTextureCache::Store(const SHA256_DIGEST &Key, const CImageInfo &Image)
+{
+	if(!Enabled())
+		return;
+
+	char aPath[IO_MAX_PATH_LENGTH];
+	Path(Key, aPath, sizeof(aPath));
+	// write to a temporary file first, so other clients never map a half written entry
+	char aTmpPath[IO_MAX_PATH_LENGTH];
+	str_format(aTmpPath, sizeof(aTmpPath), "%s.%d.tmp", aPath, pid());
+
+	IOHANDLE File = m_pStorage->OpenFile(aTmpPath, IOFLAG_WRITE, IStorage::TYPE_SAVE);
+	if(!File)
+	{
+		log_error("texturecache", "failed to open '%s' for writing", aTmpPath);
+		return;
+	}
+
+	SHeader Header;
+	mem_copy(Header.m_aMagic, TEXTURE_CACHE_MAGIC, sizeof(Header.m_aMagic));
+	Header.m_Version = VERSION;
+	Header.m_Width = Image.m_Width;
+	Header.m_Height = Image.m_Height;
+	Header.m_Format = Image.m_Format;
+	const unsigned DataSize = (size_t)Image.m_Width * Image.m_Height * Image.PixelSize();
+	const bool Success = io_write(File, &Header, sizeof(Header)) == sizeof(Header) &&
+			     io_write(File, Image.m_pData, DataSize) == DataSize;
+	if(io_close(File) != 0 || !Success || !m_pStorage->RenameFile(aTmpPath, aPath, IStorage::TYPE_SAVE))
+	{
+		log_error("texturecache", "failed to write '%s'", aPath);
+		m_pStorage->RemoveFile(aTmpPath, IStorage::TYPE_SAVE);
+	}
+}
+
+bool CTextureCache::LoadPNG(IGraphics *pGraphics, const char *pFilename, int StorageType, CImage *pImage)
+{
+	const std::chrono::nanoseconds Start = time_get_nanoseconds();
+	pImage->m_Mapped = false;
+	pImage->m_HasFileKey = false;
+	if(Enabled() && FileKey(pFilename, StorageType, &pImage->m_FileKey))
+	{
+		pImage->m_HasFileKey = true;
+		if(Load(Key(pImage->m_FileKey, "png"), pImage))
+		{
+			m_NumHits++;
+			m_HitTime += time_get_nanoseconds() - Start;
+			return true;
+		}
+	}
+
+	if(!pGraphics->LoadPNG(pImage, pFilename, StorageType))
+		return false;
+	if(pImage->m_HasFileKey)
+	{
+		Store(Key(pImage->m_FileKey, "png"), *pImage);
+		m_NumMisses++;
+		m_MissTime += time_get_nanoseconds() - Start;
+	}
+	return true;
+}
+
+bool CTextureCache::LoadVariant(const CImage &Source, const char *pVariant, CImage *pImage)
+{
+	pImage->m_Mapped = false;
+	pImage->m_HasFileKey = false;
+	if(!Source.m_HasFileKey)
+		return false;
+
+	const std::chrono::nanoseconds Start = time_get_nanoseconds();
+	if(Load(Key(Source.m_FileKey, pVariant), pImage))
+	{
+		m_NumHits++;
+		m_HitTime += time_get_nanoseconds() - Start;
+		return true;
+	}
+	m_NumMisses++;
+	return false;
+}
+
+void CTextureCache::StoreVariant(const CImage &Source, const char *pVariant, const CImageInfo &Image)
+{
+	if(Source.m_HasFileKey)
+		Store(Key(Source.m_FileKey, pVariant), Image);
+}
+
+void CTextureCache::Free(IGraphics *pGraphics, CImage *pImage)
+{
+	if(pImage->m_Mapped)
+	{
+		const unsigned DataSize = (size_t)pImage->m_Width * pImage->m_Height * pImage->PixelSize();
+		io_unmap_file((uint8_t *)pImage->m_pData - sizeof(SHeader), sizeof(SHeader) + DataSize);
+		pImage->m_pData = nullptr;
+		pImage->m_Mapped = false;
+	}
+	else if(pGraphics)
+	{
+		pGraphics->FreePNG(pImage);
+	}
+	else
+	{
+		free(pImage->m_pData);
+		pImage->m_pData = nullptr;
+	}
+}
+
+struct SCacheEntry
+{
+	char m_aName[IO_MAX_PATH_LENGTH];
+	time_t m_TimeModified;
+};
+
+static int CollectCacheEntriesCallback(const CFsFileInfo *pInfo, int IsDir, int StorageType, void *pUser)
+{
+	std::vector<SCacheEntry> *pvEntries = (std::vector<SCacheEntry> *)pUser;
+	if(IsDir || !(str_endswith(pInfo->m_pName, ".ddtc") || str_endswith(pInfo->m_pName, ".tmp")))
+		return 0;
+	SCacheEntry Entry;
+	str_format(Entry.m_aName, sizeof(Entry.m_aName), "%s/%s", TEXTURE_CACHE_DIR, pInfo->m_pName);
+	Entry.m_TimeModified = pInfo->m_TimeModified;
+	pvEntries->push_back(Entry);
+	return 0;
+}
+
+void CTextureCache::Prune(int64_t MaxSize)
+{
+	std::vector<SCacheEntry> vEntries;
+	m_pStorage->ListDirectoryInfo(IStorage::TYPE_SAVE, TEXTURE_CACHE_DIR, CollectCacheEntriesCallback, &vEntries);
+
+	// keep the most recently written entries, hits don't refresh them,
+	// temporary files of crashed clients are removed as well
+	std::sort(vEntries.begin(), vEntries.end(), [](const SCacheEntry &Left, const SCacheEntry &Right) {
+		return Left.m_TimeModified > Right.m_TimeModified;
+	});
+	int64_t Size = 0;
+	int NumRemoved = 0;
+	for(const SCacheEntry &Entry : vEntries)
+	{
+		if(!str_endswith(Entry.m_aName, ".tmp"))
+		{
+			IOHANDLE File = m_pStorage->OpenFile(Entry.m_aName, IOFLAG_READ, IStorage::TYPE_SAVE);
+			if(File)
+			{
+				Size += io_length(File);
+				io_close(File);
+				if(Size <= MaxSize)
+					continue;
+			}
+		}
+		if(m_pStorage->RemoveFile(Entry.m_aName, IStorage::TYPE_SAVE))
+			NumRemoved++;
+	}
+	if(NumRemoved > 0)
+		log_info("texturecache", "removed %d old cache entries", NumRemoved);
+}
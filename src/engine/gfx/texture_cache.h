@@ -0,0 +1,73 @@
+#ifndef ENGINE_GFX_TEXTURE_CACHE_H
+#define ENGINE_GFX_TEXTURE_CACHE_H
+
+#include <base/hash.h>
+
+#include <engine/graphics.h>
+
+#include <chrono>
+
+class IStorage;
+
+// Stores decoded images on disk, keyed by the path, size and modification
+// time of the file they were decoded from and a variant name, so loading
+// them again only needs to map the cached pixels into memory instead of
+// reading and decoding the file again.
+class CTextureCache
+{
+public:
+	class CImage : public CImageInfo
+	{
+		friend class CTextureCache;
+
+		bool m_Mapped = false;
+		bool m_HasFileKey = false;
+		SHA256_DIGEST m_FileKey;
+	};
+
+	void Init(IStorage *pStorage, int MaxSizeMiB);
+	bool Enabled() const { return m_pStorage != nullptr; }
+
+	// decodes a png file, using the cache if it is enabled
+	bool LoadPNG(IGraphics *pGraphics, const char *pFilename, int StorageType, CImage *pImage);
+	// loads an image derived from a loaded png, e.g. a masked variant of it
+	bool LoadVariant(const CImage &Source, const char *pVariant, CImage *pImage);
+	void StoreVariant(const CImage &Source, const char *pVariant, const CImageInfo &Image);
+	void Free(IGraphics *pGraphics, CImage *pImage);
+
+	bool Load(const SHA256_DIGEST &Key, CImage *pImage);
+	void Store(const SHA256_DIGEST &Key, const CImageInfo &Image);
+	static SHA256_DIGEST Key(const SHA256_DIGEST &FileKey, const char *pVariant);
+
+	int NumHits() const { return m_NumHits; }
+	int NumMisses() const { return m_NumMisses; }
+	std::chrono::nanoseconds HitTime() const { return m_HitTime; }
+	std::chrono::nanoseconds MissTime() const { return m_MissTime; }
+
+private:
+	enum
+	{
+		VERSION = 1,
+	};
+
+	struct SHeader
+	{
+		char m_aMagic[4];
+		int m_Version;
+		int m_Width;
+		int m_Height;
+		int m_Format;
+	};
+
+	IStorage *m_pStorage = nullptr;
+	int m_NumHits = 0;
+	int m_NumMisses = 0;
+	std::chrono::nanoseconds m_HitTime{0};
+	std::chrono::nanoseconds m_MissTime{0};
+
+	void Path(const SHA256_DIGEST &Key, char *pBuffer, int BufferSize) const;
+	bool FileKey(const char *pFilename, int StorageType, SHA256_DIGEST *pFileKey) const;
+	void Prune(int64_t MaxSize);
+};
+
+#endif // ENGINE_GFX_TEXTURE_CACHE_H
@@ -6,6 +6,9 @@
 
 #include "kernel.h"
 
+#include <memory>
+#include <vector>
+
 class CGhostInfo
 {
 public:
@@ -42,7 +45,47 @@ public:
 	virtual bool ReadNextType(int *pType) = 0;
 	virtual bool ReadData(int Type, void *pData, int Size) = 0;
 
+	// whether the file has a chunk index, which allows seeking to items
+	virtual bool IsIndexed() const = 0;
+	// continues reading at the chunk holding the item with the given index
+	// among the items of the type, returns the index of the first item of
+	// that chunk or -1 on error. Without an index reading restarts at the
+	// beginning of the data, so 0 is returned.
+	virtual int SeekItem(int Type, int Index) = 0;
+
+	// opens a separate loader for the file, which stays open until it is
+	// destroyed so ghosts can be streamed during playback
+	virtual std::unique_ptr<IGhostLoader> OpenStream(const char *pFilename, const char *pMap, SHA256_DIGEST MapSha256, unsigned MapCrc) = 0;
+
 	virtual bool GetGhostInfo(const char *pFilename, CGhostInfo *pInfo, const char *pMap, SHA256_DIGEST MapSha256, unsigned MapCrc) = 0;
 };
 
+// window of the items of one type, read from a loader as they are needed
+// so only a part of the items is held in memory
+class CGhostItemWindow
+{
+	IGhostLoader *m_pLoader;
+	int m_Type;
+	int m_ItemSize;
+	int m_WindowSize;
+	int m_NumItems;
+
+	std::vector<unsigned char> m_vData;
+	int m_Start;
+	int m_Size;
+	int m_ReadPos;
+
+	bool Fill(int Index);
+
+public:
+	CGhostItemWindow() { Reset(); }
+
+	void Init(IGhostLoader *pLoader, int Type, int ItemSize, int NumItems, int WindowSize);
+	void Reset();
+
+	int NumItems() const { return m_NumItems; }
+	// the returned item is only valid until the next call
+	const void *Get(int Index);
+};
+
 #endif
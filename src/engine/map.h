@@ -35,6 +35,11 @@ class IEngineMap : public IMap
 	MACRO_INTERFACE("enginemap")
 public:
 	virtual bool Load(const char *pMapName) = 0;
+	// Does not need the map to be registered in a kernel, so it can be used
+	// to prepare a map on another thread.
+	virtual bool Load(class IStorage *pStorage, const char *pMapName) = 0;
+	// Replaces this map by the one loaded into `pOther`, leaving it unloaded.
+	virtual void LoadFrom(IEngineMap *pOther) = 0;
 	virtual void Unload() = 0;
 	virtual bool IsLoaded() const = 0;
 	virtual IOHANDLE File() const = 0;
@@ -236,6 +236,11 @@ public:
 	virtual void Ban(int ClientID, int Seconds, const char *pReason) = 0;
 	virtual void RedirectClient(int ClientID, int Port, bool Verbose = false) = 0;
 	virtual void ChangeMap(const char *pMap) = 0;
+	// Starts loading the map in the background so that a following change to
+	// it doesn't have to wait for the disk.
+	virtual void PreloadMap(const char *pMap) = 0;
+	// Drops the preloaded map again, unless a change to it is pending.
+	virtual void CancelMapPreload() = 0;
 
 	virtual void DemoRecorder_HandleAutoStart() = 0;
 
@@ -47,6 +47,15 @@ public:
 	// has to be called to return the connection back to the pool
 	virtual void Disconnect() = 0;
 
+	// groups all following statements into one transaction until
+	// CommitTransaction or RollbackTransaction is called, connection has
+	// to be established
+	//
+	// returns true on failure
+	virtual bool BeginTransaction(char *pError, int ErrorSize) = 0;
+	virtual bool CommitTransaction(char *pError, int ErrorSize) = 0;
+	virtual bool RollbackTransaction(char *pError, int ErrorSize) = 0;
+
 	// ? for Placeholders, connection has to be established, can overwrite previous prepared statements
 	//
 	// returns true on failure
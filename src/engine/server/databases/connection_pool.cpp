@@ -33,6 +33,12 @@ struct CSqlExecData
 	CSqlExecData(IConsole *pConsole, CDbConnectionPool::Mode m);
 	~CSqlExecData() = default;
 
+	// whether both are write queries executing the same function
+	bool SameWrite(const CSqlExecData *pOther) const
+	{
+		return m_Mode == WRITE_ACCESS && pOther->m_Mode == WRITE_ACCESS && m_Ptr.m_pWriteFunc == pOther->m_Ptr.m_pWriteFunc;
+	}
+
 	enum
 	{
 		READ_ACCESS,
@@ -227,8 +233,27 @@ void CBackup::ProcessQueries()
 		}
 		else if(pThreadData->m_Mode == CSqlExecData::WRITE_ACCESS && m_pWriteBackup.get())
 		{
-			bool Success = CDbConnectionPool::ExecSqlFunc(m_pWriteBackup.get(), pThreadData, Write::BACKUP_FIRST);
-			dbg_msg("sql", "[%i] %s done on write backup database, Success=%i", JobNum, pThreadData->m_pName, Success);
+			CSqlExecData *apBatch[CDbConnectionPool::MAX_WRITE_BATCH];
+			bool aSuccess[CDbConnectionPool::MAX_WRITE_BATCH];
+			int NumBatch = 0;
+			apBatch[NumBatch++] = pThreadData;
+			// combine directly following writes of the same kind that are already queued
+			while(NumBatch < CDbConnectionPool::MAX_WRITE_BATCH && m_pShared->m_NumBackup.GetApproximateValue() > 0)
+			{
+				CSqlExecData *pNext = m_pShared->m_aQueries[(JobNum + 1) % std::size(m_pShared->m_aQueries)].get();
+				if(!pNext || !pThreadData->SameWrite(pNext))
+					break;
+				m_pShared->m_NumBackup.Wait();
+				apBatch[NumBatch++] = pNext;
+				JobNum++;
+			}
+			CDbConnectionPool::ExecSqlBatch(m_pWriteBackup.get(), apBatch, aSuccess, NumBatch, Write::BACKUP_FIRST);
+			for(int i = 0; i < NumBatch; i++)
+			{
+				dbg_msg("sql", "[%i] %s done on write backup database, Success=%i", JobNum - NumBatch + 1 + i, apBatch[i]->m_pName, aSuccess[i]);
+				m_pShared->m_NumWorker.Signal();
+			}
+			continue;
 		}
 		m_pShared->m_NumWorker.Signal();
 	}
@@ -248,6 +273,7 @@ public:
 
 private:
 	void Print(IConsole *pConsole, CDbConnectionPool::Mode DatabaseMode);
+	void ProcessWrites(CSqlExecData **ppData, bool *pSuccess, int NumData, int FirstJobNum, bool &FailMode);
 
 	// There are two possible configurations
 	//  * sqlite mode: There exists exactly one READ and the same WRITE server
@@ -327,29 +353,38 @@ void CWorker::ProcessQueries()
 		break;
 		case CSqlExecData::WRITE_ACCESS:
 		{
-			if(m_pShared->m_Shutdown && m_pWriteBackup != nullptr)
-			{
-				dbg_msg("sql", "[%i] %s skipped to backup database during shutdown", JobNum, pThreadData->m_pName);
-			}
-			else if(FailMode && m_pWriteBackup != nullptr)
+			std::unique_ptr<CSqlExecData> apBatch[CDbConnectionPool::MAX_WRITE_BATCH];
+			CSqlExecData *apBatchData[CDbConnectionPool::MAX_WRITE_BATCH];
+			bool aSuccess[CDbConnectionPool::MAX_WRITE_BATCH];
+			int FirstJobNum = JobNum;
+			int NumBatch = 0;
+			apBatchData[NumBatch] = pThreadData.get();
+			apBatch[NumBatch++] = std::move(pThreadData);
+			// combine directly following writes of the same kind that the
+			// backup thread already handed over
+			while(NumBatch < CDbConnectionPool::MAX_WRITE_BATCH && m_pShared->m_NumWorker.GetApproximateValue() > 0)
 			{
-				dbg_msg("sql", "[%i] %s skipped to backup database during FailMode", JobNum, pThreadData->m_pName);
+				auto &pNext = m_pShared->m_aQueries[(JobNum + 1) % std::size(m_pShared->m_aQueries)];
+				if(!pNext || !apBatchData[0]->SameWrite(pNext.get()))
+					break;
+				m_pShared->m_NumWorker.Wait();
+				apBatchData[NumBatch] = pNext.get();
+				apBatch[NumBatch++] = std::move(pNext);
+				JobNum++;
 			}
-			else if(CDbConnectionPool::ExecSqlFunc(m_pWriteConnection.get(), pThreadData.get(), Write::NORMAL))
+			ProcessWrites(apBatchData, aSuccess, NumBatch, FirstJobNum, FailMode);
+			for(int i = 0; i < NumBatch; i++)
 			{
-				dbg_msg("sql", "[%i] %s done on write database", JobNum, pThreadData->m_pName);
-				Success = true;
-			}
-			// enter fail mode if not successful
-			FailMode = FailMode || !Success;
-			const Write w = Success ? Write::NORMAL_SUCCEEDED : Write::NORMAL_FAILED;
-			if(m_pWriteBackup && CDbConnectionPool::ExecSqlFunc(m_pWriteBackup.get(), pThreadData.get(), w))
-			{
-				dbg_msg("sql", "[%i] %s done move write on backup database to non-backup table", JobNum, pThreadData->m_pName);
-				Success = true;
+				if(!aSuccess[i])
+					dbg_msg("sql", "[%i] %s failed on all databases", FirstJobNum + i, apBatchData[i]->m_pName);
+				if(apBatchData[i]->m_pThreadData->m_pResult != nullptr)
+				{
+					apBatchData[i]->m_pThreadData->m_pResult->m_Success = aSuccess[i];
+					apBatchData[i]->m_pThreadData->m_pResult->m_Completed.store(true);
+				}
 			}
+			continue;
 		}
-		break;
 		case CSqlExecData::ADD_MYSQL:
 		{
 			auto pMysql = CreateMysqlConnection(pThreadData->m_Ptr.m_MySql.m_Config);
@@ -405,6 +440,87 @@ void CWorker::ProcessQueries()
 	}
 }
 
+void CWorker::ProcessWrites(CSqlExecData **ppData, bool *pSuccess, int NumData, int FirstJobNum, bool &FailMode)
+{
+	for(int i = 0; i < NumData; i++)
+		pSuccess[i] = false;
+
+	if(m_pShared->m_Shutdown && m_pWriteBackup != nullptr)
+	{
+		for(int i = 0; i < NumData; i++)
+			dbg_msg("sql", "[%i] %s skipped to backup database during shutdown", FirstJobNum + i, ppData[i]->m_pName);
+	}
+	else if(FailMode && m_pWriteBackup != nullptr)
+	{
+		for(int i = 0; i < NumData; i++)
+			dbg_msg("sql", "[%i] %s skipped to backup database during FailMode", FirstJobNum + i, ppData[i]->m_pName);
+	}
+	else
+	{
+		CDbConnectionPool::ExecSqlBatch(m_pWriteConnection.get(), ppData, pSuccess, NumData, Write::NORMAL);
+		for(int i = 0; i < NumData; i++)
+		{
+			if(pSuccess[i])
+				dbg_msg("sql", "[%i] %s done on write database", FirstJobNum + i, ppData[i]->m_pName);
+		}
+	}
+
+	if(!m_pWriteBackup)
+	{
+		// enter fail mode if not successful
+		for(int i = 0; i < NumData; i++)
+			FailMode = FailMode || !pSuccess[i];
+		return;
+	}
+
+	// move the succeeded writes on the backup database to the non-backup
+	// table and notify about the failed ones, each group in one transaction
+	CSqlExecData *apSucceeded[CDbConnectionPool::MAX_WRITE_BATCH];
+	CSqlExecData *apFailed[CDbConnectionPool::MAX_WRITE_BATCH];
+	int aSucceededIndex[CDbConnectionPool::MAX_WRITE_BATCH];
+	int aFailedIndex[CDbConnectionPool::MAX_WRITE_BATCH];
+	int NumSucceeded = 0;
+	int NumFailed = 0;
+	for(int i = 0; i < NumData; i++)
+	{
+		if(pSuccess[i])
+		{
+			aSucceededIndex[NumSucceeded] = i;
+			apSucceeded[NumSucceeded++] = ppData[i];
+		}
+		else
+		{
+			// enter fail mode if not successful
+			FailMode = true;
+			aFailedIndex[NumFailed] = i;
+			apFailed[NumFailed++] = ppData[i];
+		}
+	}
+
+	bool aBackupSuccess[CDbConnectionPool::MAX_WRITE_BATCH];
+	if(NumSucceeded)
+	{
+		CDbConnectionPool::ExecSqlBatch(m_pWriteBackup.get(), apSucceeded, aBackupSuccess, NumSucceeded, Write::NORMAL_SUCCEEDED);
+		for(int i = 0; i < NumSucceeded; i++)
+		{
+			if(aBackupSuccess[i])
+				dbg_msg("sql", "[%i] %s done move write on backup database to non-backup table", FirstJobNum + aSucceededIndex[i], apSucceeded[i]->m_pName);
+		}
+	}
+	if(NumFailed)
+	{
+		CDbConnectionPool::ExecSqlBatch(m_pWriteBackup.get(), apFailed, aBackupSuccess, NumFailed, Write::NORMAL_FAILED);
+		for(int i = 0; i < NumFailed; i++)
+		{
+			if(aBackupSuccess[i])
+			{
+				dbg_msg("sql", "[%i] %s done move write on backup database to non-backup table", FirstJobNum + aFailedIndex[i], apFailed[i]->m_pName);
+				pSuccess[aFailedIndex[i]] = true;
+			}
+		}
+	}
+}
+
 void CWorker::Print(IConsole *pConsole, CDbConnectionPool::Mode DatabaseMode)
 {
 	if(DatabaseMode == CDbConnectionPool::Mode::READ)
@@ -464,6 +580,55 @@ bool CDbConnectionPool::ExecSqlFunc(IDbConnection *pConnection, CSqlExecData *pD
 	return Success;
 }
 
+/* static */
+void CDbConnectionPool::ExecSqlBatch(IDbConnection *pConnection, CSqlExecData **ppData, bool *pSuccess, int NumData, Write w)
+{
+	if(NumData == 1 || pConnection == nullptr)
+	{
+		for(int i = 0; i < NumData; i++)
+			pSuccess[i] = ExecSqlFunc(pConnection, ppData[i], w);
+		return;
+	}
+
+	char aError[256] = "unknown error";
+	if(pConnection->Connect(aError, sizeof(aError)))
+	{
+		dbg_msg("sql", "failed connecting to db: %s", aError);
+		for(int i = 0; i < NumData; i++)
+			pSuccess[i] = false;
+		return;
+	}
+	const bool Begun = !pConnection->BeginTransaction(aError, sizeof(aError));
+	bool Success = Begun;
+	for(int i = 0; i < NumData && Success; i++)
+	{
+		dbg_assert(ppData[i]->m_Mode == CSqlExecData::WRITE_ACCESS, "only writes can be batched");
+		Success = !ppData[i]->m_Ptr.m_pWriteFunc(pConnection, ppData[i]->m_pThreadData.get(), w, aError, sizeof(aError));
+	}
+	if(Success)
+	{
+		Success = !pConnection->CommitTransaction(aError, sizeof(aError));
+	}
+	if(!Success)
+	{
+		dbg_msg("sql", "batch of %d %s failed, retrying one by one: %s", NumData, ppData[0]->m_pName, aError);
+		char aRollbackError[256];
+		if(Begun && pConnection->RollbackTransaction(aRollbackError, sizeof(aRollbackError)))
+			dbg_msg("sql", "rollback failed: %s", aRollbackError);
+	}
+	pConnection->Disconnect();
+
+	if(Success)
+	{
+		dbg_msg("sql", "batch of %d %s done in one transaction", NumData, ppData[0]->m_pName);
+		for(int i = 0; i < NumData; i++)
+			pSuccess[i] = true;
+		return;
+	}
+	for(int i = 0; i < NumData; i++)
+		pSuccess[i] = ExecSqlFunc(pConnection, ppData[i], w);
+}
+
 CDbConnectionPool::CDbConnectionPool()
 {
 	m_pShared = std::make_shared<CSharedData>();
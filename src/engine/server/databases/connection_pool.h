@@ -99,6 +99,14 @@ public:
 
 private:
 	static bool ExecSqlFunc(IDbConnection *pConnection, struct CSqlExecData *pData, Write w);
+	// Executes all writes in a single transaction. If that fails, they are
+	// retried one by one so that each request gets its own result.
+	static void ExecSqlBatch(IDbConnection *pConnection, struct CSqlExecData **ppData, bool *pSuccess, int NumData, Write w);
+
+	// Maximum number of queued write queries of the same kind that are
+	// combined into one transaction. Only queries that are already queued
+	// get combined, so batching doesn't delay a write.
+	static constexpr int MAX_WRITE_BATCH = 64;
 
 	// Only the main thread accesses this variable. It points to the index,
 	// where the next query is added to the queue.
@@ -30,6 +30,10 @@ public:
 	bool Connect(char *pError, int ErrorSize) override;
 	void Disconnect() override;
 
+	bool BeginTransaction(char *pError, int ErrorSize) override;
+	bool CommitTransaction(char *pError, int ErrorSize) override;
+	bool RollbackTransaction(char *pError, int ErrorSize) override;
+
 	bool PrepareStatement(const char *pStmt, char *pError, int ErrorSize) override;
 
 	void BindString(int Idx, const char *pString) override;
@@ -187,6 +191,28 @@ void CSqliteConnection::Disconnect()
 	m_InUse.store(false);
 }
 
+bool CSqliteConnection::BeginTransaction(char *pError, int ErrorSize)
+{
+	return Execute("BEGIN", pError, ErrorSize);
+}
+
+bool CSqliteConnection::CommitTransaction(char *pError, int ErrorSize)
+{
+	// a transaction can't be committed while a statement is still pending
+	if(m_pStmt != nullptr)
+		sqlite3_finalize(m_pStmt);
+	m_pStmt = nullptr;
+	return Execute("COMMIT", pError, ErrorSize);
+}
+
+bool CSqliteConnection::RollbackTransaction(char *pError, int ErrorSize)
+{
+	if(m_pStmt != nullptr)
+		sqlite3_finalize(m_pStmt);
+	m_pStmt = nullptr;
+	return Execute("ROLLBACK", pError, ErrorSize);
+}
+
 bool CSqliteConnection::PrepareStatement(const char *pStmt, char *pError, int ErrorSize)
 {
 	if(m_pStmt != nullptr)
@@ -29,6 +29,9 @@
 
 #include <csignal>
 
+// messages written by the game while a log thread is busy, per logger
+static const int LOG_QUEUE_SIZE = 512;
+
 volatile sig_atomic_t InterruptSignaled = 0;
 
 bool IsInterrupted()
@@ -73,7 +76,7 @@ int main(int argc, const char **argv)
 #else
 	if(!Silent)
 	{
-		pStdoutLogger = std::shared_ptr<ILogger>(log_logger_stdout());
+		pStdoutLogger = std::shared_ptr<ILogger>(log_logger_queue(log_logger_stdout(), LOG_QUEUE_SIZE));
 	}
 #endif
 	if(pStdoutLogger)
@@ -173,18 +176,26 @@ int main(int argc, const char **argv)
 	pConfigManager->SetReadOnly("sv_rescue", true);
 
 	const int Mode = g_Config.m_Logappend ? IOFLAG_APPEND : IOFLAG_WRITE;
+	bool FileLoggerSet = false;
 	if(g_Config.m_Logfile[0])
 	{
 		IOHANDLE Logfile = pStorage->OpenFile(g_Config.m_Logfile, Mode, IStorage::TYPE_SAVE_OR_ABSOLUTE);
 		if(Logfile)
 		{
-			pFutureFileLogger->Set(log_logger_file(Logfile));
+			pFutureFileLogger->Set(log_logger_queue(log_logger_file(Logfile), LOG_QUEUE_SIZE));
+			FileLoggerSet = true;
 		}
 		else
 		{
 			dbg_msg("server", "failed to open '%s' for logging", g_Config.m_Logfile);
 		}
 	}
+	if(!FileLoggerSet)
+	{
+		// stop collecting messages for a log file that doesn't exist
+		std::vector<std::shared_ptr<ILogger>> vpNoLoggers;
+		pFutureFileLogger->Set(log_logger_collection(std::move(vpNoLoggers)));
+	}
 	auto pServerLogger = std::make_shared<CServerLogger>(pServer);
 	pEngine->SetAdditionalLogger(pServerLogger);
 
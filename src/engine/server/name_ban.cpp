@@ -4,6 +4,33 @@
 
 #include <engine/shared/config.h>
 
+#include <algorithm>
+
+// Counts how often each bigram occurs in a skeleton, sorted by bigram.
+static void SkeletonBigrams(const int *pSkeleton, int Length, std::vector<std::pair<uint64_t, int>> &vBigrams)
+{
+	std::vector<uint64_t> vAll;
+	for(int i = 0; i + 1 < Length; i++)
+		vAll.push_back(((uint64_t)(uint32_t)pSkeleton[i] << 32) | (uint32_t)pSkeleton[i + 1]);
+	std::sort(vAll.begin(), vAll.end());
+
+	vBigrams.clear();
+	for(uint64_t Bigram : vAll)
+	{
+		if(!vBigrams.empty() && vBigrams.back().first == Bigram)
+			vBigrams.back().second++;
+		else
+			vBigrams.emplace_back(Bigram, 1);
+	}
+}
+
+// Each edit changes at most two bigrams, so two skeletons within `Distance`
+// edits share at least this many bigrams.
+static int MinSharedBigrams(int Length1, int Length2, int Distance)
+{
+	return maximum(Length1, Length2) - 1 - 2 * Distance;
+}
+
 CNameBan::CNameBan(const char *pName, const char *pReason, int Distance, bool IsSubstring) :
 	m_Distance(Distance), m_IsSubstring(IsSubstring)
 {
@@ -23,24 +50,26 @@ void CNameBans::InitConsole(IConsole *pConsole)
 
 void CNameBans::Ban(const char *pName, const char *pReason, const int Distance, const bool IsSubstring)
 {
-	for(auto &Ban : m_vNameBans)
+	auto Existing = m_NameBanIndices.find(pName);
+	if(Existing != m_NameBanIndices.end())
 	{
-		if(str_comp(Ban.m_aName, pName) == 0)
+		CNameBan &Ban = m_vNameBans[Existing->second];
+		if(m_pConsole)
 		{
-			if(m_pConsole)
-			{
-				char aBuf[256];
-				str_format(aBuf, sizeof(aBuf), "changed name='%s' distance=%d old_distance=%d is_substring=%d old_is_substring=%d reason='%s' old_reason='%s'", pName, Distance, Ban.m_Distance, IsSubstring, Ban.m_IsSubstring, pReason, Ban.m_aReason);
-				m_pConsole->Print(IConsole::OUTPUT_LEVEL_STANDARD, "name_ban", aBuf);
-			}
-			str_copy(Ban.m_aReason, pReason);
-			Ban.m_Distance = Distance;
-			Ban.m_IsSubstring = IsSubstring;
-			return;
+			char aBuf[256];
+			str_format(aBuf, sizeof(aBuf), "changed name='%s' distance=%d old_distance=%d is_substring=%d old_is_substring=%d reason='%s' old_reason='%s'", pName, Distance, Ban.m_Distance, IsSubstring, Ban.m_IsSubstring, pReason, Ban.m_aReason);
+			m_pConsole->Print(IConsole::OUTPUT_LEVEL_STANDARD, "name_ban", aBuf);
 		}
+		str_copy(Ban.m_aReason, pReason);
+		Ban.m_Distance = Distance;
+		Ban.m_IsSubstring = IsSubstring;
+		m_IndexDirty = true;
+		return;
 	}
 
 	m_vNameBans.emplace_back(pName, pReason, Distance, IsSubstring);
+	m_NameBanIndices.emplace(m_vNameBans.back().m_aName, m_vNameBans.size() - 1);
+	m_IndexDirty = true;
 	if(m_pConsole)
 	{
 		char aBuf[256];
@@ -70,6 +99,10 @@ void CNameBans::Unban(const char *pName)
 			m_pConsole->Print(IConsole::OUTPUT_LEVEL_STANDARD, "name_ban", aBuf);
 		}
 		m_vNameBans.erase(ToRemove, m_vNameBans.end());
+		m_NameBanIndices.clear();
+		for(size_t i = 0; i < m_vNameBans.size(); i++)
+			m_NameBanIndices.emplace(m_vNameBans[i].m_aName, i);
+		m_IndexDirty = true;
 	}
 }
 
@@ -86,24 +119,131 @@ void CNameBans::Dump() const
 	}
 }
 
+void CNameBans::RebuildIndex() const
+{
+	m_BigramBans.clear();
+	m_vShortBans.clear();
+	m_SubstringBans.clear();
+	m_vEmptySubstringBans.clear();
+
+	std::vector<std::pair<uint64_t, int>> vBigrams;
+	for(int i = 0; i < (int)m_vNameBans.size(); i++)
+	{
+		const CNameBan &Ban = m_vNameBans[i];
+		if(Ban.m_Distance >= 0)
+		{
+			if(MinSharedBigrams(0, Ban.m_SkeletonLength, Ban.m_Distance) <= 0)
+				m_vShortBans.push_back(i);
+			SkeletonBigrams(Ban.m_aSkeleton, Ban.m_SkeletonLength, vBigrams);
+			for(const auto &[Bigram, Count] : vBigrams)
+				m_BigramBans[Bigram].push_back({i, Count, Ban.m_SkeletonLength, Ban.m_Distance});
+		}
+		if(Ban.m_IsSubstring)
+		{
+			const char *pName = Ban.m_aName;
+			if(*pName)
+				m_SubstringBans[str_utf8_tolower(str_utf8_decode(&pName))].push_back(i);
+			else
+				m_vEmptySubstringBans.push_back(i);
+		}
+	}
+	m_vSharedBigrams.assign(m_vNameBans.size(), 0);
+	m_IndexDirty = false;
+}
+
+// Same as `str_utf32_dist_buffer(...) <= MaxDistance`, but stops as soon
+// as every entry of a row exceeds the maximum.
+static bool SkeletonWithinDistance(const int *pSkeleton1, int Length1, const int *pSkeleton2, int Length2, int MaxDistance)
+{
+	int aaRows[2][MAX_NAME_SKELETON_LENGTH + 1];
+	for(int i = 0; i <= Length1; i++)
+		aaRows[0][i] = i;
+	for(int j = 1; j <= Length2; j++)
+	{
+		const int *pPrev = aaRows[(j - 1) & 1];
+		int *pRow = aaRows[j & 1];
+		pRow[0] = j;
+		int RowMin = pRow[0];
+		for(int i = 1; i <= Length1; i++)
+		{
+			const int Subst = pSkeleton1[i - 1] != pSkeleton2[j - 1];
+			pRow[i] = minimum(minimum(pPrev[i] + 1, pRow[i - 1] + 1), pPrev[i - 1] + Subst);
+			RowMin = minimum(RowMin, pRow[i]);
+		}
+		if(RowMin > MaxDistance)
+			return false;
+	}
+	return aaRows[Length2 & 1][Length1] <= MaxDistance;
+}
+
 const CNameBan *CNameBans::IsBanned(const char *pName) const
 {
+	if(m_IndexDirty)
+		RebuildIndex();
+
 	char aTrimmed[MAX_NAME_LENGTH];
 	str_copy(aTrimmed, str_utf8_skip_whitespaces(pName));
 	str_utf8_trim_right(aTrimmed);
 
 	int aSkeleton[MAX_NAME_SKELETON_LENGTH];
 	int SkeletonLength = str_utf8_to_skeleton(aTrimmed, aSkeleton, std::size(aSkeleton));
-	int aBuffer[MAX_NAME_SKELETON_LENGTH * 2 + 2];
 
-	const CNameBan *pResult = nullptr;
-	for(const CNameBan &Ban : m_vNameBans)
+	// The last matching ban wins, candidates are checked the same way all
+	// bans were before, so the index only skips bans that can't match.
+	int Result = -1;
+	const auto CheckDistance = [&](int Index) {
+		const CNameBan &Ban = m_vNameBans[Index];
+		if(Index <= Result || absolute(SkeletonLength - Ban.m_SkeletonLength) > Ban.m_Distance)
+			return;
+		if(SkeletonWithinDistance(aSkeleton, SkeletonLength, Ban.m_aSkeleton, Ban.m_SkeletonLength, Ban.m_Distance))
+			Result = Index;
+	};
+	const auto CheckSubstring = [&](int Index) {
+		if(Index > Result && str_utf8_find_nocase(pName, m_vNameBans[Index].m_aName))
+			Result = Index;
+	};
+
+	for(int Index : m_vShortBans)
+		CheckDistance(Index);
+
+	std::vector<std::pair<uint64_t, int>> vBigrams;
+	SkeletonBigrams(aSkeleton, SkeletonLength, vBigrams);
+	for(const auto &[Bigram, Count] : vBigrams)
 	{
-		int Distance = str_utf32_dist_buffer(aSkeleton, SkeletonLength, Ban.m_aSkeleton, Ban.m_SkeletonLength, aBuffer, std::size(aBuffer));
-		if(Distance <= Ban.m_Distance || (Ban.m_IsSubstring && str_utf8_find_nocase(pName, Ban.m_aName)))
-			pResult = &Ban;
+		auto It = m_BigramBans.find(Bigram);
+		if(It == m_BigramBans.end())
+			continue;
+		for(const CBigramBan &BigramBan : It->second)
+		{
+			if(absolute(SkeletonLength - BigramBan.m_SkeletonLength) > BigramBan.m_Distance)
+				continue;
+			if(m_vSharedBigrams[BigramBan.m_Index] == 0)
+				m_vSharingBans.push_back(BigramBan.m_Index);
+			m_vSharedBigrams[BigramBan.m_Index] += minimum(Count, BigramBan.m_Count);
+		}
 	}
-	return pResult;
+	for(int Index : m_vSharingBans)
+	{
+		const CNameBan &Ban = m_vNameBans[Index];
+		if(m_vSharedBigrams[Index] >= MinSharedBigrams(SkeletonLength, Ban.m_SkeletonLength, Ban.m_Distance))
+			CheckDistance(Index);
+		m_vSharedBigrams[Index] = 0;
+	}
+	m_vSharingBans.clear();
+
+	for(int Index : m_vEmptySubstringBans)
+		CheckSubstring(Index);
+	const char *pChar = pName;
+	while(*pChar)
+	{
+		auto It = m_SubstringBans.find(str_utf8_tolower(str_utf8_decode(&pChar)));
+		if(It == m_SubstringBans.end())
+			continue;
+		for(int Index : It->second)
+			CheckSubstring(Index);
+	}
+
+	return Result >= 0 ? &m_vNameBans[Result] : nullptr;
 }
 
 void CNameBans::ConNameBan(IConsole::IResult *pResult, void *pUser)
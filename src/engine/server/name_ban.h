@@ -4,6 +4,9 @@
 #include <engine/console.h>
 #include <engine/shared/protocol.h>
 
+#include <cstdint>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 enum
@@ -29,6 +32,30 @@ class CNameBans
 {
 	IConsole *m_pConsole = nullptr;
 	std::vector<CNameBan> m_vNameBans;
+	std::unordered_map<std::string, int> m_NameBanIndices;
+
+	// Index to find the few bans that can match a name without comparing
+	// it to every ban. Rebuilt on the next check after bans changed.
+	struct CBigramBan
+	{
+		int m_Index;
+		int m_Count;
+		int m_SkeletonLength;
+		int m_Distance;
+	};
+	mutable bool m_IndexDirty = false;
+	// skeleton bigram -> bans containing it
+	mutable std::unordered_map<uint64_t, std::vector<CBigramBan>> m_BigramBans;
+	// bans too short to be filtered by bigrams
+	mutable std::vector<int> m_vShortBans;
+	// lowercase first character -> substring bans
+	mutable std::unordered_map<int, std::vector<int>> m_SubstringBans;
+	mutable std::vector<int> m_vEmptySubstringBans;
+	// shared bigrams per ban while checking a name
+	mutable std::vector<int> m_vSharedBigrams;
+	mutable std::vector<int> m_vSharingBans;
+
+	void RebuildIndex() const;
 
 	static void ConNameBan(IConsole::IResult *pResult, void *pUser);
 	static void ConNameUnban(IConsole::IResult *pResult, void *pUser);
@@ -13,6 +13,10 @@
 #include <engine/shared/packer.h>
 #include <engine/shared/uuid_manager.h>
 
+#include <chrono>
+#include <thread>
+#include <vector>
+
 class CRegister : public IRegister
 {
 	enum
@@ -129,6 +133,9 @@ class CRegister : public IRegister
 	bool m_GotServerInfo = false;
 	char m_aServerInfo[16384];
 
+	// The HTTP thread is stopped after `OnShutdown()`, which waits for these.
+	std::vector<std::shared_ptr<CHttpRequest>> m_vpShutdownDeletes;
+
 public:
 	CRegister(CConfig *pConfig, IConsole *pConsole, IEngine *pEngine, int ServerPort, unsigned SixupSecurityToken);
 	void Update() override;
@@ -348,7 +355,12 @@ void CRegister::CProtocol::SendDeleteIfRegistered(bool Shutdown)
 		pDelete->Timeout(CTimeout{1000, 1000, 0, 0});
 	}
 	log_info(ProtocolToSystem(m_Protocol), "deleting...");
-	m_pParent->m_pEngine->AddJob(std::move(pDelete));
+	std::shared_ptr<CHttpRequest> pJob = std::move(pDelete);
+	if(Shutdown)
+	{
+		m_pParent->m_vpShutdownDeletes.push_back(pJob);
+	}
+	m_pParent->m_pEngine->AddJob(std::move(pJob));
 }
 
 CRegister::CProtocol::CProtocol(CRegister *pParent, int Protocol) :
@@ -747,6 +759,14 @@ void CRegister::OnShutdown()
 		}
 		m_aProtocols[i].SendDeleteIfRegistered(true);
 	}
+	for(auto &pDelete : m_vpShutdownDeletes)
+	{
+		while(pDelete->Status() != IJob::STATE_DONE)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		}
+	}
+	m_vpShutdownDeletes.clear();
 }
 
 IRegister *CreateRegister(CConfig *pConfig, IConsole *pConsole, IEngine *pEngine, int ServerPort, unsigned SixupSecurityToken)
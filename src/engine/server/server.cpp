@@ -202,9 +202,8 @@ int CServerBan::BanExt(T *pBanPool, const typename T::CDataType *pData, int Seco
 
 		if(NetMatch(&Data, Server()->m_NetServer.ClientAddr(i)))
 		{
-			CNetHash NetHash(&Data);
 			char aBuf[256];
-			MakeBanInfo(pBanPool->Find(&Data, &NetHash), aBuf, sizeof(aBuf), MSGTYPE_PLAYER);
+			MakeBanInfo(pBanPool->Find(&Data), aBuf, sizeof(aBuf), MSGTYPE_PLAYER);
 			Server()->m_NetServer.Drop(i, aBuf);
 		}
 	}
@@ -314,8 +313,8 @@ CServer::CServer()
 {
 	m_pConfig = &g_Config;
 	for(int i = 0; i < MAX_CLIENTS; i++)
-		m_aDemoRecorder[i] = CDemoRecorder(&m_SnapshotDelta, true);
-	m_aDemoRecorder[MAX_CLIENTS] = CDemoRecorder(&m_SnapshotDelta, false);
+		m_aDemoRecorder[i] = CDemoRecorder(&m_SnapshotDelta, true, true);
+	m_aDemoRecorder[MAX_CLIENTS] = CDemoRecorder(&m_SnapshotDelta, false, true);
 
 	m_pGameServer = 0;
 
@@ -1944,7 +1943,11 @@ bool CServer::RateLimitServerInfoConnless()
 
 void CServer::SendServerInfoConnless(const NETADDR *pAddr, int Token, int Type)
 {
-	SendServerInfo(pAddr, Token, Type, RateLimitServerInfoConnless());
+	const bool SendClients = RateLimitServerInfoConnless();
+	if(!SendClients)
+		m_ServerInfoStats.m_Limited++;
+	m_ServerInfoStats.m_Served++;
+	SendServerInfo(pAddr, Token, Type, SendClients, &m_ServerInfoStats);
 }
 
 static inline int GetCacheIndex(int Type, bool SendClient)
@@ -1969,7 +1972,17 @@ CServer::CCache::~CCache()
 
 CServer::CCache::CCacheChunk::CCacheChunk(const void *pData, int Size)
 {
-	m_vData.assign((const uint8_t *)pData, (const uint8_t *)pData + Size);
+	m_vData.resize(PREFIX_SPACE + Size);
+	mem_copy(m_vData.data() + PREFIX_SPACE, pData, Size);
+}
+
+unsigned char *CServer::CCache::CCacheChunk::Prefix(const void *pPrefix, int PrefixSize, int *pPacketSize)
+{
+	dbg_assert(PrefixSize <= PREFIX_SPACE - NET_CONNLESS_HEADER_SPACE, "serverinfo prefix too big");
+	unsigned char *pPacket = m_vData.data() + PREFIX_SPACE - PrefixSize;
+	mem_copy(pPacket, pPrefix, PrefixSize);
+	*pPacketSize = m_vData.size() - (PREFIX_SPACE - PrefixSize);
+	return pPacket;
 }
 
 void CServer::CCache::AddChunk(const void *pData, int Size)
@@ -2258,58 +2271,80 @@ void CServer::CacheServerInfoSixup(CCache *pCache, bool SendClients)
 	pCache->AddChunk(Packer.Data(), Packer.Size());
 }
 
-void CServer::SendServerInfo(const NETADDR *pAddr, int Token, int Type, bool SendClients)
+void CServer::SendServerInfo(const NETADDR *pAddr, int Token, int Type, bool SendClients, CServerInfoStats *pStats)
 {
-	CPacker p;
-	char aBuf[128];
-	p.Reset();
-
 	CCache *pCache = &m_aServerInfoCache[GetCacheIndex(Type, SendClients)];
 
-#define ADD_RAW(p, x) (p).AddRaw(x, sizeof(x))
-#define ADD_INT(p, x) \
-	do \
-	{ \
-		str_from_int(x, aBuf); \
-		(p).AddString(aBuf, 0); \
-	} while(0)
+	// every chunk holds at least one client
+	unsigned char *apPackets[MAX_CLIENTS + 1];
+	int aSizes[MAX_CLIENTS + 1];
+	int NumPackets = 0;
 
-	CNetChunk Packet;
-	Packet.m_ClientID = -1;
-	Packet.m_Address = *pAddr;
-	Packet.m_Flags = NETSENDFLAG_CONNLESS;
+	unsigned char aPrefix[SERVERBROWSE_SIZE + 12];
+	char aToken[12];
+	str_from_int(Token, aToken);
+	const int PrefixSize = SERVERBROWSE_SIZE + str_length(aToken) + 1;
+	mem_copy(aPrefix + SERVERBROWSE_SIZE, aToken, PrefixSize - SERVERBROWSE_SIZE);
 
-	for(const auto &Chunk : pCache->m_vCache)
+	for(auto &Chunk : pCache->m_vCache)
 	{
-		p.Reset();
 		if(Type == SERVERINFO_EXTENDED)
 		{
 			if(&Chunk == &pCache->m_vCache.front())
-				p.AddRaw(SERVERBROWSE_INFO_EXTENDED, sizeof(SERVERBROWSE_INFO_EXTENDED));
+				mem_copy(aPrefix, SERVERBROWSE_INFO_EXTENDED, SERVERBROWSE_SIZE);
 			else
-				p.AddRaw(SERVERBROWSE_INFO_EXTENDED_MORE, sizeof(SERVERBROWSE_INFO_EXTENDED_MORE));
-			ADD_INT(p, Token);
+				mem_copy(aPrefix, SERVERBROWSE_INFO_EXTENDED_MORE, SERVERBROWSE_SIZE);
 		}
 		else if(Type == SERVERINFO_64_LEGACY)
 		{
-			ADD_RAW(p, SERVERBROWSE_INFO_64_LEGACY);
-			ADD_INT(p, Token);
+			mem_copy(aPrefix, SERVERBROWSE_INFO_64_LEGACY, SERVERBROWSE_SIZE);
 		}
 		else if(Type == SERVERINFO_VANILLA || Type == SERVERINFO_INGAME)
 		{
-			ADD_RAW(p, SERVERBROWSE_INFO);
-			ADD_INT(p, Token);
+			mem_copy(aPrefix, SERVERBROWSE_INFO, SERVERBROWSE_SIZE);
 		}
 		else
 		{
 			dbg_assert(false, "unknown serverinfo type");
 		}
 
-		p.AddRaw(Chunk.m_vData.data(), Chunk.m_vData.size());
-		Packet.m_pData = p.Data();
-		Packet.m_DataSize = p.Size();
-		m_NetServer.Send(&Packet);
+		dbg_assert(NumPackets < (int)std::size(apPackets), "too many serverinfo chunks");
+		apPackets[NumPackets] = Chunk.Prefix(aPrefix, PrefixSize, &aSizes[NumPackets]);
+		NumPackets++;
+	}
+
+	// the whole reply goes out in one batch
+	const int Sent = m_NetServer.SendConnlessInPlace(pAddr, apPackets, aSizes, NumPackets);
+	if(pStats)
+	{
+		pStats->m_Cached += Sent;
+		if(Sent < NumPackets)
+			pStats->m_Dropped++;
+	}
+}
+
+void CServer::SendServerInfoSixupConnless(const NETADDR *pAddr, int Token, SECURITY_TOKEN ResponseToken)
+{
+	const bool SendClients = RateLimitServerInfoConnless();
+	if(!SendClients)
+		m_ServerInfoStats.m_Limited++;
+	m_ServerInfoStats.m_Served++;
+
+	// same as `GetServerInfoSixup`
+	CPacker Prefix;
+	Prefix.Reset();
+	if(Token != -1)
+	{
+		Prefix.AddRaw(SERVERBROWSE_INFO, sizeof(SERVERBROWSE_INFO));
+		Prefix.AddInt(Token);
 	}
+
+	int PacketSize;
+	unsigned char *pPacket = m_aSixupServerInfoCache[SendClients && Token != -1].m_vCache.front().Prefix(Prefix.Data(), Prefix.Size(), &PacketSize);
+	if(m_NetServer.SendConnlessSixupInPlace(pAddr, pPacket, PacketSize, ResponseToken) == 0)
+		m_ServerInfoStats.m_Cached++;
+	else
+		m_ServerInfoStats.m_Dropped++;
 }
 
 void CServer::GetServerInfoSixup(CPacker *pPacker, int Token, bool SendClients)
@@ -2323,8 +2358,8 @@ void CServer::GetServerInfoSixup(CPacker *pPacker, int Token, bool SendClients)
 
 	SendClients = SendClients && Token != -1;
 
-	CCache::CCacheChunk &FirstChunk = m_aSixupServerInfoCache[SendClients].m_vCache.front();
-	pPacker->AddRaw(FirstChunk.m_vData.data(), FirstChunk.m_vData.size());
+	const CCache::CCacheChunk &FirstChunk = m_aSixupServerInfoCache[SendClients].m_vCache.front();
+	pPacker->AddRaw(FirstChunk.Data(), FirstChunk.Size());
 }
 
 void CServer::FillAntibot(CAntibotRoundData *pData)
@@ -2508,19 +2543,11 @@ void CServer::PumpNetwork(bool PacketWaiting)
 						int SrvBrwsToken = Unpacker.GetInt();
 						if(Unpacker.Error())
 						{
+							m_ServerInfoStats.m_Dropped++;
 							continue;
 						}
 
-						CPacker Packer;
-						GetServerInfoSixup(&Packer, SrvBrwsToken, RateLimitServerInfoConnless());
-
-						CNetChunk Response;
-						Response.m_ClientID = -1;
-						Response.m_Address = Packet.m_Address;
-						Response.m_Flags = NETSENDFLAG_CONNLESS;
-						Response.m_pData = Packer.Data();
-						Response.m_DataSize = Packer.Size();
-						m_NetServer.SendConnlessSixup(&Response, ResponseToken);
+						SendServerInfoSixupConnless(&Packet.m_Address, SrvBrwsToken, ResponseToken);
 					}
 					else if(Type != -1)
 					{
@@ -2587,6 +2614,142 @@ void CServer::ChangeMap(const char *pMap)
 	m_MapReload = str_comp(Config()->m_SvMap, m_aCurrentMap) != 0;
 }
 
+// Loads the map, hashes it and reads it into memory for download. Runs as a
+// job when preloading, the map change then only has to take over the result.
+class CMapPreload : public IJob
+{
+	IStorage *m_pStorage;
+
+	// Identifies the file a map was read from, to notice when it was
+	// replaced between preloading and the map change.
+	struct CFileStamp
+	{
+		char m_aPath[IO_MAX_PATH_LENGTH] = "";
+		long m_Size = -1;
+		time_t m_Modified = 0;
+
+		bool operator==(const CFileStamp &Other) const
+		{
+			return !str_comp(m_aPath, Other.m_aPath) && m_Size == Other.m_Size && m_Modified == Other.m_Modified;
+		}
+	};
+	CFileStamp m_aStamp[CServer::NUM_MAP_TYPES];
+
+	CFileStamp Stamp(const char *pPath) const
+	{
+		CFileStamp Result;
+		IOHANDLE File = m_pStorage->OpenFile(pPath, IOFLAG_READ, IStorage::TYPE_ALL, Result.m_aPath, sizeof(Result.m_aPath));
+		if(!File)
+			return Result;
+		Result.m_Size = io_length(File);
+		io_close(File);
+		time_t Created;
+		fs_file_time(Result.m_aPath, &Created, &Result.m_Modified);
+		return Result;
+	}
+
+	void SixupPath(char *pBuf, int BufSize) const
+	{
+		str_format(pBuf, BufSize, "maps7/%s.map", m_aMap);
+	}
+
+	void Run() override
+	{
+		// taken before reading, so changes while loading are noticed as well
+		m_aStamp[CServer::MAP_TYPE_SIX] = Stamp(m_aPath);
+		if(!m_pMap->Load(m_pStorage, m_aPath))
+			return;
+		m_aSha256[CServer::MAP_TYPE_SIX] = m_pMap->Sha256();
+		m_aCrc[CServer::MAP_TYPE_SIX] = m_pMap->Crc();
+		void *pData;
+		if(m_pStorage->ReadFile(m_aPath, IStorage::TYPE_ALL, &pData, &m_aSize[CServer::MAP_TYPE_SIX]))
+			m_apData[CServer::MAP_TYPE_SIX] = (unsigned char *)pData;
+
+		if(m_Sixup)
+		{
+			char aPath[IO_MAX_PATH_LENGTH];
+			SixupPath(aPath, sizeof(aPath));
+			m_aStamp[CServer::MAP_TYPE_SIXUP] = Stamp(aPath);
+			if(m_pStorage->ReadFile(aPath, IStorage::TYPE_ALL, &pData, &m_aSize[CServer::MAP_TYPE_SIXUP]))
+			{
+				m_apData[CServer::MAP_TYPE_SIXUP] = (unsigned char *)pData;
+				m_aSha256[CServer::MAP_TYPE_SIXUP] = sha256(pData, m_aSize[CServer::MAP_TYPE_SIXUP]);
+				m_aCrc[CServer::MAP_TYPE_SIXUP] = crc32(0, (unsigned char *)pData, m_aSize[CServer::MAP_TYPE_SIXUP]);
+			}
+		}
+		m_Success = true;
+	}
+
+public:
+	char m_aMap[IO_MAX_PATH_LENGTH];
+	char m_aPath[IO_MAX_PATH_LENGTH];
+	bool m_Sixup;
+
+	bool m_Success = false;
+	IEngineMap *m_pMap;
+	SHA256_DIGEST m_aSha256[CServer::NUM_MAP_TYPES];
+	unsigned m_aCrc[CServer::NUM_MAP_TYPES] = {0};
+	unsigned char *m_apData[CServer::NUM_MAP_TYPES] = {nullptr};
+	unsigned int m_aSize[CServer::NUM_MAP_TYPES] = {0};
+
+	CMapPreload(IStorage *pStorage, const char *pMap, const char *pPath, bool Sixup) :
+		m_pStorage(pStorage), m_Sixup(Sixup), m_pMap(CreateEngineMap())
+	{
+		str_copy(m_aMap, pMap);
+		str_copy(m_aPath, pPath);
+	}
+
+	~CMapPreload()
+	{
+		delete m_pMap;
+		for(auto *pData : m_apData)
+			free(pData);
+	}
+
+	bool Matches(const char *pMap, const char *pPath, bool Sixup)
+	{
+		if(Status() != IJob::STATE_DONE || !m_Success || str_comp(m_aMap, pMap) || str_comp(m_aPath, pPath) || m_Sixup != Sixup)
+			return false;
+		if(!(Stamp(m_aPath) == m_aStamp[CServer::MAP_TYPE_SIX]))
+			return false;
+		if(m_Sixup)
+		{
+			char aPath[IO_MAX_PATH_LENGTH];
+			SixupPath(aPath, sizeof(aPath));
+			if(!(Stamp(aPath) == m_aStamp[CServer::MAP_TYPE_SIXUP]))
+				return false;
+		}
+		return true;
+	}
+
+	unsigned char *TakeData(int MapType)
+	{
+		unsigned char *pData = m_apData[MapType];
+		m_apData[MapType] = nullptr;
+		return pData;
+	}
+};
+
+void CServer::PreloadMap(const char *pMap)
+{
+	if(!str_comp(pMap, m_aCurrentMap) || (m_pMapPreload && !str_comp(m_pMapPreload->m_aMap, pMap)))
+		return;
+
+	char aPath[IO_MAX_PATH_LENGTH];
+	str_format(aPath, sizeof(aPath), "maps/%s.map", pMap);
+	// a still running preload of another map finishes in the job pool and is
+	// freed afterwards
+	m_pMapPreload = std::make_shared<CMapPreload>(Storage(), pMap, aPath, Config()->m_SvSixup);
+	Kernel()->RequestInterface<IEngine>()->AddJob(m_pMapPreload);
+}
+
+void CServer::CancelMapPreload()
+{
+	if(m_pMapPreload && m_MapReload && !str_comp(Config()->m_SvMap, m_pMapPreload->m_aMap))
+		return;
+	m_pMapPreload = nullptr;
+}
+
 int CServer::LoadMap(const char *pMapName)
 {
 	m_MapReload = false;
@@ -2595,37 +2758,43 @@ int CServer::LoadMap(const char *pMapName)
 	str_format(aBuf, sizeof(aBuf), "maps/%s.map", pMapName);
 	GameServer()->OnMapChange(aBuf, sizeof(aBuf));
 
-	if(!m_pMap->Load(aBuf))
+	// maps with settings from a .cfg file are rewritten to a temporary file by
+	// `OnMapChange`, so they never match a preloaded map
+	std::shared_ptr<CMapPreload> pPreload = std::move(m_pMapPreload);
+	const bool Preloaded = pPreload && pPreload->Matches(pMapName, aBuf, Config()->m_SvSixup);
+	if(!Preloaded)
+	{
+		pPreload = std::make_shared<CMapPreload>(Storage(), pMapName, aBuf, Config()->m_SvSixup);
+		IEngine::RunJobBlocking(pPreload.get());
+	}
+	if(!pPreload->m_Success)
 		return 0;
+	m_pMap->LoadFrom(pPreload->m_pMap);
 
 	// reinit snapshot ids
 	m_IDPool.TimeoutIDs();
 
 	// get the crc of the map
-	m_aCurrentMapSha256[MAP_TYPE_SIX] = m_pMap->Sha256();
-	m_aCurrentMapCrc[MAP_TYPE_SIX] = m_pMap->Crc();
+	m_aCurrentMapSha256[MAP_TYPE_SIX] = pPreload->m_aSha256[MAP_TYPE_SIX];
+	m_aCurrentMapCrc[MAP_TYPE_SIX] = pPreload->m_aCrc[MAP_TYPE_SIX];
 	char aBufMsg[256];
 	char aSha256[SHA256_MAXSTRSIZE];
 	sha256_str(m_aCurrentMapSha256[MAP_TYPE_SIX], aSha256, sizeof(aSha256));
-	str_format(aBufMsg, sizeof(aBufMsg), "%s sha256 is %s", aBuf, aSha256);
+	str_format(aBufMsg, sizeof(aBufMsg), "%s sha256 is %s%s", aBuf, aSha256, Preloaded ? " (preloaded)" : "");
 	Console()->Print(IConsole::OUTPUT_LEVEL_ADDINFO, "server", aBufMsg);
 
 	str_copy(m_aCurrentMap, pMapName);
 
-	// load complete map into memory for download
-	{
-		free(m_apCurrentMapData[MAP_TYPE_SIX]);
-		void *pData;
-		Storage()->ReadFile(aBuf, IStorage::TYPE_ALL, &pData, &m_aCurrentMapSize[MAP_TYPE_SIX]);
-		m_apCurrentMapData[MAP_TYPE_SIX] = (unsigned char *)pData;
-	}
+	// complete map in memory for download
+	free(m_apCurrentMapData[MAP_TYPE_SIX]);
+	m_apCurrentMapData[MAP_TYPE_SIX] = pPreload->TakeData(MAP_TYPE_SIX);
+	m_aCurrentMapSize[MAP_TYPE_SIX] = pPreload->m_aSize[MAP_TYPE_SIX];
 
-	// load sixup version of the map
+	// sixup version of the map
 	if(Config()->m_SvSixup)
 	{
 		str_format(aBuf, sizeof(aBuf), "maps7/%s.map", pMapName);
-		void *pData;
-		if(!Storage()->ReadFile(aBuf, IStorage::TYPE_ALL, &pData, &m_aCurrentMapSize[MAP_TYPE_SIXUP]))
+		if(!pPreload->m_apData[MAP_TYPE_SIXUP])
 		{
 			Config()->m_SvSixup = 0;
 			if(m_pRegister)
@@ -2639,10 +2808,11 @@ int CServer::LoadMap(const char *pMapName)
 		else
 		{
 			free(m_apCurrentMapData[MAP_TYPE_SIXUP]);
-			m_apCurrentMapData[MAP_TYPE_SIXUP] = (unsigned char *)pData;
+			m_apCurrentMapData[MAP_TYPE_SIXUP] = pPreload->TakeData(MAP_TYPE_SIXUP);
+			m_aCurrentMapSize[MAP_TYPE_SIXUP] = pPreload->m_aSize[MAP_TYPE_SIXUP];
 
-			m_aCurrentMapSha256[MAP_TYPE_SIXUP] = sha256(m_apCurrentMapData[MAP_TYPE_SIXUP], m_aCurrentMapSize[MAP_TYPE_SIXUP]);
-			m_aCurrentMapCrc[MAP_TYPE_SIXUP] = crc32(0, m_apCurrentMapData[MAP_TYPE_SIXUP], m_aCurrentMapSize[MAP_TYPE_SIXUP]);
+			m_aCurrentMapSha256[MAP_TYPE_SIXUP] = pPreload->m_aSha256[MAP_TYPE_SIXUP];
+			m_aCurrentMapCrc[MAP_TYPE_SIXUP] = pPreload->m_aCrc[MAP_TYPE_SIXUP];
 			sha256_str(m_aCurrentMapSha256[MAP_TYPE_SIXUP], aSha256, sizeof(aSha256));
 			str_format(aBufMsg, sizeof(aBufMsg), "%s sha256 is %s", aBuf, aSha256);
 			Console()->Print(IConsole::OUTPUT_LEVEL_ADDINFO, "sixup", aBufMsg);
@@ -2831,6 +3001,7 @@ int CServer::Run()
 			// load new map
 			if(m_MapReload || m_CurrentGameTick >= MAX_TICK) // force reload to make sure the ticks stay within a valid range
 			{
+				const int64_t MapChangeStart = time_get();
 				// load map
 				if(LoadMap(Config()->m_SvMap))
 				{
@@ -2870,6 +3041,8 @@ int CServer::Run()
 						break;
 					}
 					UpdateServerInfo(true);
+					str_format(aBuf, sizeof(aBuf), "map change to '%s' took %.2fms", m_aCurrentMap, (time_get() - MapChangeStart) * 1000.0 / time_freq());
+					Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "server", aBuf);
 					for(int ClientID = 0; ClientID < MAX_CLIENTS; ClientID++)
 					{
 						if(m_aClients[ClientID].m_State != CClient::STATE_CONNECTING)
@@ -3192,6 +3365,15 @@ void CServer::AuthRemoveKey(int KeySlot)
 	}
 }
 
+void CServer::ConServerInfoStats(IConsole::IResult *pResult, void *pUser)
+{
+	CServer *pThis = static_cast<CServer *>(pUser);
+	const CServerInfoStats &Stats = pThis->m_ServerInfoStats;
+	char aBuf[256];
+	str_format(aBuf, sizeof(aBuf), "served=%" PRId64 " cached_packets=%" PRId64 " limited=%" PRId64 " dropped=%" PRId64, Stats.m_Served, Stats.m_Cached, Stats.m_Limited, Stats.m_Dropped);
+	pThis->Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "server", aBuf);
+}
+
 void CServer::ConAuthAdd(IConsole::IResult *pResult, void *pUser)
 {
 	CServer *pThis = (CServer *)pUser;
@@ -3827,6 +4009,8 @@ void CServer::RegisterCommands()
 	Console()->Register("logout", "", CFGFLAG_SERVER, ConLogout, this, "Logout of rcon");
 	Console()->Register("show_ips", "?i[show]", CFGFLAG_SERVER, ConShowIps, this, "Show IP addresses in rcon commands (1 = on, 0 = off)");
 
+	Console()->Register("server_info_stats", "", CFGFLAG_SERVER, ConServerInfoStats, this, "Show counters of answered server info requests");
+
 	Console()->Register("record", "?s[file]", CFGFLAG_SERVER | CFGFLAG_STORE, ConRecord, this, "Record to a file");
 	Console()->Register("stoprecord", "", CFGFLAG_SERVER, ConStopRecord, this, "Stop recording");
 
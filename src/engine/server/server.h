@@ -11,6 +11,7 @@
 #include <engine/shared/demo.h>
 #include <engine/shared/econ.h>
 #include <engine/shared/fifo.h>
+#include <engine/shared/masterserver.h>
 #include <engine/shared/netban.h>
 #include <engine/shared/network.h>
 #include <engine/shared/protocol.h>
@@ -33,6 +34,7 @@
 class CConfig;
 class CHostLookup;
 class CLogMessage;
+class CMapPreload;
 class CMsgPacker;
 class CPacker;
 class IEngineMap;
@@ -102,6 +104,7 @@ public:
 class CServer : public IServer
 {
 	friend class CServerLogger;
+	friend class CServerBench;
 
 	class IGameServer *m_pGameServer;
 	class CConfig *m_pConfig;
@@ -274,6 +277,7 @@ public:
 	unsigned m_aCurrentMapCrc[NUM_MAP_TYPES];
 	unsigned char *m_apCurrentMapData[NUM_MAP_TYPES];
 	unsigned int m_aCurrentMapSize[NUM_MAP_TYPES];
+	std::shared_ptr<CMapPreload> m_pMapPreload;
 
 	CDemoRecorder m_aDemoRecorder[MAX_CLIENTS + 1];
 	CAuthManager m_AuthManager;
@@ -281,6 +285,16 @@ public:
 	int64_t m_ServerInfoFirstRequest;
 	int m_ServerInfoNumRequests;
 
+	// connless server info requests
+	struct CServerInfoStats
+	{
+		int64_t m_Served = 0; // requests answered
+		int64_t m_Cached = 0; // packets sent straight from the packet cache
+		int64_t m_Limited = 0; // answered without players by sv_server_info_per_second
+		int64_t m_Dropped = 0; // malformed requests and replies that failed to send
+	};
+	CServerInfoStats m_ServerInfoStats;
+
 	char m_aErrorShutdownReason[128];
 
 	CNameBans m_NameBans;
@@ -367,13 +381,27 @@ public:
 	class CCache
 	{
 	public:
+		// A chunk is stored as a complete packet with room in front of the
+		// data for the packet header, the info marker and the token, so a
+		// reply only needs to write those and can be sent without copying.
 		class CCacheChunk
 		{
 		public:
+			enum
+			{
+				PREFIX_SPACE = NET_CONNLESS_HEADER_SPACE + SERVERBROWSE_SIZE + 12,
+			};
+
 			CCacheChunk(const void *pData, int Size);
 			CCacheChunk(const CCacheChunk &) = delete;
 			CCacheChunk(CCacheChunk &&) = default;
 
+			const uint8_t *Data() const { return m_vData.data() + PREFIX_SPACE; }
+			int Size() const { return m_vData.size() - PREFIX_SPACE; }
+			// writes the prefix in front of the data and returns the start of the packet payload
+			unsigned char *Prefix(const void *pPrefix, int PrefixSize, int *pPacketSize);
+
+		private:
 			std::vector<uint8_t> m_vData;
 		};
 
@@ -394,16 +422,20 @@ public:
 	void ExpireServerInfo() override;
 	void CacheServerInfo(CCache *pCache, int Type, bool SendClients);
 	void CacheServerInfoSixup(CCache *pCache, bool SendClients);
-	void SendServerInfo(const NETADDR *pAddr, int Token, int Type, bool SendClients);
+	// `pStats` is only passed for replies to connless requests
+	void SendServerInfo(const NETADDR *pAddr, int Token, int Type, bool SendClients, CServerInfoStats *pStats = nullptr);
 	void GetServerInfoSixup(CPacker *pPacker, int Token, bool SendClients);
 	bool RateLimitServerInfoConnless();
 	void SendServerInfoConnless(const NETADDR *pAddr, int Token, int Type);
+	void SendServerInfoSixupConnless(const NETADDR *pAddr, int Token, SECURITY_TOKEN ResponseToken);
 	void UpdateRegisterServerInfo();
 	void UpdateServerInfo(bool Resend = false);
 
 	void PumpNetwork(bool PacketWaiting);
 
 	void ChangeMap(const char *pMap) override;
+	void PreloadMap(const char *pMap) override;
+	void CancelMapPreload() override;
 	const char *GetMapName() const override;
 	int LoadMap(const char *pMapName);
 
@@ -423,6 +455,7 @@ public:
 	static void ConMapReload(IConsole::IResult *pResult, void *pUser);
 	static void ConLogout(IConsole::IResult *pResult, void *pUser);
 	static void ConShowIps(IConsole::IResult *pResult, void *pUser);
+	static void ConServerInfoStats(IConsole::IResult *pResult, void *pUser);
 
 	static void ConAuthAdd(IConsole::IResult *pResult, void *pUser);
 	static void ConAuthAddHashed(IConsole::IResult *pResult, void *pUser);
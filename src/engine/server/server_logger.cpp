@@ -4,6 +4,7 @@
 
 CServerLogger::CServerLogger(CServer *pServer) :
 	m_pServer(pServer),
+	m_Pending(512),
 	m_MainThread(std::this_thread::get_id())
 {
 	dbg_assert(pServer != nullptr, "server pointer must not be null");
@@ -15,28 +16,26 @@ void CServerLogger::Log(const CLogMessage *pMessage)
 	{
 		return;
 	}
-	m_PendingLock.lock();
 	if(m_MainThread == std::this_thread::get_id())
 	{
-		if(!m_vPending.empty())
-		{
+		const auto SendPending = [this](const CLogMessage *pPending) {
 			if(m_pServer)
-			{
-				for(const auto &Message : m_vPending)
-				{
-					m_pServer->SendLogLine(&Message);
-				}
-			}
-			m_vPending.clear();
+				m_pServer->SendLogLine(pPending);
+		};
+		while(m_Pending.Pop(SendPending))
+		{
+		}
+		CLogMessage Dropped;
+		if(m_Pending.DroppedMessage(&Dropped))
+		{
+			SendPending(&Dropped);
 		}
-		m_PendingLock.unlock();
 		if(m_pServer)
 			m_pServer->SendLogLine(pMessage);
 	}
 	else
 	{
-		m_vPending.push_back(*pMessage);
-		m_PendingLock.unlock();
+		m_Pending.Push(pMessage);
 	}
 }
 
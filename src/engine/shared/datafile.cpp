@@ -710,10 +710,19 @@ int CDataFileWriter::AddData(size_t Size, const void *pData, int CompressionLeve
 	dbg_assert(Size > 0 && pData != nullptr, "Data missing");
 	dbg_assert(Size <= (size_t)std::numeric_limits<int>::max(), "Data too large");
 
+	void *pCopy = malloc(Size);
+	mem_copy(pCopy, pData, Size);
+	return AddDataOwned(Size, pCopy, CompressionLevel);
+}
+
+int CDataFileWriter::AddDataOwned(size_t Size, void *pData, int CompressionLevel)
+{
+	dbg_assert(Size > 0 && pData != nullptr, "Data missing");
+	dbg_assert(Size <= (size_t)std::numeric_limits<int>::max(), "Data too large");
+
 	m_vDatas.emplace_back();
 	CDataInfo &Info = m_vDatas.back();
-	Info.m_pUncompressedData = malloc(Size);
-	mem_copy(Info.m_pUncompressedData, pData, Size);
+	Info.m_pUncompressedData = pData;
 	Info.m_UncompressedSize = Size;
 	Info.m_pCompressedData = nullptr;
 	Info.m_CompressedSize = 0;
@@ -124,6 +124,9 @@ public:
 	bool Open(class IStorage *pStorage, const char *pFilename, int StorageType = IStorage::TYPE_SAVE);
 	int AddItem(int Type, int ID, size_t Size, const void *pData);
 	int AddData(size_t Size, const void *pData, int CompressionLevel = Z_DEFAULT_COMPRESSION);
+	// Takes ownership of the buffer allocated with malloc instead of copying it.
+	// It can still be modified until `Finish` is called.
+	int AddDataOwned(size_t Size, void *pData, int CompressionLevel = Z_DEFAULT_COMPRESSION);
 	int AddDataSwapped(size_t Size, const void *pData);
 	int AddDataString(const char *pStr);
 	void Finish();
@@ -2,6 +2,7 @@
 /* If you are missing that file, acquire a complete release at teeworlds.com.                */
 #include <base/math.h>
 #include <base/system.h>
+#include <base/tl/threading.h>
 
 #include <engine/console.h>
 #include <engine/storage.h>
@@ -31,7 +32,21 @@ static const int gs_NumMarkersOffset = 176;
 
 static const ColorRGBA gs_DemoPrintColor{0.75f, 0.7f, 0.7f, 1.0f};
 
-CDemoRecorder::CDemoRecorder(class CSnapshotDelta *pSnapshotDelta, bool NoMapData)
+class CDemoRecorder::CEncoderQueue
+{
+public:
+	SQueuedChunk m_aChunks[ENCODER_QUEUE_SIZE];
+	CSemaphore m_NumQueued;
+	CSemaphore m_NumFree;
+
+	CEncoderQueue()
+	{
+		for(int i = 0; i < ENCODER_QUEUE_SIZE; i++)
+			m_NumFree.Signal();
+	}
+};
+
+CDemoRecorder::CDemoRecorder(class CSnapshotDelta *pSnapshotDelta, bool NoMapData, bool Threaded)
 {
 	m_File = 0;
 	m_aCurrentFilename[0] = '\0';
@@ -40,13 +55,19 @@ CDemoRecorder::CDemoRecorder(class CSnapshotDelta *pSnapshotDelta, bool NoMapDat
 	m_LastTickMarker = -1;
 	m_pSnapshotDelta = pSnapshotDelta;
 	m_NoMapData = NoMapData;
+	m_Threaded = Threaded;
+	m_pEncoderThread = nullptr;
 }
 
+CDemoRecorder::CDemoRecorder() = default;
+
 CDemoRecorder::~CDemoRecorder()
 {
 	dbg_assert(m_File == 0, "Demo recorder was not stopped");
 }
 
+CDemoRecorder &CDemoRecorder::operator=(CDemoRecorder &&Other) = default;
+
 // Record
 int CDemoRecorder::Start(class IStorage *pStorage, class IConsole *pConsole, const char *pFilename, const char *pNetVersion, const char *pMap, const SHA256_DIGEST &Sha256, unsigned Crc, const char *pType, unsigned MapSize, unsigned char *pMapData, IOHANDLE MapFile, DEMOFUNC_FILTER pfnFilter, void *pUser)
 {
@@ -167,6 +188,7 @@ int CDemoRecorder::Start(class IStorage *pStorage, class IConsole *pConsole, con
 
 	m_LastKeyFrame = -1;
 	m_LastTickMarker = -1;
+	m_LastWrittenTickMarker = -1;
 	m_FirstTick = -1;
 	m_NumTimelineMarkers = 0;
 
@@ -179,6 +201,17 @@ int CDemoRecorder::Start(class IStorage *pStorage, class IConsole *pConsole, con
 	m_File = DemoFile;
 	str_copy(m_aCurrentFilename, pFilename);
 
+	if(m_Threaded)
+	{
+		m_pEncoderQueue = std::make_unique<CEncoderQueue>();
+		m_pEncoderSnapshotDelta = std::make_unique<CSnapshotDelta>(*m_pSnapshotDelta);
+		m_NumQueuedChunks = 0;
+		m_NumStalls = 0;
+		m_MaxQueueLength = 0;
+		m_StallTime = std::chrono::nanoseconds(0);
+		m_pEncoderThread = thread_init(EncoderThread, this, "demo encoder");
+	}
+
 	return 0;
 }
 
@@ -210,9 +243,64 @@ enum
 	CHUNKTYPE_DELTA = 3,
 };
 
+void CDemoRecorder::EncoderThread(void *pUser)
+{
+	CDemoRecorder *pSelf = (CDemoRecorder *)pUser;
+	CEncoderQueue *pQueue = pSelf->m_pEncoderQueue.get();
+	int Index = 0;
+	while(true)
+	{
+		pQueue->m_NumQueued.Wait();
+		const SQueuedChunk &Chunk = pQueue->m_aChunks[Index];
+		Index = (Index + 1) % ENCODER_QUEUE_SIZE;
+		if(Chunk.m_Type == QUEUED_STOP)
+			break;
+		else if(Chunk.m_Type == QUEUED_SNAPSHOT)
+		{
+			CSnapshotDelta *pSnapshotDelta = pSelf->m_pEncoderSnapshotDelta.get();
+			for(int i = 0; i < CSnapshotDelta::MAX_NETOBJSIZES; i++)
+				pSnapshotDelta->SetStaticsize(i, Chunk.m_aStaticsizes[i]);
+			pSelf->EncodeSnapshot(Chunk.m_Tick, Chunk.m_vData.data(), Chunk.m_vData.size(), pSnapshotDelta);
+		}
+		else
+			pSelf->Write(CHUNKTYPE_MESSAGE, Chunk.m_vData.data(), Chunk.m_vData.size());
+		pQueue->m_NumFree.Signal();
+	}
+}
+
+void CDemoRecorder::Enqueue(int Type, int Tick, const void *pData, int Size)
+{
+	CEncoderQueue *pQueue = m_pEncoderQueue.get();
+	if(pQueue->m_NumFree.GetApproximateValue() <= 0)
+	{
+		const std::chrono::nanoseconds StallStart = time_get_nanoseconds();
+		pQueue->m_NumFree.Wait();
+		m_StallTime += time_get_nanoseconds() - StallStart;
+		m_NumStalls++;
+	}
+	else
+	{
+		pQueue->m_NumFree.Wait();
+	}
+
+	// only the recording thread inserts, so the insert position follows from the count
+	SQueuedChunk &Chunk = pQueue->m_aChunks[m_NumQueuedChunks % ENCODER_QUEUE_SIZE];
+	Chunk.m_Type = Type;
+	Chunk.m_Tick = Tick;
+	Chunk.m_vData.assign((const unsigned char *)pData, (const unsigned char *)pData + Size);
+	if(Type == QUEUED_SNAPSHOT)
+	{
+		for(int i = 0; i < CSnapshotDelta::MAX_NETOBJSIZES; i++)
+			Chunk.m_aStaticsizes[i] = m_pSnapshotDelta->GetStaticsize(i);
+	}
+	m_NumQueuedChunks++;
+	pQueue->m_NumQueued.Signal();
+	m_MaxQueueLength = maximum(m_MaxQueueLength, pQueue->m_NumQueued.GetApproximateValue());
+}
+
 void CDemoRecorder::WriteTickMarker(int Tick, bool Keyframe)
 {
-	if(m_LastTickMarker == -1 || Tick - m_LastTickMarker > CHUNKMASK_TICK || Keyframe)
+	if(m_LastWrittenTickMarker == -1 || Tick - m_LastWrittenTickMarker > CHUNKMASK_TICK || Keyframe)
 	{
 		unsigned char aChunk[sizeof(int32_t) + 1];
 		aChunk[0] = CHUNKTYPEFLAG_TICKMARKER;
@@ -226,13 +314,11 @@ void CDemoRecorder::WriteTickMarker(int Tick, bool Keyframe)
 	else
 	{
 		unsigned char aChunk[1];
-		aChunk[0] = CHUNKTYPEFLAG_TICKMARKER | CHUNKTICKFLAG_TICK_COMPRESSED | (Tick - m_LastTickMarker);
+		aChunk[0] = CHUNKTYPEFLAG_TICKMARKER | CHUNKTICKFLAG_TICK_COMPRESSED | (Tick - m_LastWrittenTickMarker);
 		io_write(m_File, aChunk, sizeof(aChunk));
 	}
 
-	m_LastTickMarker = Tick;
-	if(m_FirstTick < 0)
-		m_FirstTick = Tick;
+	m_LastWrittenTickMarker = Tick;
 }
 
 void CDemoRecorder::Write(int Type, const void *pData, int Size)
@@ -286,6 +372,18 @@ void CDemoRecorder::Write(int Type, const void *pData, int Size)
 }
 
 void CDemoRecorder::RecordSnapshot(int Tick, const void *pData, int Size)
+{
+	m_LastTickMarker = Tick;
+	if(m_FirstTick < 0)
+		m_FirstTick = Tick;
+
+	if(m_pEncoderQueue)
+		Enqueue(QUEUED_SNAPSHOT, Tick, pData, Size);
+	else
+		EncodeSnapshot(Tick, pData, Size, m_pSnapshotDelta);
+}
+
+void CDemoRecorder::EncodeSnapshot(int Tick, const void *pData, int Size, CSnapshotDelta *pSnapshotDelta)
 {
 	if(m_LastKeyFrame == -1 || (Tick - m_LastKeyFrame) > SERVER_TICK_SPEED * 5)
 	{
@@ -305,7 +403,7 @@ void CDemoRecorder::RecordSnapshot(int Tick, const void *pData, int Size)
 
 		// create delta
 		char aDeltaData[CSnapshot::MAX_SIZE + sizeof(int)];
-		const int DeltaSize = m_pSnapshotDelta->CreateDelta((CSnapshot *)m_aLastSnapshotData, (CSnapshot *)pData, &aDeltaData);
+		const int DeltaSize = pSnapshotDelta->CreateDelta((CSnapshot *)m_aLastSnapshotData, (CSnapshot *)pData, &aDeltaData);
 		if(DeltaSize)
 		{
 			// record delta
@@ -324,7 +422,10 @@ void CDemoRecorder::RecordMessage(const void *pData, int Size)
 			return;
 		}
 	}
-	Write(CHUNKTYPE_MESSAGE, pData, Size);
+	if(m_pEncoderQueue)
+		Enqueue(QUEUED_MESSAGE, -1, pData, Size);
+	else
+		Write(CHUNKTYPE_MESSAGE, pData, Size);
 }
 
 int CDemoRecorder::Stop()
@@ -332,6 +433,24 @@ int CDemoRecorder::Stop()
 	if(!m_File)
 		return -1;
 
+	if(m_pEncoderQueue)
+	{
+		// let the encoder write everything that is still queued
+		Enqueue(QUEUED_STOP, -1, nullptr, 0);
+		thread_wait(m_pEncoderThread);
+		m_pEncoderThread = nullptr;
+		m_pEncoderQueue = nullptr;
+		m_pEncoderSnapshotDelta = nullptr;
+
+		if(m_pConsole && m_NumStalls > 0)
+		{
+			char aBuf[256];
+			str_format(aBuf, sizeof(aBuf), "Encoder fell behind %d times while recording %d chunks, waited %.2fms in total, at most %d chunks queued",
+				m_NumStalls, m_NumQueuedChunks - 1, m_StallTime.count() / 1000000.0, m_MaxQueueLength);
+			m_pConsole->Print(IConsole::OUTPUT_LEVEL_STANDARD, "demo_recorder", aBuf, gs_DemoPrintColor);
+		}
+	}
+
 	// add the demo length to the header
 	io_seek(m_File, gs_LengthOffset, IOSEEK_START);
 	unsigned char aLength[sizeof(int32_t)];
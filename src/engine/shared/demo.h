@@ -8,7 +8,9 @@
 #include <engine/demo.h>
 #include <engine/shared/protocol.h>
 
+#include <chrono>
 #include <functional>
+#include <memory>
 #include <vector>
 
 #include "snapshot.h"
@@ -33,14 +35,59 @@ class CDemoRecorder : public IDemoRecorder
 	DEMOFUNC_FILTER m_pfnFilter;
 	void *m_pUser;
 
+	// Snapshots and messages are compressed and written on a background
+	// thread if the recorder is threaded. The queue between the threads is
+	// bounded: if the encoder falls behind, the recording thread waits for
+	// a free slot instead of dropping chunks, so the demo is the same as one
+	// recorded without a thread.
+	enum
+	{
+		ENCODER_QUEUE_SIZE = 128,
+	};
+	enum
+	{
+		QUEUED_SNAPSHOT,
+		QUEUED_MESSAGE,
+		QUEUED_STOP,
+	};
+	struct SQueuedChunk
+	{
+		int m_Type;
+		int m_Tick;
+		std::vector<unsigned char> m_vData;
+		// static item sizes of the delta when the snapshot was recorded, the
+		// server changes them between the snapshots of its clients
+		short m_aStaticsizes[CSnapshotDelta::MAX_NETOBJSIZES];
+	};
+	class CEncoderQueue;
+	bool m_Threaded;
+	std::unique_ptr<CEncoderQueue> m_pEncoderQueue;
+	// own copy of the delta for the encoder, the one passed to the
+	// constructor is shared with the recording thread
+	std::unique_ptr<CSnapshotDelta> m_pEncoderSnapshotDelta;
+	void *m_pEncoderThread;
+	// last tick marker written to the file, only used by the encoder
+	int m_LastWrittenTickMarker;
+
+	// statistics of the encoder queue, reported when stopping
+	int m_NumQueuedChunks;
+	int m_NumStalls;
+	int m_MaxQueueLength;
+	std::chrono::nanoseconds m_StallTime;
+
+	static void EncoderThread(void *pUser);
+	void Enqueue(int Type, int Tick, const void *pData, int Size);
+	void EncodeSnapshot(int Tick, const void *pData, int Size, CSnapshotDelta *pSnapshotDelta);
 	void WriteTickMarker(int Tick, bool Keyframe);
 	void Write(int Type, const void *pData, int Size);
 
 public:
-	CDemoRecorder(class CSnapshotDelta *pSnapshotDelta, bool NoMapData = false);
-	CDemoRecorder() {}
+	CDemoRecorder(class CSnapshotDelta *pSnapshotDelta, bool NoMapData = false, bool Threaded = false);
+	CDemoRecorder();
 	~CDemoRecorder() override;
 
+	CDemoRecorder &operator=(CDemoRecorder &&Other);
+
 	int Start(class IStorage *pStorage, class IConsole *pConsole, const char *pFilename, const char *pNetversion, const char *pMap, const SHA256_DIGEST &Sha256, unsigned MapCrc, const char *pType, unsigned MapSize, unsigned char *pMapData, IOHANDLE MapFile = nullptr, DEMOFUNC_FILTER pfnFilter = nullptr, void *pUser = nullptr);
 	int Stop() override;
 
@@ -1,5 +1,6 @@
 #include "http.h"
 
+#include <base/lock.h>
 #include <base/log.h>
 #include <base/math.h>
 #include <base/system.h>
@@ -12,6 +13,10 @@
 #include <csignal>
 #endif
 
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
 #define WIN32_LEAN_AND_MEAN
 #include <curl/curl.h>
 
@@ -71,8 +76,221 @@ int CurlDebug(CURL *pHandle, curl_infotype Type, char *pData, size_t DataSize, v
 	return 0;
 }
 
+// All transfers are driven by a single thread using one curl multi handle,
+// so connections are kept alive and reused across requests and no job pool
+// thread has to block on network I/O.
+class CHttpRunner
+{
+	enum
+	{
+		MAX_RUNNING = 16,
+		NUM_PRIORITIES = (int)HTTPPRIORITY::HIGH + 1,
+	};
+
+	void *m_pThread = nullptr;
+	std::atomic<bool> m_Shutdown{false};
+
+	CLock m_Lock;
+	CURLM *m_pMultiH GUARDED_BY(m_Lock) = nullptr;
+	std::deque<CHttpRequest *> m_apPending[NUM_PRIORITIES] GUARDED_BY(m_Lock);
+	// only accessed by the HTTP thread
+	std::unordered_map<CURL *, CHttpRequest *> m_RunningRequests;
+
+	static void ThreadMain(void *pUser) NO_THREAD_SAFETY_ANALYSIS;
+	void StartPending() REQUIRES(!m_Lock);
+	void AbortAll() REQUIRES(!m_Lock);
+
+public:
+	bool Init() REQUIRES(!m_Lock);
+	void Shutdown() REQUIRES(!m_Lock);
+	void Submit(CHttpRequest *pRequest) REQUIRES(!m_Lock);
+	void Wakeup() REQUIRES(!m_Lock);
+};
+
+static CHttpRunner gs_Runner;
+
+bool CHttpRunner::Init()
+{
+	CURLM *pMultiH = curl_multi_init();
+	if(!pMultiH)
+	{
+		return true;
+	}
+	{
+		CLockScope ls(m_Lock);
+		m_pMultiH = pMultiH;
+	}
+	m_pThread = thread_init(ThreadMain, this, "http");
+	return !m_pThread;
+}
+
+void CHttpRunner::Shutdown()
+{
+	if(!m_pThread)
+	{
+		return;
+	}
+	m_Shutdown = true;
+	Wakeup();
+	thread_wait(m_pThread);
+	m_pThread = nullptr;
+
+	AbortAll();
+
+	CURLM *pMultiH;
+	{
+		CLockScope ls(m_Lock);
+		pMultiH = m_pMultiH;
+		m_pMultiH = nullptr;
+	}
+	curl_multi_cleanup(pMultiH);
+}
+
+void CHttpRunner::Submit(CHttpRequest *pRequest)
+{
+	{
+		CLockScope ls(m_Lock);
+		if(!m_Shutdown)
+		{
+			m_apPending[(int)pRequest->m_Priority].push_back(pRequest);
+			pRequest = nullptr;
+		}
+	}
+	if(pRequest)
+	{
+		str_copy(pRequest->m_aErr, "http is shut down");
+		pRequest->OnTransferDone(CURLE_ABORTED_BY_CALLBACK);
+		return;
+	}
+	Wakeup();
+}
+
+void CHttpRunner::Wakeup()
+{
+	CLockScope ls(m_Lock);
+	if(m_pMultiH)
+	{
+		curl_multi_wakeup(m_pMultiH);
+	}
+}
+
+void CHttpRunner::AbortAll()
+{
+	// the HTTP thread has stopped, so the running requests can be touched
+	CURLM *pMultiH;
+	{
+		CLockScope ls(m_Lock);
+		pMultiH = m_pMultiH;
+	}
+	for(auto &[pHandle, pRequest] : m_RunningRequests)
+	{
+		curl_multi_remove_handle(pMultiH, pHandle);
+		str_copy(pRequest->m_aErr, "http is shut down");
+		pRequest->OnTransferDone(CURLE_ABORTED_BY_CALLBACK);
+	}
+	m_RunningRequests.clear();
+
+	std::vector<CHttpRequest *> vpPending;
+	{
+		CLockScope ls(m_Lock);
+		for(auto &vpQueue : m_apPending)
+		{
+			vpPending.insert(vpPending.end(), vpQueue.begin(), vpQueue.end());
+			vpQueue.clear();
+		}
+	}
+	for(CHttpRequest *pRequest : vpPending)
+	{
+		str_copy(pRequest->m_aErr, "http is shut down");
+		pRequest->OnTransferDone(CURLE_ABORTED_BY_CALLBACK);
+	}
+}
+
+void CHttpRunner::StartPending()
+{
+	// requests must not be resumed while holding the lock
+	std::vector<std::pair<CHttpRequest *, CURLcode>> vFailed;
+	{
+		CLockScope ls(m_Lock);
+		for(auto &vpPending : m_apPending)
+		{
+			for(auto It = vpPending.begin(); It != vpPending.end();)
+			{
+				if((*It)->m_Abort)
+				{
+					str_copy((*It)->m_aErr, "aborted before the transfer started");
+					vFailed.emplace_back(*It, CURLE_ABORTED_BY_CALLBACK);
+					It = vpPending.erase(It);
+				}
+				else
+				{
+					++It;
+				}
+			}
+		}
+		for(int Priority = NUM_PRIORITIES - 1; Priority >= 0; Priority--)
+		{
+			std::deque<CHttpRequest *> &vpPending = m_apPending[Priority];
+			while(!vpPending.empty() && (int)m_RunningRequests.size() < MAX_RUNNING)
+			{
+				CHttpRequest *pRequest = vpPending.front();
+				vpPending.pop_front();
+				CURL *pHandle = (CURL *)pRequest->m_pHandle;
+				CURLMcode Error = curl_multi_add_handle(m_pMultiH, pHandle);
+				if(Error != CURLM_OK)
+				{
+					str_copy(pRequest->m_aErr, curl_multi_strerror(Error));
+					vFailed.emplace_back(pRequest, CURLE_FAILED_INIT);
+					continue;
+				}
+				m_RunningRequests[pHandle] = pRequest;
+			}
+		}
+	}
+	for(auto &[pRequest, Result] : vFailed)
+	{
+		pRequest->OnTransferDone(Result);
+	}
+}
+
+void CHttpRunner::ThreadMain(void *pUser)
+{
+	// `m_pMultiH` is only reset after this thread stopped
+	CHttpRunner *pSelf = (CHttpRunner *)pUser;
+	while(!pSelf->m_Shutdown)
+	{
+		pSelf->StartPending();
+
+		int NumRunning;
+		curl_multi_perform(pSelf->m_pMultiH, &NumRunning);
+
+		int NumMessages;
+		while(CURLMsg *pMsg = curl_multi_info_read(pSelf->m_pMultiH, &NumMessages))
+		{
+			if(pMsg->msg != CURLMSG_DONE)
+				continue;
+			// `pMsg` is invalidated by removing the handle
+			CURL *pHandle = pMsg->easy_handle;
+			CURLcode Result = pMsg->data.result;
+			auto It = pSelf->m_RunningRequests.find(pHandle);
+			dbg_assert(It != pSelf->m_RunningRequests.end(), "finished unknown http transfer");
+			CHttpRequest *pRequest = It->second;
+			pSelf->m_RunningRequests.erase(It);
+			curl_multi_remove_handle(pSelf->m_pMultiH, pHandle);
+			pRequest->OnTransferDone(Result);
+		}
+
+		// woken up early by new or aborted requests
+		curl_multi_poll(pSelf->m_pMultiH, nullptr, 0, 1000, nullptr);
+	}
+}
+
 bool HttpInit(IStorage *pStorage)
 {
+	if(gs_Initialized)
+	{
+		return false;
+	}
 	if(curl_global_init(CURL_GLOBAL_DEFAULT))
 	{
 		return true;
@@ -100,11 +318,25 @@ bool HttpInit(IStorage *pStorage)
 	signal(SIGPIPE, SIG_IGN);
 #endif
 
+	if(gs_Runner.Init())
+	{
+		return true;
+	}
+
 	gs_Initialized = true;
 
 	return false;
 }
 
+void HttpShutdown()
+{
+	if(!gs_Initialized)
+	{
+		return;
+	}
+	gs_Runner.Shutdown();
+}
+
 void EscapeUrl(char *pBuf, int Size, const char *pStr)
 {
 	char *pEsc = curl_easy_escape(0, pStr, 0);
@@ -146,20 +378,65 @@ CHttpRequest::~CHttpRequest()
 
 void CHttpRequest::Run()
 {
+	if(m_TransferDone)
+	{
+		// resumed by the HTTP thread
+		m_State = OnCompletion(m_TransferState);
+		return;
+	}
+
 	dbg_assert(gs_Initialized, "must initialize HTTP before running HTTP requests");
-	int FinalState;
 	if(!BeforeInit())
 	{
-		FinalState = HTTP_ERROR;
+		m_State = OnCompletion(HTTP_ERROR);
+		return;
 	}
-	else
+	CURL *pHandle = curl_easy_init();
+	if(!ConfigureHandle(pHandle))
 	{
-		CURL *pHandle = curl_easy_init();
-		FinalState = RunImpl(pHandle);
 		curl_easy_cleanup(pHandle);
+		m_State = OnCompletion(HTTP_ERROR);
+		return;
 	}
+	if(g_Config.m_DbgCurl || m_LogProgress >= HTTPLOG::ALL)
+		dbg_msg("http", "fetching %s", m_aUrl);
+	m_State = HTTP_RUNNING;
+	m_pHandle = pHandle;
+	// the HTTP thread does the transfer, so the job thread isn't blocked
+	// for its duration
+	Defer();
+	gs_Runner.Submit(this);
+}
 
-	m_State = OnCompletion(FinalState);
+void CHttpRequest::OnTransferDone(int Result)
+{
+	if(Result != CURLE_OK)
+	{
+		if(g_Config.m_DbgCurl || m_LogProgress >= HTTPLOG::FAILURE)
+			dbg_msg("http", "%s failed. libcurl error (%d): %s", m_aUrl, Result, m_aErr);
+		m_TransferState = (Result == CURLE_ABORTED_BY_CALLBACK) ? HTTP_ABORTED : HTTP_ERROR;
+	}
+	else
+	{
+		if(g_Config.m_DbgCurl || m_LogProgress >= HTTPLOG::ALL)
+			dbg_msg("http", "task done %s", m_aUrl);
+		m_TransferState = HTTP_DONE;
+	}
+	curl_easy_cleanup((CURL *)m_pHandle);
+	m_pHandle = nullptr;
+
+	// `OnCompletion()` runs on a job thread, it may take a while
+	m_TransferDone = true;
+	Resume();
+}
+
+void CHttpRequest::Abort()
+{
+	m_Abort = true;
+	if(gs_Initialized)
+	{
+		gs_Runner.Wakeup();
+	}
 }
 
 bool CHttpRequest::BeforeInit()
@@ -182,12 +459,13 @@ bool CHttpRequest::BeforeInit()
 	return true;
 }
 
-int CHttpRequest::RunImpl(CURL *pUser)
+bool CHttpRequest::ConfigureHandle(void *pUser)
 {
+	static_assert(sizeof(m_aErr) >= CURL_ERROR_SIZE);
 	CURL *pHandle = (CURL *)pUser;
 	if(!pHandle)
 	{
-		return HTTP_ERROR;
+		return false;
 	}
 
 	if(g_Config.m_DbgCurl)
@@ -200,8 +478,8 @@ int CHttpRequest::RunImpl(CURL *pUser)
 	{
 		Protocols |= CURLPROTO_HTTP;
 	}
-	char aErr[CURL_ERROR_SIZE];
-	curl_easy_setopt(pHandle, CURLOPT_ERRORBUFFER, aErr);
+	m_aErr[0] = '\0';
+	curl_easy_setopt(pHandle, CURLOPT_ERRORBUFFER, m_aErr);
 
 	curl_easy_setopt(pHandle, CURLOPT_CONNECTTIMEOUT_MS, m_Timeout.ConnectTimeoutMs);
 	curl_easy_setopt(pHandle, CURLOPT_TIMEOUT_MS, m_Timeout.TimeoutMs);
@@ -285,23 +563,7 @@ int CHttpRequest::RunImpl(CURL *pUser)
 	}
 
 	curl_easy_setopt(pHandle, CURLOPT_HTTPHEADER, m_pHeaders);
-
-	if(g_Config.m_DbgCurl || m_LogProgress >= HTTPLOG::ALL)
-		dbg_msg("http", "fetching %s", m_aUrl);
-	m_State = HTTP_RUNNING;
-	int Ret = curl_easy_perform(pHandle);
-	if(Ret != CURLE_OK)
-	{
-		if(g_Config.m_DbgCurl || m_LogProgress >= HTTPLOG::FAILURE)
-			dbg_msg("http", "%s failed. libcurl error (%d): %s", m_aUrl, (int)Ret, aErr);
-		return (Ret == CURLE_ABORTED_BY_CALLBACK) ? HTTP_ABORTED : HTTP_ERROR;
-	}
-	else
-	{
-		if(g_Config.m_DbgCurl || m_LogProgress >= HTTPLOG::ALL)
-			dbg_msg("http", "task done %s", m_aUrl);
-		return HTTP_DONE;
-	}
+	return true;
 }
 
 size_t CHttpRequest::OnData(char *pData, size_t DataSize)
@@ -34,6 +34,15 @@ enum class IPRESOLVE
 	V6,
 };
 
+// Queued requests with a higher priority are started first when too many
+// transfers are running at once.
+enum class HTTPPRIORITY
+{
+	LOW,
+	NORMAL,
+	HIGH,
+};
+
 struct CTimeout
 {
 	long ConnectTimeoutMs;
@@ -44,6 +53,8 @@ struct CTimeout
 
 class CHttpRequest : public IJob
 {
+	friend class CHttpRunner;
+
 	enum class REQUEST
 	{
 		GET = 0,
@@ -83,13 +94,25 @@ class CHttpRequest : public IJob
 	HTTPLOG m_LogProgress = HTTPLOG::ALL;
 	IPRESOLVE m_IpResolve = IPRESOLVE::WHATEVER;
 
+	HTTPPRIORITY m_Priority = HTTPPRIORITY::NORMAL;
+
 	std::atomic<int> m_State{HTTP_QUEUED};
 	std::atomic<bool> m_Abort{false};
 
+	// Set up by `Run()`, the transfer itself is done by the HTTP thread,
+	// which then resumes the job in `OnTransferDone()`. `OnCompletion()`
+	// runs when the job runs again, so it doesn't hold up other transfers.
+	void *m_pHandle = nullptr;
+	char m_aErr[256]; // CURL_ERROR_SIZE
+	bool m_TransferDone = false;
+	int m_TransferState = HTTP_ERROR;
+
 	void Run() override;
+	// Resumes the job, the request may be freed once this returns.
+	void OnTransferDone(int Result);
 	// Abort the request with an error if `BeforeInit()` returns false.
 	bool BeforeInit();
-	int RunImpl(void *pUser);
+	bool ConfigureHandle(void *pUser);
 
 	// Abort the request if `OnData()` returns something other than
 	// `DataSize`.
@@ -110,6 +133,7 @@ public:
 	void MaxResponseSize(int64_t MaxResponseSize) { m_MaxResponseSize = MaxResponseSize; }
 	void LogProgress(HTTPLOG LogProgress) { m_LogProgress = LogProgress; }
 	void IpResolve(IPRESOLVE IpResolve) { m_IpResolve = IpResolve; }
+	void Priority(HTTPPRIORITY Priority) { m_Priority = Priority; }
 	void WriteToFile(IStorage *pStorage, const char *pDest, int StorageType);
 	void ExpectSha256(const SHA256_DIGEST &Sha256) { m_ExpectedSha256 = Sha256; }
 	void Head() { m_Type = REQUEST::HEAD; }
@@ -157,7 +181,7 @@ public:
 	double Size() const { return m_Size.load(std::memory_order_relaxed); }
 	int Progress() const { return m_Progress.load(std::memory_order_relaxed); }
 	int State() const { return m_State; }
-	void Abort() { m_Abort = true; }
+	void Abort();
 
 	void Result(unsigned char **ppResult, size_t *pResultLength) const;
 	json_value *ResultJson() const;
@@ -200,6 +224,9 @@ inline std::unique_ptr<CHttpRequest> HttpPostJson(const char *pUrl, const char *
 }
 
 bool HttpInit(IStorage *pStorage);
+// Stops the HTTP thread, aborting all requests that are still queued or
+// running.
+void HttpShutdown();
 void EscapeUrl(char *pBuf, int Size, const char *pStr);
 bool HttpHasIpresolveBug();
 #endif // ENGINE_SHARED_HTTP_H
@@ -14,6 +14,26 @@ int IJob::Status()
 	return m_Status.load();
 }
 
+void IJob::Resume()
+{
+	dbg_assert(m_DeferredRefs > 0, "only deferred jobs can be resumed");
+	if(m_DeferredRefs.fetch_sub(1) != 1)
+	{
+		// `Run()` hasn't returned yet, the thread running it continues
+		return;
+	}
+	if(m_pDeferredSelf)
+	{
+		CJobPool *pPool = m_pPool;
+		pPool->Add(std::move(m_pDeferredSelf));
+	}
+	else
+	{
+		// `RunBlocking()` runs the job again after waking up
+		m_DeferredResume.Signal();
+	}
+}
+
 CJobPool::CJobPool()
 {
 	// empty the pool
@@ -57,7 +77,22 @@ void CJobPool::WorkerThread(void *pUser)
 		// do the job if we have one
 		if(pJob)
 		{
-			RunBlocking(pJob.get());
+			pJob->m_Status = IJob::STATE_RUNNING;
+			pJob->m_pPool = pPool;
+			while(true)
+			{
+				pJob->m_pDeferredSelf = pJob;
+				pJob->Run();
+				if(pJob->m_DeferredRefs == 0)
+				{
+					pJob->m_pDeferredSelf = nullptr;
+					pJob->m_Status = IJob::STATE_DONE;
+					break;
+				}
+				// added again by `IJob::Resume()` unless it was already called
+				if(pJob->m_DeferredRefs.fetch_sub(1) != 1)
+					break;
+			}
 		}
 	}
 }
@@ -104,5 +139,11 @@ void CJobPool::RunBlocking(IJob *pJob)
 {
 	pJob->m_Status = IJob::STATE_RUNNING;
 	pJob->Run();
+	while(pJob->m_DeferredRefs != 0)
+	{
+		if(pJob->m_DeferredRefs.fetch_sub(1) != 1)
+			pJob->m_DeferredResume.Wait();
+		pJob->Run();
+	}
 	pJob->m_Status = IJob::STATE_DONE;
 }
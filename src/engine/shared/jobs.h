@@ -5,6 +5,7 @@
 
 #include <base/lock.h>
 #include <base/system.h>
+#include <base/tl/threading.h>
 
 #include <atomic>
 #include <memory>
@@ -22,6 +23,26 @@ private:
 	std::atomic<int> m_Status;
 	virtual void Run() = 0;
 
+	// Two while the job waits for another thread: returning from `Run()`
+	// and `Resume()` each count down, the last one runs the job again.
+	std::atomic<int> m_DeferredRefs{0};
+	// The pool running the job, deferred jobs are added to it again.
+	CJobPool *m_pPool = nullptr;
+	// Keeps deferred jobs of the job pool alive until they call `Resume()`.
+	std::shared_ptr<IJob> m_pDeferredSelf;
+	// Signalled by `Resume()` for deferred jobs run by `RunBlocking()`.
+	CSemaphore m_DeferredResume;
+
+protected:
+	// Called from `Run()` by jobs that hand their work off to another
+	// thread instead of blocking. The job isn't done when `Run()` returns,
+	// the other thread has to call `Resume()` once it finished.
+	void Defer() { m_DeferredRefs = 2; }
+	// Runs a deferred job again, on a thread of its pool or on the thread
+	// in `RunBlocking()`. The job may run or be freed during this call, so
+	// it must be the last thing to touch it.
+	void Resume();
+
 public:
 	IJob();
 	IJob(const IJob &Other) = delete;
@@ -6,107 +6,248 @@
 
 #include "netban.h"
 
-CNetBan::CNetHash::CNetHash(const NETADDR *pAddr)
+#include <algorithm>
+
+static int AddrBits(const NETADDR *pAddr)
 {
-	if(pAddr->type == NETTYPE_IPV4)
-		m_Hash = (pAddr->ip[0] + pAddr->ip[1] + pAddr->ip[2] + pAddr->ip[3]) & 0xFF;
-	else
-		m_Hash = (pAddr->ip[0] + pAddr->ip[1] + pAddr->ip[2] + pAddr->ip[3] + pAddr->ip[4] + pAddr->ip[5] + pAddr->ip[6] + pAddr->ip[7] +
-				 pAddr->ip[8] + pAddr->ip[9] + pAddr->ip[10] + pAddr->ip[11] + pAddr->ip[12] + pAddr->ip[13] + pAddr->ip[14] + pAddr->ip[15]) &
-			 0xFF;
-	m_HashIndex = 0;
+	return pAddr->type == NETTYPE_IPV4 ? 32 : 128;
 }
 
-CNetBan::CNetHash::CNetHash(const CNetRange *pRange)
+static int TrieIndex(const NETADDR *pAddr)
 {
-	m_Hash = 0;
-	m_HashIndex = 0;
-	for(int i = 0; pRange->m_LB.ip[i] == pRange->m_UB.ip[i]; ++i)
-	{
-		m_Hash += pRange->m_LB.ip[i];
-		++m_HashIndex;
-	}
-	m_Hash &= 0xFF;
+	return pAddr->type == NETTYPE_IPV4 ? 0 : 1;
+}
+
+static int TrieIndex(const CNetRange *pRange)
+{
+	return TrieIndex(&pRange->m_LB);
+}
+
+static int PrefixBit(const unsigned char *pPrefix, int Bit)
+{
+	return (pPrefix[Bit / 8] >> (7 - Bit % 8)) & 1;
 }
 
-int CNetBan::CNetHash::MakeHashArray(const NETADDR *pAddr, CNetHash aHash[17])
+static int CommonPrefixLength(const unsigned char *pPrefix1, const unsigned char *pPrefix2, int MaxLength)
 {
-	int Length = pAddr->type == NETTYPE_IPV4 ? 4 : 16;
-	aHash[0].m_Hash = 0;
-	aHash[0].m_HashIndex = 0;
-	for(int i = 1, Sum = 0; i <= Length; ++i)
+	for(int Byte = 0; Byte * 8 < MaxLength; Byte++)
 	{
-		Sum += pAddr->ip[i - 1];
-		aHash[i].m_Hash = Sum & 0xFF;
-		aHash[i].m_HashIndex = i % Length;
+		const unsigned Diff = pPrefix1[Byte] ^ pPrefix2[Byte];
+		if(Diff)
+		{
+			int Bit = Byte * 8;
+			for(unsigned Mask = 0x80; !(Diff & Mask); Mask >>= 1)
+				Bit++;
+			return minimum(Bit, MaxLength);
+		}
 	}
-	return Length;
+	return MaxLength;
 }
 
-template<class T, int HashCount>
-void CNetBan::CBanPool<T, HashCount>::InsertUsed(CBan<T> *pBan)
+// Calls `Fn(pPrefix, Length)` for the prefixes an address or a range is
+// stored under, until it returns false.
+template<class F>
+static void ForEachPrefix(const NETADDR *pAddr, F &&Fn)
 {
-	if(m_pFirstUsed)
+	Fn(pAddr->ip, AddrBits(pAddr));
+}
+
+template<class F>
+static void ForEachPrefix(const CNetRange *pRange, F &&Fn)
+{
+	// split the range into the fewest aligned blocks, at most two per bit
+	const int Bits = AddrBits(&pRange->m_LB);
+	const int Bytes = Bits / 8;
+	unsigned char aLow[16];
+	mem_copy(aLow, pRange->m_LB.ip, sizeof(aLow));
+	while(true)
 	{
-		for(CBan<T> *p = m_pFirstUsed;; p = p->m_pNext)
+		unsigned char aHigh[16];
+		mem_copy(aHigh, aLow, sizeof(aHigh));
+		int Size = 0;
+		while(Size < Bits)
 		{
-			if(p->m_Info.m_Expires == CBanInfo::EXPIRES_NEVER || (pBan->m_Info.m_Expires != CBanInfo::EXPIRES_NEVER && pBan->m_Info.m_Expires <= p->m_Info.m_Expires))
-			{
-				// insert before
-				pBan->m_pNext = p;
-				pBan->m_pPrev = p->m_pPrev;
-				if(p->m_pPrev)
-					p->m_pPrev->m_pNext = pBan;
-				else
-					m_pFirstUsed = pBan;
-				p->m_pPrev = pBan;
+			const int Bit = Bits - 1 - Size;
+			if(PrefixBit(aLow, Bit))
 				break;
-			}
+			unsigned char aNext[16];
+			mem_copy(aNext, aHigh, sizeof(aNext));
+			aNext[Bit / 8] |= 1 << (7 - Bit % 8);
+			if(mem_comp(aNext, pRange->m_UB.ip, Bytes) > 0)
+				break;
+			mem_copy(aHigh, aNext, sizeof(aHigh));
+			Size++;
+		}
+		if(!Fn(aLow, Bits - Size) || mem_comp(aHigh, pRange->m_UB.ip, Bytes) >= 0)
+			return;
 
-			if(!p->m_pNext)
+		// continue after the block
+		for(int i = Bytes - 1; i >= 0 && ++aHigh[i] == 0; i--)
+		{
+		}
+		mem_copy(aLow, aHigh, sizeof(aLow));
+	}
+}
+
+template<class T>
+void CNetBan::CBanTrie<T>::Insert(const unsigned char *pPrefix, int Length, CBan<T> *pBan)
+{
+	CNode *pNode = &m_Root;
+	while(pNode->m_Length < Length)
+	{
+		std::unique_ptr<CNode> &pChild = pNode->m_apChildren[PrefixBit(pPrefix, pNode->m_Length)];
+		if(!pChild)
+		{
+			pChild = std::make_unique<CNode>();
+			mem_copy(pChild->m_aPrefix, pPrefix, sizeof(pChild->m_aPrefix));
+			pChild->m_Length = Length;
+		}
+		else
+		{
+			const int Common = CommonPrefixLength(pPrefix, pChild->m_aPrefix, minimum(Length, pChild->m_Length));
+			if(Common < pChild->m_Length)
 			{
-				// last entry
-				p->m_pNext = pBan;
-				pBan->m_pPrev = p;
-				pBan->m_pNext = 0;
-				break;
+				// split the compressed path where the prefixes differ
+				std::unique_ptr<CNode> pSplit = std::make_unique<CNode>();
+				mem_copy(pSplit->m_aPrefix, pPrefix, sizeof(pSplit->m_aPrefix));
+				pSplit->m_Length = Common;
+				const int ChildBit = PrefixBit(pChild->m_aPrefix, Common);
+				pSplit->m_apChildren[ChildBit] = std::move(pChild);
+				pChild = std::move(pSplit);
 			}
 		}
+		pNode = pChild.get();
 	}
-	else
+	pNode->m_vpBans.push_back(pBan);
+}
+
+template<class T>
+void CNetBan::CBanTrie<T>::Remove(const unsigned char *pPrefix, int Length, CBan<T> *pBan)
+{
+	std::unique_ptr<CNode> *apPath[129];
+	int PathLength = 0;
+	CNode *pNode = &m_Root;
+	while(pNode->m_Length < Length)
 	{
-		m_pFirstUsed = pBan;
-		pBan->m_pNext = pBan->m_pPrev = 0;
+		std::unique_ptr<CNode> &pChild = pNode->m_apChildren[PrefixBit(pPrefix, pNode->m_Length)];
+		if(!pChild || CommonPrefixLength(pPrefix, pChild->m_aPrefix, pChild->m_Length) < pChild->m_Length)
+			return;
+		apPath[PathLength++] = &pChild;
+		pNode = pChild.get();
+	}
+	if(pNode->m_Length != Length)
+		return;
+
+	auto It = std::find(pNode->m_vpBans.begin(), pNode->m_vpBans.end(), pBan);
+	if(It == pNode->m_vpBans.end())
+		return;
+	pNode->m_vpBans.erase(It);
+
+	// drop nodes that are no longer needed, keeping the path compressed
+	while(PathLength > 0)
+	{
+		std::unique_ptr<CNode> &pPathNode = *apPath[--PathLength];
+		if(!pPathNode->m_vpBans.empty() || (pPathNode->m_apChildren[0] && pPathNode->m_apChildren[1]))
+			break;
+		std::unique_ptr<CNode> pOnlyChild = std::move(pPathNode->m_apChildren[pPathNode->m_apChildren[0] ? 0 : 1]);
+		pPathNode = std::move(pOnlyChild);
 	}
 }
 
-template<class T, int HashCount>
-typename CNetBan::CBan<T> *CNetBan::CBanPool<T, HashCount>::Add(const T *pData, const CBanInfo *pInfo, const CNetHash *pNetHash)
+template<class T>
+void CNetBan::CBanTrie<T>::Reset()
 {
-	if(!m_pFirstFree)
-		return 0;
+	mem_zero(m_Root.m_aPrefix, sizeof(m_Root.m_aPrefix));
+	m_Root.m_Length = 0;
+	m_Root.m_apChildren[0] = nullptr;
+	m_Root.m_apChildren[1] = nullptr;
+	m_Root.m_vpBans.clear();
+}
+
+template<class T>
+const std::vector<CNetBan::CBan<T> *> *CNetBan::CBanTrie<T>::Find(const unsigned char *pPrefix, int Length) const
+{
+	const CNode *pNode = &m_Root;
+	while(pNode->m_Length < Length)
+	{
+		pNode = pNode->m_apChildren[PrefixBit(pPrefix, pNode->m_Length)].get();
+		if(!pNode || CommonPrefixLength(pPrefix, pNode->m_aPrefix, pNode->m_Length) < pNode->m_Length)
+			return nullptr;
+	}
+	return pNode->m_Length == Length ? &pNode->m_vpBans : nullptr;
+}
+
+template<class T>
+CNetBan::CBan<T> *CNetBan::CBanTrie<T>::Match(const NETADDR *pAddr, int Bits) const
+{
+	CBan<T> *pMatch = nullptr;
+	const CNode *pNode = &m_Root;
+	while(pNode && CommonPrefixLength(pAddr->ip, pNode->m_aPrefix, pNode->m_Length) == pNode->m_Length)
+	{
+		for(CBan<T> *pBan : pNode->m_vpBans)
+		{
+			if(NetMatch(&pBan->m_Data, pAddr))
+				pMatch = pBan;
+		}
+		if(pNode->m_Length >= Bits)
+			break;
+		pNode = pNode->m_apChildren[PrefixBit(pAddr->ip, pNode->m_Length)].get();
+	}
+	return pMatch;
+}
+
+template<class T>
+void CNetBan::CBanPool<T>::InsertExpiry(CBan<T> *pBan)
+{
+	pBan->m_pExpiryNext = pBan->m_pExpiryPrev = nullptr;
+	if(pBan->m_Info.m_Expires == CBanInfo::EXPIRES_NEVER)
+		return;
+
+	CBan<T> *&pSlot = m_apExpiryWheel[pBan->m_Info.m_Expires % EXPIRY_WHEEL_SIZE];
+	if(pSlot)
+		pSlot->m_pExpiryPrev = pBan;
+	pBan->m_pExpiryNext = pSlot;
+	pSlot = pBan;
+}
+
+template<class T>
+void CNetBan::CBanPool<T>::RemoveExpiry(CBan<T> *pBan)
+{
+	if(pBan->m_Info.m_Expires == CBanInfo::EXPIRES_NEVER)
+		return;
+
+	if(pBan->m_pExpiryNext)
+		pBan->m_pExpiryNext->m_pExpiryPrev = pBan->m_pExpiryPrev;
+	if(pBan->m_pExpiryPrev)
+		pBan->m_pExpiryPrev->m_pExpiryNext = pBan->m_pExpiryNext;
+	else
+		m_apExpiryWheel[pBan->m_Info.m_Expires % EXPIRY_WHEEL_SIZE] = pBan->m_pExpiryNext;
+	pBan->m_pExpiryNext = pBan->m_pExpiryPrev = nullptr;
+}
 
+template<class T>
+typename CNetBan::CBan<T> *CNetBan::CBanPool<T>::Add(const T *pData, const CBanInfo *pInfo)
+{
 	// create new ban
-	CBan<T> *pBan = m_pFirstFree;
+	CBan<T> *pBan = new CBan<T>;
 	pBan->m_Data = *pData;
 	pBan->m_Info = *pInfo;
-	pBan->m_NetHash = *pNetHash;
-	if(pBan->m_pNext)
-		pBan->m_pNext->m_pPrev = pBan->m_pPrev;
-	if(pBan->m_pPrev)
-		pBan->m_pPrev->m_pNext = pBan->m_pNext;
-	else
-		m_pFirstFree = pBan->m_pNext;
+	pBan->m_Sequence = ++m_Sequence;
 
-	// add it to the hash list
-	if(m_aapHashList[pNetHash->m_HashIndex][pNetHash->m_Hash])
-		m_aapHashList[pNetHash->m_HashIndex][pNetHash->m_Hash]->m_pHashPrev = pBan;
-	pBan->m_pHashPrev = 0;
-	pBan->m_pHashNext = m_aapHashList[pNetHash->m_HashIndex][pNetHash->m_Hash];
-	m_aapHashList[pNetHash->m_HashIndex][pNetHash->m_Hash] = pBan;
+	// add it to the trie and the timer wheel
+	CBanTrie<T> &Trie = m_aTries[TrieIndex(pData)];
+	ForEachPrefix(pData, [&](const unsigned char *pPrefix, int Length) {
+		Trie.Insert(pPrefix, Length, pBan);
+		return true;
+	});
+	InsertExpiry(pBan);
 
 	// insert it into the used list
-	InsertUsed(pBan);
+	pBan->m_pPrev = nullptr;
+	pBan->m_pNext = m_pFirstUsed;
+	if(m_pFirstUsed)
+		m_pFirstUsed->m_pPrev = pBan;
+	m_pFirstUsed = pBan;
 
 	// update ban count
 	++m_CountUsed;
@@ -114,20 +255,19 @@ typename CNetBan::CBan<T> *CNetBan::CBanPool<T, HashCount>::Add(const T *pData,
 	return pBan;
 }
 
-template<class T, int HashCount>
-int CNetBan::CBanPool<T, HashCount>::Remove(CBan<T> *pBan)
+template<class T>
+int CNetBan::CBanPool<T>::Remove(CBan<T> *pBan)
 {
 	if(pBan == 0)
 		return -1;
 
-	// remove from hash list
-	if(pBan->m_pHashNext)
-		pBan->m_pHashNext->m_pHashPrev = pBan->m_pHashPrev;
-	if(pBan->m_pHashPrev)
-		pBan->m_pHashPrev->m_pHashNext = pBan->m_pHashNext;
-	else
-		m_aapHashList[pBan->m_NetHash.m_HashIndex][pBan->m_NetHash.m_Hash] = pBan->m_pHashNext;
-	pBan->m_pHashNext = pBan->m_pHashPrev = 0;
+	// remove from the trie and the timer wheel
+	CBanTrie<T> &Trie = m_aTries[TrieIndex(&pBan->m_Data)];
+	ForEachPrefix(&pBan->m_Data, [&](const unsigned char *pPrefix, int Length) {
+		Trie.Remove(pPrefix, Length, pBan);
+		return true;
+	});
+	RemoveExpiry(pBan);
 
 	// remove from used list
 	if(pBan->m_pNext)
@@ -136,13 +276,7 @@ int CNetBan::CBanPool<T, HashCount>::Remove(CBan<T> *pBan)
 		pBan->m_pPrev->m_pNext = pBan->m_pNext;
 	else
 		m_pFirstUsed = pBan->m_pNext;
-
-	// add to recycle list
-	if(m_pFirstFree)
-		m_pFirstFree->m_pPrev = pBan;
-	pBan->m_pPrev = 0;
-	pBan->m_pNext = m_pFirstFree;
-	m_pFirstFree = pBan;
+	delete pBan;
 
 	// update ban count
 	--m_CountUsed;
@@ -150,21 +284,13 @@ int CNetBan::CBanPool<T, HashCount>::Remove(CBan<T> *pBan)
 	return 0;
 }
 
-template<class T, int HashCount>
-void CNetBan::CBanPool<T, HashCount>::Update(CBan<CDataType> *pBan, const CBanInfo *pInfo)
+template<class T>
+void CNetBan::CBanPool<T>::Update(CBan<CDataType> *pBan, const CBanInfo *pInfo)
 {
+	RemoveExpiry(pBan);
 	pBan->m_Info = *pInfo;
-
-	// remove from used list
-	if(pBan->m_pNext)
-		pBan->m_pNext->m_pPrev = pBan->m_pPrev;
-	if(pBan->m_pPrev)
-		pBan->m_pPrev->m_pNext = pBan->m_pNext;
-	else
-		m_pFirstUsed = pBan->m_pNext;
-
-	// insert it into the used list
-	InsertUsed(pBan);
+	pBan->m_Sequence = ++m_Sequence;
+	InsertExpiry(pBan);
 }
 
 void CNetBan::UnbanAll()
@@ -173,38 +299,101 @@ void CNetBan::UnbanAll()
 	m_BanRangePool.Reset();
 }
 
-template<class T, int HashCount>
-void CNetBan::CBanPool<T, HashCount>::Reset()
+template<class T>
+void CNetBan::CBanPool<T>::Reset()
 {
-	mem_zero(m_aapHashList, sizeof(m_aapHashList));
-	mem_zero(m_aBans, sizeof(m_aBans));
-	m_pFirstUsed = 0;
-	m_CountUsed = 0;
+	for(CBanTrie<T> &Trie : m_aTries)
+		Trie.Reset();
+	mem_zero(m_apExpiryWheel, sizeof(m_apExpiryWheel));
+	m_ExpiryCursor = time_timestamp();
+	m_Sequence = 0;
 
-	for(int i = 1; i < MAX_BANS - 1; ++i)
+	while(m_pFirstUsed)
 	{
-		m_aBans[i].m_pNext = &m_aBans[i + 1];
-		m_aBans[i].m_pPrev = &m_aBans[i - 1];
+		CBan<T> *pNext = m_pFirstUsed->m_pNext;
+		delete m_pFirstUsed;
+		m_pFirstUsed = pNext;
 	}
+	m_CountUsed = 0;
+}
 
-	m_aBans[0].m_pNext = &m_aBans[1];
-	m_aBans[MAX_BANS - 1].m_pPrev = &m_aBans[MAX_BANS - 2];
-	m_pFirstFree = &m_aBans[0];
+template<class T>
+typename CNetBan::CBan<T> *CNetBan::CBanPool<T>::Find(const T *pData) const
+{
+	CBan<T> *pFound = nullptr;
+	const CBanTrie<T> &Trie = m_aTries[TrieIndex(pData)];
+	// every ban is stored under its first prefix
+	ForEachPrefix(pData, [&](const unsigned char *pPrefix, int Length) {
+		const std::vector<CBan<T> *> *pvpBans = Trie.Find(pPrefix, Length);
+		if(pvpBans)
+		{
+			for(CBan<T> *pBan : *pvpBans)
+			{
+				if(NetComp(&pBan->m_Data, pData) == 0)
+				{
+					pFound = pBan;
+					break;
+				}
+			}
+		}
+		return false;
+	});
+	return pFound;
 }
 
-template<class T, int HashCount>
-typename CNetBan::CBan<T> *CNetBan::CBanPool<T, HashCount>::Get(int Index) const
+template<class T>
+typename CNetBan::CBan<T> *CNetBan::CBanPool<T>::Match(const NETADDR *pAddr) const
 {
-	if(Index < 0 || Index >= Num())
-		return 0;
+	return m_aTries[TrieIndex(pAddr)].Match(pAddr, AddrBits(pAddr));
+}
+
+template<class T>
+void CNetBan::CBanPool<T>::Sorted(std::vector<CBan<T> *> &vpBans) const
+{
+	vpBans.clear();
+	vpBans.reserve(m_CountUsed);
+	for(CBan<T> *pBan = m_pFirstUsed; pBan; pBan = pBan->m_pNext)
+		vpBans.push_back(pBan);
+
+	// bans expiring first, permanent bans last, newer bans before older ones
+	std::sort(vpBans.begin(), vpBans.end(), [](const CBan<T> *pLeft, const CBan<T> *pRight) {
+		const bool LeftNever = pLeft->m_Info.m_Expires == CBanInfo::EXPIRES_NEVER;
+		const bool RightNever = pRight->m_Info.m_Expires == CBanInfo::EXPIRES_NEVER;
+		if(LeftNever != RightNever)
+			return RightNever;
+		if(pLeft->m_Info.m_Expires != pRight->m_Info.m_Expires)
+			return pLeft->m_Info.m_Expires < pRight->m_Info.m_Expires;
+		return pLeft->m_Sequence > pRight->m_Sequence;
+	});
+}
 
-	for(CNetBan::CBan<T> *pBan = m_pFirstUsed; pBan; pBan = pBan->m_pNext, --Index)
+template<class T>
+template<class F>
+void CNetBan::CBanPool<T>::RemoveExpired(int Now, F &&Callback)
+{
+	// the slots are keyed by the absolute expiry, so after the clock stepped
+	// back the cursor is rewound to revisit the slots it already passed
+	if(Now < m_ExpiryCursor)
+		m_ExpiryCursor = Now;
+
+	// visit the slot of every second since the last call, bans a whole
+	// wheel turn ahead share a slot and stay
+	const int NumSlots = minimum(Now - m_ExpiryCursor, (int)EXPIRY_WHEEL_SIZE);
+	for(int i = 0; i < NumSlots; i++)
 	{
-		if(Index == 0)
-			return pBan;
+		CBan<T> *pBan = m_apExpiryWheel[(m_ExpiryCursor + i) % EXPIRY_WHEEL_SIZE];
+		while(pBan)
+		{
+			CBan<T> *pNext = pBan->m_pExpiryNext;
+			if(pBan->m_Info.m_Expires < Now)
+			{
+				Callback(pBan);
+				Remove(pBan);
+			}
+			pBan = pNext;
+		}
 	}
-
-	return 0;
+	m_ExpiryCursor = Now;
 }
 
 template<class T>
@@ -225,8 +414,7 @@ int CNetBan::Ban(T *pBanPool, const typename T::CDataType *pData, int Seconds, c
 	str_copy(Info.m_aReason, pReason);
 
 	// check if it already exists
-	CNetHash NetHash(pData);
-	CBan<typename T::CDataType> *pBan = pBanPool->Find(pData, &NetHash);
+	CBan<typename T::CDataType> *pBan = pBanPool->Find(pData);
 	if(pBan)
 	{
 		// adjust the ban
@@ -238,24 +426,17 @@ int CNetBan::Ban(T *pBanPool, const typename T::CDataType *pData, int Seconds, c
 	}
 
 	// add ban and print result
-	pBan = pBanPool->Add(pData, &Info, &NetHash);
-	if(pBan)
-	{
-		char aBuf[128];
-		MakeBanInfo(pBan, aBuf, sizeof(aBuf), MSGTYPE_BANADD);
-		Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "net_ban", aBuf);
-		return 0;
-	}
-	else
-		Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "net_ban", "ban failed (full banlist)");
-	return -1;
+	pBan = pBanPool->Add(pData, &Info);
+	char aBuf[128];
+	MakeBanInfo(pBan, aBuf, sizeof(aBuf), MSGTYPE_BANADD);
+	Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "net_ban", aBuf);
+	return 0;
 }
 
 template<class T>
 int CNetBan::Unban(T *pBanPool, const typename T::CDataType *pData)
 {
-	CNetHash NetHash(pData);
-	CBan<typename T::CDataType> *pBan = pBanPool->Find(pData, &NetHash);
+	CBan<typename T::CDataType> *pBan = pBanPool->Find(pData);
 	if(pBan)
 	{
 		char aBuf[256];
@@ -290,22 +471,18 @@ void CNetBan::Init(IConsole *pConsole, IStorage *pStorage)
 
 void CNetBan::Update()
 {
-	int Now = time_timestamp();
+	RemoveExpired(time_timestamp());
+}
 
-	// remove expired bans
+void CNetBan::RemoveExpired(int Now)
+{
 	char aBuf[256], aNetStr[256];
-	while(m_BanAddrPool.First() && m_BanAddrPool.First()->m_Info.m_Expires != CBanInfo::EXPIRES_NEVER && m_BanAddrPool.First()->m_Info.m_Expires < Now)
-	{
-		str_format(aBuf, sizeof(aBuf), "ban %s expired", NetToString(&m_BanAddrPool.First()->m_Data, aNetStr, sizeof(aNetStr)));
-		Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "net_ban", aBuf);
-		m_BanAddrPool.Remove(m_BanAddrPool.First());
-	}
-	while(m_BanRangePool.First() && m_BanRangePool.First()->m_Info.m_Expires != CBanInfo::EXPIRES_NEVER && m_BanRangePool.First()->m_Info.m_Expires < Now)
-	{
-		str_format(aBuf, sizeof(aBuf), "ban %s expired", NetToString(&m_BanRangePool.First()->m_Data, aNetStr, sizeof(aNetStr)));
+	const auto PrintExpired = [&](const auto *pBan) {
+		str_format(aBuf, sizeof(aBuf), "ban %s expired", NetToString(&pBan->m_Data, aNetStr, sizeof(aNetStr)));
 		Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "net_ban", aBuf);
-		m_BanRangePool.Remove(m_BanRangePool.First());
-	}
+	};
+	m_BanAddrPool.RemoveExpired(Now, PrintExpired);
+	m_BanRangePool.RemoveExpired(Now, PrintExpired);
 }
 
 int CNetBan::BanAddr(const NETADDR *pAddr, int Seconds, const char *pReason)
@@ -340,19 +517,22 @@ int CNetBan::UnbanByIndex(int Index)
 {
 	int Result;
 	char aBuf[256];
-	CBanAddr *pBan = m_BanAddrPool.Get(Index);
-	if(pBan)
+	if(Index >= 0 && Index < m_BanAddrPool.Num())
 	{
-		NetToString(&pBan->m_Data, aBuf, sizeof(aBuf));
-		Result = m_BanAddrPool.Remove(pBan);
+		std::vector<CBanAddr *> vpBans;
+		m_BanAddrPool.Sorted(vpBans);
+		NetToString(&vpBans[Index]->m_Data, aBuf, sizeof(aBuf));
+		Result = m_BanAddrPool.Remove(vpBans[Index]);
 	}
 	else
 	{
-		CBanRange *pBanRange = m_BanRangePool.Get(Index - m_BanAddrPool.Num());
-		if(pBanRange)
+		const int RangeIndex = Index - m_BanAddrPool.Num();
+		if(RangeIndex >= 0 && RangeIndex < m_BanRangePool.Num())
 		{
-			NetToString(&pBanRange->m_Data, aBuf, sizeof(aBuf));
-			Result = m_BanRangePool.Remove(pBanRange);
+			std::vector<CBanRange *> vpBans;
+			m_BanRangePool.Sorted(vpBans);
+			NetToString(&vpBans[RangeIndex]->m_Data, aBuf, sizeof(aBuf));
+			Result = m_BanRangePool.Remove(vpBans[RangeIndex]);
 		}
 		else
 		{
@@ -377,11 +557,9 @@ bool CNetBan::IsBanned(const NETADDR *pOrigAddr, char *pBuf, unsigned BufferSize
 		pAddr = &Addr;
 		Addr.type = NETTYPE_IPV4;
 	}
-	CNetHash aHash[17];
-	int Length = CNetHash::MakeHashArray(pAddr, aHash);
 
 	// check ban addresses
-	CBanAddr *pBan = m_BanAddrPool.Find(pAddr, &aHash[Length]);
+	CBanAddr *pBan = m_BanAddrPool.Find(pAddr);
 	if(pBan)
 	{
 		MakeBanInfo(pBan, pBuf, BufferSize, MSGTYPE_PLAYER);
@@ -389,16 +567,11 @@ bool CNetBan::IsBanned(const NETADDR *pOrigAddr, char *pBuf, unsigned BufferSize
 	}
 
 	// check ban ranges
-	for(int i = Length - 1; i >= 0; --i)
+	CBanRange *pBanRange = m_BanRangePool.Match(pAddr);
+	if(pBanRange)
 	{
-		for(CBanRange *pBanRange = m_BanRangePool.First(&aHash[i]); pBanRange; pBanRange = pBanRange->m_pHashNext)
-		{
-			if(NetMatch(&pBanRange->m_Data, pAddr, i, Length))
-			{
-				MakeBanInfo(pBanRange, pBuf, BufferSize, MSGTYPE_PLAYER);
-				return true;
-			}
-		}
+		MakeBanInfo(pBanRange, pBuf, BufferSize, MSGTYPE_PLAYER);
+		return true;
 	}
 
 	return false;
@@ -485,25 +658,29 @@ void CNetBan::ConBans(IConsole::IResult *pResult, void *pUser)
 
 	int Count = 0;
 	char aBuf[256], aMsg[256];
-	for(CBanAddr *pBan = pThis->m_BanAddrPool.First(); pBan; pBan = pBan->m_pNext, Count++)
+	std::vector<CBanAddr *> vpBanAddrs;
+	pThis->m_BanAddrPool.Sorted(vpBanAddrs);
+	for(CBanAddr *pBan : vpBanAddrs)
 	{
-		if(Count < Start || Count >= End)
+		if(Count >= Start && Count < End)
 		{
-			continue;
+			pThis->MakeBanInfo(pBan, aBuf, sizeof(aBuf), MSGTYPE_LIST);
+			str_format(aMsg, sizeof(aMsg), "#%i %s", Count, aBuf);
+			pThis->Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "net_ban", aMsg);
 		}
-		pThis->MakeBanInfo(pBan, aBuf, sizeof(aBuf), MSGTYPE_LIST);
-		str_format(aMsg, sizeof(aMsg), "#%i %s", Count, aBuf);
-		pThis->Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "net_ban", aMsg);
+		Count++;
 	}
-	for(CBanRange *pBan = pThis->m_BanRangePool.First(); pBan; pBan = pBan->m_pNext, Count++)
+	std::vector<CBanRange *> vpBanRanges;
+	pThis->m_BanRangePool.Sorted(vpBanRanges);
+	for(CBanRange *pBan : vpBanRanges)
 	{
-		if(Count < Start || Count >= End)
+		if(Count >= Start && Count < End)
 		{
-			continue;
+			pThis->MakeBanInfo(pBan, aBuf, sizeof(aBuf), MSGTYPE_LIST);
+			str_format(aMsg, sizeof(aMsg), "#%i %s", Count, aBuf);
+			pThis->Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "net_ban", aMsg);
 		}
-		pThis->MakeBanInfo(pBan, aBuf, sizeof(aBuf), MSGTYPE_LIST);
-		str_format(aMsg, sizeof(aMsg), "#%i %s", Count, aBuf);
-		pThis->Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "net_ban", aMsg);
+		Count++;
 	}
 	str_format(aMsg, sizeof(aMsg), "%d %s, showing entries %d - %d", Count, Count == 1 ? "ban" : "bans", Start, End - 1);
 	pThis->Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "net_ban", aMsg);
@@ -524,7 +701,9 @@ void CNetBan::ConBansSave(IConsole::IResult *pResult, void *pUser)
 
 	int Now = time_timestamp();
 	char aAddrStr1[NETADDR_MAXSTRSIZE], aAddrStr2[NETADDR_MAXSTRSIZE];
-	for(CBanAddr *pBan = pThis->m_BanAddrPool.First(); pBan; pBan = pBan->m_pNext)
+	std::vector<CBanAddr *> vpBanAddrs;
+	pThis->m_BanAddrPool.Sorted(vpBanAddrs);
+	for(CBanAddr *pBan : vpBanAddrs)
 	{
 		int Min = pBan->m_Info.m_Expires > -1 ? (pBan->m_Info.m_Expires - Now + 59) / 60 : -1;
 		net_addr_str(&pBan->m_Data, aAddrStr1, sizeof(aAddrStr1), false);
@@ -532,7 +711,9 @@ void CNetBan::ConBansSave(IConsole::IResult *pResult, void *pUser)
 		io_write(File, aBuf, str_length(aBuf));
 		io_write_newline(File);
 	}
-	for(CBanRange *pBan = pThis->m_BanRangePool.First(); pBan; pBan = pBan->m_pNext)
+	std::vector<CBanRange *> vpBanRanges;
+	pThis->m_BanRangePool.Sorted(vpBanRanges);
+	for(CBanRange *pBan : vpBanRanges)
 	{
 		int Min = pBan->m_Info.m_Expires > -1 ? (pBan->m_Info.m_Expires - Now + 59) / 60 : -1;
 		net_addr_str(&pBan->m_Data.m_LB, aAddrStr1, sizeof(aAddrStr1), false);
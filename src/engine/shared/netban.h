@@ -5,6 +5,9 @@
 
 #include <base/system.h>
 
+#include <memory>
+#include <vector>
+
 inline int NetComp(const NETADDR *pAddr1, const NETADDR *pAddr2)
 {
 	return mem_comp(pAddr1, pAddr2, pAddr1->type == NETTYPE_IPV4 ? 8 : 20);
@@ -27,20 +30,15 @@ inline int NetComp(const CNetRange *pRange1, const CNetRange *pRange2)
 class CNetBan
 {
 protected:
-	bool NetMatch(const NETADDR *pAddr1, const NETADDR *pAddr2) const
+	static bool NetMatch(const NETADDR *pAddr1, const NETADDR *pAddr2)
 	{
 		return NetComp(pAddr1, pAddr2) == 0;
 	}
 
-	bool NetMatch(const CNetRange *pRange, const NETADDR *pAddr, int Start, int Length) const
-	{
-		return pRange->m_LB.type == pAddr->type && (Start == 0 || mem_comp(&pRange->m_LB.ip[0], &pAddr->ip[0], Start) == 0) &&
-		       mem_comp(&pRange->m_LB.ip[Start], &pAddr->ip[Start], Length - Start) <= 0 && mem_comp(&pRange->m_UB.ip[Start], &pAddr->ip[Start], Length - Start) >= 0;
-	}
-
-	bool NetMatch(const CNetRange *pRange, const NETADDR *pAddr) const
+	static bool NetMatch(const CNetRange *pRange, const NETADDR *pAddr)
 	{
-		return NetMatch(pRange, pAddr, 0, pRange->m_LB.type == NETTYPE_IPV4 ? 4 : 16);
+		const int Length = pRange->m_LB.type == NETTYPE_IPV4 ? 4 : 16;
+		return pRange->m_LB.type == pAddr->type && mem_comp(pRange->m_LB.ip, pAddr->ip, Length) <= 0 && mem_comp(pRange->m_UB.ip, pAddr->ip, Length) >= 0;
 	}
 
 	const char *NetToString(const NETADDR *pData, char *pBuffer, unsigned BufferSize) const
@@ -60,19 +58,6 @@ protected:
 		return pBuffer;
 	}
 
-	class CNetHash
-	{
-	public:
-		int m_Hash;
-		int m_HashIndex; // matching parts for ranges, 0 for addr
-
-		CNetHash() = default;
-		CNetHash(const NETADDR *pAddr);
-		CNetHash(const CNetRange *pRange);
-
-		static int MakeHashArray(const NETADDR *pAddr, CNetHash aHash[17]);
-	};
-
 	struct CBanInfo
 	{
 		enum
@@ -89,62 +74,90 @@ protected:
 	{
 		T m_Data;
 		CBanInfo m_Info;
-		CNetHash m_NetHash;
+		// orders bans with the same expiry, newer ones first
+		int64_t m_Sequence;
 
-		// hash list
-		CBan *m_pHashNext;
-		CBan *m_pHashPrev;
+		// timer wheel slot list
+		CBan *m_pExpiryNext;
+		CBan *m_pExpiryPrev;
 
-		// used or free list
+		// used list
 		CBan *m_pNext;
 		CBan *m_pPrev;
 	};
 
-	template<class T, int HashCount>
+	// Binary trie of address prefixes, paths without branches are
+	// compressed into a single node. Every node lists the bans covering
+	// its prefix, so a lookup only walks the bits of one address.
+	template<class T>
+	class CBanTrie
+	{
+		struct CNode
+		{
+			unsigned char m_aPrefix[16];
+			int m_Length; // in bits
+			std::unique_ptr<CNode> m_apChildren[2];
+			std::vector<CBan<T> *> m_vpBans;
+		};
+
+		CNode m_Root;
+
+	public:
+		CBanTrie() { Reset(); }
+
+		void Insert(const unsigned char *pPrefix, int Length, CBan<T> *pBan);
+		void Remove(const unsigned char *pPrefix, int Length, CBan<T> *pBan);
+		void Reset();
+
+		// bans stored for exactly this prefix
+		const std::vector<CBan<T> *> *Find(const unsigned char *pPrefix, int Length) const;
+		// most specific ban covering the address
+		CBan<T> *Match(const NETADDR *pAddr, int Bits) const;
+	};
+
+	template<class T>
 	class CBanPool
 	{
 	public:
 		typedef T CDataType;
 
-		CBan<CDataType> *Add(const CDataType *pData, const CBanInfo *pInfo, const CNetHash *pNetHash);
+		CBanPool() { Reset(); }
+		~CBanPool() { Reset(); }
+
+		CBan<CDataType> *Add(const CDataType *pData, const CBanInfo *pInfo);
 		int Remove(CBan<CDataType> *pBan);
 		void Update(CBan<CDataType> *pBan, const CBanInfo *pInfo);
 		void Reset();
 
 		int Num() const { return m_CountUsed; }
-		bool IsFull() const { return m_CountUsed == MAX_BANS; }
 
 		CBan<CDataType> *First() const { return m_pFirstUsed; }
-		CBan<CDataType> *First(const CNetHash *pNetHash) const { return m_aapHashList[pNetHash->m_HashIndex][pNetHash->m_Hash]; }
-		CBan<CDataType> *Find(const CDataType *pData, const CNetHash *pNetHash) const
-		{
-			for(CBan<CDataType> *pBan = m_aapHashList[pNetHash->m_HashIndex][pNetHash->m_Hash]; pBan; pBan = pBan->m_pHashNext)
-			{
-				if(NetComp(&pBan->m_Data, pData) == 0)
-					return pBan;
-			}
-
-			return 0;
-		}
-		CBan<CDataType> *Get(int Index) const;
+		CBan<CDataType> *Find(const CDataType *pData) const;
+		CBan<CDataType> *Match(const NETADDR *pAddr) const;
+		// all bans, ordered by expiry
+		void Sorted(std::vector<CBan<CDataType> *> &vpBans) const;
+		template<class F>
+		void RemoveExpired(int Now, F &&Callback);
 
 	private:
 		enum
 		{
-			MAX_BANS = 1024,
+			EXPIRY_WHEEL_SIZE = 4096, // seconds
 		};
 
-		CBan<CDataType> *m_aapHashList[HashCount][256];
-		CBan<CDataType> m_aBans[MAX_BANS];
-		CBan<CDataType> *m_pFirstFree;
-		CBan<CDataType> *m_pFirstUsed;
-		int m_CountUsed;
+		CBanTrie<CDataType> m_aTries[2]; // IPv4, IPv6
+		CBan<CDataType> *m_apExpiryWheel[EXPIRY_WHEEL_SIZE];
+		int m_ExpiryCursor = 0;
+		CBan<CDataType> *m_pFirstUsed = nullptr;
+		int m_CountUsed = 0;
+		int64_t m_Sequence = 0;
 
-		void InsertUsed(CBan<CDataType> *pBan);
+		void InsertExpiry(CBan<CDataType> *pBan);
+		void RemoveExpiry(CBan<CDataType> *pBan);
 	};
 
-	typedef CBanPool<NETADDR, 1> CBanAddrPool;
-	typedef CBanPool<CNetRange, 16> CBanRangePool;
+	typedef CBanPool<NETADDR> CBanAddrPool;
+	typedef CBanPool<CNetRange> CBanRangePool;
 	typedef CBan<NETADDR> CBanAddr;
 	typedef CBan<CNetRange> CBanRange;
 
@@ -161,6 +174,8 @@ protected:
 	CBanRangePool m_BanRangePool;
 	NETADDR m_LocalhostIPV4, m_LocalhostIPV6;
 
+	void RemoveExpired(int Now);
+
 public:
 	enum
 	{
@@ -57,6 +57,8 @@ enum
 
 	NET_MAX_PACKETSIZE = 1400,
 	NET_MAX_PAYLOAD = NET_MAX_PACKETSIZE - 6,
+	// space for the largest connless packet header, the one of 0.7
+	NET_CONNLESS_HEADER_SPACE = 9,
 	NET_MAX_CHUNKHEADERSIZE = 3,
 	NET_PACKETHEADERSIZE = 3,
 	NET_MAX_CLIENTS = 64,
@@ -145,6 +147,7 @@ public:
 	unsigned char *m_pData;
 
 	int m_Sequence;
+	int m_NumResends;
 	int64_t m_LastSendTime;
 	int64_t m_FirstSendTime;
 };
@@ -203,6 +206,27 @@ public:
 	CONNECTIVITY GetConnectivity(int NetType, NETADDR *pGlobalAddr);
 };
 
+// Round trip time estimation from acked vital chunks (RFC 6298). All times
+// are in time_freq() units.
+class CNetRttEstimator
+{
+	int64_t m_SmoothedRtt;
+	int64_t m_RttVariance;
+	int64_t m_RetransmitTimeout;
+
+public:
+	CNetRttEstimator() { Reset(); }
+	void Reset();
+	void Update(int64_t Rtt);
+
+	// -1 until the first sample
+	int64_t SmoothedRtt() const { return m_SmoothedRtt; }
+	int64_t RttVariance() const { return m_RttVariance; }
+	int64_t RetransmitTimeout() const { return m_RetransmitTimeout; }
+	// timeout for a chunk that was already resent NumResends times
+	int64_t ChunkResendTimeout(int NumResends) const;
+};
+
 class CNetConnection
 {
 	// TODO: is this needed because this needs to be aware of
@@ -227,6 +251,9 @@ private:
 	int64_t m_LastRecvTime;
 	int64_t m_LastSendTime;
 
+	CNetRttEstimator m_Rtt;
+	int m_NumResentChunks;
+
 	char m_aErrorString[256];
 
 	CNetPacketConstruct m_Construct;
@@ -280,6 +307,12 @@ public:
 	int64_t LastRecvTime() const { return m_LastRecvTime; }
 	int64_t ConnectTime() const { return m_LastUpdateTime; }
 
+	// -1 if no round trip time was measured yet
+	int64_t SmoothedRtt() const { return m_Rtt.SmoothedRtt(); }
+	int64_t RttVariance() const { return m_Rtt.RttVariance(); }
+	int64_t RetransmitTimeout() const { return m_Rtt.RetransmitTimeout(); }
+	int NumResentChunks() const { return m_NumResentChunks; }
+
 	int AckSequence() const { return m_Ack; }
 	int SeqSequence() const { return m_Sequence; }
 	int SecurityToken() const { return m_SecurityToken; }
@@ -397,6 +430,9 @@ class CNetServer
 	int NumClientsWithAddr(NETADDR Addr);
 	bool Connlimit(NETADDR Addr);
 	void SendMsgs(NETADDR &Addr, const CPacker **ppMsgs, int Num);
+	// Writes the 0.7 connless header into the NET_CONNLESS_HEADER_SPACE bytes
+	// at the start of `pPacket` and sends it with the `DataSize` bytes after it.
+	int SendConnlessSixupPacket(const NETADDR *pAddr, unsigned char *pPacket, int DataSize, SECURITY_TOKEN ResponseToken);
 
 public:
 	int SetCallbacks(NETFUNC_NEWCLIENT pfnNewClient, NETFUNC_DELCLIENT pfnDelClient, void *pUser);
@@ -426,6 +462,12 @@ public:
 	void SendTokenSixup(NETADDR &Addr, SECURITY_TOKEN Token);
 	int SendConnlessSixup(CNetChunk *pChunk, SECURITY_TOKEN ResponseToken);
 
+	// Send connless packets without copying them, the packet headers are
+	// written into the NET_CONNLESS_HEADER_SPACE bytes in front of the data.
+	// Returns the number of packets sent before the first failure.
+	int SendConnlessInPlace(const NETADDR *pAddr, unsigned char *const *ppData, const int *pDataSizes, int Num);
+	int SendConnlessSixupInPlace(const NETADDR *pAddr, unsigned char *pData, int DataSize, SECURITY_TOKEN ResponseToken);
+
 	//
 	void SetMaxClientsPerIP(int Max);
 	bool SetTimedOut(int ClientID, int OrigID);
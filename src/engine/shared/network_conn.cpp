@@ -9,6 +9,36 @@ SECURITY_TOKEN ToSecurityToken(unsigned char *pData)
 	return (int)pData[0] | (pData[1] << 8) | (pData[2] << 16) | (pData[3] << 24);
 }
 
+void CNetRttEstimator::Reset()
+{
+	m_SmoothedRtt = -1;
+	m_RttVariance = 0;
+	m_RetransmitTimeout = time_freq();
+}
+
+void CNetRttEstimator::Update(int64_t Rtt)
+{
+	if(m_SmoothedRtt == -1)
+	{
+		m_SmoothedRtt = Rtt;
+		m_RttVariance = Rtt / 2;
+	}
+	else
+	{
+		m_RttVariance = (3 * m_RttVariance + absolute(m_SmoothedRtt - Rtt)) / 4;
+		m_SmoothedRtt = (7 * m_SmoothedRtt + Rtt) / 8;
+	}
+	// never wait longer than the old fixed timeout of one second, and not
+	// less than 200ms, as acks are only sent along with the next packet
+	m_RetransmitTimeout = clamp(m_SmoothedRtt + 4 * m_RttVariance, time_freq() / 5, time_freq());
+}
+
+int64_t CNetRttEstimator::ChunkResendTimeout(int NumResends) const
+{
+	// back off exponentially for chunks that got lost repeatedly
+	return minimum(m_RetransmitTimeout << minimum(NumResends, 3), time_freq());
+}
+
 void CNetConnection::ResetStats()
 {
 	mem_zero(&m_Stats, sizeof(m_Stats));
@@ -38,6 +68,9 @@ void CNetConnection::Reset(bool Rejoin)
 	m_LastRecvTime = 0;
 	//m_LastUpdateTime = 0;
 
+	m_Rtt.Reset();
+	m_NumResentChunks = 0;
+
 	mem_zero(&m_aConnectAddrs, sizeof(m_aConnectAddrs));
 	m_NumConnectAddrs = 0;
 	//mem_zero(&m_PeerAddr, sizeof(m_PeerAddr));
@@ -70,6 +103,7 @@ void CNetConnection::Init(NETSOCKET Socket, bool BlockCloseMsg)
 
 void CNetConnection::AckChunks(int Ack)
 {
+	int64_t RttSendTime = -1;
 	while(true)
 	{
 		CNetChunkResend *pResend = m_Buffer.First();
@@ -77,10 +111,19 @@ void CNetConnection::AckChunks(int Ack)
 			break;
 
 		if(CNetBase::IsSeqInBackroom(pResend->m_Sequence, Ack))
+		{
+			// only chunks that weren't resent give an unambiguous sample
+			if(pResend->m_NumResends == 0)
+				RttSendTime = pResend->m_LastSendTime;
 			m_Buffer.PopFirst();
+		}
 		else
 			break;
 	}
+
+	// the newest acked chunk was acked the quickest
+	if(RttSendTime != -1)
+		m_Rtt.Update(time_get() - RttSendTime);
 }
 
 void CNetConnection::SignalResend()
@@ -140,6 +183,7 @@ int CNetConnection::QueueChunkEx(int Flags, int DataSize, const void *pData, int
 		if(pResend)
 		{
 			pResend->m_Sequence = Sequence;
+			pResend->m_NumResends = 0;
 			pResend->m_Flags = Flags;
 			pResend->m_DataSize = DataSize;
 			pResend->m_pData = (unsigned char *)(pResend + 1);
@@ -185,12 +229,20 @@ void CNetConnection::ResendChunk(CNetChunkResend *pResend)
 {
 	QueueChunkEx(pResend->m_Flags | NET_CHUNKFLAG_RESEND, pResend->m_DataSize, pResend->m_pData, pResend->m_Sequence);
 	pResend->m_LastSendTime = time_get();
+	pResend->m_NumResends++;
+	m_NumResentChunks++;
 }
 
 void CNetConnection::Resend()
 {
+	// skip chunks that were (re)sent less than a round trip ago, they are
+	// most likely still on their way
+	const int64_t Now = time_get();
 	for(CNetChunkResend *pResend = m_Buffer.First(); pResend; pResend = m_Buffer.Next(pResend))
-		ResendChunk(pResend);
+	{
+		if(m_Rtt.SmoothedRtt() == -1 || Now - pResend->m_LastSendTime >= m_Rtt.SmoothedRtt())
+			ResendChunk(pResend);
+	}
 }
 
 int CNetConnection::Connect(const NETADDR *pAddr, int NumAddrs)
@@ -467,9 +519,23 @@ int CNetConnection::Update()
 		}
 		else
 		{
-			// resend packet if we haven't got it acked in 1 second
-			if(Now - pResend->m_LastSendTime > time_freq())
-				ResendChunk(pResend);
+			// resend the chunks that weren't acked within their timeout,
+			// at most one packet worth of data per update to not flood a
+			// lossy link with a burst that gets dropped again
+			int NumResent = 0;
+			int ResentSize = 0;
+			for(; pResend && ResentSize < NET_MAX_PAYLOAD; pResend = m_Buffer.Next(pResend))
+			{
+				if(Now - pResend->m_LastSendTime > m_Rtt.ChunkResendTimeout(pResend->m_NumResends))
+				{
+					ResendChunk(pResend);
+					NumResent++;
+					ResentSize += pResend->m_DataSize + NET_MAX_CHUNKHEADERSIZE;
+				}
+			}
+			if(NumResent && g_Config.m_Debug)
+				dbg_msg("connection", "resent %d chunks. srtt=%.1fms rttvar=%.1fms rto=%.1fms", NumResent,
+					m_Rtt.SmoothedRtt() * 1000.0f / time_freq(), m_Rtt.RttVariance() * 1000.0f / time_freq(), m_Rtt.RetransmitTimeout() * 1000.0f / time_freq());
 		}
 	}
 
@@ -10,6 +10,8 @@
 #include <engine/shared/packer.h>
 #include <engine/shared/protocol.h>
 
+#include <iterator> // std::size
+
 const int g_DummyMapCrc = 0xD6909B17;
 const unsigned char g_aDummyMapData[] = {
 	0x44, 0x41, 0x54, 0x41, 0x04, 0x00, 0x00, 0x00, 0xFA, 0x00, 0x00, 0x00,
@@ -768,20 +770,67 @@ void CNetServer::SendTokenSixup(NETADDR &Addr, SECURITY_TOKEN Token)
 	CNetBase::SendControlMsg(m_Socket, &Addr, 0, 5, aBuf, Size, Token, true);
 }
 
+int CNetServer::SendConnlessSixupPacket(const NETADDR *pAddr, unsigned char *pPacket, int DataSize, SECURITY_TOKEN ResponseToken)
+{
+	if(DataSize > NET_MAX_PACKETSIZE - NET_CONNLESS_HEADER_SPACE)
+		return -1;
+
+	pPacket[0] = NET_PACKETFLAG_CONNLESS << 2 | 1;
+	SECURITY_TOKEN Token = GetToken(*pAddr);
+	mem_copy(pPacket + 1, &ResponseToken, 4);
+	mem_copy(pPacket + 5, &Token, 4);
+	net_udp_send(m_Socket, pAddr, pPacket, DataSize + NET_CONNLESS_HEADER_SPACE);
+
+	return 0;
+}
+
 int CNetServer::SendConnlessSixup(CNetChunk *pChunk, SECURITY_TOKEN ResponseToken)
 {
-	if(pChunk->m_DataSize > NET_MAX_PACKETSIZE - 9)
+	if(pChunk->m_DataSize > NET_MAX_PACKETSIZE - NET_CONNLESS_HEADER_SPACE)
 		return -1;
 
 	unsigned char aBuffer[NET_MAX_PACKETSIZE];
-	aBuffer[0] = NET_PACKETFLAG_CONNLESS << 2 | 1;
-	SECURITY_TOKEN Token = GetToken(pChunk->m_Address);
-	mem_copy(aBuffer + 1, &ResponseToken, 4);
-	mem_copy(aBuffer + 5, &Token, 4);
-	mem_copy(aBuffer + 9, pChunk->m_pData, pChunk->m_DataSize);
-	net_udp_send(m_Socket, &pChunk->m_Address, aBuffer, pChunk->m_DataSize + 9);
+	mem_copy(aBuffer + NET_CONNLESS_HEADER_SPACE, pChunk->m_pData, pChunk->m_DataSize);
+	return SendConnlessSixupPacket(&pChunk->m_Address, aBuffer, pChunk->m_DataSize, ResponseToken);
+}
 
-	return 0;
+int CNetServer::SendConnlessInPlace(const NETADDR *pAddr, unsigned char *const *ppData, const int *pDataSizes, int Num)
+{
+	const int HEADER_SIZE = 6;
+	const void *apPackets[16];
+	int aSizes[16];
+	int Sent = 0;
+	while(Sent < Num)
+	{
+		int Batch = minimum(Num - Sent, (int)std::size(apPackets));
+		bool TooBig = false;
+		for(int i = 0; i < Batch; i++)
+		{
+			if(pDataSizes[Sent + i] >= NET_MAX_PAYLOAD)
+			{
+				dbg_msg("netserver", "packet payload too big. %d. dropping packet", pDataSizes[Sent + i]);
+				// still send the packets before it
+				Batch = i;
+				TooBig = true;
+				break;
+			}
+			unsigned char *pPacket = ppData[Sent + i] - HEADER_SIZE;
+			for(int j = 0; j < HEADER_SIZE; j++)
+				pPacket[j] = 0xff;
+			apPackets[i] = pPacket;
+			aSizes[i] = pDataSizes[Sent + i] + HEADER_SIZE;
+		}
+		const int Result = Batch > 0 ? net_udp_send_multi(m_Socket, pAddr, apPackets, aSizes, Batch) : 0;
+		Sent += Result;
+		if(TooBig || Result < Batch)
+			break;
+	}
+	return Sent;
+}
+
+int CNetServer::SendConnlessSixupInPlace(const NETADDR *pAddr, unsigned char *pData, int DataSize, SECURITY_TOKEN ResponseToken)
+{
+	return SendConnlessSixupPacket(pAddr, pData - NET_CONNLESS_HEADER_SPACE, DataSize, ResponseToken);
 }
 
 void CNetServer::SetMaxClientsPerIP(int Max)
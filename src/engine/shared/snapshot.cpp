@@ -263,6 +263,12 @@ void CSnapshotDelta::SetStaticsize(int ItemType, size_t Size)
 	m_aItemSizes[ItemType] = Size;
 }
 
+int CSnapshotDelta::GetStaticsize(int ItemType) const
+{
+	dbg_assert(ItemType >= 0 && ItemType < MAX_NETOBJSIZES, "ItemType invalid");
+	return m_aItemSizes[ItemType];
+}
+
 const CSnapshotDelta::CData *CSnapshotDelta::EmptyDelta() const
 {
 	return &m_Empty;
@@ -456,52 +462,154 @@ int CSnapshotDelta::UnpackDelta(const CSnapshot *pFrom, CSnapshot *pTo, const vo
 
 // CSnapshotStorage
 
-void CSnapshotStorage::Init()
+static size_t HolderAllocationSize(size_t DataSize, size_t AltDataSize)
+{
+	// keep the following holders aligned
+	return (sizeof(CSnapshotStorage::CHolder) + DataSize + AltDataSize + 7) & ~(size_t)7;
+}
+
+void *CSnapshotStorage::CArena::Allocate(size_t Size)
+{
+	if(m_NumHolders == 0)
+	{
+		m_Head = 0;
+		m_Tail = 0;
+	}
+
+	size_t Offset;
+	if(m_NumHolders == 0 || m_Head > m_Tail)
+	{
+		// the free space is behind the head and in front of the tail
+		if(m_Size - m_Head >= Size)
+			Offset = m_Head;
+		else if(m_Tail >= Size)
+			Offset = 0;
+		else
+			return nullptr;
+	}
+	else if(m_Tail - m_Head >= Size)
+		Offset = m_Head;
+	else
+		return nullptr;
+
+	m_Head = Offset + Size;
+	m_NumHolders++;
+	return m_pData + Offset;
+}
+
+CSnapshotStorage::CSnapshotStorage()
 {
 	m_pFirst = nullptr;
 	m_pLast = nullptr;
+	mem_zero(m_apIndex, sizeof(m_apIndex));
+	m_NumUnindexed = 0;
 }
 
-void CSnapshotStorage::PurgeAll()
+CSnapshotStorage::~CSnapshotStorage()
 {
-	CHolder *pHolder = m_pFirst;
+	for(CArena &Arena : m_vArenas)
+		free(Arena.m_pData);
+}
 
-	while(pHolder)
+void CSnapshotStorage::Init()
+{
+	PurgeAll();
+}
+
+void CSnapshotStorage::PurgeAll()
+{
+	// the newest arena is kept for the next snapshots
+	while(m_vArenas.size() > 1)
 	{
-		CHolder *pNext = pHolder->m_pNext;
-		free(pHolder);
-		pHolder = pNext;
+		m_Stats.m_ArenaBytes -= m_vArenas.front().m_Size;
+		free(m_vArenas.front().m_pData);
+		m_vArenas.erase(m_vArenas.begin());
 	}
+	if(!m_vArenas.empty())
+		m_vArenas.back().m_NumHolders = 0;
 
 	// no more snapshots in storage
 	m_pFirst = nullptr;
 	m_pLast = nullptr;
+	mem_zero(m_apIndex, sizeof(m_apIndex));
+	m_NumUnindexed = 0;
+	m_Stats.m_UsedBytes = 0;
 }
 
 void CSnapshotStorage::PurgeUntil(int Tick)
 {
-	CHolder *pHolder = m_pFirst;
-
-	while(pHolder)
+	while(m_pFirst && m_pFirst->m_Tick < Tick)
 	{
-		CHolder *pNext = pHolder->m_pNext;
-		if(pHolder->m_Tick >= Tick)
-			return; // no more to remove
-		free(pHolder);
+		CHolder *pHolder = m_pFirst;
+		m_pFirst = pHolder->m_pNext;
+		Free(pHolder);
 
-		// did we come to the end of the list?
-		if(!pNext)
-			break;
+		if(m_pFirst)
+			m_pFirst->m_pPrev = nullptr;
+		else
+			m_pLast = nullptr;
+	}
+}
 
-		m_pFirst = pNext;
-		pNext->m_pPrev = nullptr;
+CSnapshotStorage::CHolder *CSnapshotStorage::Allocate(size_t Size)
+{
+	if(!m_vArenas.empty())
+	{
+		void *pData = m_vArenas.back().Allocate(Size);
+		if(pData)
+			return (CHolder *)pData;
+	}
 
-		pHolder = pNext;
+	// the newest arena is full, use a larger one from now on and let the
+	// old ones go once their snapshots are purged
+	size_t ArenaSize = maximum((size_t)MIN_ARENA_SIZE, 4 * Size);
+	if(!m_vArenas.empty())
+	{
+		ArenaSize = maximum(ArenaSize, 2 * m_vArenas.back().m_Size);
+		if(m_vArenas.back().m_NumHolders == 0)
+		{
+			m_Stats.m_ArenaBytes -= m_vArenas.back().m_Size;
+			free(m_vArenas.back().m_pData);
+			m_vArenas.pop_back();
+		}
 	}
 
-	// no more snapshots in storage
-	m_pFirst = nullptr;
-	m_pLast = nullptr;
+	CArena Arena;
+	Arena.m_pData = (char *)malloc(ArenaSize);
+	Arena.m_Size = ArenaSize;
+	Arena.m_Head = 0;
+	Arena.m_Tail = 0;
+	Arena.m_NumHolders = 0;
+	m_vArenas.push_back(Arena);
+	m_Stats.m_NumArenaAllocations++;
+	m_Stats.m_ArenaBytes += ArenaSize;
+	return (CHolder *)m_vArenas.back().Allocate(Size);
+}
+
+void CSnapshotStorage::Free(CHolder *pHolder)
+{
+	CHolder **ppSlot = &m_apIndex[pHolder->m_Tick & (INDEX_SIZE - 1)];
+	if(*ppSlot == pHolder)
+		*ppSlot = nullptr;
+	else
+		m_NumUnindexed--;
+	m_Stats.m_UsedBytes -= HolderAllocationSize(pHolder->m_SnapSize, pHolder->m_AltSnapSize);
+
+	// holders are freed in the order they were added, so this is the
+	// oldest holder of the oldest arena
+	CArena &Arena = m_vArenas.front();
+	dbg_assert(Arena.m_pData + Arena.m_Tail == (char *)pHolder, "snapshot holders freed out of order");
+	Arena.m_NumHolders--;
+	if(Arena.m_NumHolders > 0)
+	{
+		Arena.m_Tail = (char *)pHolder->m_pNext - Arena.m_pData;
+	}
+	else if(m_vArenas.size() > 1)
+	{
+		m_Stats.m_ArenaBytes -= Arena.m_Size;
+		free(Arena.m_pData);
+		m_vArenas.erase(m_vArenas.begin());
+	}
 }
 
 void CSnapshotStorage::Add(int Tick, int64_t Tagtime, size_t DataSize, const void *pData, size_t AltDataSize, const void *pAltData)
@@ -510,8 +618,8 @@ void CSnapshotStorage::Add(int Tick, int64_t Tagtime, size_t DataSize, const voi
 	dbg_assert(AltDataSize <= (size_t)CSnapshot::MAX_SIZE, "Alt snapshot data size invalid");
 
 	// allocate memory for holder + snapshot data
-	const size_t TotalSize = sizeof(CHolder) + DataSize + AltDataSize;
-	CHolder *pHolder = (CHolder *)malloc(TotalSize);
+	const size_t TotalSize = HolderAllocationSize(DataSize, AltDataSize);
+	CHolder *pHolder = Allocate(TotalSize);
 
 	// set data
 	pHolder->m_Tick = Tick;
@@ -540,29 +648,46 @@ void CSnapshotStorage::Add(int Tick, int64_t Tagtime, size_t DataSize, const voi
 	else
 		m_pFirst = pHolder;
 	m_pLast = pHolder;
+
+	CHolder **ppSlot = &m_apIndex[Tick & (INDEX_SIZE - 1)];
+	if(*ppSlot)
+		m_NumUnindexed++;
+	else
+		*ppSlot = pHolder;
+
+	m_Stats.m_NumAdded++;
+	m_Stats.m_UsedBytes += TotalSize;
+	m_Stats.m_PeakUsedBytes = maximum(m_Stats.m_PeakUsedBytes, m_Stats.m_UsedBytes);
 }
 
 int CSnapshotStorage::Get(int Tick, int64_t *pTagtime, const CSnapshot **ppData, const CSnapshot **ppAltData)
 {
-	CHolder *pHolder = m_pFirst;
-
-	while(pHolder)
+	CHolder *pHolder = m_apIndex[Tick & (INDEX_SIZE - 1)];
+	if(!pHolder || pHolder->m_Tick != Tick)
 	{
-		if(pHolder->m_Tick == Tick)
+		pHolder = nullptr;
+		if(m_NumUnindexed > 0)
 		{
-			if(pTagtime)
-				*pTagtime = pHolder->m_Tagtime;
-			if(ppData)
-				*ppData = pHolder->m_pSnap;
-			if(ppAltData)
-				*ppAltData = pHolder->m_pAltSnap;
-			return pHolder->m_SnapSize;
+			for(CHolder *pCur = m_pFirst; pCur; pCur = pCur->m_pNext)
+			{
+				if(pCur->m_Tick == Tick)
+				{
+					pHolder = pCur;
+					break;
+				}
+			}
 		}
-
-		pHolder = pHolder->m_pNext;
 	}
-
-	return -1;
+	if(!pHolder)
+		return -1;
+
+	if(pTagtime)
+		*pTagtime = pHolder->m_Tagtime;
+	if(ppData)
+		*ppData = pHolder->m_pSnap;
+	if(ppAltData)
+		*ppAltData = pHolder->m_pAltSnap;
+	return pHolder->m_SnapSize;
 }
 
 // CSnapshotBuilder
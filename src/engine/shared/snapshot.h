@@ -5,6 +5,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <vector>
 
 // CSnapshot
 
@@ -77,11 +78,12 @@ public:
 		int m_aData[1];
 	};
 
-private:
 	enum
 	{
 		MAX_NETOBJSIZES = 64
 	};
+
+private:
 	short m_aItemSizes[MAX_NETOBJSIZES];
 	int m_aSnapshotDataRate[CSnapshot::MAX_TYPE + 1];
 	int m_aSnapshotDataUpdates[CSnapshot::MAX_TYPE + 1];
@@ -96,6 +98,7 @@ public:
 	int GetDataRate(int Index) const { return m_aSnapshotDataRate[Index]; }
 	int GetDataUpdates(int Index) const { return m_aSnapshotDataUpdates[Index]; }
 	void SetStaticsize(int ItemType, size_t Size);
+	int GetStaticsize(int ItemType) const;
 	const CData *EmptyDelta() const;
 	int CreateDelta(const CSnapshot *pFrom, const CSnapshot *pTo, void *pDstData);
 	int UnpackDelta(const CSnapshot *pFrom, CSnapshot *pTo, const void *pSrcData, int DataSize);
@@ -103,6 +106,11 @@ public:
 
 // CSnapshotStorage
 
+// Stores the snapshots of the last ticks. Snapshots are always added with
+// increasing ticks and purged from the oldest one, so their memory comes
+// from ring arenas instead of one allocation per snapshot. An arena that
+// turns out to be too small for the retention window is replaced by a
+// larger one once the snapshots in it have been purged.
 class CSnapshotStorage
 {
 public:
@@ -122,16 +130,62 @@ public:
 		CSnapshot *m_pAltSnap;
 	};
 
+	class CStats
+	{
+	public:
+		int64_t m_NumAdded = 0;
+		int m_NumArenaAllocations = 0;
+		size_t m_ArenaBytes = 0;
+		size_t m_UsedBytes = 0;
+		size_t m_PeakUsedBytes = 0;
+	};
+
 	CHolder *m_pFirst;
 	CHolder *m_pLast;
 
-	CSnapshotStorage() { Init(); }
-	~CSnapshotStorage() { PurgeAll(); }
+	CSnapshotStorage();
+	~CSnapshotStorage();
+	CSnapshotStorage(const CSnapshotStorage &Other) = delete;
+	CSnapshotStorage &operator=(const CSnapshotStorage &Other) = delete;
+
 	void Init();
 	void PurgeAll();
 	void PurgeUntil(int Tick);
 	void Add(int Tick, int64_t Tagtime, size_t DataSize, const void *pData, size_t AltDataSize, const void *pAltData);
 	int Get(int Tick, int64_t *pTagtime, const CSnapshot **ppData, const CSnapshot **ppAltData);
+
+	const CStats &Stats() const { return m_Stats; }
+
+private:
+	enum
+	{
+		// more than the ticks kept by the server and the client
+		INDEX_SIZE = 256,
+		MIN_ARENA_SIZE = 64 * 1024,
+	};
+
+	class CArena
+	{
+	public:
+		char *m_pData;
+		size_t m_Size;
+		// the used part starts at the oldest holder and wraps around the end
+		size_t m_Head;
+		size_t m_Tail;
+		int m_NumHolders;
+
+		void *Allocate(size_t Size);
+	};
+
+	// oldest first, new holders only come from the last one
+	std::vector<CArena> m_vArenas;
+	// holders by tick, a holder whose slot was taken is only found in the list
+	CHolder *m_apIndex[INDEX_SIZE];
+	int m_NumUnindexed;
+	CStats m_Stats;
+
+	CHolder *Allocate(size_t Size);
+	void Free(CHolder *pHolder);
 };
 
 class CSnapshotBuilder
@@ -12,6 +12,8 @@
 
 #include "debughud.h"
 
+using namespace std::chrono_literals;
+
 void CDebugHud::RenderNetCorrections()
 {
 	if(!g_Config.m_Debug || g_Config.m_DbgGraphs || !m_pClient->m_Snap.m_pLocalCharacter || !m_pClient->m_Snap.m_pLocalPrevCharacter)
@@ -72,6 +74,43 @@ void CDebugHud::RenderNetCorrections()
 	RenderRow(" on:", m_pClient->NetobjCorrectedOn());
 }
 
+void CDebugHud::RenderTextureCache()
+{
+	if(!g_Config.m_Debug || g_Config.m_DbgGraphs)
+		return;
+
+	const float Height = 300.0f;
+	const float Width = Height * Graphics()->ScreenAspect();
+	Graphics()->MapScreen(0.0f, 0.0f, Width, Height);
+
+	const float FontSize = 5.0f;
+	const float LineHeight = FontSize + 1.0f;
+
+	float y = Height - 4 * LineHeight - 10.0f;
+	char aBuf[128];
+	const auto &&RenderRow = [&](const char *pLabel, const char *pValue) {
+		TextRender()->Text(Width - 100.0f, y, FontSize, pLabel);
+		TextRender()->Text(Width - 10.0f - TextRender()->TextWidth(FontSize, pValue), y, FontSize, pValue);
+		y += LineHeight;
+	};
+
+	TextRender()->TextColor(TextRender()->DefaultTextColor());
+
+	const CTextureCache &TextureCache = m_pClient->m_TextureCache;
+	const int NumLoads = TextureCache.NumHits() + TextureCache.NumMisses();
+	str_format(aBuf, sizeof(aBuf), "%d/%d (%.0f%%)", TextureCache.NumHits(), NumLoads, NumLoads > 0 ? TextureCache.NumHits() * 100.0f / NumLoads : 0.0f);
+	RenderRow("Texture cache hits:", TextureCache.Enabled() ? aBuf : "disabled");
+
+	str_format(aBuf, sizeof(aBuf), "%.2fms / %.2fms", TextureCache.HitTime() / 1us / 1000.0, TextureCache.MissTime() / 1us / 1000.0);
+	RenderRow("Hit / miss time:", aBuf);
+
+	str_format(aBuf, sizeof(aBuf), "%.2fms", m_pClient->m_MapImages.LoadTime() / 1us / 1000.0);
+	RenderRow("Map images load:", aBuf);
+
+	str_format(aBuf, sizeof(aBuf), "%.2fms", m_pClient->m_MapImages.EntitiesLoadTime() / 1us / 1000.0);
+	RenderRow("Entities load:", aBuf);
+}
+
 void CDebugHud::RenderTuning()
 {
 	enum
@@ -255,5 +294,6 @@ void CDebugHud::OnRender()
 {
 	RenderTuning();
 	RenderNetCorrections();
+	RenderTextureCache();
 	RenderHint();
 }
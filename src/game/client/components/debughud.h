@@ -9,6 +9,7 @@
 class CDebugHud : public CComponent
 {
 	void RenderNetCorrections();
+	void RenderTextureCache();
 	void RenderTuning();
 	void RenderHint();
 
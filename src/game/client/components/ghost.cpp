@@ -122,6 +122,29 @@ CGhostCharacter *CGhost::CGhostPath::Get(int Index)
 	return &m_vpChunks[Chunk][Pos];
 }
 
+void CGhost::CGhostItem::Reset()
+{
+	m_Path.Reset();
+	m_StreamWindow.Reset();
+	m_pStream = nullptr;
+	m_StartTick = -1;
+	m_PlaybackPos = -1;
+}
+
+void CGhost::CGhostItem::StartStream(std::unique_ptr<IGhostLoader> &&pStream, int NumTicks)
+{
+	m_Path.Reset();
+	m_pStream = std::move(pStream);
+	m_StreamWindow.Init(m_pStream.get(), GHOSTDATA_TYPE_CHARACTER, sizeof(CGhostCharacter), NumTicks, STREAM_WINDOW_SIZE);
+}
+
+const CGhostCharacter *CGhost::CGhostItem::GetCharacter(int Index)
+{
+	if(!m_pStream)
+		return m_Path.Get(Index);
+	return static_cast<const CGhostCharacter *>(m_StreamWindow.Get(Index));
+}
+
 void CGhost::GetPath(char *pBuf, int Size, const char *pPlayerName, int Time) const
 {
 	const char *pMap = Client()->GetCurrentMap();
@@ -323,9 +346,12 @@ void CGhost::OnRender()
 			continue;
 
 		int GhostTick = Ghost.m_StartTick + PlaybackTick;
-		while(Ghost.m_PlaybackPos >= 0 && Ghost.m_Path.Get(Ghost.m_PlaybackPos)->m_Tick < GhostTick)
+		while(Ghost.m_PlaybackPos >= 0)
 		{
-			if(Ghost.m_PlaybackPos < Ghost.m_Path.Size() - 1)
+			const CGhostCharacter *pChar = Ghost.GetCharacter(Ghost.m_PlaybackPos);
+			if(pChar != nullptr && pChar->m_Tick >= GhostTick)
+				break;
+			if(pChar != nullptr && Ghost.m_PlaybackPos < Ghost.NumTicks() - 1)
 				Ghost.m_PlaybackPos++;
 			else
 				Ghost.m_PlaybackPos = -1;
@@ -336,12 +362,17 @@ void CGhost::OnRender()
 
 		int CurPos = Ghost.m_PlaybackPos;
 		int PrevPos = maximum(0, CurPos - 1);
-		if(Ghost.m_Path.Get(PrevPos)->m_Tick > GhostTick)
+		const CGhostCharacter *pPrevChar = Ghost.GetCharacter(PrevPos);
+		if(pPrevChar == nullptr || pPrevChar->m_Tick > GhostTick)
 			continue;
 
+		// streamed characters are copied before the next one is fetched
 		CNetObj_Character Player, Prev;
-		GetNetObjCharacter(&Player, Ghost.m_Path.Get(CurPos));
-		GetNetObjCharacter(&Prev, Ghost.m_Path.Get(PrevPos));
+		GetNetObjCharacter(&Prev, pPrevChar);
+		const CGhostCharacter *pCurChar = Ghost.GetCharacter(CurPos);
+		if(pCurChar == nullptr)
+			continue;
+		GetNetObjCharacter(&Player, pCurChar);
 
 		int TickDiff = Player.m_Tick - Prev.m_Tick;
 		float IntraTick = 0.f;
@@ -483,24 +514,29 @@ int CGhost::Load(const char *pFilename)
 	if(Slot == -1)
 		return -1;
 
-	if(GhostLoader()->Load(pFilename, Client()->GetCurrentMap(), Client()->GetCurrentMapSha256(), Client()->GetCurrentMapCrc()) != 0)
+	std::unique_ptr<IGhostLoader> pLoader = GhostLoader()->OpenStream(pFilename, Client()->GetCurrentMap(), Client()->GetCurrentMapSha256(), Client()->GetCurrentMapCrc());
+	if(!pLoader)
 		return -1;
 
-	const CGhostInfo *pInfo = GhostLoader()->GetInfo();
+	const CGhostInfo Info = *pLoader->GetInfo();
 
-	if(pInfo->m_NumTicks <= 0 || pInfo->m_Time <= 0)
+	if(Info.m_NumTicks <= 0 || Info.m_Time <= 0)
 	{
 		Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "ghost", "invalid header info");
-		GhostLoader()->Close();
 		return -1;
 	}
 
+	// the characters of indexed ghosts are streamed during playback,
+	// older ghosts are loaded completely
+	const bool Stream = pLoader->IsIndexed();
+
 	// select ghost
 	CGhostItem *pGhost = &m_aActiveGhosts[Slot];
 	pGhost->Reset();
-	pGhost->m_Path.SetSize(pInfo->m_NumTicks);
+	if(!Stream)
+		pGhost->m_Path.SetSize(Info.m_NumTicks);
 
-	str_copy(pGhost->m_aPlayer, pInfo->m_aOwner);
+	str_copy(pGhost->m_aPlayer, Info.m_aOwner);
 
 	int Index = 0;
 	bool FoundSkin = false;
@@ -508,9 +544,12 @@ int CGhost::Load(const char *pFilename)
 	bool Error = false;
 
 	int Type;
-	while(!Error && GhostLoader()->ReadNextType(&Type))
+	while(!Error && pLoader->ReadNextType(&Type))
 	{
-		if(Index == pInfo->m_NumTicks && (Type == GHOSTDATA_TYPE_CHARACTER || Type == GHOSTDATA_TYPE_CHARACTER_NO_TICK))
+		if(Stream && (Type == GHOSTDATA_TYPE_CHARACTER || Type == GHOSTDATA_TYPE_CHARACTER_NO_TICK))
+			break;
+
+		if(Index == Info.m_NumTicks && (Type == GHOSTDATA_TYPE_CHARACTER || Type == GHOSTDATA_TYPE_CHARACTER_NO_TICK))
 		{
 			Error = true;
 			break;
@@ -519,30 +558,36 @@ int CGhost::Load(const char *pFilename)
 		if(Type == GHOSTDATA_TYPE_SKIN && !FoundSkin)
 		{
 			FoundSkin = true;
-			if(!GhostLoader()->ReadData(Type, &pGhost->m_Skin, sizeof(CGhostSkin)))
+			if(!pLoader->ReadData(Type, &pGhost->m_Skin, sizeof(CGhostSkin)))
 				Error = true;
 		}
 		else if(Type == GHOSTDATA_TYPE_CHARACTER_NO_TICK)
 		{
 			NoTick = true;
-			if(!GhostLoader()->ReadData(Type, pGhost->m_Path.Get(Index++), sizeof(CGhostCharacter_NoTick)))
+			if(!pLoader->ReadData(Type, pGhost->m_Path.Get(Index++), sizeof(CGhostCharacter_NoTick)))
 				Error = true;
 		}
 		else if(Type == GHOSTDATA_TYPE_CHARACTER)
 		{
-			if(!GhostLoader()->ReadData(Type, pGhost->m_Path.Get(Index++), sizeof(CGhostCharacter)))
+			if(!pLoader->ReadData(Type, pGhost->m_Path.Get(Index++), sizeof(CGhostCharacter)))
 				Error = true;
 		}
 		else if(Type == GHOSTDATA_TYPE_START_TICK)
 		{
-			if(!GhostLoader()->ReadData(Type, &pGhost->m_StartTick, sizeof(int)))
+			if(!pLoader->ReadData(Type, &pGhost->m_StartTick, sizeof(int)))
 				Error = true;
 		}
 	}
 
-	GhostLoader()->Close();
+	if(Stream && !Error)
+	{
+		pGhost->StartStream(std::move(pLoader), Info.m_NumTicks);
+		// fetch the first characters right away to check the data
+		if(pGhost->GetCharacter(0) != nullptr)
+			Index = Info.m_NumTicks;
+	}
 
-	if(Error || Index != pInfo->m_NumTicks)
+	if(Error || Index != Info.m_NumTicks)
 	{
 		Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "ghost", "invalid ghost data");
 		pGhost->Reset();
@@ -552,15 +597,15 @@ int CGhost::Load(const char *pFilename)
 	if(NoTick)
 	{
 		int StartTick = 0;
-		for(int i = 1; i < pInfo->m_NumTicks; i++) // estimate start tick
+		for(int i = 1; i < Info.m_NumTicks; i++) // estimate start tick
 			if(pGhost->m_Path.Get(i)->m_AttackTick != pGhost->m_Path.Get(i - 1)->m_AttackTick)
 				StartTick = pGhost->m_Path.Get(i)->m_AttackTick - i;
-		for(int i = 0; i < pInfo->m_NumTicks; i++)
+		for(int i = 0; i < Info.m_NumTicks; i++)
 			pGhost->m_Path.Get(i)->m_Tick = StartTick + i;
 	}
 
 	if(pGhost->m_StartTick == -1)
-		pGhost->m_StartTick = pGhost->m_Path.Get(0)->m_Tick;
+		pGhost->m_StartTick = pGhost->GetCharacter(0)->m_Tick;
 
 	if(!FoundSkin)
 		GetGhostSkin(&pGhost->m_Skin, "default", 0, 0, 0);
@@ -3,12 +3,17 @@
 #ifndef GAME_CLIENT_COMPONENTS_GHOST_H
 #define GAME_CLIENT_COMPONENTS_GHOST_H
 
+#include <engine/ghost.h>
+
 #include <game/client/component.h>
 #include <game/client/components/menus.h>
 #include <game/generated/protocol.h>
 
 #include <game/client/render.h>
 
+#include <memory>
+#include <vector>
+
 struct CNetObj_Character;
 
 enum
@@ -86,6 +91,15 @@ private:
 
 	class CGhostItem
 	{
+		enum
+		{
+			STREAM_WINDOW_SIZE = 25 * 10, // ten seconds with default snap rate
+		};
+
+		// characters of a ghost streamed from its file
+		std::unique_ptr<IGhostLoader> m_pStream;
+		CGhostItemWindow m_StreamWindow;
+
 	public:
 		CTeeRenderInfo m_RenderInfo;
 		CGhostSkin m_Skin;
@@ -96,13 +110,14 @@ private:
 
 		CGhostItem() { Reset(); }
 
-		bool Empty() const { return m_Path.Size() == 0; }
-		void Reset()
-		{
-			m_Path.Reset();
-			m_StartTick = -1;
-			m_PlaybackPos = -1;
-		}
+		bool Empty() const { return m_Path.Size() == 0 && !m_pStream; }
+		void Reset();
+
+		void StartStream(std::unique_ptr<IGhostLoader> &&pStream, int NumTicks);
+		bool Streamed() const { return m_pStream != nullptr; }
+		int NumTicks() const { return Streamed() ? m_StreamWindow.NumItems() : m_Path.Size(); }
+		// the returned character is only valid until the next call
+		const CGhostCharacter *GetCharacter(int Index);
 	};
 
 	static const char *ms_pGhostDir;
@@ -101,6 +101,7 @@ void CMapImages::OnMapLoadImpl(class CLayers *pLayers, IMap *pMap)
 		}
 	}
 
+	const std::chrono::nanoseconds LoadStart = time_get_nanoseconds();
 	const int TextureLoadFlag = Graphics()->Uses2DTextureArrays() ? IGraphics::TEXLOAD_TO_2D_ARRAY_TEXTURE : IGraphics::TEXLOAD_TO_3D_TEXTURE;
 
 	// load new textures
@@ -127,7 +128,14 @@ void CMapImages::OnMapLoadImpl(class CLayers *pLayers, IMap *pMap)
 		{
 			char aPath[IO_MAX_PATH_LENGTH];
 			str_format(aPath, sizeof(aPath), "mapres/%s.png", pName);
-			m_aTextures[i] = Graphics()->LoadTexture(aPath, IStorage::TYPE_ALL, LoadFlag);
+			CTextureCache::CImage ImgInfo;
+			if(TextureCache()->LoadPNG(Graphics(), aPath, IStorage::TYPE_ALL, &ImgInfo))
+			{
+				m_aTextures[i] = Graphics()->LoadTextureRaw(ImgInfo.m_Width, ImgInfo.m_Height, ImgInfo.m_Format, ImgInfo.m_pData, LoadFlag, aPath);
+				TextureCache()->Free(Graphics(), &ImgInfo);
+			}
+			if(!m_aTextures[i].IsValid())
+				m_aTextures[i] = Graphics()->NullTexture();
 		}
 		else if(Format == CImageInfo::FORMAT_RGBA)
 		{
@@ -140,12 +148,18 @@ void CMapImages::OnMapLoadImpl(class CLayers *pLayers, IMap *pMap)
 		pMap->UnloadData(pImg->m_ImageName);
 		ShowWarning = ShowWarning || m_aTextures[i].IsNullTexture();
 	}
+	m_LoadTime = time_get_nanoseconds() - LoadStart;
 	if(ShowWarning)
 	{
 		Client()->AddWarning(SWarning(Localize("Some map images could not be loaded. Check the local console for details.")));
 	}
 }
 
+CTextureCache *CMapImages::TextureCache()
+{
+	return &GameClient()->m_TextureCache;
+}
+
 void CMapImages::OnMapLoad()
 {
 	IMap *pMap = Kernel()->RequestInterface<IMap>();
@@ -223,9 +237,10 @@ IGraphics::CTextureHandle CMapImages::GetEntities(EMapImageEntityLayerType Entit
 		if(Graphics()->HasTextureArraysSupport())
 			TextureLoadFlag = (Graphics()->Uses2DTextureArrays() ? IGraphics::TEXLOAD_TO_2D_ARRAY_TEXTURE : IGraphics::TEXLOAD_TO_3D_TEXTURE) | IGraphics::TEXLOAD_NO_2D_TEXTURE;
 
-		CImageInfo ImgInfo;
+		const std::chrono::nanoseconds LoadStart = time_get_nanoseconds();
+		CTextureCache::CImage ImgInfo;
 		bool ImagePNGLoaded = false;
-		if(Graphics()->LoadPNG(&ImgInfo, aPath, IStorage::TYPE_ALL))
+		if(TextureCache()->LoadPNG(Graphics(), aPath, IStorage::TYPE_ALL, &ImgInfo))
 			ImagePNGLoaded = true;
 		else
 		{
@@ -234,7 +249,7 @@ IGraphics::CTextureHandle CMapImages::GetEntities(EMapImageEntityLayerType Entit
 			if(EntitiesModType == MAP_IMAGE_MOD_TYPE_DDNET)
 			{
 				str_format(aPath, sizeof(aPath), "%s.png", m_aEntitiesPath);
-				if(Graphics()->LoadPNG(&ImgInfo, aPath, IStorage::TYPE_ALL))
+				if(TextureCache()->LoadPNG(Graphics(), aPath, IStorage::TYPE_ALL, &ImgInfo))
 				{
 					ImagePNGLoaded = true;
 					TryDefault = false;
@@ -245,7 +260,7 @@ IGraphics::CTextureHandle CMapImages::GetEntities(EMapImageEntityLayerType Entit
 			{
 				// try default
 				str_format(aPath, sizeof(aPath), "editor/entities_clear/%s.png", gs_apModEntitiesNames[EntitiesModType]);
-				if(Graphics()->LoadPNG(&ImgInfo, aPath, IStorage::TYPE_ALL))
+				if(TextureCache()->LoadPNG(Graphics(), aPath, IStorage::TYPE_ALL, &ImgInfo))
 				{
 					ImagePNGLoaded = true;
 				}
@@ -258,7 +273,7 @@ IGraphics::CTextureHandle CMapImages::GetEntities(EMapImageEntityLayerType Entit
 			const size_t BuildImageSize = (size_t)ImgInfo.m_Width * ImgInfo.m_Height * PixelSize;
 
 			uint8_t *pTmpImgData = (uint8_t *)ImgInfo.m_pData;
-			uint8_t *pBuildImgData = (uint8_t *)malloc(BuildImageSize);
+			uint8_t *pBuildImgData = nullptr;
 
 			// build game layer
 			for(int n = 0; n < MAP_IMAGE_ENTITY_LAYER_TYPE_COUNT; ++n)
@@ -272,6 +287,20 @@ IGraphics::CTextureHandle CMapImages::GetEntities(EMapImageEntityLayerType Entit
 
 				dbg_assert(!m_aaEntitiesTextures[(EntitiesModType * 2) + (int)EntitiesAreMasked][n].IsValid(), "entities texture already loaded when it should not be");
 
+				// the layers only depend on the image and the mod, so they are cached as well
+				char aVariant[64];
+				str_format(aVariant, sizeof(aVariant), "entities-v1 %s %d %d", gs_apModEntitiesNames[EntitiesModType], (int)EntitiesAreMasked, n);
+				CTextureCache::CImage CachedLayer;
+				if(BuildThisLayer && TextureCache()->LoadVariant(ImgInfo, aVariant, &CachedLayer))
+				{
+					m_aaEntitiesTextures[(EntitiesModType * 2) + (int)EntitiesAreMasked][n] = Graphics()->LoadTextureRaw(CachedLayer.m_Width, CachedLayer.m_Height, CachedLayer.m_Format, CachedLayer.m_pData, TextureLoadFlag, aPath);
+					TextureCache()->Free(Graphics(), &CachedLayer);
+					continue;
+				}
+
+				if(pBuildImgData == nullptr && (BuildThisLayer || !m_TransparentTexture.IsValid()))
+					pBuildImgData = (uint8_t *)malloc(BuildImageSize);
+
 				if(BuildThisLayer)
 				{
 					// set everything transparent
@@ -328,6 +357,10 @@ IGraphics::CTextureHandle CMapImages::GetEntities(EMapImageEntityLayerType Entit
 						}
 					}
 
+					CImageInfo BuildImgInfo = ImgInfo;
+					BuildImgInfo.m_pData = pBuildImgData;
+					TextureCache()->StoreVariant(ImgInfo, aVariant, BuildImgInfo);
+
 					m_aaEntitiesTextures[(EntitiesModType * 2) + (int)EntitiesAreMasked][n] = Graphics()->LoadTextureRaw(ImgInfo.m_Width, ImgInfo.m_Height, ImgInfo.m_Format, pBuildImgData, TextureLoadFlag, aPath);
 				}
 				else
@@ -345,8 +378,9 @@ IGraphics::CTextureHandle CMapImages::GetEntities(EMapImageEntityLayerType Entit
 
 			free(pBuildImgData);
 
-			Graphics()->FreePNG(&ImgInfo);
+			TextureCache()->Free(Graphics(), &ImgInfo);
 		}
+		m_EntitiesLoadTime += time_get_nanoseconds() - LoadStart;
 	}
 
 	return m_aaEntitiesTextures[(EntitiesModType * 2) + (int)EntitiesAreMasked][EntityLayerType];
@@ -8,6 +8,8 @@
 #include <game/client/component.h>
 #include <game/mapitems.h>
 
+#include <chrono>
+
 enum EMapImageEntityLayerType
 {
 	MAP_IMAGE_ENTITY_LAYER_TYPE_ALL_EXCEPT_SWITCH = 0,
@@ -48,6 +50,8 @@ class CMapImages : public CComponent
 	bool HasTeleLayer(EMapImageModType ModType);
 	bool HasTuneLayer(EMapImageModType ModType);
 
+	class CTextureCache *TextureCache();
+
 public:
 	CMapImages();
 	CMapImages(int TextureSize);
@@ -74,6 +78,9 @@ public:
 
 	void ChangeEntitiesPath(const char *pPath);
 
+	std::chrono::nanoseconds LoadTime() const { return m_LoadTime; }
+	std::chrono::nanoseconds EntitiesLoadTime() const { return m_EntitiesLoadTime; }
+
 private:
 	bool m_aEntitiesIsLoaded[MAP_IMAGE_MOD_TYPE_COUNT * 2];
 	bool m_SpeedupArrowIsLoaded;
@@ -84,6 +91,8 @@ private:
 	IGraphics::CTextureHandle m_OverlayCenterTexture;
 	IGraphics::CTextureHandle m_TransparentTexture;
 	int m_TextureScale;
+	std::chrono::nanoseconds m_LoadTime{0};
+	std::chrono::nanoseconds m_EntitiesLoadTime{0};
 
 	void InitOverlayTextures();
 	IGraphics::CTextureHandle UploadEntityLayerText(int TextureSize, int MaxWidth, int YOffset);
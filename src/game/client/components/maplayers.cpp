@@ -1,10 +1,16 @@
 /* (c) Magnus Auvinen. See licence.txt in the root of the distribution for more information. */
 /* If you are missing that file, acquire a complete release at teeworlds.com.                */
+#include <base/lock.h>
+#include <base/log.h>
+#include <base/tl/threading.h>
+
 #include <engine/demo.h>
+#include <engine/engine.h>
 #include <engine/graphics.h>
 #include <engine/keys.h>
 #include <engine/serverbrowser.h>
 #include <engine/shared/config.h>
+#include <engine/shared/jobs.h>
 #include <engine/storage.h>
 
 #include <game/client/gameclient.h>
@@ -20,10 +26,14 @@
 
 #include "maplayers.h"
 
+#include <atomic>
 #include <chrono>
 
 using namespace std::chrono_literals;
 
+// shared by all map layers, the time of envelopes which are not synchronized
+static std::chrono::nanoseconds s_EnvelopeTime{0};
+
 CMapLayers::CMapLayers(int t, bool OnlineOnly)
 {
 	m_Type = t;
@@ -69,15 +79,16 @@ void CMapLayers::EnvelopeEval(int TimeOffsetMillis, int Env, ColorRGBA &Channels
 
 	const CMapItemEnvelope *pItem = (CMapItemEnvelope *)pThis->m_pLayers->Map()->GetItem(EnvStart + Env);
 
-	CMapBasedEnvelopePointAccess EnvelopePoints(pThis->m_pLayers->Map());
+	// finding the envelope points scans all envelopes, only do it once per map
+	if(!pThis->m_pEnvelopePoints)
+		pThis->m_pEnvelopePoints = std::make_unique<CMapBasedEnvelopePointAccess>(pThis->m_pLayers->Map());
+	CMapBasedEnvelopePointAccess &EnvelopePoints = *pThis->m_pEnvelopePoints;
 	EnvelopePoints.SetPointsRange(pItem->m_StartPoint, pItem->m_NumPoints);
 	if(EnvelopePoints.NumPoints() == 0)
 		return;
 
 	const auto TickToNanoSeconds = std::chrono::nanoseconds(1s) / (int64_t)pThis->Client()->GameTickSpeed();
 
-	static std::chrono::nanoseconds s_Time{0};
-	static auto s_LastLocalTime = time_get_nanoseconds();
 	if(pThis->Client()->State() == IClient::STATE_DEMOPLAYBACK)
 	{
 		const IDemoPlayer::CInfo *pInfo = pThis->DemoPlayer()->BaseInfo();
@@ -96,25 +107,25 @@ void CMapLayers::EnvelopeEval(int TimeOffsetMillis, int Env, ColorRGBA &Channels
 					// get the lerp of the current tick and prev
 					int MinTick = pThis->Client()->PrevGameTick(g_Config.m_ClDummy) - pThis->m_pClient->m_Snap.m_pGameInfoObj->m_RoundStartTick;
 					int CurTick = pThis->Client()->GameTick(g_Config.m_ClDummy) - pThis->m_pClient->m_Snap.m_pGameInfoObj->m_RoundStartTick;
-					s_Time = std::chrono::nanoseconds((int64_t)(mix<double>(
-											    0,
-											    (CurTick - MinTick),
-											    (double)pThis->Client()->IntraGameTick(g_Config.m_ClDummy)) *
-										    TickToNanoSeconds.count())) +
-						 MinTick * TickToNanoSeconds;
+					s_EnvelopeTime = std::chrono::nanoseconds((int64_t)(mix<double>(
+											            0,
+											            (CurTick - MinTick),
+											            (double)pThis->Client()->IntraGameTick(g_Config.m_ClDummy)) *
+										            TickToNanoSeconds.count())) +
+						         MinTick * TickToNanoSeconds;
 				}
 			}
 			else
 			{
 				int MinTick = pThis->m_LastLocalTick;
-				s_Time = std::chrono::nanoseconds((int64_t)(mix<double>(0,
-										    pThis->m_CurrentLocalTick - MinTick,
-										    (double)pThis->Client()->IntraGameTick(g_Config.m_ClDummy)) *
-									    TickToNanoSeconds.count())) +
-					 MinTick * TickToNanoSeconds;
+				s_EnvelopeTime = std::chrono::nanoseconds((int64_t)(mix<double>(0,
+										            pThis->m_CurrentLocalTick - MinTick,
+										            (double)pThis->Client()->IntraGameTick(g_Config.m_ClDummy)) *
+									            TickToNanoSeconds.count())) +
+					         MinTick * TickToNanoSeconds;
 			}
 		}
-		CRenderTools::RenderEvalEnvelope(&EnvelopePoints, 4, s_Time + (int64_t)TimeOffsetMillis * std::chrono::nanoseconds(1ms), Channels);
+		pThis->EvalEnvelopeCached(Env, TimeOffsetMillis, s_EnvelopeTime + (int64_t)TimeOffsetMillis * std::chrono::nanoseconds(1ms), Channels);
 	}
 	else
 	{
@@ -125,24 +136,43 @@ void CMapLayers::EnvelopeEval(int TimeOffsetMillis, int Env, ColorRGBA &Channels
 				// get the lerp of the current tick and prev
 				int MinTick = pThis->Client()->PrevGameTick(g_Config.m_ClDummy) - pThis->m_pClient->m_Snap.m_pGameInfoObj->m_RoundStartTick;
 				int CurTick = pThis->Client()->GameTick(g_Config.m_ClDummy) - pThis->m_pClient->m_Snap.m_pGameInfoObj->m_RoundStartTick;
-				s_Time = std::chrono::nanoseconds((int64_t)(mix<double>(
-										    0,
-										    (CurTick - MinTick),
-										    (double)pThis->Client()->IntraGameTick(g_Config.m_ClDummy)) *
-									    TickToNanoSeconds.count())) +
-					 MinTick * TickToNanoSeconds;
+				s_EnvelopeTime = std::chrono::nanoseconds((int64_t)(mix<double>(
+										            0,
+										            (CurTick - MinTick),
+										            (double)pThis->Client()->IntraGameTick(g_Config.m_ClDummy)) *
+									            TickToNanoSeconds.count())) +
+					         MinTick * TickToNanoSeconds;
 			}
 		}
-		else
-		{
-			auto CurTime = time_get_nanoseconds();
-			s_Time += CurTime - s_LastLocalTime;
-			s_LastLocalTime = CurTime;
-		}
-		CRenderTools::RenderEvalEnvelope(&EnvelopePoints, 4, s_Time + std::chrono::nanoseconds(std::chrono::milliseconds(TimeOffsetMillis)), Channels);
+		// else the local time advanced by UpdateLocalEnvelopeTime is used
+		pThis->EvalEnvelopeCached(Env, TimeOffsetMillis, s_EnvelopeTime + std::chrono::nanoseconds(std::chrono::milliseconds(TimeOffsetMillis)), Channels);
 	}
 }
 
+void CMapLayers::UpdateLocalEnvelopeTime()
+{
+	// advanced once per render instead of for every evaluation, so all
+	// quads of a frame sharing an envelope and offset get the same result
+	static auto s_LastLocalTime = time_get_nanoseconds();
+	const auto CurTime = time_get_nanoseconds();
+	if(Client()->State() != IClient::STATE_DEMOPLAYBACK)
+		s_EnvelopeTime += CurTime - s_LastLocalTime;
+	s_LastLocalTime = CurTime;
+}
+
+void CMapLayers::EvalEnvelopeCached(int Env, int TimeOffsetMillis, std::chrono::nanoseconds Time, ColorRGBA &Channels)
+{
+	SEnvelopeCacheEntry &Entry = m_EnvelopeCache[((uint64_t)(uint32_t)Env << 32) | (uint32_t)TimeOffsetMillis];
+	if(!Entry.m_Valid || Entry.m_Time != Time)
+	{
+		Entry.m_Valid = true;
+		Entry.m_Time = Time;
+		Entry.m_Channels = ColorRGBA();
+		CRenderTools::RenderEvalEnvelope(m_pEnvelopePoints.get(), 4, Time, Entry.m_Channels);
+	}
+	Channels = Entry.m_Channels;
+}
+
 void FillTmpTile(SGraphicTile *pTmpTile, SGraphicTileTexureCoords *pTmpTex, unsigned char Flags, unsigned char Index, int x, int y, const ivec2 &Offset, int Scale, CMapItemGroup *pGroup)
 {
 	if(pTmpTex)
@@ -306,6 +336,367 @@ void mem_copy_special(void *pDest, void *pSource, size_t Size, size_t Count, siz
 	}
 }
 
+// Scratch vectors for building the vertices of one tile layer, handed from
+// one layer to the next during a map load so they don't grow for every layer
+struct STileLayerScratch
+{
+	std::vector<SGraphicTile> m_vTiles;
+	std::vector<SGraphicTileTexureCoords> m_vTileTexCoords;
+	std::vector<SGraphicTile> m_vBorderTopTiles;
+	std::vector<SGraphicTileTexureCoords> m_vBorderTopTilesTexCoords;
+	std::vector<SGraphicTile> m_vBorderLeftTiles;
+	std::vector<SGraphicTileTexureCoords> m_vBorderLeftTilesTexCoords;
+	std::vector<SGraphicTile> m_vBorderRightTiles;
+	std::vector<SGraphicTileTexureCoords> m_vBorderRightTilesTexCoords;
+	std::vector<SGraphicTile> m_vBorderBottomTiles;
+	std::vector<SGraphicTileTexureCoords> m_vBorderBottomTilesTexCoords;
+	std::vector<SGraphicTile> m_vBorderCorners;
+	std::vector<SGraphicTileTexureCoords> m_vBorderCornersTexCoords;
+};
+
+class CTileLayerScratchPool
+{
+	CLock m_Lock;
+	std::vector<std::unique_ptr<STileLayerScratch>> m_vpScratch GUARDED_BY(m_Lock);
+
+public:
+	std::unique_ptr<STileLayerScratch> Get() REQUIRES(!m_Lock)
+	{
+		CLockScope ls(m_Lock);
+		if(m_vpScratch.empty())
+			return std::make_unique<STileLayerScratch>();
+		std::unique_ptr<STileLayerScratch> pScratch = std::move(m_vpScratch.back());
+		m_vpScratch.pop_back();
+		return pScratch;
+	}
+
+	void Put(std::unique_ptr<STileLayerScratch> pScratch) REQUIRES(!m_Lock)
+	{
+		CLockScope ls(m_Lock);
+		m_vpScratch.push_back(std::move(pScratch));
+	}
+};
+
+// Builds the vertices of one tile layer (or one overlay of an entity layer)
+// on the job pool, the buffers are created from them on the main thread.
+class CMapLayers::CTileLayerBuildJob : public IJob
+{
+	CTileLayerScratchPool *m_pScratchPool;
+	CSemaphore *m_pFinished;
+
+	void Run() override;
+
+public:
+	STileLayerVisuals *m_pVisuals;
+	CMapItemLayerTilemap *m_pTMap;
+	CMapItemGroup *m_pGroup;
+	void *m_pTiles;
+	int m_CurOverlay;
+	bool m_DoTextureCoords;
+	bool m_IsEntityLayer;
+	bool m_IsGameLayer;
+	bool m_IsFrontLayer;
+	bool m_IsSwitchLayer;
+	bool m_IsTeleLayer;
+	bool m_IsSpeedupLayer;
+	bool m_IsTuneLayer;
+
+	char *m_pUploadData = nullptr;
+	size_t m_UploadDataSize = 0;
+	size_t m_NumTiles = 0;
+	std::atomic<bool> m_Finished{false};
+
+	// `pFinished` is signalled once per finished job
+	CTileLayerBuildJob(CTileLayerScratchPool *pScratchPool, CSemaphore *pFinished) :
+		m_pScratchPool(pScratchPool), m_pFinished(pFinished) {}
+	~CTileLayerBuildJob() { free(m_pUploadData); }
+};
+
+void CMapLayers::CTileLayerBuildJob::Run()
+{
+	std::unique_ptr<STileLayerScratch> pScratch = m_pScratchPool->Get();
+	std::vector<SGraphicTile> &vtmpTiles = pScratch->m_vTiles;
+	std::vector<SGraphicTileTexureCoords> &vtmpTileTexCoords = pScratch->m_vTileTexCoords;
+	std::vector<SGraphicTile> &vtmpBorderTopTiles = pScratch->m_vBorderTopTiles;
+	std::vector<SGraphicTileTexureCoords> &vtmpBorderTopTilesTexCoords = pScratch->m_vBorderTopTilesTexCoords;
+	std::vector<SGraphicTile> &vtmpBorderLeftTiles = pScratch->m_vBorderLeftTiles;
+	std::vector<SGraphicTileTexureCoords> &vtmpBorderLeftTilesTexCoords = pScratch->m_vBorderLeftTilesTexCoords;
+	std::vector<SGraphicTile> &vtmpBorderRightTiles = pScratch->m_vBorderRightTiles;
+	std::vector<SGraphicTileTexureCoords> &vtmpBorderRightTilesTexCoords = pScratch->m_vBorderRightTilesTexCoords;
+	std::vector<SGraphicTile> &vtmpBorderBottomTiles = pScratch->m_vBorderBottomTiles;
+	std::vector<SGraphicTileTexureCoords> &vtmpBorderBottomTilesTexCoords = pScratch->m_vBorderBottomTilesTexCoords;
+	std::vector<SGraphicTile> &vtmpBorderCorners = pScratch->m_vBorderCorners;
+	std::vector<SGraphicTileTexureCoords> &vtmpBorderCornersTexCoords = pScratch->m_vBorderCornersTexCoords;
+
+	STileLayerVisuals &Visuals = *m_pVisuals;
+	CMapItemLayerTilemap *pTMap = m_pTMap;
+	CMapItemGroup *pGroup = m_pGroup;
+	void *pTiles = m_pTiles;
+	const int CurOverlay = m_CurOverlay;
+	const bool DoTextureCoords = m_DoTextureCoords;
+	const bool IsEntityLayer = m_IsEntityLayer;
+	const bool IsGameLayer = m_IsGameLayer;
+	const bool IsFrontLayer = m_IsFrontLayer;
+	const bool IsSwitchLayer = m_IsSwitchLayer;
+	const bool IsTeleLayer = m_IsTeleLayer;
+	const bool IsSpeedupLayer = m_IsSpeedupLayer;
+	const bool IsTuneLayer = m_IsTuneLayer;
+
+	vtmpTiles.clear();
+	vtmpTileTexCoords.clear();
+
+	vtmpBorderTopTiles.clear();
+	vtmpBorderLeftTiles.clear();
+	vtmpBorderRightTiles.clear();
+	vtmpBorderBottomTiles.clear();
+	vtmpBorderCorners.clear();
+	vtmpBorderTopTilesTexCoords.clear();
+	vtmpBorderLeftTilesTexCoords.clear();
+	vtmpBorderRightTilesTexCoords.clear();
+	vtmpBorderBottomTilesTexCoords.clear();
+	vtmpBorderCornersTexCoords.clear();
+
+	if(!DoTextureCoords)
+	{
+		vtmpTiles.reserve((size_t)pTMap->m_Width * pTMap->m_Height);
+		vtmpBorderTopTiles.reserve((size_t)pTMap->m_Width);
+		vtmpBorderBottomTiles.reserve((size_t)pTMap->m_Width);
+		vtmpBorderLeftTiles.reserve((size_t)pTMap->m_Height);
+		vtmpBorderRightTiles.reserve((size_t)pTMap->m_Height);
+		vtmpBorderCorners.reserve((size_t)4);
+	}
+	else
+	{
+		vtmpTileTexCoords.reserve((size_t)pTMap->m_Width * pTMap->m_Height);
+		vtmpBorderTopTilesTexCoords.reserve((size_t)pTMap->m_Width);
+		vtmpBorderBottomTilesTexCoords.reserve((size_t)pTMap->m_Width);
+		vtmpBorderLeftTilesTexCoords.reserve((size_t)pTMap->m_Height);
+		vtmpBorderRightTilesTexCoords.reserve((size_t)pTMap->m_Height);
+		vtmpBorderCornersTexCoords.reserve((size_t)4);
+	}
+
+	int x = 0;
+	int y = 0;
+	for(y = 0; y < pTMap->m_Height; ++y)
+	{
+		for(x = 0; x < pTMap->m_Width; ++x)
+		{
+			unsigned char Index = 0;
+			unsigned char Flags = 0;
+			int AngleRotate = -1;
+			if(IsEntityLayer)
+			{
+				if(IsGameLayer)
+				{
+					Index = ((CTile *)pTiles)[y * pTMap->m_Width + x].m_Index;
+					Flags = ((CTile *)pTiles)[y * pTMap->m_Width + x].m_Flags;
+				}
+				if(IsFrontLayer)
+				{
+					Index = ((CTile *)pTiles)[y * pTMap->m_Width + x].m_Index;
+					Flags = ((CTile *)pTiles)[y * pTMap->m_Width + x].m_Flags;
+				}
+				if(IsSwitchLayer)
+				{
+					Flags = 0;
+					Index = ((CSwitchTile *)pTiles)[y * pTMap->m_Width + x].m_Type;
+					if(CurOverlay == 0)
+					{
+						Flags = ((CSwitchTile *)pTiles)[y * pTMap->m_Width + x].m_Flags;
+						if(Index == TILE_SWITCHTIMEDOPEN)
+							Index = 8;
+					}
+					else if(CurOverlay == 1)
+						Index = ((CSwitchTile *)pTiles)[y * pTMap->m_Width + x].m_Number;
+					else if(CurOverlay == 2)
+						Index = ((CSwitchTile *)pTiles)[y * pTMap->m_Width + x].m_Delay;
+				}
+				if(IsTeleLayer)
+				{
+					Index = ((CTeleTile *)pTiles)[y * pTMap->m_Width + x].m_Type;
+					Flags = 0;
+					if(CurOverlay == 1)
+					{
+						if(IsTeleTileNumberUsed(Index))
+							Index = ((CTeleTile *)pTiles)[y * pTMap->m_Width + x].m_Number;
+						else
+							Index = 0;
+					}
+				}
+				if(IsSpeedupLayer)
+				{
+					Index = ((CSpeedupTile *)pTiles)[y * pTMap->m_Width + x].m_Type;
+					Flags = 0;
+					AngleRotate = ((CSpeedupTile *)pTiles)[y * pTMap->m_Width + x].m_Angle;
+					if(((CSpeedupTile *)pTiles)[y * pTMap->m_Width + x].m_Force == 0)
+						Index = 0;
+					else if(CurOverlay == 1)
+						Index = ((CSpeedupTile *)pTiles)[y * pTMap->m_Width + x].m_Force;
+					else if(CurOverlay == 2)
+						Index = ((CSpeedupTile *)pTiles)[y * pTMap->m_Width + x].m_MaxSpeed;
+				}
+				if(IsTuneLayer)
+				{
+					Index = ((CTuneTile *)pTiles)[y * pTMap->m_Width + x].m_Type;
+					Flags = 0;
+				}
+			}
+			else
+			{
+				Index = ((CTile *)pTiles)[y * pTMap->m_Width + x].m_Index;
+				Flags = ((CTile *)pTiles)[y * pTMap->m_Width + x].m_Flags;
+			}
+
+			//the amount of tiles handled before this tile
+			int TilesHandledCount = vtmpTiles.size();
+			Visuals.m_pTilesOfLayer[y * pTMap->m_Width + x].SetIndexBufferByteOffset((offset_ptr32)(TilesHandledCount));
+
+			bool AddAsSpeedup = false;
+			if(IsSpeedupLayer && CurOverlay == 0)
+				AddAsSpeedup = true;
+
+			if(AddTile(vtmpTiles, vtmpTileTexCoords, Index, Flags, x, y, pGroup, DoTextureCoords, AddAsSpeedup, AngleRotate))
+				Visuals.m_pTilesOfLayer[y * pTMap->m_Width + x].Draw(true);
+
+			//do the border tiles
+			if(x == 0)
+			{
+				if(y == 0)
+				{
+					Visuals.m_BorderTopLeft.SetIndexBufferByteOffset((offset_ptr32)(vtmpBorderCorners.size()));
+					if(AddTile(vtmpBorderCorners, vtmpBorderCornersTexCoords, Index, Flags, 0, 0, pGroup, DoTextureCoords, AddAsSpeedup, AngleRotate, ivec2{-32, -32}))
+						Visuals.m_BorderTopLeft.Draw(true);
+				}
+				else if(y == pTMap->m_Height - 1)
+				{
+					Visuals.m_BorderBottomLeft.SetIndexBufferByteOffset((offset_ptr32)(vtmpBorderCorners.size()));
+					if(AddTile(vtmpBorderCorners, vtmpBorderCornersTexCoords, Index, Flags, 0, 0, pGroup, DoTextureCoords, AddAsSpeedup, AngleRotate, ivec2{-32, 0}))
+						Visuals.m_BorderBottomLeft.Draw(true);
+				}
+				Visuals.m_vBorderLeft[y].SetIndexBufferByteOffset((offset_ptr32)(vtmpBorderLeftTiles.size()));
+				if(AddTile(vtmpBorderLeftTiles, vtmpBorderLeftTilesTexCoords, Index, Flags, 0, y, pGroup, DoTextureCoords, AddAsSpeedup, AngleRotate, ivec2{-32, 0}))
+					Visuals.m_vBorderLeft[y].Draw(true);
+			}
+			else if(x == pTMap->m_Width - 1)
+			{
+				if(y == 0)
+				{
+					Visuals.m_BorderTopRight.SetIndexBufferByteOffset((offset_ptr32)(vtmpBorderCorners.size()));
+					if(AddTile(vtmpBorderCorners, vtmpBorderCornersTexCoords, Index, Flags, 0, 0, pGroup, DoTextureCoords, AddAsSpeedup, AngleRotate, ivec2{0, -32}))
+						Visuals.m_BorderTopRight.Draw(true);
+				}
+				else if(y == pTMap->m_Height - 1)
+				{
+					Visuals.m_BorderBottomRight.SetIndexBufferByteOffset((offset_ptr32)(vtmpBorderCorners.size()));
+					if(AddTile(vtmpBorderCorners, vtmpBorderCornersTexCoords, Index, Flags, 0, 0, pGroup, DoTextureCoords, AddAsSpeedup, AngleRotate, ivec2{0, 0}))
+						Visuals.m_BorderBottomRight.Draw(true);
+				}
+				Visuals.m_vBorderRight[y].SetIndexBufferByteOffset((offset_ptr32)(vtmpBorderRightTiles.size()));
+				if(AddTile(vtmpBorderRightTiles, vtmpBorderRightTilesTexCoords, Index, Flags, 0, y, pGroup, DoTextureCoords, AddAsSpeedup, AngleRotate, ivec2{0, 0}))
+					Visuals.m_vBorderRight[y].Draw(true);
+			}
+			if(y == 0)
+			{
+				Visuals.m_vBorderTop[x].SetIndexBufferByteOffset((offset_ptr32)(vtmpBorderTopTiles.size()));
+				if(AddTile(vtmpBorderTopTiles, vtmpBorderTopTilesTexCoords, Index, Flags, x, 0, pGroup, DoTextureCoords, AddAsSpeedup, AngleRotate, ivec2{0, -32}))
+					Visuals.m_vBorderTop[x].Draw(true);
+			}
+			else if(y == pTMap->m_Height - 1)
+			{
+				Visuals.m_vBorderBottom[x].SetIndexBufferByteOffset((offset_ptr32)(vtmpBorderBottomTiles.size()));
+				if(AddTile(vtmpBorderBottomTiles, vtmpBorderBottomTilesTexCoords, Index, Flags, x, 0, pGroup, DoTextureCoords, AddAsSpeedup, AngleRotate, ivec2{0, 0}))
+					Visuals.m_vBorderBottom[x].Draw(true);
+			}
+		}
+	}
+
+	//append one kill tile to the gamelayer
+	if(IsGameLayer)
+	{
+		Visuals.m_BorderKillTile.SetIndexBufferByteOffset((offset_ptr32)(vtmpTiles.size()));
+		if(AddTile(vtmpTiles, vtmpTileTexCoords, TILE_DEATH, 0, 0, 0, pGroup, DoTextureCoords))
+			Visuals.m_BorderKillTile.Draw(true);
+	}
+
+	//add the border corners, then the borders and fix their byte offsets
+	int TilesHandledCount = vtmpTiles.size();
+	Visuals.m_BorderTopLeft.AddIndexBufferByteOffset(TilesHandledCount);
+	Visuals.m_BorderTopRight.AddIndexBufferByteOffset(TilesHandledCount);
+	Visuals.m_BorderBottomLeft.AddIndexBufferByteOffset(TilesHandledCount);
+	Visuals.m_BorderBottomRight.AddIndexBufferByteOffset(TilesHandledCount);
+	//add the Corners to the tiles
+	vtmpTiles.insert(vtmpTiles.end(), vtmpBorderCorners.begin(), vtmpBorderCorners.end());
+	vtmpTileTexCoords.insert(vtmpTileTexCoords.end(), vtmpBorderCornersTexCoords.begin(), vtmpBorderCornersTexCoords.end());
+
+	//now the borders
+	TilesHandledCount = vtmpTiles.size();
+	if(pTMap->m_Width > 0)
+	{
+		for(int i = 0; i < pTMap->m_Width; ++i)
+		{
+			Visuals.m_vBorderTop[i].AddIndexBufferByteOffset(TilesHandledCount);
+		}
+	}
+	vtmpTiles.insert(vtmpTiles.end(), vtmpBorderTopTiles.begin(), vtmpBorderTopTiles.end());
+	vtmpTileTexCoords.insert(vtmpTileTexCoords.end(), vtmpBorderTopTilesTexCoords.begin(), vtmpBorderTopTilesTexCoords.end());
+
+	TilesHandledCount = vtmpTiles.size();
+	if(pTMap->m_Width > 0)
+	{
+		for(int i = 0; i < pTMap->m_Width; ++i)
+		{
+			Visuals.m_vBorderBottom[i].AddIndexBufferByteOffset(TilesHandledCount);
+		}
+	}
+	vtmpTiles.insert(vtmpTiles.end(), vtmpBorderBottomTiles.begin(), vtmpBorderBottomTiles.end());
+	vtmpTileTexCoords.insert(vtmpTileTexCoords.end(), vtmpBorderBottomTilesTexCoords.begin(), vtmpBorderBottomTilesTexCoords.end());
+
+	TilesHandledCount = vtmpTiles.size();
+	if(pTMap->m_Height > 0)
+	{
+		for(int i = 0; i < pTMap->m_Height; ++i)
+		{
+			Visuals.m_vBorderLeft[i].AddIndexBufferByteOffset(TilesHandledCount);
+		}
+	}
+	vtmpTiles.insert(vtmpTiles.end(), vtmpBorderLeftTiles.begin(), vtmpBorderLeftTiles.end());
+	vtmpTileTexCoords.insert(vtmpTileTexCoords.end(), vtmpBorderLeftTilesTexCoords.begin(), vtmpBorderLeftTilesTexCoords.end());
+
+	TilesHandledCount = vtmpTiles.size();
+	if(pTMap->m_Height > 0)
+	{
+		for(int i = 0; i < pTMap->m_Height; ++i)
+		{
+			Visuals.m_vBorderRight[i].AddIndexBufferByteOffset(TilesHandledCount);
+		}
+	}
+	vtmpTiles.insert(vtmpTiles.end(), vtmpBorderRightTiles.begin(), vtmpBorderRightTiles.end());
+	vtmpTileTexCoords.insert(vtmpTileTexCoords.end(), vtmpBorderRightTilesTexCoords.begin(), vtmpBorderRightTilesTexCoords.end());
+
+	//setup params
+	float *pTmpTiles = vtmpTiles.empty() ? NULL : (float *)vtmpTiles.data();
+	unsigned char *pTmpTileTexCoords = vtmpTileTexCoords.empty() ? NULL : (unsigned char *)vtmpTileTexCoords.data();
+
+	m_NumTiles = vtmpTiles.size();
+	m_UploadDataSize = vtmpTileTexCoords.size() * sizeof(SGraphicTileTexureCoords) + vtmpTiles.size() * sizeof(SGraphicTile);
+	if(m_UploadDataSize > 0)
+	{
+		m_pUploadData = (char *)malloc(sizeof(char) * m_UploadDataSize);
+
+		mem_copy_special(m_pUploadData, pTmpTiles, sizeof(vec2), vtmpTiles.size() * 4, (DoTextureCoords ? sizeof(ubvec4) : 0));
+		if(DoTextureCoords)
+		{
+			mem_copy_special(m_pUploadData + sizeof(vec2), pTmpTileTexCoords, sizeof(ubvec4), vtmpTiles.size() * 4, sizeof(vec2));
+		}
+	}
+
+	m_pScratchPool->Put(std::move(pScratch));
+
+	// the job state is only set after this returns, so use an own flag
+	m_Finished = true;
+	m_pFinished->Signal();
+}
+
 CMapLayers::~CMapLayers()
 {
 	//clear everything and destroy all buffers
@@ -329,6 +720,10 @@ CMapLayers::~CMapLayers()
 
 void CMapLayers::OnMapLoad()
 {
+	m_pEnvelopePoints = nullptr;
+	m_EnvelopeCache.clear();
+
+	// headless clients only build the buffers with dbg_gfx_null_buffering
 	if(!Graphics()->IsTileBufferingEnabled() && !Graphics()->IsQuadBufferingEnabled())
 		return;
 
@@ -368,19 +763,67 @@ void CMapLayers::OnMapLoad()
 	}
 
 	bool PassedGameLayer = false;
-	//prepare all visuals for all tile layers
-	std::vector<SGraphicTile> vtmpTiles;
-	std::vector<SGraphicTileTexureCoords> vtmpTileTexCoords;
-	std::vector<SGraphicTile> vtmpBorderTopTiles;
-	std::vector<SGraphicTileTexureCoords> vtmpBorderTopTilesTexCoords;
-	std::vector<SGraphicTile> vtmpBorderLeftTiles;
-	std::vector<SGraphicTileTexureCoords> vtmpBorderLeftTilesTexCoords;
-	std::vector<SGraphicTile> vtmpBorderRightTiles;
-	std::vector<SGraphicTileTexureCoords> vtmpBorderRightTilesTexCoords;
-	std::vector<SGraphicTile> vtmpBorderBottomTiles;
-	std::vector<SGraphicTileTexureCoords> vtmpBorderBottomTilesTexCoords;
-	std::vector<SGraphicTile> vtmpBorderCorners;
-	std::vector<SGraphicTileTexureCoords> vtmpBorderCornersTexCoords;
+	//prepare all visuals for all tile layers on the job pool
+	CTileLayerScratchPool ScratchPool;
+	CSemaphore TileLayerJobFinished;
+	std::vector<std::shared_ptr<CTileLayerBuildJob>> vpTileLayerJobs;
+	std::chrono::nanoseconds WaitTime = 0ns;
+	// creating the buffers has to happen on this thread, upload the layers in the
+	// order they finish while the others are still being built
+	auto &&UploadTileLayer = [&](CTileLayerBuildJob *pJob) {
+		STileLayerVisuals &Visuals = *pJob->m_pVisuals;
+		const bool DoTextureCoords = pJob->m_DoTextureCoords;
+		Visuals.m_BufferContainerIndex = -1;
+		if(pJob->m_UploadDataSize == 0)
+			return;
+
+		// first create the buffer object, it takes over the upload data
+		int BufferObjectIndex = Graphics()->CreateBufferObject(pJob->m_UploadDataSize, pJob->m_pUploadData, 0, true);
+		pJob->m_pUploadData = nullptr;
+
+		// then create the buffer container
+		SBufferContainerInfo ContainerInfo;
+		ContainerInfo.m_Stride = (DoTextureCoords ? (sizeof(float) * 2 + sizeof(ubvec4)) : 0);
+		ContainerInfo.m_VertBufferBindingIndex = BufferObjectIndex;
+		ContainerInfo.m_vAttributes.emplace_back();
+		SBufferContainerInfo::SAttribute *pAttr = &ContainerInfo.m_vAttributes.back();
+		pAttr->m_DataTypeCount = 2;
+		pAttr->m_Type = GRAPHICS_TYPE_FLOAT;
+		pAttr->m_Normalized = false;
+		pAttr->m_pOffset = 0;
+		pAttr->m_FuncType = 0;
+		if(DoTextureCoords)
+		{
+			ContainerInfo.m_vAttributes.emplace_back();
+			pAttr = &ContainerInfo.m_vAttributes.back();
+			pAttr->m_DataTypeCount = 4;
+			pAttr->m_Type = GRAPHICS_TYPE_UNSIGNED_BYTE;
+			pAttr->m_Normalized = false;
+			pAttr->m_pOffset = (void *)(sizeof(vec2));
+			pAttr->m_FuncType = 1;
+		}
+
+		Visuals.m_BufferContainerIndex = Graphics()->CreateBufferContainer(&ContainerInfo);
+		// and finally inform the backend how many indices are required
+		Graphics()->IndicesNumRequiredNotify(pJob->m_NumTiles * 6);
+	};
+	auto &&FinishTileLayers = [&]() {
+		while(!vpTileLayerJobs.empty())
+		{
+			const auto StartWait = time_get_nanoseconds();
+			TileLayerJobFinished.Wait();
+			WaitTime += time_get_nanoseconds() - StartWait;
+			auto FinishedIt = std::find_if(vpTileLayerJobs.begin(), vpTileLayerJobs.end(), [](const std::shared_ptr<CTileLayerBuildJob> &pJob) {
+				return pJob->m_Finished.load();
+			});
+			dbg_assert(FinishedIt != vpTileLayerJobs.end(), "tile layer job signalled without finishing");
+			UploadTileLayer(FinishedIt->get());
+			vpTileLayerJobs.erase(FinishedIt);
+			RenderLoading();
+		}
+		log_info("maplayers", "built %d tile layers and %d quad layers in %.2fms, waited %.2fms for tile layer jobs",
+			(int)m_vpTileLayerVisuals.size(), (int)m_vpQuadLayerVisuals.size(), (time_get_nanoseconds() - CurTime) / 1us / 1000.0, WaitTime / 1us / 1000.0);
+	};
 
 	std::vector<STmpQuad> vtmpQuads;
 	std::vector<STmpQuadTextured> vtmpQuadsTextured;
@@ -432,7 +875,10 @@ void CMapLayers::OnMapLoad()
 			if(m_Type <= TYPE_BACKGROUND_FORCE)
 			{
 				if(PassedGameLayer)
+				{
+					FinishTileLayers();
 					return;
+				}
 			}
 			else if(m_Type == TYPE_FOREGROUND)
 			{
@@ -506,284 +952,22 @@ void CMapLayers::OnMapLoad()
 						}
 						Visuals.m_IsTextured = DoTextureCoords;
 
-						vtmpTiles.clear();
-						vtmpTileTexCoords.clear();
-
-						vtmpBorderTopTiles.clear();
-						vtmpBorderLeftTiles.clear();
-						vtmpBorderRightTiles.clear();
-						vtmpBorderBottomTiles.clear();
-						vtmpBorderCorners.clear();
-						vtmpBorderTopTilesTexCoords.clear();
-						vtmpBorderLeftTilesTexCoords.clear();
-						vtmpBorderRightTilesTexCoords.clear();
-						vtmpBorderBottomTilesTexCoords.clear();
-						vtmpBorderCornersTexCoords.clear();
-
-						if(!DoTextureCoords)
-						{
-							vtmpTiles.reserve((size_t)pTMap->m_Width * pTMap->m_Height);
-							vtmpBorderTopTiles.reserve((size_t)pTMap->m_Width);
-							vtmpBorderBottomTiles.reserve((size_t)pTMap->m_Width);
-							vtmpBorderLeftTiles.reserve((size_t)pTMap->m_Height);
-							vtmpBorderRightTiles.reserve((size_t)pTMap->m_Height);
-							vtmpBorderCorners.reserve((size_t)4);
-						}
-						else
-						{
-							vtmpTileTexCoords.reserve((size_t)pTMap->m_Width * pTMap->m_Height);
-							vtmpBorderTopTilesTexCoords.reserve((size_t)pTMap->m_Width);
-							vtmpBorderBottomTilesTexCoords.reserve((size_t)pTMap->m_Width);
-							vtmpBorderLeftTilesTexCoords.reserve((size_t)pTMap->m_Height);
-							vtmpBorderRightTilesTexCoords.reserve((size_t)pTMap->m_Height);
-							vtmpBorderCornersTexCoords.reserve((size_t)4);
-						}
-
-						int x = 0;
-						int y = 0;
-						for(y = 0; y < pTMap->m_Height; ++y)
-						{
-							for(x = 0; x < pTMap->m_Width; ++x)
-							{
-								unsigned char Index = 0;
-								unsigned char Flags = 0;
-								int AngleRotate = -1;
-								if(IsEntityLayer)
-								{
-									if(IsGameLayer)
-									{
-										Index = ((CTile *)pTiles)[y * pTMap->m_Width + x].m_Index;
-										Flags = ((CTile *)pTiles)[y * pTMap->m_Width + x].m_Flags;
-									}
-									if(IsFrontLayer)
-									{
-										Index = ((CTile *)pTiles)[y * pTMap->m_Width + x].m_Index;
-										Flags = ((CTile *)pTiles)[y * pTMap->m_Width + x].m_Flags;
-									}
-									if(IsSwitchLayer)
-									{
-										Flags = 0;
-										Index = ((CSwitchTile *)pTiles)[y * pTMap->m_Width + x].m_Type;
-										if(CurOverlay == 0)
-										{
-											Flags = ((CSwitchTile *)pTiles)[y * pTMap->m_Width + x].m_Flags;
-											if(Index == TILE_SWITCHTIMEDOPEN)
-												Index = 8;
-										}
-										else if(CurOverlay == 1)
-											Index = ((CSwitchTile *)pTiles)[y * pTMap->m_Width + x].m_Number;
-										else if(CurOverlay == 2)
-											Index = ((CSwitchTile *)pTiles)[y * pTMap->m_Width + x].m_Delay;
-									}
-									if(IsTeleLayer)
-									{
-										Index = ((CTeleTile *)pTiles)[y * pTMap->m_Width + x].m_Type;
-										Flags = 0;
-										if(CurOverlay == 1)
-										{
-											if(IsTeleTileNumberUsed(Index))
-												Index = ((CTeleTile *)pTiles)[y * pTMap->m_Width + x].m_Number;
-											else
-												Index = 0;
-										}
-									}
-									if(IsSpeedupLayer)
-									{
-										Index = ((CSpeedupTile *)pTiles)[y * pTMap->m_Width + x].m_Type;
-										Flags = 0;
-										AngleRotate = ((CSpeedupTile *)pTiles)[y * pTMap->m_Width + x].m_Angle;
-										if(((CSpeedupTile *)pTiles)[y * pTMap->m_Width + x].m_Force == 0)
-											Index = 0;
-										else if(CurOverlay == 1)
-											Index = ((CSpeedupTile *)pTiles)[y * pTMap->m_Width + x].m_Force;
-										else if(CurOverlay == 2)
-											Index = ((CSpeedupTile *)pTiles)[y * pTMap->m_Width + x].m_MaxSpeed;
-									}
-									if(IsTuneLayer)
-									{
-										Index = ((CTuneTile *)pTiles)[y * pTMap->m_Width + x].m_Type;
-										Flags = 0;
-									}
-								}
-								else
-								{
-									Index = ((CTile *)pTiles)[y * pTMap->m_Width + x].m_Index;
-									Flags = ((CTile *)pTiles)[y * pTMap->m_Width + x].m_Flags;
-								}
-
-								//the amount of tiles handled before this tile
-								int TilesHandledCount = vtmpTiles.size();
-								Visuals.m_pTilesOfLayer[y * pTMap->m_Width + x].SetIndexBufferByteOffset((offset_ptr32)(TilesHandledCount));
-
-								bool AddAsSpeedup = false;
-								if(IsSpeedupLayer && CurOverlay == 0)
-									AddAsSpeedup = true;
-
-								if(AddTile(vtmpTiles, vtmpTileTexCoords, Index, Flags, x, y, pGroup, DoTextureCoords, AddAsSpeedup, AngleRotate))
-									Visuals.m_pTilesOfLayer[y * pTMap->m_Width + x].Draw(true);
-
-								//do the border tiles
-								if(x == 0)
-								{
-									if(y == 0)
-									{
-										Visuals.m_BorderTopLeft.SetIndexBufferByteOffset((offset_ptr32)(vtmpBorderCorners.size()));
-										if(AddTile(vtmpBorderCorners, vtmpBorderCornersTexCoords, Index, Flags, 0, 0, pGroup, DoTextureCoords, AddAsSpeedup, AngleRotate, ivec2{-32, -32}))
-											Visuals.m_BorderTopLeft.Draw(true);
-									}
-									else if(y == pTMap->m_Height - 1)
-									{
-										Visuals.m_BorderBottomLeft.SetIndexBufferByteOffset((offset_ptr32)(vtmpBorderCorners.size()));
-										if(AddTile(vtmpBorderCorners, vtmpBorderCornersTexCoords, Index, Flags, 0, 0, pGroup, DoTextureCoords, AddAsSpeedup, AngleRotate, ivec2{-32, 0}))
-											Visuals.m_BorderBottomLeft.Draw(true);
-									}
-									Visuals.m_vBorderLeft[y].SetIndexBufferByteOffset((offset_ptr32)(vtmpBorderLeftTiles.size()));
-									if(AddTile(vtmpBorderLeftTiles, vtmpBorderLeftTilesTexCoords, Index, Flags, 0, y, pGroup, DoTextureCoords, AddAsSpeedup, AngleRotate, ivec2{-32, 0}))
-										Visuals.m_vBorderLeft[y].Draw(true);
-								}
-								else if(x == pTMap->m_Width - 1)
-								{
-									if(y == 0)
-									{
-										Visuals.m_BorderTopRight.SetIndexBufferByteOffset((offset_ptr32)(vtmpBorderCorners.size()));
-										if(AddTile(vtmpBorderCorners, vtmpBorderCornersTexCoords, Index, Flags, 0, 0, pGroup, DoTextureCoords, AddAsSpeedup, AngleRotate, ivec2{0, -32}))
-											Visuals.m_BorderTopRight.Draw(true);
-									}
-									else if(y == pTMap->m_Height - 1)
-									{
-										Visuals.m_BorderBottomRight.SetIndexBufferByteOffset((offset_ptr32)(vtmpBorderCorners.size()));
-										if(AddTile(vtmpBorderCorners, vtmpBorderCornersTexCoords, Index, Flags, 0, 0, pGroup, DoTextureCoords, AddAsSpeedup, AngleRotate, ivec2{0, 0}))
-											Visuals.m_BorderBottomRight.Draw(true);
-									}
-									Visuals.m_vBorderRight[y].SetIndexBufferByteOffset((offset_ptr32)(vtmpBorderRightTiles.size()));
-									if(AddTile(vtmpBorderRightTiles, vtmpBorderRightTilesTexCoords, Index, Flags, 0, y, pGroup, DoTextureCoords, AddAsSpeedup, AngleRotate, ivec2{0, 0}))
-										Visuals.m_vBorderRight[y].Draw(true);
-								}
-								if(y == 0)
-								{
-									Visuals.m_vBorderTop[x].SetIndexBufferByteOffset((offset_ptr32)(vtmpBorderTopTiles.size()));
-									if(AddTile(vtmpBorderTopTiles, vtmpBorderTopTilesTexCoords, Index, Flags, x, 0, pGroup, DoTextureCoords, AddAsSpeedup, AngleRotate, ivec2{0, -32}))
-										Visuals.m_vBorderTop[x].Draw(true);
-								}
-								else if(y == pTMap->m_Height - 1)
-								{
-									Visuals.m_vBorderBottom[x].SetIndexBufferByteOffset((offset_ptr32)(vtmpBorderBottomTiles.size()));
-									if(AddTile(vtmpBorderBottomTiles, vtmpBorderBottomTilesTexCoords, Index, Flags, x, 0, pGroup, DoTextureCoords, AddAsSpeedup, AngleRotate, ivec2{0, 0}))
-										Visuals.m_vBorderBottom[x].Draw(true);
-								}
-							}
-						}
-
-						//append one kill tile to the gamelayer
-						if(IsGameLayer)
-						{
-							Visuals.m_BorderKillTile.SetIndexBufferByteOffset((offset_ptr32)(vtmpTiles.size()));
-							if(AddTile(vtmpTiles, vtmpTileTexCoords, TILE_DEATH, 0, 0, 0, pGroup, DoTextureCoords))
-								Visuals.m_BorderKillTile.Draw(true);
-						}
-
-						//add the border corners, then the borders and fix their byte offsets
-						int TilesHandledCount = vtmpTiles.size();
-						Visuals.m_BorderTopLeft.AddIndexBufferByteOffset(TilesHandledCount);
-						Visuals.m_BorderTopRight.AddIndexBufferByteOffset(TilesHandledCount);
-						Visuals.m_BorderBottomLeft.AddIndexBufferByteOffset(TilesHandledCount);
-						Visuals.m_BorderBottomRight.AddIndexBufferByteOffset(TilesHandledCount);
-						//add the Corners to the tiles
-						vtmpTiles.insert(vtmpTiles.end(), vtmpBorderCorners.begin(), vtmpBorderCorners.end());
-						vtmpTileTexCoords.insert(vtmpTileTexCoords.end(), vtmpBorderCornersTexCoords.begin(), vtmpBorderCornersTexCoords.end());
-
-						//now the borders
-						TilesHandledCount = vtmpTiles.size();
-						if(pTMap->m_Width > 0)
-						{
-							for(int i = 0; i < pTMap->m_Width; ++i)
-							{
-								Visuals.m_vBorderTop[i].AddIndexBufferByteOffset(TilesHandledCount);
-							}
-						}
-						vtmpTiles.insert(vtmpTiles.end(), vtmpBorderTopTiles.begin(), vtmpBorderTopTiles.end());
-						vtmpTileTexCoords.insert(vtmpTileTexCoords.end(), vtmpBorderTopTilesTexCoords.begin(), vtmpBorderTopTilesTexCoords.end());
-
-						TilesHandledCount = vtmpTiles.size();
-						if(pTMap->m_Width > 0)
-						{
-							for(int i = 0; i < pTMap->m_Width; ++i)
-							{
-								Visuals.m_vBorderBottom[i].AddIndexBufferByteOffset(TilesHandledCount);
-							}
-						}
-						vtmpTiles.insert(vtmpTiles.end(), vtmpBorderBottomTiles.begin(), vtmpBorderBottomTiles.end());
-						vtmpTileTexCoords.insert(vtmpTileTexCoords.end(), vtmpBorderBottomTilesTexCoords.begin(), vtmpBorderBottomTilesTexCoords.end());
-
-						TilesHandledCount = vtmpTiles.size();
-						if(pTMap->m_Height > 0)
-						{
-							for(int i = 0; i < pTMap->m_Height; ++i)
-							{
-								Visuals.m_vBorderLeft[i].AddIndexBufferByteOffset(TilesHandledCount);
-							}
-						}
-						vtmpTiles.insert(vtmpTiles.end(), vtmpBorderLeftTiles.begin(), vtmpBorderLeftTiles.end());
-						vtmpTileTexCoords.insert(vtmpTileTexCoords.end(), vtmpBorderLeftTilesTexCoords.begin(), vtmpBorderLeftTilesTexCoords.end());
-
-						TilesHandledCount = vtmpTiles.size();
-						if(pTMap->m_Height > 0)
-						{
-							for(int i = 0; i < pTMap->m_Height; ++i)
-							{
-								Visuals.m_vBorderRight[i].AddIndexBufferByteOffset(TilesHandledCount);
-							}
-						}
-						vtmpTiles.insert(vtmpTiles.end(), vtmpBorderRightTiles.begin(), vtmpBorderRightTiles.end());
-						vtmpTileTexCoords.insert(vtmpTileTexCoords.end(), vtmpBorderRightTilesTexCoords.begin(), vtmpBorderRightTilesTexCoords.end());
-
-						//setup params
-						float *pTmpTiles = vtmpTiles.empty() ? NULL : (float *)vtmpTiles.data();
-						unsigned char *pTmpTileTexCoords = vtmpTileTexCoords.empty() ? NULL : (unsigned char *)vtmpTileTexCoords.data();
-
-						Visuals.m_BufferContainerIndex = -1;
-						size_t UploadDataSize = vtmpTileTexCoords.size() * sizeof(SGraphicTileTexureCoords) + vtmpTiles.size() * sizeof(SGraphicTile);
-						if(UploadDataSize > 0)
-						{
-							char *pUploadData = (char *)malloc(sizeof(char) * UploadDataSize);
-
-							mem_copy_special(pUploadData, pTmpTiles, sizeof(vec2), vtmpTiles.size() * 4, (DoTextureCoords ? sizeof(ubvec4) : 0));
-							if(DoTextureCoords)
-							{
-								mem_copy_special(pUploadData + sizeof(vec2), pTmpTileTexCoords, sizeof(ubvec4), vtmpTiles.size() * 4, sizeof(vec2));
-							}
-
-							// first create the buffer object
-							int BufferObjectIndex = Graphics()->CreateBufferObject(UploadDataSize, pUploadData, 0, true);
-
-							// then create the buffer container
-							SBufferContainerInfo ContainerInfo;
-							ContainerInfo.m_Stride = (DoTextureCoords ? (sizeof(float) * 2 + sizeof(ubvec4)) : 0);
-							ContainerInfo.m_VertBufferBindingIndex = BufferObjectIndex;
-							ContainerInfo.m_vAttributes.emplace_back();
-							SBufferContainerInfo::SAttribute *pAttr = &ContainerInfo.m_vAttributes.back();
-							pAttr->m_DataTypeCount = 2;
-							pAttr->m_Type = GRAPHICS_TYPE_FLOAT;
-							pAttr->m_Normalized = false;
-							pAttr->m_pOffset = 0;
-							pAttr->m_FuncType = 0;
-							if(DoTextureCoords)
-							{
-								ContainerInfo.m_vAttributes.emplace_back();
-								pAttr = &ContainerInfo.m_vAttributes.back();
-								pAttr->m_DataTypeCount = 4;
-								pAttr->m_Type = GRAPHICS_TYPE_UNSIGNED_BYTE;
-								pAttr->m_Normalized = false;
-								pAttr->m_pOffset = (void *)(sizeof(vec2));
-								pAttr->m_FuncType = 1;
-							}
-
-							Visuals.m_BufferContainerIndex = Graphics()->CreateBufferContainer(&ContainerInfo);
-							// and finally inform the backend how many indices are required
-							Graphics()->IndicesNumRequiredNotify(vtmpTiles.size() * 6);
-
-							RenderLoading();
-						}
+						auto pJob = std::make_shared<CTileLayerBuildJob>(&ScratchPool, &TileLayerJobFinished);
+						pJob->m_pVisuals = &Visuals;
+						pJob->m_pTMap = pTMap;
+						pJob->m_pGroup = pGroup;
+						pJob->m_pTiles = pTiles;
+						pJob->m_CurOverlay = CurOverlay;
+						pJob->m_DoTextureCoords = DoTextureCoords;
+						pJob->m_IsEntityLayer = IsEntityLayer;
+						pJob->m_IsGameLayer = IsGameLayer;
+						pJob->m_IsFrontLayer = IsFrontLayer;
+						pJob->m_IsSwitchLayer = IsSwitchLayer;
+						pJob->m_IsTeleLayer = IsTeleLayer;
+						pJob->m_IsSpeedupLayer = IsSpeedupLayer;
+						pJob->m_IsTuneLayer = IsTuneLayer;
+						m_pClient->Engine()->AddJob(pJob);
+						vpTileLayerJobs.push_back(std::move(pJob));
 
 						++CurOverlay;
 					}
@@ -899,6 +1083,8 @@ void CMapLayers::OnMapLoad()
 			}
 		}
 	}
+
+	FinishTileLayers();
 }
 
 void CMapLayers::RenderTileLayer(int LayerIndex, ColorRGBA &Color, CMapItemLayerTilemap *pTileLayer, CMapItemGroup *pGroup)
@@ -1432,6 +1618,8 @@ void CMapLayers::OnRender()
 	if(m_OnlineOnly && Client()->State() != IClient::STATE_ONLINE && Client()->State() != IClient::STATE_DEMOPLAYBACK)
 		return;
 
+	UpdateLocalEnvelopeTime();
+
 	CUIRect Screen;
 	Graphics()->GetScreen(&Screen.x, &Screen.y, &Screen.w, &Screen.h);
 
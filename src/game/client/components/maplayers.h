@@ -3,8 +3,12 @@
 #ifndef GAME_CLIENT_COMPONENTS_MAPLAYERS_H
 #define GAME_CLIENT_COMPONENTS_MAPLAYERS_H
 #include <game/client/component.h>
+#include <game/client/render.h>
 
+#include <chrono>
 #include <cstdint>
+#include <memory>
+#include <unordered_map>
 #include <vector>
 
 #define INDEX_BUFFER_GROUP_WIDTH 12
@@ -18,7 +22,6 @@ typedef unsigned int offset_ptr32;
 class CCamera;
 class CLayers;
 class CMapImages;
-class ColorRGBA;
 struct CMapItemGroup;
 struct CMapItemLayerTilemap;
 struct CMapItemLayerQuads;
@@ -106,6 +109,7 @@ class CMapLayers : public CComponent
 		bool m_IsTextured;
 	};
 	std::vector<STileLayerVisuals *> m_vpTileLayerVisuals;
+	class CTileLayerBuildJob;
 
 	struct SQuadLayerVisuals
 	{
@@ -128,6 +132,19 @@ class CMapLayers : public CComponent
 	};
 	std::vector<SQuadLayerVisuals *> m_vpQuadLayerVisuals;
 
+	// results of the envelopes evaluated in this frame, keyed by envelope and time offset
+	struct SEnvelopeCacheEntry
+	{
+		bool m_Valid = false;
+		std::chrono::nanoseconds m_Time;
+		ColorRGBA m_Channels;
+	};
+	std::unique_ptr<CMapBasedEnvelopePointAccess> m_pEnvelopePoints;
+	std::unordered_map<uint64_t, SEnvelopeCacheEntry> m_EnvelopeCache;
+
+	void UpdateLocalEnvelopeTime();
+	void EvalEnvelopeCached(int Env, int TimeOffsetMillis, std::chrono::nanoseconds Time, ColorRGBA &Channels);
+
 	virtual CCamera *GetCurCamera();
 
 	void LayersOfGroupCount(CMapItemGroup *pGroup, int &TileLayerCount, int &QuadLayerCount, bool &PassedGameLayer);
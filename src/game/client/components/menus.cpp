@@ -4,6 +4,7 @@
 #include <algorithm>
 #include <chrono>
 #include <cmath>
+#include <thread>
 #include <vector>
 
 #include <base/math.h>
@@ -1926,6 +1927,14 @@ void CMenus::OnReset()
 void CMenus::OnShutdown()
 {
 	KillServer();
+	if(m_pDemoListJob)
+	{
+		// the job uses the storage and demo player, which are gone soon
+		m_pDemoListJob->Abort();
+		while(m_pDemoListJob->Status() != IJob::STATE_DONE)
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		m_pDemoListJob = nullptr;
+	}
 }
 
 bool CMenus::OnCursorMove(float x, float y, IInput::ECursorType CursorType)
@@ -8,15 +8,18 @@
 
 #include <chrono>
 #include <deque>
+#include <memory>
 #include <unordered_set>
 #include <vector>
 
+#include <engine/client/demo_index.h>
 #include <engine/console.h>
 #include <engine/demo.h>
 #include <engine/friends.h>
 #include <engine/serverbrowser.h>
 #include <engine/shared/config.h>
 #include <engine/shared/http.h>
+#include <engine/shared/jobs.h>
 #include <engine/shared/linereader.h>
 #include <engine/textrender.h>
 
@@ -261,6 +264,7 @@ protected:
 		bool m_IsLink;
 		int m_StorageType;
 		time_t m_Date;
+		int m_ScanIndex = -1;
 
 		bool m_InfosLoaded;
 		bool m_Valid;
@@ -330,10 +334,54 @@ protected:
 	int m_Speed = 4;
 	bool m_StartPaused = false;
 
-	std::chrono::nanoseconds m_DemoPopulateStartTime{0};
+	// Lists a demo folder and parses the demo headers in the background,
+	// publishing the results in batches so the list fills progressively.
+	class CDemoListJob : public IJob
+	{
+		IStorage *m_pStorage;
+		IConsole *m_pConsole;
+		IDemoPlayer *m_pDemoPlayer;
+		char m_aFolder[IO_MAX_PATH_LENGTH];
+		int m_StorageType;
+		bool m_MultipleStorages;
+		bool m_List;
+		std::atomic<bool> m_Abort{false};
+
+		// the items to fetch the headers of
+		std::vector<CDemoItem> m_vItems;
+		std::vector<CDemoItem> m_vBatch;
+
+		CLock m_Lock;
+		std::vector<CDemoItem> m_vNewItems GUARDED_BY(m_Lock);
+		std::vector<std::pair<int, IDemoIndex::CEntry>> m_vNewInfos GUARDED_BY(m_Lock);
+
+		static int ListCallback(const CFsFileInfo *pInfo, int IsDir, int StorageType, void *pUser);
+		void Run() override REQUIRES(!m_Lock);
+
+	public:
+		enum
+		{
+			BATCH_SIZE = 256,
+		};
+
+		// lists the folder if `vItems` is empty, otherwise only fetches the headers of the given items
+		CDemoListJob(IStorage *pStorage, IConsole *pConsole, IDemoPlayer *pDemoPlayer, const char *pFolder, int StorageType, bool MultipleStorages, bool FetchInfo, std::vector<CDemoItem> vItems = {});
+
+		std::atomic<bool> m_FetchInfo;
+		std::atomic<int> m_NumListed{0};
+
+		void Abort() { m_Abort = true; }
+		void TakeResults(std::vector<CDemoItem> &vItems, std::vector<std::pair<int, IDemoIndex::CEntry>> &vInfos) REQUIRES(!m_Lock);
+	};
+	std::shared_ptr<CDemoListJob> m_pDemoListJob;
+	// position in `m_vDemos` of each item by scan index while the job runs
+	std::vector<int> m_vDemolistScanPositions;
 
 	void DemolistOnUpdate(bool Reset);
-	static int DemolistFetchCallback(const CFsFileInfo *pInfo, int IsDir, int StorageType, void *pUser);
+	void DemolistRefresh();
+	void DemolistUpdateJob();
+	void DemolistIndexScanPositions();
+	void DemolistApplyResults(const std::vector<CDemoItem> &vItems, const std::vector<std::pair<int, IDemoIndex::CEntry>> &vInfos);
 
 	// friends
 	class CFriendItem
@@ -458,7 +506,6 @@ protected:
 	// found in menus_browser.cpp
 	int m_SelectedIndex;
 	bool m_ServerBrowserShouldRevealSelection;
-	std::vector<CUIElement *> m_avpServerBrowserUiElements[IServerBrowser::NUM_TYPES];
 	void RenderServerbrowserServerList(CUIRect View, bool &WasListboxItemActivated);
 	void RenderServerbrowserStatusBox(CUIRect StatusBox, bool WasListboxItemActivated);
 	void Connect(const char *pAddress);
@@ -229,21 +229,16 @@ void CMenus::RenderServerbrowserServerList(CUIRect View, bool &WasListboxItemAct
 		TextRender()->SetFontPreset(EFontPreset::DEFAULT_FONT);
 	};
 
-	std::vector<CUIElement *> &vpServerBrowserUiElements = m_avpServerBrowserUiElements[ServerBrowser()->GetCurrentType()];
-	if(vpServerBrowserUiElements.size() < (size_t)NumServers)
-		vpServerBrowserUiElements.resize(NumServers, nullptr);
+	// rows are retained per server, so their labels are only rebuilt when
+	// the server changed and not when the list is sorted again
+	static CUIListRowCache s_RowCache(NUM_UI_ELEMS);
+	s_RowCache.StartFrame();
 
 	for(int i = 0; i < NumServers; i++)
 	{
 		const CServerInfo *pItem = ServerBrowser()->SortedGet(i);
 		const CCommunity *pCommunity = ServerBrowser()->Community(pItem->m_aCommunityId);
 
-		if(vpServerBrowserUiElements[i] == nullptr)
-		{
-			vpServerBrowserUiElements[i] = UI()->GetNewUIElement(NUM_UI_ELEMS);
-		}
-		CUIElement *pUiElement = vpServerBrowserUiElements[i];
-
 		const CListboxItem ListItem = s_ListBox.DoNextItem(pItem, str_comp(pItem->m_aAddress, g_Config.m_UiServerAddress) == 0);
 		if(ListItem.m_Selected)
 			m_SelectedIndex = i;
@@ -258,6 +253,8 @@ void CMenus::RenderServerbrowserServerList(CUIRect View, bool &WasListboxItemAct
 			continue;
 		}
 
+		CUIElement *pUiElement = s_RowCache.Get(pItem->m_aAddress);
+
 		const float FontSize = 12.0f;
 		char aTemp[64];
 		for(const auto &Col : s_aCols)
@@ -6,6 +6,7 @@
 #include <base/system.h>
 
 #include <engine/demo.h>
+#include <engine/engine.h>
 #include <engine/graphics.h>
 #include <engine/keys.h>
 #include <engine/shared/localization.h>
@@ -891,11 +892,26 @@ void CMenus::RenderDemoPlayerSliceSavePopup(CUIRect MainView)
 	}
 }
 
-int CMenus::DemolistFetchCallback(const CFsFileInfo *pInfo, int IsDir, int StorageType, void *pUser)
+CMenus::CDemoListJob::CDemoListJob(IStorage *pStorage, IConsole *pConsole, IDemoPlayer *pDemoPlayer, const char *pFolder, int StorageType, bool MultipleStorages, bool FetchInfo, std::vector<CDemoItem> vItems) :
+	m_pStorage(pStorage),
+	m_pConsole(pConsole),
+	m_pDemoPlayer(pDemoPlayer),
+	m_StorageType(StorageType),
+	m_MultipleStorages(MultipleStorages),
+	m_List(vItems.empty()),
+	m_vItems(std::move(vItems)),
+	m_FetchInfo(FetchInfo)
 {
-	CMenus *pSelf = (CMenus *)pUser;
+	str_copy(m_aFolder, pFolder);
+}
+
+int CMenus::CDemoListJob::ListCallback(const CFsFileInfo *pInfo, int IsDir, int StorageType, void *pUser)
+{
+	CDemoListJob *pSelf = (CDemoListJob *)pUser;
+	if(pSelf->m_Abort)
+		return 1;
 	if(str_comp(pInfo->m_pName, ".") == 0 ||
-		(str_comp(pInfo->m_pName, "..") == 0 && (pSelf->m_aCurrentDemoFolder[0] == '\0' || (!pSelf->m_DemolistMultipleStorages && str_comp(pSelf->m_aCurrentDemoFolder, "demos") == 0))) ||
+		(str_comp(pInfo->m_pName, "..") == 0 && (pSelf->m_aFolder[0] == '\0' || (!pSelf->m_MultipleStorages && str_comp(pSelf->m_aFolder, "demos") == 0))) ||
 		(!IsDir && !str_endswith(pInfo->m_pName, ".demo")))
 	{
 		return 0;
@@ -918,19 +934,108 @@ int CMenus::DemolistFetchCallback(const CFsFileInfo *pInfo, int IsDir, int Stora
 	Item.m_IsDir = IsDir != 0;
 	Item.m_IsLink = false;
 	Item.m_StorageType = StorageType;
-	pSelf->m_vDemos.push_back(Item);
+	Item.m_ScanIndex = pSelf->m_vItems.size();
+	pSelf->m_vItems.push_back(Item);
+	pSelf->m_vBatch.push_back(Item);
 
-	if(time_get_nanoseconds() - pSelf->m_DemoPopulateStartTime > 500ms)
+	if(pSelf->m_vBatch.size() >= BATCH_SIZE)
 	{
-		pSelf->RenderLoading(Localize("Loading demo files"), "", 0, false);
+		const CLockScope LockScope(pSelf->m_Lock);
+		pSelf->m_vNewItems.insert(pSelf->m_vNewItems.end(), pSelf->m_vBatch.begin(), pSelf->m_vBatch.end());
+		pSelf->m_vBatch.clear();
 	}
-
+	pSelf->m_NumListed++;
 	return 0;
 }
 
+void CMenus::CDemoListJob::Run()
+{
+	if(m_List)
+	{
+		m_pStorage->ListDirectoryInfo(m_StorageType, m_aFolder, ListCallback, this);
+		const CLockScope LockScope(m_Lock);
+		m_vNewItems.insert(m_vNewItems.end(), m_vBatch.begin(), m_vBatch.end());
+		m_vBatch.clear();
+	}
+	if(m_Abort || !m_FetchInfo)
+		return;
+
+	// Parsing a header needs a few small reads at the start of every demo,
+	// which adds up for folders with thousands of demos. Unchanged demos are
+	// looked up in the index instead, keyed by their path, size and mtime.
+	std::unique_ptr<IDemoIndex> pIndex(CreateDemoIndex(m_pConsole, m_pStorage));
+	std::vector<std::pair<int, IDemoIndex::CEntry>> vBatch;
+	// newly parsed headers are only written at the end of a batch, so the
+	// write transaction doesn't include the parsing
+	struct SNewEntry
+	{
+		char m_aCompletePath[IO_MAX_PATH_LENGTH];
+		int64_t m_Size;
+		time_t m_Date;
+		int m_BatchIndex;
+	};
+	std::vector<SNewEntry> vNewEntries;
+	auto &&PublishBatch = [&]() {
+		for(const SNewEntry &NewEntry : vNewEntries)
+			pIndex->Store(NewEntry.m_aCompletePath, NewEntry.m_Size, NewEntry.m_Date, vBatch[NewEntry.m_BatchIndex].second);
+		pIndex->Commit();
+		vNewEntries.clear();
+		const CLockScope LockScope(m_Lock);
+		m_vNewInfos.insert(m_vNewInfos.end(), vBatch.begin(), vBatch.end());
+		vBatch.clear();
+	};
+	for(const CDemoItem &Item : m_vItems)
+	{
+		if(m_Abort)
+			return;
+		if(Item.m_IsDir || Item.m_InfosLoaded)
+			continue;
+
+		char aPath[IO_MAX_PATH_LENGTH];
+		str_format(aPath, sizeof(aPath), "%s/%s", m_aFolder, Item.m_aFilename);
+		SNewEntry NewEntry;
+		m_pStorage->GetCompletePath(Item.m_StorageType, aPath, NewEntry.m_aCompletePath, sizeof(NewEntry.m_aCompletePath));
+		NewEntry.m_Size = -1;
+		NewEntry.m_Date = Item.m_Date;
+		NewEntry.m_BatchIndex = vBatch.size();
+
+		IDemoIndex::CEntry Entry;
+		IOHANDLE File = m_pStorage->OpenFile(aPath, IOFLAG_READ, Item.m_StorageType);
+		if(File)
+		{
+			NewEntry.m_Size = io_length(File);
+			io_close(File);
+		}
+		if(NewEntry.m_Size < 0 || !pIndex->Get(NewEntry.m_aCompletePath, NewEntry.m_Size, Item.m_Date, &Entry))
+		{
+			Entry.m_Valid = m_pDemoPlayer->GetDemoInfo(m_pStorage, nullptr, aPath, Item.m_StorageType, &Entry.m_Info, &Entry.m_TimelineMarkers, &Entry.m_MapInfo);
+			if(NewEntry.m_Size >= 0)
+				vNewEntries.push_back(NewEntry);
+		}
+		vBatch.emplace_back(Item.m_ScanIndex, Entry);
+
+		if(vBatch.size() >= BATCH_SIZE)
+			PublishBatch();
+	}
+	PublishBatch();
+}
+
+void CMenus::CDemoListJob::TakeResults(std::vector<CDemoItem> &vItems, std::vector<std::pair<int, IDemoIndex::CEntry>> &vInfos)
+{
+	const CLockScope LockScope(m_Lock);
+	std::swap(vItems, m_vNewItems);
+	std::swap(vInfos, m_vNewInfos);
+}
+
 void CMenus::DemolistPopulate()
 {
+	if(m_pDemoListJob)
+	{
+		m_pDemoListJob->Abort();
+		m_pDemoListJob = nullptr;
+	}
 	m_vDemos.clear();
+	m_vDemolistScanPositions.clear();
 
 	int NumStoragesWithDemos = 0;
 	for(int StorageType = IStorage::TYPE_SAVE; StorageType < Storage()->NumPaths(); ++StorageType)
@@ -977,15 +1082,89 @@ void CMenus::DemolistPopulate()
 	}
 	else
 	{
-		m_DemoPopulateStartTime = time_get_nanoseconds();
-		Storage()->ListDirectoryInfo(m_DemolistStorageType, m_aCurrentDemoFolder, DemolistFetchCallback, this);
+		m_pDemoListJob = std::make_shared<CDemoListJob>(Storage(), Console(), DemoPlayer(), m_aCurrentDemoFolder, m_DemolistStorageType, m_DemolistMultipleStorages, g_Config.m_BrDemoFetchInfo);
+		Engine()->AddJob(m_pDemoListJob);
+	}
+	RefreshFilteredDemos();
+}
 
+void CMenus::DemolistUpdateJob()
+{
+	if(!m_pDemoListJob)
+		return;
+
+	// check the status first, so the last results are not missed
+	const bool Done = m_pDemoListJob->Status() == IJob::STATE_DONE;
+	std::vector<CDemoItem> vItems;
+	std::vector<std::pair<int, IDemoIndex::CEntry>> vInfos;
+	m_pDemoListJob->TakeResults(vItems, vInfos);
+	if(!vItems.empty() || !vInfos.empty())
+		DemolistApplyResults(vItems, vInfos);
+	if(Done)
+	{
+		m_pDemoListJob = nullptr;
+		// the list is only sorted once all results are in
+		std::stable_sort(m_vDemos.begin(), m_vDemos.end());
+		m_vDemolistScanPositions.clear();
+		DemolistRefresh();
+		// fetch info might have been enabled after the job checked it
 		if(g_Config.m_BrDemoFetchInfo)
 			FetchAllHeaders();
+	}
+}
 
-		std::stable_sort(m_vDemos.begin(), m_vDemos.end());
+void CMenus::DemolistIndexScanPositions()
+{
+	m_vDemolistScanPositions.clear();
+	for(size_t i = 0; i < m_vDemos.size(); i++)
+	{
+		const int ScanIndex = m_vDemos[i].m_ScanIndex;
+		if(ScanIndex < 0)
+			continue;
+		if((size_t)ScanIndex >= m_vDemolistScanPositions.size())
+			m_vDemolistScanPositions.resize(ScanIndex + 1, -1);
+		m_vDemolistScanPositions[ScanIndex] = i;
+	}
+}
+
+void CMenus::DemolistApplyResults(const std::vector<CDemoItem> &vItems, const std::vector<std::pair<int, IDemoIndex::CEntry>> &vInfos)
+{
+	// new items are appended, so the positions of the others stay valid
+	for(const CDemoItem &Item : vItems)
+	{
+		if((size_t)Item.m_ScanIndex >= m_vDemolistScanPositions.size())
+			m_vDemolistScanPositions.resize(Item.m_ScanIndex + 1, -1);
+		m_vDemolistScanPositions[Item.m_ScanIndex] = m_vDemos.size();
+		m_vDemos.push_back(Item);
+	}
+	for(const auto &[ScanIndex, Entry] : vInfos)
+	{
+		if(ScanIndex < 0 || (size_t)ScanIndex >= m_vDemolistScanPositions.size() || m_vDemolistScanPositions[ScanIndex] < 0)
+			continue;
+		CDemoItem &Item = m_vDemos[m_vDemolistScanPositions[ScanIndex]];
+		Item.m_Valid = Entry.m_Valid;
+		Item.m_Info = Entry.m_Info;
+		Item.m_TimelineMarkers = Entry.m_TimelineMarkers;
+		Item.m_MapInfo = Entry.m_MapInfo;
+		Item.m_InfosLoaded = true;
+	}
+	if(!vItems.empty())
+		DemolistRefresh();
+}
+
+void CMenus::DemolistRefresh()
+{
+	// keep the selection without scrolling the list while the user browses it
+	if(m_aCurrentDemoSelectionName[0] == '\0')
+	{
+		DemolistOnUpdate(true);
+	}
+	else
+	{
+		const bool SelectedReveal = m_DemolistSelectedReveal;
+		DemolistOnUpdate(false);
+		m_DemolistSelectedReveal = SelectedReveal;
 	}
-	RefreshFilteredDemos();
 }
 
 void CMenus::RefreshFilteredDemos()
@@ -1051,11 +1230,24 @@ bool CMenus::FetchHeader(CDemoItem &Item)
 
 void CMenus::FetchAllHeaders()
 {
-	for(auto &Item : m_vDemos)
+	if(m_pDemoListJob)
 	{
-		FetchHeader(Item);
+		// the running job fetches them once it has listed the folder
+		m_pDemoListJob->m_FetchInfo = true;
+		return;
+	}
+
+	std::vector<CDemoItem> vItems;
+	for(const auto &Item : m_vDemos)
+	{
+		if(!Item.m_IsDir && !Item.m_InfosLoaded && Item.m_ScanIndex >= 0)
+			vItems.push_back(Item);
 	}
-	std::stable_sort(m_vDemos.begin(), m_vDemos.end());
+	if(vItems.empty())
+		return;
+	DemolistIndexScanPositions();
+	m_pDemoListJob = std::make_shared<CDemoListJob>(Storage(), Console(), DemoPlayer(), m_aCurrentDemoFolder, m_DemolistStorageType, m_DemolistMultipleStorages, true, std::move(vItems));
+	Engine()->AddJob(m_pDemoListJob);
 }
 
 void CMenus::RenderDemoBrowser(CUIRect MainView)
@@ -1081,6 +1273,7 @@ void CMenus::RenderDemoBrowserList(CUIRect ListView, bool &WasListboxItemActivat
 		DemolistOnUpdate(true);
 		m_DemoBrowserListInitialized = true;
 	}
+	DemolistUpdateJob();
 
 #if defined(CONF_VIDEORECORDER)
 	if(!m_DemoRenderInput.IsEmpty())
@@ -1125,6 +1318,15 @@ void CMenus::RenderDemoBrowserList(CUIRect ListView, bool &WasListboxItemActivat
 	Headers.Draw(ColorRGBA(1.0f, 1.0f, 1.0f, 0.25f), IGraphics::CORNER_T, 5.0f);
 	ListBox.Draw(ColorRGBA(0.0f, 0.0f, 0.0f, 0.15f), IGraphics::CORNER_B, 5.0f);
 
+	if(m_pDemoListJob)
+	{
+		CUIRect Status;
+		ListBox.HSplitBottom(ms_ListheaderHeight, &ListBox, &Status);
+		char aStatus[128];
+		str_format(aStatus, sizeof(aStatus), "%s (%d)", Localize("Loading demo files"), m_pDemoListJob->m_NumListed.load());
+		UI()->DoLabel(&Status, aStatus, Status.h * CUI::ms_FontmodHeight * 0.8f, TEXTALIGN_MC);
+	}
+
 	for(auto &Col : s_aCols)
 	{
 		if(Col.m_Direction == -1)
@@ -1160,6 +1362,8 @@ void CMenus::RenderDemoBrowserList(CUIRect ListView, bool &WasListboxItemActivat
 				g_Config.m_BrDemoSort = Col.m_Sort;
 				// Don't rescan in order to keep fetched headers, just resort
 				std::stable_sort(m_vDemos.begin(), m_vDemos.end());
+				if(m_pDemoListJob)
+					DemolistIndexScanPositions();
 				DemolistOnUpdate(false);
 			}
 		}
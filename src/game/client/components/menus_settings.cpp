@@ -723,6 +723,8 @@ void CMenus::RenderSettingsTee(CUIRect MainView)
 	if(s_InitSkinlist || m_pClient->m_Skins.Num() != s_SkinCount || m_SkinFavoritesChanged || (m_pClient->m_Skins.IsDownloadingSkins() && (CurTime - s_SkinLastRebuildTime > 500ms)))
 	{
 		s_SkinLastRebuildTime = CurTime;
+		// the list shows all skins, so they all have to be loaded
+		m_pClient->m_Skins.LoadAll();
 		s_vSkinList.clear();
 		s_vSkinListHelper.clear();
 		s_vFavoriteSkinListHelper.clear();
@@ -1,5 +1,6 @@
 /* (c) Magnus Auvinen. See licence.txt in the root of the distribution for more information. */
 /* If you are missing that file, acquire a complete release at teeworlds.com.                */
+#include <base/log.h>
 #include <base/math.h>
 #include <engine/demo.h>
 #include <engine/graphics.h>
@@ -10,6 +11,10 @@
 
 #include <game/client/gameclient.h>
 
+#include <chrono>
+
+using namespace std::chrono_literals;
+
 CParticles::CParticles()
 {
 	OnReset();
@@ -19,21 +24,62 @@ CParticles::CParticles()
 	m_RenderGeneral.m_pParts = this;
 }
 
-void CParticles::OnReset()
+void CParticles::CParticleGroup::Add(const CParticle *pPart, float TimePassed)
 {
-	// reset particles
-	for(int i = 0; i < MAX_PARTICLES; i++)
+	m_vPosX.push_back(pPart->m_Pos.x);
+	m_vPosY.push_back(pPart->m_Pos.y);
+	m_vVelX.push_back(pPart->m_Vel.x);
+	m_vVelY.push_back(pPart->m_Vel.y);
+	m_vLife.push_back(TimePassed);
+	m_vLifeSpan.push_back(pPart->m_LifeSpan);
+	m_vRot.push_back(pPart->m_Rot);
+	m_vRotspeed.push_back(pPart->m_Rotspeed);
+	m_vGravity.push_back(pPart->m_Gravity);
+	m_vFriction.push_back(pPart->m_Friction);
+	m_vStartSize.push_back(pPart->m_StartSize);
+	m_vEndSize.push_back(pPart->m_EndSize);
+	// without alpha fading both ends are the color's alpha, so rendering
+	// can always interpolate
+	m_vStartAlpha.push_back(pPart->m_UseAlphaFading ? pPart->m_StartAlpha : pPart->m_Color.a);
+	m_vEndAlpha.push_back(pPart->m_UseAlphaFading ? pPart->m_EndAlpha : pPart->m_Color.a);
+	m_vColor.push_back(pPart->m_Color);
+	m_vSpr.push_back(pPart->m_Spr);
+	m_vCollides.push_back(pPart->m_Collides);
+}
+
+void CParticles::CParticleGroup::Clear()
+{
+	ForEachArray([](auto &vArray) { vArray.clear(); });
+}
+
+int CParticles::CParticleGroup::RemoveDead()
+{
+	const int Num = Size();
+	int First = 0;
+	while(First < Num && m_vLife[First] <= m_vLifeSpan[First])
+		First++;
+	if(First == Num)
+		return 0;
+
+	// keep the order of the alive particles, the render order depends on it
+	int Alive = First;
+	for(int i = First + 1; i < Num; i++)
 	{
-		m_aParticles[i].m_PrevPart = i - 1;
-		m_aParticles[i].m_NextPart = i + 1;
+		if(m_vLife[i] > m_vLifeSpan[i])
+			continue;
+		ForEachArray([&](auto &vArray) { vArray[Alive] = vArray[i]; });
+		Alive++;
 	}
+	ForEachArray([&](auto &vArray) { vArray.resize(Alive); });
+	return Num - Alive;
+}
 
-	m_aParticles[0].m_PrevPart = 0;
-	m_aParticles[MAX_PARTICLES - 1].m_NextPart = -1;
-	m_FirstFree = 0;
-
-	for(int &FirstPart : m_aFirstPart)
-		FirstPart = -1;
+void CParticles::OnReset()
+{
+	// reset particles
+	for(auto &Group : m_aGroups)
+		Group.Clear();
+	m_NumParticles = 0;
 }
 
 void CParticles::Add(int Group, CParticle *pPart, float TimePassed)
@@ -50,27 +96,11 @@ void CParticles::Add(int Group, CParticle *pPart, float TimePassed)
 			return;
 	}
 
-	if(m_FirstFree == -1)
+	if(m_NumParticles >= MAX_PARTICLES)
 		return;
 
-	// remove from the free list
-	int Id = m_FirstFree;
-	m_FirstFree = m_aParticles[Id].m_NextPart;
-	if(m_FirstFree != -1)
-		m_aParticles[m_FirstFree].m_PrevPart = -1;
-
-	// copy data
-	m_aParticles[Id] = *pPart;
-
-	// insert to the group list
-	m_aParticles[Id].m_PrevPart = -1;
-	m_aParticles[Id].m_NextPart = m_aFirstPart[Group];
-	if(m_aFirstPart[Group] != -1)
-		m_aParticles[m_aFirstPart[Group]].m_PrevPart = Id;
-	m_aFirstPart[Group] = Id;
-
-	// set some parameters
-	m_aParticles[Id].m_Life = TimePassed;
+	m_aGroups[Group].Add(pPart, TimePassed);
+	m_NumParticles++;
 }
 
 void CParticles::Update(float TimePassed)
@@ -91,55 +121,85 @@ void CParticles::Update(float TimePassed)
 		FrictionFraction -= 0.05f;
 	}
 
-	for(int &FirstPart : m_aFirstPart)
+	for(auto &Group : m_aGroups)
+	{
+		UpdateGroup(Group, TimePassed, FrictionCount);
+		m_NumParticles -= Group.RemoveDead();
+	}
+}
+
+void CParticles::UpdateGroup(CParticleGroup &Group, float TimePassed, int FrictionCount)
+{
+	const int Num = Group.Size();
+	if(Num == 0)
+		return;
+
+	// plain loops over the arrays, so the compiler can vectorize them
+	float *pPosX = Group.m_vPosX.data();
+	float *pPosY = Group.m_vPosY.data();
+	float *pVelX = Group.m_vVelX.data();
+	float *pVelY = Group.m_vVelY.data();
+	const float *pGravity = Group.m_vGravity.data();
+	const float *pFriction = Group.m_vFriction.data();
+
+	for(int i = 0; i < Num; i++)
+		pVelY[i] += pGravity[i] * TimePassed;
+
+	for(int f = 0; f < FrictionCount; f++) // apply friction
 	{
-		int i = FirstPart;
-		while(i != -1)
+		for(int i = 0; i < Num; i++)
 		{
-			int Next = m_aParticles[i].m_NextPart;
-			//m_aParticles[i].vel += flow_get(m_aParticles[i].pos)*time_passed * m_aParticles[i].flow_affected;
-			m_aParticles[i].m_Vel.y += m_aParticles[i].m_Gravity * TimePassed;
+			pVelX[i] *= pFriction[i];
+			pVelY[i] *= pFriction[i];
+		}
+	}
 
-			for(int f = 0; f < FrictionCount; f++) // apply friction
-				m_aParticles[i].m_Vel *= m_aParticles[i].m_Friction;
+	for(int i = 0; i < Num; i++)
+	{
+		pVelX[i] *= TimePassed;
+		pVelY[i] *= TimePassed;
+	}
 
-			// move the point
-			vec2 Vel = m_aParticles[i].m_Vel * TimePassed;
-			if(m_aParticles[i].m_Collides)
-			{
-				Collision()->MovePoint(&m_aParticles[i].m_Pos, &Vel, random_float(0.1f, 1.0f), NULL);
-			}
-			else
-			{
-				m_aParticles[i].m_Pos += Vel;
-			}
-			m_aParticles[i].m_Vel = Vel * (1.0f / TimePassed);
+	// find all colliding particles that would end up in a solid tile first,
+	// only those bounce and stay in place (see CCollision::MovePoint)
+	m_vCollisions.clear();
+	const CCollision *pCollision = Collision();
+	const uint8_t *pCollides = Group.m_vCollides.data();
+	for(int i = 0; i < Num; i++)
+	{
+		if(pCollides[i] && pCollision->CheckPoint(pPosX[i] + pVelX[i], pPosY[i] + pVelY[i]))
+			m_vCollisions.push_back(i);
+	}
 
-			m_aParticles[i].m_Life += TimePassed;
-			m_aParticles[i].m_Rot += TimePassed * m_aParticles[i].m_Rotspeed;
+	m_vMove.assign(Num, 1.0f);
+	for(int i : m_vCollisions)
+	{
+		vec2 Pos(pPosX[i], pPosY[i]);
+		vec2 Vel(pVelX[i], pVelY[i]);
+		pCollision->MovePoint(&Pos, &Vel, random_float(0.1f, 1.0f), nullptr);
+		pVelX[i] = Vel.x;
+		pVelY[i] = Vel.y;
+		m_vMove[i] = 0.0f;
+	}
 
-			// check particle death
-			if(m_aParticles[i].m_Life > m_aParticles[i].m_LifeSpan)
-			{
-				// remove it from the group list
-				if(m_aParticles[i].m_PrevPart != -1)
-					m_aParticles[m_aParticles[i].m_PrevPart].m_NextPart = m_aParticles[i].m_NextPart;
-				else
-					FirstPart = m_aParticles[i].m_NextPart;
-
-				if(m_aParticles[i].m_NextPart != -1)
-					m_aParticles[m_aParticles[i].m_NextPart].m_PrevPart = m_aParticles[i].m_PrevPart;
-
-				// insert to the free list
-				if(m_FirstFree != -1)
-					m_aParticles[m_FirstFree].m_PrevPart = i;
-				m_aParticles[i].m_PrevPart = -1;
-				m_aParticles[i].m_NextPart = m_FirstFree;
-				m_FirstFree = i;
-			}
+	// move the points
+	const float *pMove = m_vMove.data();
+	const float InvTimePassed = 1.0f / TimePassed;
+	for(int i = 0; i < Num; i++)
+	{
+		pPosX[i] += pVelX[i] * pMove[i];
+		pPosY[i] += pVelY[i] * pMove[i];
+		pVelX[i] *= InvTimePassed;
+		pVelY[i] *= InvTimePassed;
+	}
 
-			i = Next;
-		}
+	float *pLife = Group.m_vLife.data();
+	float *pRot = Group.m_vRot.data();
+	const float *pRotspeed = Group.m_vRotspeed.data();
+	for(int i = 0; i < Num; i++)
+	{
+		pLife[i] += TimePassed;
+		pRot[i] += TimePassed * pRotspeed[i];
 	}
 }
 
@@ -189,23 +249,77 @@ void CParticles::OnInit()
 	Graphics()->QuadContainerUpload(m_ExtraParticleQuadContainerIndex);
 }
 
-bool CParticles::ParticleIsVisibleOnScreen(const vec2 &CurPos, float CurSize)
+void CParticles::OnConsoleInit()
 {
-	float ScreenX0, ScreenY0, ScreenX1, ScreenY1;
-	Graphics()->GetScreen(&ScreenX0, &ScreenY0, &ScreenX1, &ScreenY1);
+	Console()->Register("bench_particles", "i[particles] ?i[frames]", CFGFLAG_CLIENT, ConBenchParticles, this, "Measure the time to update and render the given number of particles");
+}
 
-	// for simplicity assume the worst case rotation, that increases the bounding box around the particle by its diagonal
-	const float SqrtOf2 = std::sqrt(2);
-	CurSize = SqrtOf2 * CurSize;
+void CParticles::ConBenchParticles(IConsole::IResult *pResult, void *pUserData)
+{
+	CParticles *pSelf = (CParticles *)pUserData;
+	if(pSelf->Client()->State() != IClient::STATE_ONLINE && pSelf->Client()->State() != IClient::STATE_DEMOPLAYBACK)
+	{
+		log_error("particles", "bench_particles needs a loaded map");
+		return;
+	}
+	const int NumParticles = clamp(pResult->GetInteger(0), 1, (int)MAX_PARTICLES);
+	const int NumFrames = pResult->NumArguments() > 1 ? maximum(pResult->GetInteger(1), 1) : 100;
+	const float FrameTime = 1.0f / 60.0f;
+
+	// particles that live through the whole benchmark, spread around the
+	// camera like the debris of many explosions
+	pSelf->OnReset();
+	const vec2 Center = pSelf->m_pClient->m_Camera.m_Center;
+	for(int i = 0; i < NumParticles; i++)
+	{
+		CParticle p;
+		p.SetDefault();
+		p.m_Spr = SPRITE_PART_SLICE + i % (SPRITE_PART9 - SPRITE_PART_SLICE + 1);
+		p.m_Pos = Center + random_direction() * random_float(0.0f, 600.0f);
+		p.m_Vel = random_direction() * random_float(100.0f, 1000.0f);
+		p.m_LifeSpan = NumFrames * FrameTime + 1.0f;
+		p.m_StartSize = random_float(8.0f, 32.0f);
+		p.m_EndSize = 0;
+		p.m_Rot = random_angle();
+		p.m_Rotspeed = random_float(-pi, pi);
+		p.m_Gravity = random_float(-400.0f, 800.0f);
+		p.m_Friction = 0.9f;
+		p.m_Collides = i % 4 != 0;
+		pSelf->m_aGroups[i % NUM_GROUPS].Add(&p, 0.0f);
+		pSelf->m_NumParticles++;
+	}
+
+	float aPoints[4];
+	pSelf->Graphics()->GetScreen(&aPoints[0], &aPoints[1], &aPoints[2], &aPoints[3]);
+	pSelf->Graphics()->MapScreen(Center.x - 800.0f, Center.y - 450.0f, Center.x + 800.0f, Center.y + 450.0f);
+
+	std::chrono::nanoseconds UpdateTime = 0ns;
+	std::chrono::nanoseconds RenderTime = 0ns;
+	for(int Frame = 0; Frame < NumFrames; Frame++)
+	{
+		const std::chrono::nanoseconds Start = time_get_nanoseconds();
+		pSelf->Update(FrameTime);
+		const std::chrono::nanoseconds Updated = time_get_nanoseconds();
+		for(int Group = 0; Group < NUM_GROUPS; Group++)
+			pSelf->RenderGroup(Group);
+		UpdateTime += Updated - Start;
+		RenderTime += time_get_nanoseconds() - Updated;
+	}
 
-	// always uses the mid of the particle
-	float SizeHalf = CurSize / 2;
+	pSelf->Graphics()->MapScreen(aPoints[0], aPoints[1], aPoints[2], aPoints[3]);
+	pSelf->OnReset();
 
-	return CurPos.x + SizeHalf >= ScreenX0 && CurPos.x - SizeHalf <= ScreenX1 && CurPos.y + SizeHalf >= ScreenY0 && CurPos.y - SizeHalf <= ScreenY1;
+	log_info("particles", "bench: %d particles, %d frames, update %.3fms/frame, render %.3fms/frame",
+		NumParticles, NumFrames, UpdateTime / 1us / 1000.0 / NumFrames, RenderTime / 1us / 1000.0 / NumFrames);
 }
 
 void CParticles::RenderGroup(int Group)
 {
+	const CParticleGroup &Particles = m_aGroups[Group];
+	const int Num = Particles.Size();
+	if(Num == 0)
+		return;
+
 	IGraphics::CTextureHandle *aParticles = GameClient()->m_ParticlesSkin.m_aSpriteParticles;
 	int FirstParticleOffset = SPRITE_PART_SLICE;
 	int ParticleQuadContainerIndex = m_ParticleQuadContainerIndex;
@@ -216,84 +330,80 @@ void CParticles::RenderGroup(int Group)
 		ParticleQuadContainerIndex = m_ExtraParticleQuadContainerIndex;
 	}
 
+	// interpolate size and alpha of all particles at once
+	m_vRenderSize.resize(Num);
+	m_vRenderAlpha.resize(Num);
+	{
+		const float *pLife = Particles.m_vLife.data();
+		const float *pLifeSpan = Particles.m_vLifeSpan.data();
+		const float *pStartSize = Particles.m_vStartSize.data();
+		const float *pEndSize = Particles.m_vEndSize.data();
+		const float *pStartAlpha = Particles.m_vStartAlpha.data();
+		const float *pEndAlpha = Particles.m_vEndAlpha.data();
+		float *pSize = m_vRenderSize.data();
+		float *pAlpha = m_vRenderAlpha.data();
+		for(int i = 0; i < Num; i++)
+		{
+			const float a = pLife[i] / pLifeSpan[i];
+			pSize[i] = mix(pStartSize[i], pEndSize[i], a);
+			pAlpha[i] = mix(pStartAlpha[i], pEndAlpha[i], a);
+		}
+	}
+
+	float ScreenX0, ScreenY0, ScreenX1, ScreenY1;
+	Graphics()->GetScreen(&ScreenX0, &ScreenY0, &ScreenX1, &ScreenY1);
+
+	// the current position, respecting the size, is inside the viewport
+	// for simplicity assume the worst case rotation, that increases the bounding box around the particle by its diagonal
+	const float SqrtOf2 = std::sqrt(2);
+	auto &&IsVisible = [&](int i) {
+		const float SizeHalf = SqrtOf2 * m_vRenderSize[i] / 2;
+		return Particles.m_vPosX[i] + SizeHalf >= ScreenX0 && Particles.m_vPosX[i] - SizeHalf <= ScreenX1 && Particles.m_vPosY[i] + SizeHalf >= ScreenY0 && Particles.m_vPosY[i] - SizeHalf <= ScreenY1;
+	};
+
+	// newest particles are rendered first
 	// don't use the buffer methods here, else the old renderer gets many draw calls
 	if(Graphics()->IsQuadContainerBufferingEnabled())
 	{
-		int i = m_aFirstPart[Group];
-
 		static IGraphics::SRenderSpriteInfo s_aParticleRenderInfo[MAX_PARTICLES];
 
 		int CurParticleRenderCount = 0;
 
 		// batching makes sense for stuff like ninja particles
-		ColorRGBA LastColor;
-		int LastQuadOffset = 0;
+		ColorRGBA LastColor = Particles.m_vColor[Num - 1];
+		LastColor.a = m_vRenderAlpha[Num - 1];
+		int LastQuadOffset = Particles.m_vSpr[Num - 1];
+		Graphics()->SetColor(LastColor.r, LastColor.g, LastColor.b, LastColor.a);
 
-		if(i != -1)
+		for(int i = Num - 1; i >= 0; i--)
 		{
-			float Alpha = m_aParticles[i].m_Color.a;
-			if(m_aParticles[i].m_UseAlphaFading)
-			{
-				float a = m_aParticles[i].m_Life / m_aParticles[i].m_LifeSpan;
-				Alpha = mix(m_aParticles[i].m_StartAlpha, m_aParticles[i].m_EndAlpha, a);
-			}
-			LastColor.r = m_aParticles[i].m_Color.r;
-			LastColor.g = m_aParticles[i].m_Color.g;
-			LastColor.b = m_aParticles[i].m_Color.b;
-			LastColor.a = Alpha;
-
-			Graphics()->SetColor(
-				m_aParticles[i].m_Color.r,
-				m_aParticles[i].m_Color.g,
-				m_aParticles[i].m_Color.b,
-				Alpha);
-
-			LastQuadOffset = m_aParticles[i].m_Spr;
-		}
+			if(!IsVisible(i))
+				continue;
 
-		while(i != -1)
-		{
-			int QuadOffset = m_aParticles[i].m_Spr;
-			float a = m_aParticles[i].m_Life / m_aParticles[i].m_LifeSpan;
-			vec2 p = m_aParticles[i].m_Pos;
-			float Size = mix(m_aParticles[i].m_StartSize, m_aParticles[i].m_EndSize, a);
-			float Alpha = m_aParticles[i].m_Color.a;
-			if(m_aParticles[i].m_UseAlphaFading)
+			const int QuadOffset = Particles.m_vSpr[i];
+			const ColorRGBA &Color = Particles.m_vColor[i];
+			const float Alpha = m_vRenderAlpha[i];
+			if((size_t)CurParticleRenderCount == gs_GraphicsMaxParticlesRenderCount || LastColor.r != Color.r || LastColor.g != Color.g || LastColor.b != Color.b || LastColor.a != Alpha || LastQuadOffset != QuadOffset)
 			{
-				Alpha = mix(m_aParticles[i].m_StartAlpha, m_aParticles[i].m_EndAlpha, a);
-			}
+				Graphics()->TextureSet(aParticles[LastQuadOffset - FirstParticleOffset]);
+				Graphics()->RenderQuadContainerAsSpriteMultiple(ParticleQuadContainerIndex, LastQuadOffset - FirstParticleOffset, CurParticleRenderCount, s_aParticleRenderInfo);
+				CurParticleRenderCount = 0;
+				LastQuadOffset = QuadOffset;
 
-			// the current position, respecting the size, is inside the viewport, render it, else ignore
-			if(ParticleIsVisibleOnScreen(p, Size))
-			{
-				if((size_t)CurParticleRenderCount == gs_GraphicsMaxParticlesRenderCount || LastColor.r != m_aParticles[i].m_Color.r || LastColor.g != m_aParticles[i].m_Color.g || LastColor.b != m_aParticles[i].m_Color.b || LastColor.a != Alpha || LastQuadOffset != QuadOffset)
-				{
-					Graphics()->TextureSet(aParticles[LastQuadOffset - FirstParticleOffset]);
-					Graphics()->RenderQuadContainerAsSpriteMultiple(ParticleQuadContainerIndex, LastQuadOffset - FirstParticleOffset, CurParticleRenderCount, s_aParticleRenderInfo);
-					CurParticleRenderCount = 0;
-					LastQuadOffset = QuadOffset;
-
-					Graphics()->SetColor(
-						m_aParticles[i].m_Color.r,
-						m_aParticles[i].m_Color.g,
-						m_aParticles[i].m_Color.b,
-						Alpha);
-
-					LastColor.r = m_aParticles[i].m_Color.r;
-					LastColor.g = m_aParticles[i].m_Color.g;
-					LastColor.b = m_aParticles[i].m_Color.b;
-					LastColor.a = Alpha;
-				}
-
-				s_aParticleRenderInfo[CurParticleRenderCount].m_Pos[0] = p.x;
-				s_aParticleRenderInfo[CurParticleRenderCount].m_Pos[1] = p.y;
-				s_aParticleRenderInfo[CurParticleRenderCount].m_Scale = Size;
-				s_aParticleRenderInfo[CurParticleRenderCount].m_Rotation = m_aParticles[i].m_Rot;
-
-				++CurParticleRenderCount;
+				Graphics()->SetColor(Color.r, Color.g, Color.b, Alpha);
+
+				LastColor.r = Color.r;
+				LastColor.g = Color.g;
+				LastColor.b = Color.b;
+				LastColor.a = Alpha;
 			}
 
-			i = m_aParticles[i].m_NextPart;
+			s_aParticleRenderInfo[CurParticleRenderCount].m_Pos[0] = Particles.m_vPosX[i];
+			s_aParticleRenderInfo[CurParticleRenderCount].m_Pos[1] = Particles.m_vPosY[i];
+			s_aParticleRenderInfo[CurParticleRenderCount].m_Scale = m_vRenderSize[i];
+			s_aParticleRenderInfo[CurParticleRenderCount].m_Rotation = Particles.m_vRot[i];
+
+			++CurParticleRenderCount;
 		}
 
 		Graphics()->TextureSet(aParticles[LastQuadOffset - FirstParticleOffset]);
@@ -301,42 +411,26 @@ void CParticles::RenderGroup(int Group)
 	}
 	else
 	{
-		int i = m_aFirstPart[Group];
-
 		Graphics()->BlendNormal();
 		Graphics()->WrapClamp();
 
-		while(i != -1)
+		for(int i = Num - 1; i >= 0; i--)
 		{
-			float a = m_aParticles[i].m_Life / m_aParticles[i].m_LifeSpan;
-			vec2 p = m_aParticles[i].m_Pos;
-			float Size = mix(m_aParticles[i].m_StartSize, m_aParticles[i].m_EndSize, a);
-			float Alpha = m_aParticles[i].m_Color.a;
-			if(m_aParticles[i].m_UseAlphaFading)
-			{
-				Alpha = mix(m_aParticles[i].m_StartAlpha, m_aParticles[i].m_EndAlpha, a);
-			}
+			if(!IsVisible(i))
+				continue;
 
-			// the current position, respecting the size, is inside the viewport, render it, else ignore
-			if(ParticleIsVisibleOnScreen(p, Size))
-			{
-				Graphics()->TextureSet(aParticles[m_aParticles[i].m_Spr - FirstParticleOffset]);
-				Graphics()->QuadsBegin();
+			const float Size = m_vRenderSize[i];
+			Graphics()->TextureSet(aParticles[Particles.m_vSpr[i] - FirstParticleOffset]);
+			Graphics()->QuadsBegin();
 
-				Graphics()->QuadsSetRotation(m_aParticles[i].m_Rot);
+			Graphics()->QuadsSetRotation(Particles.m_vRot[i]);
 
-				Graphics()->SetColor(
-					m_aParticles[i].m_Color.r,
-					m_aParticles[i].m_Color.g,
-					m_aParticles[i].m_Color.b,
-					Alpha);
-
-				IGraphics::CQuadItem QuadItem(p.x, p.y, Size, Size);
-				Graphics()->QuadsDraw(&QuadItem, 1);
-				Graphics()->QuadsEnd();
-			}
+			const ColorRGBA &Color = Particles.m_vColor[i];
+			Graphics()->SetColor(Color.r, Color.g, Color.b, m_vRenderAlpha[i]);
 
-			i = m_aParticles[i].m_NextPart;
+			IGraphics::CQuadItem QuadItem(Particles.m_vPosX[i], Particles.m_vPosY[i], Size, Size);
+			Graphics()->QuadsDraw(&QuadItem, 1);
+			Graphics()->QuadsEnd();
 		}
 		Graphics()->WrapNormal();
 		Graphics()->BlendNormal();
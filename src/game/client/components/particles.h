@@ -2,9 +2,14 @@
 /* If you are missing that file, acquire a complete release at teeworlds.com.                */
 #ifndef GAME_CLIENT_COMPONENTS_PARTICLES_H
 #define GAME_CLIENT_COMPONENTS_PARTICLES_H
+#include <base/color.h>
 #include <base/vmath.h>
+#include <engine/console.h>
 #include <game/client/component.h>
 
+#include <cstdint>
+#include <vector>
+
 // particles
 struct CParticle
 {
@@ -52,11 +57,6 @@ struct CParticle
 	ColorRGBA m_Color;
 
 	bool m_Collides;
-
-	// set by the particle system
-	float m_Life;
-	int m_PrevPart;
-	int m_NextPart;
 };
 
 class CParticles : public CComponent
@@ -81,6 +81,7 @@ public:
 	virtual void OnReset() override;
 	virtual void OnRender() override;
 	virtual void OnInit() override;
+	virtual void OnConsoleInit() override;
 
 private:
 	int m_ParticleQuadContainerIndex;
@@ -91,12 +92,71 @@ private:
 		MAX_PARTICLES = 1024 * 8,
 	};
 
-	CParticle m_aParticles[MAX_PARTICLES];
-	int m_FirstFree;
-	int m_aFirstPart[NUM_GROUPS];
+	// particles of one group stored as structure of arrays in the order
+	// they were added, so the update loops can be vectorized and dead
+	// particles can be removed by compacting the arrays
+	class CParticleGroup
+	{
+	public:
+		std::vector<float> m_vPosX;
+		std::vector<float> m_vPosY;
+		std::vector<float> m_vVelX;
+		std::vector<float> m_vVelY;
+		std::vector<float> m_vLife;
+		std::vector<float> m_vLifeSpan;
+		std::vector<float> m_vRot;
+		std::vector<float> m_vRotspeed;
+		std::vector<float> m_vGravity;
+		std::vector<float> m_vFriction;
+		std::vector<float> m_vStartSize;
+		std::vector<float> m_vEndSize;
+		std::vector<float> m_vStartAlpha;
+		std::vector<float> m_vEndAlpha;
+		std::vector<ColorRGBA> m_vColor;
+		std::vector<int> m_vSpr;
+		std::vector<uint8_t> m_vCollides;
+
+		template<typename F>
+		void ForEachArray(F &&Func)
+		{
+			Func(m_vPosX);
+			Func(m_vPosY);
+			Func(m_vVelX);
+			Func(m_vVelY);
+			Func(m_vLife);
+			Func(m_vLifeSpan);
+			Func(m_vRot);
+			Func(m_vRotspeed);
+			Func(m_vGravity);
+			Func(m_vFriction);
+			Func(m_vStartSize);
+			Func(m_vEndSize);
+			Func(m_vStartAlpha);
+			Func(m_vEndAlpha);
+			Func(m_vColor);
+			Func(m_vSpr);
+			Func(m_vCollides);
+		}
+
+		int Size() const { return m_vPosX.size(); }
+		void Add(const CParticle *pPart, float TimePassed);
+		void Clear();
+		// removes all particles that outlived their life span, returns the number of removed particles
+		int RemoveDead();
+	};
+
+	CParticleGroup m_aGroups[NUM_GROUPS];
+	int m_NumParticles;
+
+	// scratch buffers reused every frame
+	std::vector<float> m_vMove;
+	std::vector<int> m_vCollisions;
+	std::vector<float> m_vRenderSize;
+	std::vector<float> m_vRenderAlpha;
 
 	void RenderGroup(int Group);
 	void Update(float TimePassed);
+	void UpdateGroup(CParticleGroup &Group, float TimePassed, int FrictionCount);
 
 	template<int TGROUP>
 	class CRenderGroup : public CComponent
@@ -112,6 +172,6 @@ private:
 	CRenderGroup<GROUP_EXTRA> m_RenderExtra;
 	CRenderGroup<GROUP_GENERAL> m_RenderGeneral;
 
-	bool ParticleIsVisibleOnScreen(const vec2 &CurPos, float CurSize);
+	static void ConBenchParticles(IConsole::IResult *pResult, void *pUserData);
 };
 #endif
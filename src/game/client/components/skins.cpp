@@ -14,8 +14,12 @@
 #include <game/client/gameclient.h>
 #include <game/localization.h>
 
+#include <chrono>
+
 #include "skins.h"
 
+using namespace std::chrono_literals;
+
 bool CSkins::IsVanillaSkin(const char *pName)
 {
 	return std::any_of(std::begin(VANILLA_SKINS), std::end(VANILLA_SKINS), [pName](const char *pVanillaSkin) { return str_comp(pName, pVanillaSkin) == 0; });
@@ -39,6 +43,25 @@ CSkins::CGetPngFile::CGetPngFile(CSkins *pSkins, const char *pUrl, IStorage *pSt
 	WriteToFile(pStorage, pDest, IStorage::TYPE_SAVE);
 	Timeout(CTimeout{0, 0, 0, 0});
 	LogProgress(HTTPLOG::NONE);
+	Priority(HTTPPRIORITY::LOW);
+}
+
+CSkins::CSkinLoadJob::CSkinLoadJob(CSkins *pSkins, const char *pName, const char *pPath, int StorageType) :
+	m_pSkins(pSkins),
+	m_StorageType(StorageType)
+{
+	str_copy(m_aName, pName);
+	str_copy(m_aPath, pPath);
+}
+
+CSkins::CSkinLoadJob::~CSkinLoadJob()
+{
+	free(m_Info.m_pData);
+}
+
+void CSkins::CSkinLoadJob::Run()
+{
+	m_Success = m_pSkins->LoadSkinPNG(m_Info, m_aName, m_aPath, m_StorageType);
 }
 
 struct SSkinScanUser
@@ -67,10 +90,23 @@ int CSkins::SkinScan(const char *pName, int IsDir, int DirType, void *pUser)
 	if(pSelf->m_Skins.find(aNameWithoutPng) != pSelf->m_Skins.end())
 		return 0;
 
+	if(pSelf->m_SkinFiles.find(aNameWithoutPng) != pSelf->m_SkinFiles.end())
+		return 0;
+
 	char aBuf[IO_MAX_PATH_LENGTH];
 	str_format(aBuf, sizeof(aBuf), "skins/%s", pName);
-	pSelf->LoadSkin(aNameWithoutPng, aBuf, DirType);
-	pUserReal->m_SkinLoadedFunc((int)pSelf->m_Skins.size());
+	// the vanilla skins are needed as fallback and for special tees, all
+	// others are only decoded once they are used
+	if(IsVanillaSkin(aNameWithoutPng))
+	{
+		pSelf->LoadSkin(aNameWithoutPng, aBuf, DirType);
+		pUserReal->m_SkinLoadedFunc((int)pSelf->m_Skins.size());
+	}
+	else
+	{
+		auto &&pFile = std::make_unique<CSkinFile>(aNameWithoutPng, aBuf, DirType);
+		pSelf->m_SkinFiles.insert({pFile->GetName(), std::move(pFile)});
+	}
 	return 0;
 }
 
@@ -335,15 +371,25 @@ void CSkins::Refresh(TSkinLoadedCBFunc &&SkinLoadedFunc)
 	}
 
 	m_Skins.clear();
+	m_SkinFiles.clear();
+	m_LoadingSkins = 0;
 	m_DownloadSkins.clear();
 	m_DownloadingSkins = 0;
+
+	const auto StartTime = time_get_nanoseconds();
 	SSkinScanUser SkinScanUser;
 	SkinScanUser.m_pThis = this;
 	SkinScanUser.m_SkinLoadedFunc = SkinLoadedFunc;
 	Storage()->ListDirectory(IStorage::TYPE_ALL, "skins", SkinScan, &SkinScanUser);
+
+	char aBuf[128];
+	str_format(aBuf, sizeof(aBuf), "loaded %d skins and indexed %d more in %.2fms", (int)m_Skins.size(), (int)m_SkinFiles.size(), (time_get_nanoseconds() - StartTime) / 1us / 1000.0);
+	Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "skins", aBuf);
+
 	if(m_Skins.empty())
 	{
-		Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "gameclient", "failed to load skins. folder='skins/'");
+		if(m_SkinFiles.empty())
+			Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "gameclient", "failed to load skins. folder='skins/'");
 		CSkin DummySkin{"dummy"};
 		DummySkin.m_BloodColor = ColorRGBA(1.0f, 1.0f, 1.0f);
 		auto &&pDummySkin = std::make_unique<CSkin>(std::move(DummySkin));
@@ -351,6 +397,65 @@ void CSkins::Refresh(TSkinLoadedCBFunc &&SkinLoadedFunc)
 	}
 }
 
+void CSkins::OnRender()
+{
+	if(!m_LoadingSkins)
+		return;
+
+	// creating the textures has to happen on the main thread, spread it over
+	// multiple frames when many skins finish at once
+	int NumLoaded = 0;
+	for(auto SkinFileIt = m_SkinFiles.begin(); SkinFileIt != m_SkinFiles.end() && NumLoaded < MAX_SKINS_LOADED_PER_FRAME;)
+	{
+		CSkinFile *pFile = SkinFileIt->second.get();
+		if(pFile->m_pTask && pFile->m_pTask->Status() == IJob::STATE_DONE)
+		{
+			FinishLoading(pFile);
+			SkinFileIt = m_SkinFiles.erase(SkinFileIt);
+			NumLoaded++;
+		}
+		else
+		{
+			++SkinFileIt;
+		}
+	}
+	// let everyone who fell back to another skin pick up the loaded ones
+	if(NumLoaded > 0)
+		GameClient()->RefindSkins();
+}
+
+void CSkins::LoadAll()
+{
+	for(auto &SkinFileIt : m_SkinFiles)
+	{
+		if(!SkinFileIt.second->m_pTask)
+			StartLoading(SkinFileIt.second.get());
+	}
+}
+
+void CSkins::StartLoading(CSkinFile *pFile)
+{
+	pFile->m_pTask = std::make_shared<CSkinLoadJob>(this, pFile->GetName(), pFile->m_aPath, pFile->m_StorageType);
+	m_pClient->Engine()->AddJob(pFile->m_pTask);
+	++m_LoadingSkins;
+}
+
+const CSkin *CSkins::FinishLoading(CSkinFile *pFile)
+{
+	std::shared_ptr<CSkinLoadJob> pTask = std::move(pFile->m_pTask);
+	--m_LoadingSkins;
+	if(!pTask->m_Success)
+		return nullptr;
+	const CSkin *pSkin = LoadSkin(pFile->GetName(), pTask->m_Info);
+	if(pSkin)
+	{
+		char aBuf[256];
+		str_format(aBuf, sizeof(aBuf), "loaded skin '%s' on demand", pFile->GetName());
+		Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "skins", aBuf);
+	}
+	return pSkin;
+}
+
 int CSkins::Num()
 {
 	return m_Skins.size();
@@ -400,6 +505,24 @@ const CSkin *CSkins::FindImpl(const char *pName)
 	if(SkinIt != m_Skins.end())
 		return SkinIt->second.get();
 
+	const auto SkinFileIt = m_SkinFiles.find(pName);
+	if(SkinFileIt != m_SkinFiles.end())
+	{
+		CSkinFile *pFile = SkinFileIt->second.get();
+		if(!pFile->m_pTask)
+		{
+			StartLoading(pFile);
+			return nullptr;
+		}
+		if(pFile->m_pTask->Status() != IJob::STATE_DONE)
+			return nullptr;
+		const CSkin *pSkin = FinishLoading(pFile);
+		m_SkinFiles.erase(SkinFileIt);
+		// broken skin files are downloaded like before
+		if(pSkin != nullptr)
+			return pSkin;
+	}
+
 	if(str_comp(pName, "default") == 0)
 		return nullptr;
 
@@ -27,6 +27,46 @@ public:
 		CImageInfo m_Info;
 	};
 
+	// Decodes a skin file from disk on the job pool, the textures are
+	// created on the main thread once it's done.
+	class CSkinLoadJob : public IJob
+	{
+		CSkins *m_pSkins;
+		char m_aName[24];
+		char m_aPath[IO_MAX_PATH_LENGTH];
+		int m_StorageType;
+
+		void Run() override;
+
+	public:
+		CSkinLoadJob(CSkins *pSkins, const char *pName, const char *pPath, int StorageType);
+		~CSkinLoadJob();
+
+		CImageInfo m_Info;
+		bool m_Success = false;
+	};
+
+	// A skin found in the skins directory that isn't loaded yet
+	struct CSkinFile
+	{
+	private:
+		char m_aName[24];
+
+	public:
+		char m_aPath[IO_MAX_PATH_LENGTH];
+		int m_StorageType;
+		std::shared_ptr<CSkinLoadJob> m_pTask;
+
+		CSkinFile(const char *pName, const char *pPath, int StorageType) :
+			m_StorageType(StorageType)
+		{
+			str_copy(m_aName, pName);
+			str_copy(m_aPath, pPath);
+		}
+
+		const char *GetName() const { return m_aName; }
+	};
+
 	struct CDownloadSkin
 	{
 	private:
@@ -60,14 +100,18 @@ public:
 
 	virtual int Sizeof() const override { return sizeof(*this); }
 	void OnInit() override;
+	void OnRender() override;
 
 	void Refresh(TSkinLoadedCBFunc &&SkinLoadedFunc);
+	// Starts loading all skins that haven't been looked up yet, e.g. to list them.
+	void LoadAll();
 	int Num();
 	std::unordered_map<std::string_view, std::unique_ptr<CSkin>> &GetSkinsUnsafe() { return m_Skins; }
 	const CSkin *FindOrNullptr(const char *pName, bool IgnorePrefix = false);
 	const CSkin *Find(const char *pName);
 
 	bool IsDownloadingSkins() { return m_DownloadingSkins; }
+	bool IsLoadingSkins() { return m_LoadingSkins; }
 
 	static bool IsVanillaSkin(const char *pName);
 
@@ -77,7 +121,14 @@ public:
 		"twinbop", "twintri", "warpaint", "x_ninja", "x_spec"};
 
 private:
+	enum
+	{
+		MAX_SKINS_LOADED_PER_FRAME = 8,
+	};
+
 	std::unordered_map<std::string_view, std::unique_ptr<CSkin>> m_Skins;
+	std::unordered_map<std::string_view, std::unique_ptr<CSkinFile>> m_SkinFiles;
+	size_t m_LoadingSkins = 0;
 	std::unordered_map<std::string_view, std::unique_ptr<CDownloadSkin>> m_DownloadSkins;
 	size_t m_DownloadingSkins = 0;
 	char m_aEventSkinPrefix[24];
@@ -85,6 +136,8 @@ private:
 	bool LoadSkinPNG(CImageInfo &Info, const char *pName, const char *pPath, int DirType);
 	const CSkin *LoadSkin(const char *pName, const char *pPath, int DirType);
 	const CSkin *LoadSkin(const char *pName, CImageInfo &Info);
+	void StartLoading(CSkinFile *pFile);
+	const CSkin *FinishLoading(CSkinFile *pFile);
 	const CSkin *FindImpl(const char *pName);
 	static int SkinScan(const char *pName, int IsDir, int DirType, void *pUser);
 };
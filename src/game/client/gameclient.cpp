@@ -231,6 +231,7 @@ void CGameClient::OnInit()
 	// propagate pointers
 	m_UI.Init(Kernel());
 	m_RenderTools.Init(Graphics(), TextRender());
+	m_TextureCache.Init(Storage(), g_Config.m_ClTextureCacheSize);
 
 	int64_t Start = time_get();
 
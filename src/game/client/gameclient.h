@@ -8,6 +8,7 @@
 #include <base/vmath.h>
 #include <engine/client.h>
 #include <engine/console.h>
+#include <engine/gfx/texture_cache.h>
 #include <engine/shared/config.h>
 
 #include <game/collision.h>
@@ -140,6 +141,7 @@ public:
 	CFreezeBars m_FreezeBars;
 	CItems m_Items;
 	CMapImages m_MapImages;
+	CTextureCache m_TextureCache;
 
 	CMapLayers m_MapLayersBackground = CMapLayers{CMapLayers::TYPE_BACKGROUND};
 	CMapLayers m_MapLayersForeground = CMapLayers{CMapLayers::TYPE_FOREGROUND};
@@ -66,6 +66,7 @@ void CUIElement::SUIElementRect::Draw(const CUIRect *pRect, ColorRGBA Color, int
 	m_Y = pRect->y;
 	if(NeedsRecreate)
 	{
+		m_pParent->UI()->m_FrameStats.m_NumRectsCreated++;
 		m_Width = pRect->w;
 		m_Height = pRect->h;
 		m_QuadColor = Color;
@@ -74,12 +75,49 @@ void CUIElement::SUIElementRect::Draw(const CUIRect *pRect, ColorRGBA Color, int
 		m_UIRectQuadContainer = m_pParent->UI()->Graphics()->CreateRectQuadContainer(0, 0, pRect->w, pRect->h, Rounding, Corners);
 		m_pParent->UI()->Graphics()->SetColor(1, 1, 1, 1);
 	}
+	else
+		m_pParent->UI()->m_FrameStats.m_NumRectsReused++;
 
 	m_pParent->UI()->Graphics()->TextureClear();
 	m_pParent->UI()->Graphics()->RenderQuadContainerEx(m_UIRectQuadContainer,
 		0, -1, m_X, m_Y, 1, 1);
 }
 
+void CUIListRowCache::StartFrame()
+{
+	m_Frame++;
+	for(auto It = m_Rows.begin(); It != m_Rows.end();)
+	{
+		if(m_Frame - It->second.m_LastUsedFrame > m_MaxUnusedFrames)
+		{
+			UI()->ResetUIElement(*It->second.m_pElement);
+			m_vpFreeElements.push_back(It->second.m_pElement);
+			It = m_Rows.erase(It);
+		}
+		else
+			++It;
+	}
+}
+
+CUIElement *CUIListRowCache::Get(const char *pKey)
+{
+	auto It = m_Rows.find(pKey);
+	if(It == m_Rows.end())
+	{
+		SRow Row;
+		if(m_vpFreeElements.empty())
+			Row.m_pElement = UI()->GetNewUIElement(m_NumRects);
+		else
+		{
+			Row.m_pElement = m_vpFreeElements.back();
+			m_vpFreeElements.pop_back();
+		}
+		It = m_Rows.emplace(pKey, Row).first;
+	}
+	It->second.m_LastUsedFrame = m_Frame;
+	return It->second.m_pElement;
+}
+
 /********************************************************
  UI
 *********************************************************/
@@ -241,6 +279,9 @@ void CUI::DebugRender()
 	char aBuf[128];
 	str_format(aBuf, sizeof(aBuf), "hot=%p nexthot=%p active=%p lastactive=%p", HotItem(), NextHotItem(), ActiveItem(), m_pLastActiveItem);
 	TextRender()->Text(2.0f, Screen()->h - 12.0f, 10.0f, aBuf);
+
+	str_format(aBuf, sizeof(aBuf), "labels built=%d reused=%d rects built=%d reused=%d time=%.2fms", m_LastFrameStats.m_NumLabelsCreated, m_LastFrameStats.m_NumLabelsReused, m_LastFrameStats.m_NumRectsCreated, m_LastFrameStats.m_NumRectsReused, m_LastFrameStats.m_Time * 1000.0 / time_freq());
+	TextRender()->Text(2.0f, Screen()->h - 24.0f, 10.0f, aBuf);
 }
 
 bool CUI::MouseInside(const CUIRect *pRect) const
@@ -713,6 +754,7 @@ void CUI::DoLabelStreamed(CUIElement::SUIElementRect &RectEl, const CUIRect *pRe
 	RectEl.m_Y = pRect->y;
 	if(NeedsRecreate)
 	{
+		m_FrameStats.m_NumLabelsCreated++;
 		TextRender()->DeleteTextContainer(RectEl.m_UITextContainer);
 
 		RectEl.m_Width = pRect->w;
@@ -735,6 +777,8 @@ void CUI::DoLabelStreamed(CUIElement::SUIElementRect &RectEl, const CUIRect *pRe
 
 		DoLabel(RectEl, &TmpRect, pText, Size, TEXTALIGN_TL, LabelProps, StrLen, pReadCursor);
 	}
+	else
+		m_FrameStats.m_NumLabelsReused++;
 
 	if(RectEl.m_UITextContainer.Valid())
 	{
@@ -12,6 +12,7 @@
 #include <chrono>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 class IClient;
@@ -190,6 +191,20 @@ public:
 	void InitRects(int RequestedRectCount);
 };
 
+/**
+ * Number of text and quad containers of retained UI elements which had to be
+ * built or could be reused in a frame, and the time the frame took between
+ * @link CUI::StartCheck @endlink and @link CUI::FinishCheck @endlink.
+ */
+struct SUIFrameStats
+{
+	int m_NumLabelsCreated = 0;
+	int m_NumLabelsReused = 0;
+	int m_NumRectsCreated = 0;
+	int m_NumRectsReused = 0;
+	int64_t m_Time = 0;
+};
+
 struct SLabelProperties
 {
 	float m_MaxWidth = -1;
@@ -226,6 +241,38 @@ public:
 	CUI *UI() const { return s_pUI; }
 };
 
+/**
+ * Keeps the UI elements of list rows across frames, so the text and quad
+ * containers of a row are only rebuilt when the content or the size of the
+ * row changed. Rows are identified by a key such as a server address. The
+ * elements of rows which were not rendered for a while are reset and reused
+ * for other rows.
+ */
+class CUIListRowCache : private CUIElementBase
+{
+	struct SRow
+	{
+		CUIElement *m_pElement;
+		int m_LastUsedFrame;
+	};
+
+	int m_NumRects;
+	int m_MaxUnusedFrames;
+	int m_Frame = 0;
+	std::unordered_map<std::string, SRow> m_Rows;
+	std::vector<CUIElement *> m_vpFreeElements;
+
+public:
+	CUIListRowCache(int NumRects, int MaxUnusedFrames = 100) :
+		m_NumRects(NumRects), m_MaxUnusedFrames(MaxUnusedFrames) {}
+
+	/**
+	 * Has to be called once per frame before the rows are rendered.
+	 */
+	void StartFrame();
+	CUIElement *Get(const char *pKey);
+};
+
 class CButtonContainer
 {
 };
@@ -263,6 +310,8 @@ struct SPopupMenuProperties
 
 class CUI
 {
+	friend class CUIElement;
+
 public:
 	/**
 	 * These enum values are returned by popup menu functions to specify the behavior.
@@ -358,6 +407,10 @@ private:
 	std::vector<CUIElement *> m_vpOwnUIElements; // ui elements maintained by CUI class
 	std::vector<CUIElement *> m_vpUIElements;
 
+	SUIFrameStats m_FrameStats;
+	SUIFrameStats m_LastFrameStats;
+	int64_t m_FrameStart = 0;
+
 public:
 	static const CLinearScrollbarScale ms_LinearScrollbarScale;
 	static const CLogarithmicScrollbarScale ms_LogarithmicScrollbarScale;
@@ -451,9 +504,16 @@ public:
 	const void *NextHotItem() const { return m_pBecomingHotItem; }
 	const void *ActiveItem() const { return m_pActiveItem; }
 
-	void StartCheck() { m_ActiveItemValid = false; }
+	void StartCheck()
+	{
+		m_ActiveItemValid = false;
+		m_LastFrameStats = m_FrameStats;
+		m_FrameStats = SUIFrameStats();
+		m_FrameStart = time_get();
+	}
 	void FinishCheck()
 	{
+		m_FrameStats.m_Time = time_get() - m_FrameStart;
 		if(!m_ActiveItemValid && m_pActiveItem != nullptr)
 		{
 			SetActiveItem(nullptr);
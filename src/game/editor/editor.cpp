@@ -7220,6 +7220,9 @@ void CEditor::Render()
 	// reset tip
 	str_copy(m_aTooltip, "");
 
+	m_TileLayerRenderTime = 0;
+	m_NumTileChunkUploads = 0;
+
 	// render checker
 	RenderBackground(View, m_CheckerTexture, 32.0f, 1.0f);
 
@@ -7423,6 +7426,7 @@ void CEditor::Render()
 
 	RenderPressedKeys(View);
 	RenderSavingIndicator(View);
+	RenderTileLayerStats(View);
 
 	if(m_Dialog == DIALOG_FILE)
 	{
@@ -7514,6 +7518,21 @@ void CEditor::RenderSavingIndicator(CUIRect View)
 	UI()->RenderProgressSpinner(Spinner.Center(), 8.0f);
 }
 
+void CEditor::RenderTileLayerStats(CUIRect View)
+{
+	if(!g_Config.m_Debug)
+		return;
+
+	char aBuf[128];
+	str_format(aBuf, sizeof(aBuf), "tile layers: %.2f ms, %d chunk uploads", m_TileLayerRenderTime * 1000.0 / time_freq(), m_NumTileChunkUploads);
+
+	UI()->MapScreen();
+	CUIRect Label;
+	View.Margin(10.0f, &View);
+	View.HSplitTop(10.0f, &Label, nullptr);
+	UI()->DoLabel(&Label, aBuf, 10.0f, TEXTALIGN_ML);
+}
+
 void CEditor::FreeDynamicPopupMenus()
 {
 	auto Iterator = m_PopupMessageContexts.begin();
@@ -240,18 +240,34 @@ enum
 
 class CDataFileWriterFinishJob : public IJob
 {
+public:
+	// Copy of the tiles of a layer owned by the writer, its tile flags are
+	// prepared for saving by the job instead of the editor thread.
+	struct CTilesToPrepare
+	{
+		CTile *m_pTiles;
+		size_t m_NumTiles;
+		bool m_UseImageTileFlags;
+		unsigned char m_aImageTileFlags[256];
+	};
+
+private:
 	char m_aRealFileName[IO_MAX_PATH_LENGTH];
 	char m_aTempFileName[IO_MAX_PATH_LENGTH];
 	CDataFileWriter m_Writer;
+	std::vector<CTilesToPrepare> m_vTilesToPrepare;
 
 	void Run() override
 	{
+		for(const CTilesToPrepare &Tiles : m_vTilesToPrepare)
+			CLayerTiles::PrepareForSave(Tiles.m_pTiles, Tiles.m_NumTiles, Tiles.m_UseImageTileFlags ? Tiles.m_aImageTileFlags : nullptr);
 		m_Writer.Finish();
 	}
 
 public:
-	CDataFileWriterFinishJob(const char *pRealFileName, const char *pTempFileName, CDataFileWriter &&Writer) :
-		m_Writer(std::move(Writer))
+	CDataFileWriterFinishJob(const char *pRealFileName, const char *pTempFileName, CDataFileWriter &&Writer, std::vector<CTilesToPrepare> &&vTilesToPrepare) :
+		m_Writer(std::move(Writer)),
+		m_vTilesToPrepare(std::move(vTilesToPrepare))
 	{
 		str_copy(m_aRealFileName, pRealFileName);
 		str_copy(m_aTempFileName, pTempFileName);
@@ -458,6 +474,7 @@ public:
 
 	void RenderPressedKeys(CUIRect View);
 	void RenderSavingIndicator(CUIRect View);
+	void RenderTileLayerStats(CUIRect View);
 	void FreeDynamicPopupMenus();
 	void RenderMousePointer();
 
@@ -689,6 +706,11 @@ public:
 	float m_AnimateTime;
 	float m_AnimateSpeed;
 
+	// time spent rendering tile layers and number of uploaded tile chunks
+	// in the current frame, shown with debug enabled
+	int64_t m_TileLayerRenderTime = 0;
+	int m_NumTileChunkUploads = 0;
+
 	enum EExtraEditor
 	{
 		EXTRAEDITOR_NONE = -1,
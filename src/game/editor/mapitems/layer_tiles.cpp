@@ -79,17 +79,15 @@ void CLayerTiles::SetTile(int x, int y, CTile Tile)
 	m_pTiles[y * m_Width + x] = Tile;
 }
 
-void CLayerTiles::PrepareForSave()
+void CLayerTiles::PrepareForSave(CTile *pTiles, size_t NumTiles, const unsigned char *pImageTileFlags)
 {
-	for(int y = 0; y < m_Height; y++)
-		for(int x = 0; x < m_Width; x++)
-			m_pTiles[y * m_Width + x].m_Flags &= TILEFLAG_XFLIP | TILEFLAG_YFLIP | TILEFLAG_ROTATE;
+	for(size_t i = 0; i < NumTiles; i++)
+		pTiles[i].m_Flags &= TILEFLAG_XFLIP | TILEFLAG_YFLIP | TILEFLAG_ROTATE;
 
-	if(m_Image != -1 && m_Color.a == 255)
+	if(pImageTileFlags)
 	{
-		for(int y = 0; y < m_Height; y++)
-			for(int x = 0; x < m_Width; x++)
-				m_pTiles[y * m_Width + x].m_Flags |= m_pEditor->m_Map.m_vpImages[m_Image]->m_aTileFlags[m_pTiles[y * m_Width + x].m_Index];
+		for(size_t i = 0; i < NumTiles; i++)
+			pTiles[i].m_Flags |= pImageTileFlags[pTiles[i].m_Index];
 	}
 }
 
@@ -129,12 +127,35 @@ void CLayerTiles::Render(bool Tileset)
 	Graphics()->TextureSet(Texture);
 
 	ColorRGBA Color = ColorRGBA(m_Color.r / 255.0f, m_Color.g / 255.0f, m_Color.b / 255.0f, m_Color.a / 255.0f);
-	Graphics()->BlendNone();
-	m_pEditor->RenderTools()->RenderTilemap(m_pTiles, m_Width, m_Height, 32.0f, Color, LAYERRENDERFLAG_OPAQUE,
-		CEditor::EnvelopeEval, m_pEditor, m_ColorEnv, m_ColorEnvOffset);
-	Graphics()->BlendNormal();
-	m_pEditor->RenderTools()->RenderTilemap(m_pTiles, m_Width, m_Height, 32.0f, Color, LAYERRENDERFLAG_TRANSPARENT,
-		CEditor::EnvelopeEval, m_pEditor, m_ColorEnv, m_ColorEnvOffset);
+	const int64_t RenderStart = time_get();
+	if(Graphics()->IsTileBufferingEnabled())
+	{
+		if(!m_pVisuals)
+			m_pVisuals = std::make_unique<CLayerTilesVisuals>(Graphics());
+
+		ColorRGBA Channels(1.0f, 1.0f, 1.0f, 1.0f);
+		if(m_ColorEnv >= 0)
+			CEditor::EnvelopeEval(m_ColorEnvOffset, m_ColorEnv, Channels, m_pEditor);
+		Color.r *= Channels.r;
+		Color.g *= Channels.g;
+		Color.b *= Channels.b;
+		Color.a *= Channels.a;
+
+		Graphics()->BlendNormal();
+		const int NumChunkUploads = m_pVisuals->NumChunkUploads();
+		m_pVisuals->Render(m_pTiles, m_Width, m_Height, Color);
+		m_pEditor->m_NumTileChunkUploads += m_pVisuals->NumChunkUploads() - NumChunkUploads;
+	}
+	else
+	{
+		Graphics()->BlendNone();
+		m_pEditor->RenderTools()->RenderTilemap(m_pTiles, m_Width, m_Height, 32.0f, Color, LAYERRENDERFLAG_OPAQUE,
+			CEditor::EnvelopeEval, m_pEditor, m_ColorEnv, m_ColorEnvOffset);
+		Graphics()->BlendNormal();
+		m_pEditor->RenderTools()->RenderTilemap(m_pTiles, m_Width, m_Height, 32.0f, Color, LAYERRENDERFLAG_TRANSPARENT,
+			CEditor::EnvelopeEval, m_pEditor, m_ColorEnv, m_ColorEnvOffset);
+	}
+	m_pEditor->m_TileLayerRenderTime += time_get() - RenderStart;
 
 	// Render DDRace Layers
 	if(!Tileset)
@@ -2,6 +2,7 @@
 #define GAME_EDITOR_MAPITEMS_LAYER_TILES_H
 
 #include "layer.h"
+#include "layer_tiles_visuals.h"
 
 enum
 {
@@ -135,7 +136,9 @@ public:
 	void ModifyImageIndex(FIndexModifyFunction pfnFunc) override;
 	void ModifyEnvelopeIndex(FIndexModifyFunction pfnFunc) override;
 
-	void PrepareForSave();
+	// Sets the flags of saved tiles, `pImageTileFlags` are the flags of
+	// the tiles in the image if they should be used.
+	static void PrepareForSave(CTile *pTiles, size_t NumTiles, const unsigned char *pImageTileFlags);
 	void ExtractTiles(int TilemapItemVersion, const CTile *pSavedTiles, size_t SavedTilesSize);
 
 	void GetSize(float *pWidth, float *pHeight) override
@@ -166,6 +169,10 @@ public:
 	int m_Switch;
 	int m_Tune;
 	char m_aFileName[IO_MAX_PATH_LENGTH];
+
+private:
+	// created on the first render, copies of the layer start without visuals
+	std::unique_ptr<CLayerTilesVisuals> m_pVisuals;
 };
 
 #endif
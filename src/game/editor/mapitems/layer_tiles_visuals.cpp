@@ -0,0 +1,222 @@
+#include "layer_tiles_visuals.h"
+
+#include <base/math.h>
+#include <base/system.h>
+
+#include <engine/graphics.h>
+
+#include <cmath>
+#include <utility>
+
+struct STileVertex
+{
+	vec2 m_Pos;
+	ubvec4 m_TexCoord;
+};
+
+static void FillTileVertices(STileVertex *pVertices, const CTile &Tile, int x, int y)
+{
+	// texture coordinates in the order top left, top right, bottom right, bottom left
+	unsigned char aX[4] = {0, 1, 1, 0};
+	unsigned char aY[4] = {0, 0, 1, 1};
+	if(Tile.m_Flags & TILEFLAG_XFLIP)
+	{
+		std::swap(aX[0], aX[1]);
+		std::swap(aX[2], aX[3]);
+	}
+	if(Tile.m_Flags & TILEFLAG_YFLIP)
+	{
+		std::swap(aY[0], aY[3]);
+		std::swap(aY[1], aY[2]);
+	}
+	const bool Rotate = (Tile.m_Flags & TILEFLAG_ROTATE) != 0;
+	if(Rotate)
+	{
+		// the corners move one step clockwise
+		const unsigned char TmpX = aX[0];
+		const unsigned char TmpY = aY[0];
+		aX[0] = aX[3];
+		aX[3] = aX[2];
+		aX[2] = aX[1];
+		aX[1] = TmpX;
+		aY[0] = aY[3];
+		aY[3] = aY[2];
+		aY[2] = aY[1];
+		aY[1] = TmpY;
+	}
+
+	const vec2 aPos[4] = {
+		vec2(x * 32.0f, y * 32.0f),
+		vec2(x * 32.0f + 32.0f, y * 32.0f),
+		vec2(x * 32.0f + 32.0f, y * 32.0f + 32.0f),
+		vec2(x * 32.0f, y * 32.0f + 32.0f),
+	};
+	for(int i = 0; i < 4; i++)
+	{
+		pVertices[i].m_Pos = aPos[i];
+		pVertices[i].m_TexCoord = ubvec4(aX[i], aY[i], Tile.m_Index, Rotate);
+	}
+}
+
+CLayerTilesVisuals::~CLayerTilesVisuals()
+{
+	Clear();
+}
+
+void CLayerTilesVisuals::Clear()
+{
+	for(SChunk &Chunk : m_vChunks)
+	{
+		if(Chunk.m_BufferContainerIndex != -1)
+			m_pGraphics->DeleteBufferContainer(Chunk.m_BufferContainerIndex, true);
+	}
+	m_vChunks.clear();
+	m_Width = 0;
+	m_Height = 0;
+	m_NumChunksX = 0;
+	m_NumChunksY = 0;
+}
+
+bool CLayerTilesVisuals::ChunkChanged(const SChunk &Chunk, const CTile *pTiles, int StartX, int StartY, int ChunkWidth, int ChunkHeight) const
+{
+	if(!Chunk.m_Uploaded)
+		return true;
+	for(int y = 0; y < ChunkHeight; y++)
+	{
+		if(mem_comp(&Chunk.m_vTiles[y * ChunkWidth], &pTiles[(StartY + y) * m_Width + StartX], ChunkWidth * sizeof(CTile)) != 0)
+			return true;
+	}
+	return false;
+}
+
+void CLayerTilesVisuals::UploadChunk(SChunk &Chunk, const CTile *pTiles, int StartX, int StartY, int ChunkWidth, int ChunkHeight)
+{
+	Chunk.m_Uploaded = true;
+	Chunk.m_vTiles.resize((size_t)ChunkWidth * ChunkHeight);
+	Chunk.m_vTileOffsets.resize((size_t)ChunkWidth * ChunkHeight + 1);
+	int NumTiles = 0;
+	for(int y = 0; y < ChunkHeight; y++)
+	{
+		mem_copy(&Chunk.m_vTiles[y * ChunkWidth], &pTiles[(StartY + y) * m_Width + StartX], ChunkWidth * sizeof(CTile));
+		for(int x = 0; x < ChunkWidth; x++)
+		{
+			Chunk.m_vTileOffsets[y * ChunkWidth + x] = NumTiles;
+			if(Chunk.m_vTiles[y * ChunkWidth + x].m_Index)
+				NumTiles++;
+		}
+	}
+	Chunk.m_vTileOffsets.back() = NumTiles;
+
+	if(NumTiles == 0)
+	{
+		if(Chunk.m_BufferContainerIndex != -1)
+			m_pGraphics->DeleteBufferContainer(Chunk.m_BufferContainerIndex, true);
+		Chunk.m_BufferObjectIndex = -1;
+		return;
+	}
+
+	// the buffer object takes over the vertices
+	const size_t UploadDataSize = (size_t)NumTiles * 4 * sizeof(STileVertex);
+	STileVertex *pVertices = (STileVertex *)malloc(UploadDataSize);
+	STileVertex *pVertex = pVertices;
+	for(int y = 0; y < ChunkHeight; y++)
+	{
+		for(int x = 0; x < ChunkWidth; x++)
+		{
+			const CTile &Tile = Chunk.m_vTiles[y * ChunkWidth + x];
+			if(!Tile.m_Index)
+				continue;
+			FillTileVertices(pVertex, Tile, StartX + x, StartY + y);
+			pVertex += 4;
+		}
+	}
+
+	if(Chunk.m_BufferContainerIndex != -1)
+	{
+		m_pGraphics->RecreateBufferObject(Chunk.m_BufferObjectIndex, UploadDataSize, pVertices, 0, true);
+	}
+	else
+	{
+		Chunk.m_BufferObjectIndex = m_pGraphics->CreateBufferObject(UploadDataSize, pVertices, 0, true);
+
+		SBufferContainerInfo ContainerInfo;
+		ContainerInfo.m_Stride = sizeof(STileVertex);
+		ContainerInfo.m_VertBufferBindingIndex = Chunk.m_BufferObjectIndex;
+		ContainerInfo.m_vAttributes.emplace_back();
+		SBufferContainerInfo::SAttribute *pAttr = &ContainerInfo.m_vAttributes.back();
+		pAttr->m_DataTypeCount = 2;
+		pAttr->m_Type = GRAPHICS_TYPE_FLOAT;
+		pAttr->m_Normalized = false;
+		pAttr->m_pOffset = (void *)offsetof(STileVertex, m_Pos);
+		pAttr->m_FuncType = 0;
+		ContainerInfo.m_vAttributes.emplace_back();
+		pAttr = &ContainerInfo.m_vAttributes.back();
+		pAttr->m_DataTypeCount = 4;
+		pAttr->m_Type = GRAPHICS_TYPE_UNSIGNED_BYTE;
+		pAttr->m_Normalized = false;
+		pAttr->m_pOffset = (void *)offsetof(STileVertex, m_TexCoord);
+		pAttr->m_FuncType = 1;
+		Chunk.m_BufferContainerIndex = m_pGraphics->CreateBufferContainer(&ContainerInfo);
+	}
+	m_pGraphics->IndicesNumRequiredNotify(NumTiles * 6);
+	m_NumChunkUploads++;
+}
+
+void CLayerTilesVisuals::Render(const CTile *pTiles, int Width, int Height, const ColorRGBA &Color)
+{
+	if(Width != m_Width || Height != m_Height)
+	{
+		Clear();
+		m_Width = Width;
+		m_Height = Height;
+		m_NumChunksX = (Width + CHUNK_SIZE - 1) / CHUNK_SIZE;
+		m_NumChunksY = (Height + CHUNK_SIZE - 1) / CHUNK_SIZE;
+		m_vChunks.resize((size_t)m_NumChunksX * m_NumChunksY);
+	}
+
+	float ScreenX0, ScreenY0, ScreenX1, ScreenY1;
+	m_pGraphics->GetScreen(&ScreenX0, &ScreenY0, &ScreenX1, &ScreenY1);
+	const int X0 = maximum((int)std::floor(ScreenX0 / 32.0f), 0);
+	const int Y0 = maximum((int)std::floor(ScreenY0 / 32.0f), 0);
+	const int X1 = minimum((int)std::ceil(ScreenX1 / 32.0f), Width);
+	const int Y1 = minimum((int)std::ceil(ScreenY1 / 32.0f), Height);
+	if(X0 >= X1 || Y0 >= Y1)
+		return;
+
+	// only the visible chunks are checked for changes, the others are
+	// updated once they become visible
+	for(int ChunkY = Y0 / CHUNK_SIZE; ChunkY <= (Y1 - 1) / CHUNK_SIZE; ChunkY++)
+	{
+		for(int ChunkX = X0 / CHUNK_SIZE; ChunkX <= (X1 - 1) / CHUNK_SIZE; ChunkX++)
+		{
+			SChunk &Chunk = m_vChunks[ChunkY * m_NumChunksX + ChunkX];
+			const int StartX = ChunkX * CHUNK_SIZE;
+			const int StartY = ChunkY * CHUNK_SIZE;
+			const int ChunkWidth = minimum((int)CHUNK_SIZE, Width - StartX);
+			const int ChunkHeight = minimum((int)CHUNK_SIZE, Height - StartY);
+			if(ChunkChanged(Chunk, pTiles, StartX, StartY, ChunkWidth, ChunkHeight))
+				UploadChunk(Chunk, pTiles, StartX, StartY, ChunkWidth, ChunkHeight);
+			if(Chunk.m_BufferContainerIndex == -1)
+				continue;
+
+			// draw the visible part of every row of the chunk
+			m_vpIndexOffsets.clear();
+			m_vDrawCounts.clear();
+			const int FromX = maximum(X0, StartX) - StartX;
+			const int ToX = minimum(X1, StartX + ChunkWidth) - StartX;
+			const int FromY = maximum(Y0, StartY) - StartY;
+			const int ToY = minimum(Y1, StartY + ChunkHeight) - StartY;
+			for(int y = FromY; y < ToY; y++)
+			{
+				const unsigned int First = Chunk.m_vTileOffsets[y * ChunkWidth + FromX];
+				const unsigned int Last = Chunk.m_vTileOffsets[y * ChunkWidth + ToX];
+				if(First == Last)
+					continue;
+				m_vpIndexOffsets.push_back((char *)((uintptr_t)First * 6 * sizeof(uint32_t)));
+				m_vDrawCounts.push_back((Last - First) * 6);
+			}
+			if(!m_vpIndexOffsets.empty())
+				m_pGraphics->RenderTileLayer(Chunk.m_BufferContainerIndex, Color, m_vpIndexOffsets.data(), m_vDrawCounts.data(), m_vpIndexOffsets.size());
+		}
+	}
+}
@@ -0,0 +1,64 @@
+#ifndef GAME_EDITOR_MAPITEMS_LAYER_TILES_VISUALS_H
+#define GAME_EDITOR_MAPITEMS_LAYER_TILES_VISUALS_H
+
+#include <base/color.h>
+
+#include <game/mapitems.h>
+
+#include <cstdint>
+#include <vector>
+
+class IGraphics;
+
+// Renders the tiles of an editor layer from buffer containers, like the
+// tile layers of the game. The layer is split into chunks which are only
+// built and uploaded again when tiles in them changed since their last
+// upload, so editing a few tiles does not rebuild the whole layer.
+class CLayerTilesVisuals
+{
+public:
+	explicit CLayerTilesVisuals(IGraphics *pGraphics) :
+		m_pGraphics(pGraphics) {}
+	~CLayerTilesVisuals();
+
+	CLayerTilesVisuals(const CLayerTilesVisuals &Other) = delete;
+	CLayerTilesVisuals &operator=(const CLayerTilesVisuals &Other) = delete;
+
+	void Render(const CTile *pTiles, int Width, int Height, const ColorRGBA &Color);
+
+	int NumChunkUploads() const { return m_NumChunkUploads; }
+
+private:
+	enum
+	{
+		CHUNK_SIZE = 64,
+	};
+
+	struct SChunk
+	{
+		int m_BufferObjectIndex = -1;
+		int m_BufferContainerIndex = -1;
+		bool m_Uploaded = false;
+		// tiles of the last upload, to find out whether the chunk changed
+		std::vector<CTile> m_vTiles;
+		// number of drawn tiles before each tile, with one more for the end
+		std::vector<uint16_t> m_vTileOffsets;
+	};
+
+	IGraphics *m_pGraphics;
+	int m_Width = 0;
+	int m_Height = 0;
+	int m_NumChunksX = 0;
+	int m_NumChunksY = 0;
+	std::vector<SChunk> m_vChunks;
+	int m_NumChunkUploads = 0;
+
+	std::vector<char *> m_vpIndexOffsets;
+	std::vector<unsigned int> m_vDrawCounts;
+
+	void Clear();
+	bool ChunkChanged(const SChunk &Chunk, const CTile *pTiles, int StartX, int StartY, int ChunkWidth, int ChunkHeight) const;
+	void UploadChunk(SChunk &Chunk, const CTile *pTiles, int StartX, int StartY, int ChunkWidth, int ChunkHeight);
+};
+
+#endif
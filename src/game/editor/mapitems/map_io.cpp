@@ -124,8 +124,7 @@ bool CEditorMap::Save(const char *pFileName)
 					pDataRGBA[j * PixelSize + 2] = pDataRGB[j * 3 + 2];
 					pDataRGBA[j * PixelSize + 3] = 255;
 				}
-				Item.m_ImageData = Writer.AddData(DataSize, pDataRGBA);
-				free(pDataRGBA);
+				Item.m_ImageData = Writer.AddDataOwned(DataSize, pDataRGBA);
 			}
 			else
 			{
@@ -152,6 +151,7 @@ bool CEditorMap::Save(const char *pFileName)
 	}
 
 	// save layers
+	std::vector<CDataFileWriterFinishJob::CTilesToPrepare> vTilesToPrepare;
 	int LayerCount = 0, GroupCount = 0;
 	int AutomapperCount = 0;
 	for(const auto &pGroup : m_vpGroups)
@@ -180,7 +180,21 @@ bool CEditorMap::Save(const char *pFileName)
 			{
 				m_pEditor->Console()->Print(IConsole::OUTPUT_LEVEL_ADDINFO, "editor", "saving tiles layer");
 				std::shared_ptr<CLayerTiles> pLayerTiles = std::static_pointer_cast<CLayerTiles>(pLayer);
-				pLayerTiles->PrepareForSave();
+				const size_t NumTiles = (size_t)pLayerTiles->m_Width * pLayerTiles->m_Height;
+
+				// Only copy the tiles here, their flags are prepared by the finish job
+				// so editing can continue while the map is written.
+				const auto AddTiles = [&]() {
+					CTile *pTiles = (CTile *)malloc(NumTiles * sizeof(CTile));
+					mem_copy(pTiles, pLayerTiles->m_pTiles, NumTiles * sizeof(CTile));
+					CDataFileWriterFinishJob::CTilesToPrepare &Tiles = vTilesToPrepare.emplace_back();
+					Tiles.m_pTiles = pTiles;
+					Tiles.m_NumTiles = NumTiles;
+					Tiles.m_UseImageTileFlags = pLayerTiles->m_Image != -1 && pLayerTiles->m_Color.a == 255;
+					if(Tiles.m_UseImageTileFlags)
+						mem_copy(Tiles.m_aImageTileFlags, m_vpImages[pLayerTiles->m_Image]->m_aTileFlags, sizeof(Tiles.m_aImageTileFlags));
+					return Writer.AddDataOwned(NumTiles * sizeof(CTile), pTiles);
+				};
 
 				CMapItemLayerTilemap Item;
 				Item.m_Version = CMapItemLayerTilemap::CURRENT_VERSION;
@@ -221,24 +235,22 @@ bool CEditorMap::Save(const char *pFileName)
 
 				if(Item.m_Flags && !(pLayerTiles->m_Game))
 				{
-					CTile *pEmptyTiles = (CTile *)calloc((size_t)pLayerTiles->m_Width * pLayerTiles->m_Height, sizeof(CTile));
-					mem_zero(pEmptyTiles, (size_t)pLayerTiles->m_Width * pLayerTiles->m_Height * sizeof(CTile));
-					Item.m_Data = Writer.AddData((size_t)pLayerTiles->m_Width * pLayerTiles->m_Height * sizeof(CTile), pEmptyTiles);
-					free(pEmptyTiles);
+					CTile *pEmptyTiles = (CTile *)calloc(NumTiles, sizeof(CTile));
+					Item.m_Data = Writer.AddDataOwned(NumTiles * sizeof(CTile), pEmptyTiles);
 
 					if(pLayerTiles->m_Tele)
 						Item.m_Tele = Writer.AddData((size_t)pLayerTiles->m_Width * pLayerTiles->m_Height * sizeof(CTeleTile), std::static_pointer_cast<CLayerTele>(pLayerTiles)->m_pTeleTile);
 					else if(pLayerTiles->m_Speedup)
 						Item.m_Speedup = Writer.AddData((size_t)pLayerTiles->m_Width * pLayerTiles->m_Height * sizeof(CSpeedupTile), std::static_pointer_cast<CLayerSpeedup>(pLayerTiles)->m_pSpeedupTile);
 					else if(pLayerTiles->m_Front)
-						Item.m_Front = Writer.AddData((size_t)pLayerTiles->m_Width * pLayerTiles->m_Height * sizeof(CTile), pLayerTiles->m_pTiles);
+						Item.m_Front = AddTiles();
 					else if(pLayerTiles->m_Switch)
 						Item.m_Switch = Writer.AddData((size_t)pLayerTiles->m_Width * pLayerTiles->m_Height * sizeof(CSwitchTile), std::static_pointer_cast<CLayerSwitch>(pLayerTiles)->m_pSwitchTile);
 					else if(pLayerTiles->m_Tune)
 						Item.m_Tune = Writer.AddData((size_t)pLayerTiles->m_Width * pLayerTiles->m_Height * sizeof(CTuneTile), std::static_pointer_cast<CLayerTune>(pLayerTiles)->m_pTuneTile);
 				}
 				else
-					Item.m_Data = Writer.AddData((size_t)pLayerTiles->m_Width * pLayerTiles->m_Height * sizeof(CTile), pLayerTiles->m_pTiles);
+					Item.m_Data = AddTiles();
 
 				// save layer name
 				StrToInts(Item.m_aName, sizeof(Item.m_aName) / sizeof(int), pLayerTiles->m_aName);
@@ -396,7 +408,7 @@ bool CEditorMap::Save(const char *pFileName)
 	}
 
 	// finish the data file
-	std::shared_ptr<CDataFileWriterFinishJob> pWriterFinishJob = std::make_shared<CDataFileWriterFinishJob>(pFileName, aFileNameTmp, std::move(Writer));
+	std::shared_ptr<CDataFileWriterFinishJob> pWriterFinishJob = std::make_shared<CDataFileWriterFinishJob>(pFileName, aFileNameTmp, std::move(Writer), std::move(vTilesToPrepare));
 	m_pEditor->Engine()->AddJob(pWriterFinishJob);
 	m_pEditor->m_WriterFinishJobs.push_back(pWriterFinishJob);
 
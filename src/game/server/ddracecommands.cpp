@@ -921,6 +921,30 @@ void CGameContext::ConDumpLog(IConsole::IResult *pResult, void *pUserData)
 	}
 }
 
+void CGameContext::ConSnapInterestStats(IConsole::IResult *pResult, void *pUserData)
+{
+	CGameContext *pSelf = (CGameContext *)pUserData;
+	CSnapInterest::CStats Total;
+	for(const CPlayer *pPlayer : pSelf->m_apPlayers)
+	{
+		if(!pPlayer)
+			continue;
+
+		const CSnapInterest::CStats &Stats = pPlayer->m_SnapInterest.Stats();
+		char aBuf[256];
+		str_format(aBuf, sizeof(aBuf), "id=%d name='%s' culled=%" PRId64 " deferred=%" PRId64 " updated=%" PRId64,
+			pPlayer->GetCID(), pSelf->Server()->ClientName(pPlayer->GetCID()), Stats.m_NumCulled, Stats.m_NumDeferred, Stats.m_NumUpdated);
+		pSelf->Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "snap_interest", aBuf);
+		Total.m_NumCulled += Stats.m_NumCulled;
+		Total.m_NumDeferred += Stats.m_NumDeferred;
+		Total.m_NumUpdated += Stats.m_NumUpdated;
+	}
+
+	char aBuf[256];
+	str_format(aBuf, sizeof(aBuf), "total culled=%" PRId64 " deferred=%" PRId64 " updated=%" PRId64, Total.m_NumCulled, Total.m_NumDeferred, Total.m_NumUpdated);
+	pSelf->Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "snap_interest", aBuf);
+}
+
 void CGameContext::LogEvent(const char *Description, int ClientID)
 {
 	CLog *pNewEntry = &m_aLogs[m_LatestLog];
@@ -1997,9 +1997,14 @@ void CCharacter::SetTeams(CGameTeams *pTeams)
 	m_Core.SetTeamsCore(&m_pTeams->m_Core);
 }
 
+CSaveTee &CCharacter::RescueTee()
+{
+	return GameWorld()->m_aRescueTees[m_pPlayer->GetCID()];
+}
+
 void CCharacter::SetRescue()
 {
-	m_RescueTee.Save(this);
+	RescueTee().Save(this);
 	m_SetSavePos = true;
 }
 
@@ -2335,7 +2340,7 @@ void CCharacter::Rescue()
 		}
 
 		float StartTime = m_StartTime;
-		m_RescueTee.Load(this, Team());
+		RescueTee().Load(this, Team());
 		// Don't load these from saved tee:
 		m_Core.m_Vel = vec2(0, 0);
 		m_Core.m_HookState = HOOK_IDLE;
@@ -162,7 +162,7 @@ private:
 	IAntibot *Antibot();
 
 	bool m_SetSavePos;
-	CSaveTee m_RescueTee;
+	CSaveTee &RescueTee();
 
 public:
 	CGameTeams *Teams() { return m_pTeams; }
@@ -248,7 +248,7 @@ public:
 
 	bool IsSuper() { return m_Core.m_Super; }
 
-	CSaveTee &GetRescueTeeRef() { return m_RescueTee; }
+	CSaveTee &GetRescueTeeRef() { return RescueTee(); }
 
 	// carry sim
 
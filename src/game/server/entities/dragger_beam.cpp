@@ -133,7 +133,12 @@ void CDraggerBeam::Snap(int SnappingClient)
 		SnapObjID = m_pDragger->GetID();
 	}
 
-	GameServer()->SnapLaserObject(CSnapContext(SnappingClientVersion), SnapObjID,
+	// beams of other teams or far from the view don't need to follow every tick
+	int Interest = NetworkInterestLine(SnappingClient, m_Pos, TargetPos);
+	if(NetworkOtherTeam(SnappingClient, pTarget))
+		Interest = CSnapInterest::INTEREST_OTHER_TEAM;
+
+	GameServer()->SnapLaserObject(CSnapContext(SnappingClientVersion, false, SnappingClient, Interest), SnapObjID,
 		TargetPos, m_Pos, StartTick, m_ForClientID, LASERTYPE_DRAGGER, Subtype, m_Number);
 }
 
@@ -142,6 +142,8 @@ void CLight::Snap(int SnappingClient)
 			StartTick = Server()->Tick();
 	}
 
-	GameServer()->SnapLaserObject(CSnapContext(SnappingClientVersion), GetID(),
+	// rotating lights far from the view don't need to follow every tick
+	const int Interest = NetworkInterestLine(SnappingClient, m_Pos, m_To);
+	GameServer()->SnapLaserObject(CSnapContext(SnappingClientVersion, false, SnappingClient, Interest), GetID(),
 		m_Pos, From, StartTick, -1, LASERTYPE_FREEZE, 0, m_Number);
 }
@@ -120,8 +120,13 @@ void CPlasma::Snap(int SnappingClient)
 
 	int SnappingClientVersion = GameServer()->GetClientVersion(SnappingClient);
 
+	// bullets of other teams or far from the view don't need to follow every tick
+	int Interest = NetworkInterest(SnappingClient, m_Pos);
+	if(NetworkOtherTeam(SnappingClient, pTarget))
+		Interest = CSnapInterest::INTEREST_OTHER_TEAM;
+
 	int Subtype = (m_Explosive ? 1 : 0) | (m_Freeze ? 2 : 0);
-	GameServer()->SnapLaserObject(CSnapContext(SnappingClientVersion), GetID(),
+	GameServer()->SnapLaserObject(CSnapContext(SnappingClientVersion, false, SnappingClient, Interest), GetID(),
 		m_Pos, m_Pos, m_EvalTick, -1, LASERTYPE_PLASMA, Subtype, m_Number);
 }
 
@@ -5,6 +5,8 @@
 #include "gamecontext.h"
 #include "player.h"
 
+#include "entities/character.h"
+
 //////////////////////////////////////////////////
 // Entity
 //////////////////////////////////////////////////
@@ -45,6 +47,28 @@ bool CEntity::NetworkClippedLine(int SnappingClient, vec2 StartPos, vec2 EndPos)
 	return ::NetworkClippedLine(m_pGameWorld->GameServer(), SnappingClient, StartPos, EndPos);
 }
 
+int CEntity::NetworkInterest(int SnappingClient, vec2 CheckPos) const
+{
+	return ::NetworkInterest(m_pGameWorld->GameServer(), SnappingClient, CheckPos);
+}
+
+int CEntity::NetworkInterestLine(int SnappingClient, vec2 StartPos, vec2 EndPos) const
+{
+	return ::NetworkInterestLine(m_pGameWorld->GameServer(), SnappingClient, StartPos, EndPos);
+}
+
+bool CEntity::NetworkOtherTeam(int SnappingClient, CCharacter *pChr) const
+{
+	if(SnappingClient == SERVER_DEMO_CLIENT)
+		return false;
+
+	CPlayer *pPlayer = m_pGameWorld->GameServer()->m_apPlayers[SnappingClient];
+	int ViewClient = SnappingClient;
+	if((pPlayer->GetTeam() == TEAM_SPECTATORS || pPlayer->IsPaused()) && pPlayer->m_SpectatorID != SPEC_FREEVIEW)
+		ViewClient = pPlayer->m_SpectatorID;
+	return !pChr->CanCollide(ViewClient);
+}
+
 bool CEntity::GameLayerClipped(vec2 CheckPos)
 {
 	return round_to_int(CheckPos.x) / 32 < -200 || round_to_int(CheckPos.x) / 32 > GameServer()->Collision()->GetWidth() + 200 ||
@@ -121,3 +145,29 @@ bool NetworkClippedLine(const CGameContext *pGameServer, int SnappingClient, vec
 	float ClippDistance = maximum(ShowDistance.x, ShowDistance.y);
 	return (absolute(DistanceToLine.x) > ClippDistance || absolute(DistanceToLine.y) > ClippDistance);
 }
+
+// the outer part of the view in which objects are of low interest
+static const float gs_FullInterestViewPart = 0.75f;
+
+int NetworkInterest(const CGameContext *pGameServer, int SnappingClient, vec2 CheckPos)
+{
+	if(SnappingClient == SERVER_DEMO_CLIENT)
+		return CSnapInterest::INTEREST_FULL;
+
+	const vec2 Distance = pGameServer->m_apPlayers[SnappingClient]->m_ViewPos - CheckPos;
+	const vec2 FullDistance = pGameServer->m_apPlayers[SnappingClient]->m_ShowDistance * gs_FullInterestViewPart;
+	if(absolute(Distance.x) > FullDistance.x || absolute(Distance.y) > FullDistance.y)
+		return CSnapInterest::INTEREST_LOW;
+	return CSnapInterest::INTEREST_FULL;
+}
+
+int NetworkInterestLine(const CGameContext *pGameServer, int SnappingClient, vec2 StartPos, vec2 EndPos)
+{
+	if(SnappingClient == SERVER_DEMO_CLIENT)
+		return CSnapInterest::INTEREST_FULL;
+
+	vec2 ClosestPoint;
+	if(!closest_point_on_line(StartPos, EndPos, pGameServer->m_apPlayers[SnappingClient]->m_ViewPos, ClosestPoint))
+		ClosestPoint = StartPos;
+	return NetworkInterest(pGameServer, SnappingClient, ClosestPoint);
+}
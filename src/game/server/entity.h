@@ -160,6 +160,21 @@ public: // TODO: Maybe make protected
 	bool NetworkClipped(int SnappingClient, vec2 CheckPos) const;
 	bool NetworkClippedLine(int SnappingClient, vec2 StartPos, vec2 EndPos) const;
 
+	/*
+		Function: NetworkInterest
+			Tells how closely a client has to follow the entity, for
+			entities that aren't clipped.
+
+		Returns:
+			CSnapInterest::INTEREST_LOW if the entity is in the outer
+			part of the client's view or further away,
+			CSnapInterest::INTEREST_FULL otherwise.
+	*/
+	int NetworkInterest(int SnappingClient, vec2 CheckPos) const;
+	int NetworkInterestLine(int SnappingClient, vec2 StartPos, vec2 EndPos) const;
+	// Whether the character is in a team the client, or the player it spectates, doesn't interact with
+	bool NetworkOtherTeam(int SnappingClient, class CCharacter *pChr) const;
+
 	bool GameLayerClipped(vec2 CheckPos);
 
 	// DDRace
@@ -173,5 +188,7 @@ public: // TODO: Maybe make protected
 
 bool NetworkClipped(const CGameContext *pGameServer, int SnappingClient, vec2 CheckPos);
 bool NetworkClippedLine(const CGameContext *pGameServer, int SnappingClient, vec2 StartPos, vec2 EndPos);
+int NetworkInterest(const CGameContext *pGameServer, int SnappingClient, vec2 CheckPos);
+int NetworkInterestLine(const CGameContext *pGameServer, int SnappingClient, vec2 StartPos, vec2 EndPos);
 
 #endif
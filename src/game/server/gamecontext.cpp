@@ -50,8 +50,14 @@ public:
 	{
 	}
 	void Log(const CLogMessage *pMessage) override;
+	bool Enabled(LEVEL Level) override;
 };
 
+bool CClientChatLogger::Enabled(LEVEL Level)
+{
+	return ILogger::Enabled(Level) || m_pOuterLogger->Enabled(Level);
+}
+
 void CClientChatLogger::Log(const CLogMessage *pMessage)
 {
 	if(str_comp(pMessage->m_aSystem, "chatresp") == 0)
@@ -383,16 +389,37 @@ void CGameContext::CreateSoundGlobal(int Sound, int Target)
 
 bool CGameContext::SnapLaserObject(const CSnapContext &Context, int SnapID, const vec2 &To, const vec2 &From, int StartTick, int Owner, int LaserType, int Subtype, int SwitchNumber)
 {
-	if(Context.GetClientVersion() >= VERSION_DDNET_MULTI_LASER)
+	const bool MultiLaser = Context.GetClientVersion() >= VERSION_DDNET_MULTI_LASER;
+	vec2 SnapTo = To;
+	vec2 SnapFrom = From;
+	if(Context.GetSnappingClient() != SERVER_DEMO_CLIENT)
+	{
+		CSnapInterest &Interest = m_apPlayers[Context.GetSnappingClient()]->m_SnapInterest;
+		// older clients get a start tick that changes every tick, holding
+		// the positions wouldn't make their deltas any smaller
+		if(Config()->m_SvSnapInterest && Context.GetInterest() != CSnapInterest::INTEREST_FULL && Context.GetClientVersion() >= VERSION_DDNET_ENTITY_NETOBJS)
+		{
+			const int Size = MultiLaser ? sizeof(CNetObj_DDNetLaser) : sizeof(CNetObj_Laser);
+			const bool CanCull = Context.GetInterest() == CSnapInterest::INTEREST_OTHER_TEAM;
+			if(!Interest.Filter(SnapID, Size, CanCull, LaserType, Owner, &SnapTo, &SnapFrom))
+				return false;
+		}
+		else
+		{
+			Interest.Forget(SnapID);
+		}
+	}
+
+	if(MultiLaser)
 	{
 		CNetObj_DDNetLaser *pObj = Server()->SnapNewItem<CNetObj_DDNetLaser>(SnapID);
 		if(!pObj)
 			return false;
 
-		pObj->m_ToX = (int)To.x;
-		pObj->m_ToY = (int)To.y;
-		pObj->m_FromX = (int)From.x;
-		pObj->m_FromY = (int)From.y;
+		pObj->m_ToX = (int)SnapTo.x;
+		pObj->m_ToY = (int)SnapTo.y;
+		pObj->m_FromX = (int)SnapFrom.x;
+		pObj->m_FromY = (int)SnapFrom.y;
 		pObj->m_StartTick = StartTick;
 		pObj->m_Owner = Owner;
 		pObj->m_Type = LaserType;
@@ -406,10 +433,10 @@ bool CGameContext::SnapLaserObject(const CSnapContext &Context, int SnapID, cons
 		if(!pObj)
 			return false;
 
-		pObj->m_X = (int)To.x;
-		pObj->m_Y = (int)To.y;
-		pObj->m_FromX = (int)From.x;
-		pObj->m_FromY = (int)From.y;
+		pObj->m_X = (int)SnapTo.x;
+		pObj->m_Y = (int)SnapTo.y;
+		pObj->m_FromX = (int)SnapFrom.x;
+		pObj->m_FromY = (int)SnapFrom.y;
 		pObj->m_StartTick = StartTick;
 	}
 
@@ -686,6 +713,38 @@ void CGameContext::SendBroadcast(const char *pText, int ClientID, bool IsImporta
 	m_apPlayers[ClientID]->m_LastBroadcastImportance = IsImportant;
 }
 
+// Extracts the map from a "change_map" or "sv_map" command, returns false
+// for all other commands.
+static bool VoteCommandMap(const char *pCommand, char *pMap, int MapSize)
+{
+	pCommand = str_skip_whitespaces_const(pCommand);
+	const char *pArg = str_startswith(pCommand, "change_map ");
+	if(!pArg)
+		pArg = str_startswith(pCommand, "sv_map ");
+	if(!pArg)
+		return false;
+	pArg = str_skip_whitespaces_const(pArg);
+
+	int Length = 0;
+	if(*pArg == '"')
+	{
+		for(pArg++; *pArg && *pArg != '"' && Length < MapSize - 1; pArg++)
+		{
+			if(*pArg == '\\' && pArg[1])
+				pArg++;
+			pMap[Length++] = *pArg;
+		}
+	}
+	else
+	{
+		for(; *pArg && *pArg != ';' && Length < MapSize - 1; pArg++)
+			pMap[Length++] = *pArg;
+	}
+	pMap[Length] = '\0';
+	str_utf8_trim_right(pMap);
+	return pMap[0] != '\0';
+}
+
 void CGameContext::StartVote(const char *pDesc, const char *pCommand, const char *pReason, const char *pSixupDesc)
 {
 	// reset votes
@@ -708,12 +767,19 @@ void CGameContext::StartVote(const char *pDesc, const char *pCommand, const char
 	str_copy(m_aVoteReason, pReason, sizeof(m_aVoteReason));
 	SendVoteSet(-1);
 	m_VoteUpdate = true;
+
+	// have the map ready in case the vote passes
+	char aMap[IO_MAX_PATH_LENGTH];
+	if(VoteCommandMap(pCommand, aMap, sizeof(aMap)))
+		Server()->PreloadMap(aMap);
 }
 
 void CGameContext::EndVote()
 {
 	m_VoteCloseTime = 0;
 	SendVoteSet(-1);
+	// a passed map vote has already requested the map change at this point
+	Server()->CancelMapPreload();
 }
 
 void CGameContext::SendVoteSet(int ClientID)
@@ -3459,6 +3525,7 @@ void CGameContext::OnConsoleInit()
 	Console()->Register("votes", "?i[page]", CFGFLAG_SERVER, ConVotes, this, "Show all votes (page 0 by default, 20 entries per page)");
 	Console()->Register("dump_antibot", "", CFGFLAG_SERVER, ConDumpAntibot, this, "Dumps the antibot status");
 	Console()->Register("antibot", "r[command]", CFGFLAG_SERVER, ConAntibot, this, "Sends a command to the antibot");
+	Console()->Register("snap_interest_stats", "", CFGFLAG_SERVER, ConSnapInterestStats, this, "Shows how many lasers of low interest were culled, deferred or updated per player");
 
 	Console()->Chain("sv_motd", ConchainSpecialMotdupdate, this);
 
@@ -4022,7 +4089,10 @@ void CGameContext::OnSnap(int ClientID)
 	}
 
 	if(ClientID > -1)
+	{
 		m_apPlayers[ClientID]->FakeSnap();
+		m_apPlayers[ClientID]->m_SnapInterest.StartSnap(Server()->Tick(), Server()->TickSpeed(), Config()->m_SvSnapInterestRate, Config()->m_SvSnapInterestBudget);
+	}
 
 	m_World.Snap(ClientID);
 	m_Events.Snap(ClientID);
@@ -14,6 +14,7 @@
 
 #include "eventhandler.h"
 #include "gameworld.h"
+#include "snapinterest.h"
 #include "teehistorian.h"
 
 #include <memory>
@@ -62,17 +63,21 @@ struct CScoreRandomMapResult;
 
 struct CSnapContext
 {
-	CSnapContext(int Version, bool Sixup = false) :
-		m_ClientVersion(Version), m_Sixup(Sixup)
+	CSnapContext(int Version, bool Sixup = false, int SnappingClient = SERVER_DEMO_CLIENT, int Interest = CSnapInterest::INTEREST_FULL) :
+		m_ClientVersion(Version), m_Sixup(Sixup), m_SnappingClient(SnappingClient), m_Interest(Interest)
 	{
 	}
 
 	int GetClientVersion() const { return m_ClientVersion; }
 	bool IsSixup() const { return m_Sixup; }
+	int GetSnappingClient() const { return m_SnappingClient; }
+	int GetInterest() const { return m_Interest; }
 
 private:
 	int m_ClientVersion;
 	bool m_Sixup;
+	int m_SnappingClient;
+	int m_Interest;
 };
 
 class CGameContext : public IGameServer
@@ -138,6 +143,7 @@ class CGameContext : public IGameServer
 	static void ConchainSpecialMotdupdate(IConsole::IResult *pResult, void *pUserData, IConsole::FCommandCallback pfnCallback, void *pCallbackUserData);
 	static void ConchainSettingUpdate(IConsole::IResult *pResult, void *pUserData, IConsole::FCommandCallback pfnCallback, void *pCallbackUserData);
 	static void ConDumpLog(IConsole::IResult *pResult, void *pUserData);
+	static void ConSnapInterestStats(IConsole::IResult *pResult, void *pUserData);
 
 	void Construct(int Resetting);
 	void Destruct(int Resetting);
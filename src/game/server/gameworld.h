@@ -4,6 +4,7 @@
 #define GAME_SERVER_GAMEWORLD_H
 
 #include <game/gamecore.h>
+#include <game/server/save.h>
 
 #include <vector>
 
@@ -48,6 +49,11 @@ public:
 	bool m_Paused;
 	CWorldCore m_Core;
 
+	// Rescue positions of the characters, indexed by client id. They are
+	// only read by /rescue and are larger than the rest of a character, so
+	// they are kept out of CCharacter, whose other state is laid out as before.
+	CSaveTee m_aRescueTees[MAX_CLIENTS];
+
 	CGameWorld();
 	~CGameWorld();
 
@@ -10,6 +10,7 @@
 #include <game/alloc.h>
 #include <game/server/save.h>
 
+#include "snapinterest.h"
 #include "teeinfo.h"
 
 #include <memory>
@@ -184,6 +185,7 @@ public:
 	int m_ShowOthers;
 	bool m_ShowAll;
 	vec2 m_ShowDistance;
+	CSnapInterest m_SnapInterest;
 	bool m_SpecTeam;
 	bool m_NinjaJetpack;
 
@@ -10,7 +10,9 @@ class IGameController;
 class CGameContext;
 class CGameWorld;
 class CCharacter;
+class CPacker;
 class CSaveTeam;
+class CUnpacker;
 
 class CSaveTee
 {
@@ -21,6 +23,9 @@ public:
 	void Load(CCharacter *pchr, int Team, bool IsSwap = false);
 	char *GetString(const CSaveTeam *pTeam);
 	int FromString(const char *pString);
+	void AddToPacker(CPacker *pPacker, const CSaveTeam *pTeam) const;
+	// returns 0 on success
+	int FromUnpacker(CUnpacker *pUnpacker);
 	void LoadHookedPlayer(const CSaveTeam *pTeam);
 	bool IsHooking() const;
 	vec2 GetPos() const { return m_Pos; }
@@ -38,6 +43,9 @@ public:
 	};
 
 private:
+	// index of the hooked player inside the saved team, -1 if none
+	int HookedPlayerIndex(const CSaveTeam *pTeam) const;
+
 	int m_ClientID;
 
 	char m_aString[2048];
@@ -136,9 +144,17 @@ public:
 	CSaveTeam();
 	~CSaveTeam();
 	char *GetString();
+	// compact binary savegame, base64 encoded and prefixed with
+	// `BINARY_PREFIX` so that it can be stored in place of the text
+	// format, returns nullptr if the team doesn't fit
+	char *GetBinaryString();
+	// returns the size of the binary savegame or -1 on error
+	int GetBinary(unsigned char *pData, int DataSize) const;
 	int GetMembersCount() const { return m_MembersCount; }
-	// MatchPlayers has to be called afterwards
+	// MatchPlayers has to be called afterwards, accepts both the text
+	// and the binary string format
 	int FromString(const char *pString);
+	int FromBinary(const unsigned char *pData, int DataSize);
 	// returns true if a team can load, otherwise writes a nice error Message in pMessage
 	bool MatchPlayers(const char (*paNames)[MAX_NAME_LENGTH], const int *pClientID, int NumPlayer, char *pMessage, int MessageLen);
 	int Save(CGameContext *pGameServer, int Team, bool Dry = false);
@@ -149,10 +165,20 @@ public:
 	// returns true if an error occurred
 	static bool HandleSaveError(int Result, int ClientID, CGameContext *pGameContext);
 
+	static constexpr const char *BINARY_PREFIX = "ddbin:";
+	enum
+	{
+		BINARY_VERSION = 1,
+		STRING_SIZE = 65536,
+		// the base64 encoding with the prefix and the terminator has to fit into the string
+		MAX_BINARY_SIZE = (STRING_SIZE - 6 - 1) / 4 * 3
+	};
+
 private:
 	CCharacter *MatchCharacter(CGameContext *pGameServer, int ClientID, int SaveID, bool KeepCurrentCharacter);
+	int FromTextString(const char *pString);
 
-	char m_aString[65536];
+	char m_aString[STRING_SIZE];
 
 	struct SSimpleSwitchers
 	{
@@ -1561,7 +1561,12 @@ bool CScoreWorker::SaveTeam(IDbConnection *pSqlServer, const ISqlData *pGameData
 	char aSaveID[UUID_MAXSTRSIZE];
 	FormatUuid(pResult->m_SaveID, aSaveID, UUID_MAXSTRSIZE);
 
-	char *pSaveState = pResult->m_SavedTeam.GetString();
+	char *pSaveState = nullptr;
+	if(pData->m_Binary)
+		pSaveState = pResult->m_SavedTeam.GetBinaryString();
+	// fall back to the text format if the team doesn't fit
+	if(!pSaveState)
+		pSaveState = pResult->m_SavedTeam.GetString();
 	char aBuf[65536];
 
 	dbg_msg("score/dbg", "code=%s failure=%d", pData->m_aCode, (int)w);
@@ -199,6 +199,7 @@ struct CSqlTeamSave : ISqlData
 	char m_aCode[128];
 	char m_aGeneratedCode[128];
 	char m_aServer[5];
+	bool m_Binary;
 };
 
 struct CSqlTeamLoad : ISqlData
@@ -0,0 +1,68 @@
+#include "snapinterest.h"
+
+void CSnapInterest::Reset()
+{
+	m_HeldLasers.clear();
+	m_Stats = CStats();
+}
+
+void CSnapInterest::StartSnap(int Tick, int TickSpeed, int UpdateRate, int Budget)
+{
+	m_Tick = Tick;
+	m_TickSpeed = TickSpeed;
+	m_UpdateRate = UpdateRate;
+	m_Budget = Budget;
+
+	// objects that weren't snapped for a while are gone or of full interest
+	if(Tick % TickSpeed == 0)
+	{
+		for(auto It = m_HeldLasers.begin(); It != m_HeldLasers.end();)
+		{
+			if(Tick - It->second.m_UpdateTick > TickSpeed)
+				It = m_HeldLasers.erase(It);
+			else
+				++It;
+		}
+	}
+}
+
+bool CSnapInterest::Filter(int SnapID, int Size, bool CanCull, int LaserType, int Owner, vec2 *pTo, vec2 *pFrom)
+{
+	auto It = m_HeldLasers.find(SnapID);
+	if(It != m_HeldLasers.end() && (It->second.m_LaserType != LaserType || It->second.m_Owner != Owner))
+	{
+		m_HeldLasers.erase(It);
+		It = m_HeldLasers.end();
+	}
+	if(It != m_HeldLasers.end())
+	{
+		SHeldLaser &Held = It->second;
+		const int Age = m_Tick - Held.m_UpdateTick;
+		// never hold positions for longer than a second, even if that exceeds the budget
+		if(Age >= 0 && Age < m_TickSpeed && (Age < m_UpdateRate || m_Budget < Size))
+		{
+			if(Held.m_To != *pTo || Held.m_From != *pFrom)
+				m_Stats.m_NumDeferred++;
+			*pTo = Held.m_To;
+			*pFrom = Held.m_From;
+			return true;
+		}
+	}
+	else if(CanCull && m_Budget < Size)
+	{
+		m_Stats.m_NumCulled++;
+		return false;
+	}
+
+	// first appearances that can't be culled use up the budget even if it's exceeded
+	m_Budget -= Size;
+	m_HeldLasers[SnapID] = {*pTo, *pFrom, m_Tick, LaserType, Owner};
+	m_Stats.m_NumUpdated++;
+	return true;
+}
+
+void CSnapInterest::Forget(int SnapID)
+{
+	if(!m_HeldLasers.empty())
+		m_HeldLasers.erase(SnapID);
+}
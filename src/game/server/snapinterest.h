@@ -0,0 +1,71 @@
+#ifndef GAME_SERVER_SNAPINTEREST_H
+#define GAME_SERVER_SNAPINTEREST_H
+
+#include <base/vmath.h>
+
+#include <cstdint>
+#include <unordered_map>
+
+// Keeps track of the laser objects that are only of low interest to one
+// client, like moving lasers in the outer part of its view or those of
+// other teams. Instead of following the game every tick, their positions
+// are held for a few ticks, so their deltas are empty in between. The
+// updates of such objects in one snapshot are limited by a byte budget.
+// Objects of the client's own team are always sent when they appear, only
+// those of other teams, which can't interact with it, may be left out.
+class CSnapInterest
+{
+public:
+	enum
+	{
+		INTEREST_FULL,
+		INTEREST_LOW,
+		// of low interest and can't interact with the client
+		INTEREST_OTHER_TEAM,
+	};
+
+	class CStats
+	{
+	public:
+		// objects of other teams left out because they were never sent and the budget was used up
+		int64_t m_NumCulled = 0;
+		// objects sent with a position older than the current one
+		int64_t m_NumDeferred = 0;
+		// objects of low interest sent with their current position
+		int64_t m_NumUpdated = 0;
+	};
+
+	void Reset();
+	void StartSnap(int Tick, int TickSpeed, int UpdateRate, int Budget);
+
+	// Replaces the positions of a low interest object by the held ones if
+	// it isn't updated in this snapshot. Held positions of another laser
+	// that used the same snap id before are dropped. Returns false if the
+	// object should be left out of the snapshot, which only happens if it
+	// can be culled.
+	bool Filter(int SnapID, int Size, bool CanCull, int LaserType, int Owner, vec2 *pTo, vec2 *pFrom);
+	// Forgets the held positions of an object that is of full interest again
+	void Forget(int SnapID);
+
+	const CStats &Stats() const { return m_Stats; }
+
+private:
+	struct SHeldLaser
+	{
+		vec2 m_To;
+		vec2 m_From;
+		int m_UpdateTick;
+		// dragger beams switch between their own and the dragger's snap id
+		int m_LaserType;
+		int m_Owner;
+	};
+
+	std::unordered_map<int, SHeldLaser> m_HeldLasers;
+	int m_Tick = 0;
+	int m_TickSpeed = 50;
+	int m_UpdateRate = 1;
+	int m_Budget = 0;
+	CStats m_Stats;
+};
+
+#endif // GAME_SERVER_SNAPINTEREST_H
@@ -20,10 +20,11 @@ CGameTeams::CGameTeams(CGameContext *pGameContext) :
 void CGameTeams::Reset()
 {
 	m_Core.Reset();
+	RebuildTeamMembers();
+	m_TeeFinished.reset();
 	for(int i = 0; i < MAX_CLIENTS; ++i)
 	{
 		m_aTeeStarted[i] = false;
-		m_aTeeFinished[i] = false;
 		m_aLastChat[i] = 0;
 		SendTeamsState(i);
 	}
@@ -48,7 +49,7 @@ void CGameTeams::ResetRoundState(int Team)
 	m_aTeamUnfinishableKillTick[Team] = -1;
 	for(int i = 0; i < MAX_CLIENTS; i++)
 	{
-		if(m_Core.Team(i) == Team && GameServer()->m_apPlayers[i])
+		if(m_aTeamMembers[Team].test(i) && GameServer()->m_apPlayers[i])
 		{
 			GameServer()->m_apPlayers[i]->m_VotedForPractice = false;
 			GameServer()->m_apPlayers[i]->m_SwapTargetsClientID = -1;
@@ -86,9 +87,10 @@ void CGameTeams::OnCharacterStart(int ClientID)
 		return;
 	}
 	bool Waiting = false;
+	const CClientMask &Members = m_aTeamMembers[m_Core.Team(ClientID)];
 	for(int i = 0; i < MAX_CLIENTS; ++i)
 	{
-		if(m_Core.Team(ClientID) != m_Core.Team(i))
+		if(!Members.test(i))
 			continue;
 		CPlayer *pPlayer = GetPlayer(i);
 		if(!pPlayer || !pPlayer->IsPlaying())
@@ -149,7 +151,7 @@ void CGameTeams::OnCharacterStart(int ClientID)
 
 		for(int i = 0; i < MAX_CLIENTS; ++i)
 		{
-			if(m_Core.Team(ClientID) == m_Core.Team(i))
+			if(Members.test(i))
 			{
 				CPlayer *pPlayer = GetPlayer(i);
 				// TODO: THE PROBLEM IS THAT THERE IS NO CHARACTER SO START TIME CAN'T BE SET!
@@ -173,7 +175,7 @@ void CGameTeams::OnCharacterStart(int ClientID)
 			for(int i = 0; i < MAX_CLIENTS; ++i)
 			{
 				CPlayer *pPlayer = GetPlayer(i);
-				if(m_Core.Team(ClientID) == m_Core.Team(i) && pPlayer && (pPlayer->IsPlaying() || TeamLocked(m_Core.Team(ClientID))))
+				if(Members.test(i) && pPlayer && (pPlayer->IsPlaying() || TeamLocked(m_Core.Team(ClientID))))
 				{
 					GameServer()->SendChatTarget(i, aBuf);
 				}
@@ -202,7 +204,7 @@ void CGameTeams::OnCharacterFinish(int ClientID)
 	{
 		if(m_aTeeStarted[ClientID])
 		{
-			m_aTeeFinished[ClientID] = true;
+			m_TeeFinished.set(ClientID);
 		}
 		CheckTeamFinished(m_Core.Team(ClientID));
 	}
@@ -212,6 +214,10 @@ void CGameTeams::Tick()
 {
 	int Now = Server()->Tick();
 
+#ifdef CONF_DEBUG
+	ValidateTeamMembers();
+#endif
+
 	for(int i = 0; i < MAX_CLIENTS; i++)
 	{
 		CPlayerData *pData = GameServer()->Score()->PlayerData(i);
@@ -279,7 +285,7 @@ void CGameTeams::Tick()
 		aPlayerNames[0] = 0;
 		for(int j = 0; j < MAX_CLIENTS; j++)
 		{
-			if(m_Core.Team(j) == i && !m_aTeeStarted[j])
+			if(m_aTeamMembers[i].test(j) && !m_aTeeStarted[j])
 			{
 				if(aPlayerNames[0])
 				{
@@ -313,13 +319,13 @@ void CGameTeams::CheckTeamFinished(int Team)
 
 		for(int i = 0; i < MAX_CLIENTS; ++i)
 		{
-			if(Team == m_Core.Team(i))
+			if(m_aTeamMembers[Team].test(i))
 			{
 				CPlayer *pPlayer = GetPlayer(i);
 				if(pPlayer && pPlayer->IsPlaying())
 				{
 					m_aTeeStarted[i] = false;
-					m_aTeeFinished[i] = false;
+					m_TeeFinished.reset(i);
 
 					apTeamPlayers[PlayersCount++] = pPlayer;
 				}
@@ -397,7 +403,7 @@ const char *CGameTeams::SetCharacterTeam(int ClientID, int Team)
 void CGameTeams::SetForceCharacterTeam(int ClientID, int Team)
 {
 	m_aTeeStarted[ClientID] = false;
-	m_aTeeFinished[ClientID] = false;
+	m_TeeFinished.reset(ClientID);
 	int OldTeam = m_Core.Team(ClientID);
 
 	if(Team != OldTeam && (OldTeam != TEAM_FLOCK || g_Config.m_SvTeam == SV_TEAM_FORCED_SOLO) && OldTeam != TEAM_SUPER && m_aTeamState[OldTeam] != TEAMSTATE_EMPTY)
@@ -415,6 +421,8 @@ void CGameTeams::SetForceCharacterTeam(int ClientID, int Team)
 	}
 
 	m_Core.Team(ClientID, Team);
+	m_aTeamMembers[OldTeam].reset(ClientID);
+	m_aTeamMembers[Team].set(ClientID);
 
 	if(OldTeam != Team)
 	{
@@ -444,13 +452,26 @@ int CGameTeams::Count(int Team) const
 	if(Team == TEAM_SUPER)
 		return -1;
 
-	int Count = 0;
+	return m_aTeamMembers[Team].count();
+}
 
+void CGameTeams::RebuildTeamMembers()
+{
+	for(auto &Members : m_aTeamMembers)
+		Members.reset();
 	for(int i = 0; i < MAX_CLIENTS; ++i)
-		if(m_Core.Team(i) == Team)
-			Count++;
+		m_aTeamMembers[m_Core.Team(i)].set(i);
+}
 
-	return Count;
+void CGameTeams::ValidateTeamMembers() const
+{
+	for(int Team = 0; Team < NUM_TEAMS; ++Team)
+	{
+		for(int i = 0; i < MAX_CLIENTS; ++i)
+		{
+			dbg_assert(m_aTeamMembers[Team].test(i) == (m_Core.Team(i) == Team), "team member mask out of sync with team core");
+		}
+	}
 }
 
 void CGameTeams::ChangeTeamState(int Team, int State)
@@ -462,7 +483,7 @@ void CGameTeams::KillTeam(int Team, int NewStrongID, int ExceptID)
 {
 	for(int i = 0; i < MAX_CLIENTS; i++)
 	{
-		if(m_Core.Team(i) == Team && GameServer()->m_apPlayers[i])
+		if(m_aTeamMembers[Team].test(i) && GameServer()->m_apPlayers[i])
 		{
 			GameServer()->m_apPlayers[i]->m_VotedForPractice = false;
 			if(i != ExceptID)
@@ -489,10 +510,7 @@ bool CGameTeams::TeamFinished(int Team)
 	{
 		return false;
 	}
-	for(int i = 0; i < MAX_CLIENTS; ++i)
-		if(m_Core.Team(i) == Team && !m_aTeeFinished[i])
-			return false;
-	return true;
+	return (m_aTeamMembers[Team] & ~m_TeeFinished).none();
 }
 
 CClientMask CGameTeams::TeamMask(int Team, int ExceptID, int Asker)
@@ -504,6 +522,9 @@ CClientMask CGameTeams::TeamMask(int Team, int ExceptID, int Asker)
 		return CClientMask().set().reset(ExceptID);
 	}
 
+	// clients that are either in the given team or in the super team
+	const CClientMask SameTeam = m_aTeamMembers[Team] | m_aTeamMembers[TEAM_SUPER];
+
 	CClientMask Mask;
 	for(int i = 0; i < MAX_CLIENTS; ++i)
 	{
@@ -520,7 +541,7 @@ CClientMask CGameTeams::TeamMask(int Team, int ExceptID, int Asker)
 					continue; // Player is currently dead
 				if(GetPlayer(i)->m_ShowOthers == SHOW_OTHERS_ONLY_TEAM)
 				{
-					if(m_Core.Team(i) != Team && m_Core.Team(i) != TEAM_SUPER)
+					if(!SameTeam.test(i))
 						continue; // In different teams
 				}
 				else if(GetPlayer(i)->m_ShowOthers == SHOW_OTHERS_OFF)
@@ -529,7 +550,7 @@ CClientMask CGameTeams::TeamMask(int Team, int ExceptID, int Asker)
 						continue; // When in solo part don't show others
 					if(m_Core.GetSolo(i))
 						continue; // When in solo part don't show others
-					if(m_Core.Team(i) != Team && m_Core.Team(i) != TEAM_SUPER)
+					if(!SameTeam.test(i))
 						continue; // In different teams
 				}
 			} // See everything of yourself
@@ -542,7 +563,7 @@ CClientMask CGameTeams::TeamMask(int Team, int ExceptID, int Asker)
 					continue; // Player is currently dead
 				if(GetPlayer(i)->m_ShowOthers == SHOW_OTHERS_ONLY_TEAM)
 				{
-					if(m_Core.Team(GetPlayer(i)->m_SpectatorID) != Team && m_Core.Team(GetPlayer(i)->m_SpectatorID) != TEAM_SUPER)
+					if(!SameTeam.test(GetPlayer(i)->m_SpectatorID))
 						continue; // In different teams
 				}
 				else if(GetPlayer(i)->m_ShowOthers == SHOW_OTHERS_OFF)
@@ -551,7 +572,7 @@ CClientMask CGameTeams::TeamMask(int Team, int ExceptID, int Asker)
 						continue; // When in solo part don't show others
 					if(m_Core.GetSolo(GetPlayer(i)->m_SpectatorID))
 						continue; // When in solo part don't show others
-					if(m_Core.Team(GetPlayer(i)->m_SpectatorID) != Team && m_Core.Team(GetPlayer(i)->m_SpectatorID) != TEAM_SUPER)
+					if(!SameTeam.test(GetPlayer(i)->m_SpectatorID))
 						continue; // In different teams
 				}
 			} // See everything of player you're spectating
@@ -560,7 +581,7 @@ CClientMask CGameTeams::TeamMask(int Team, int ExceptID, int Asker)
 		{ // Freeview
 			if(GetPlayer(i)->m_SpecTeam)
 			{ // Show only players in own team when spectating
-				if(m_Core.Team(i) != Team && m_Core.Team(i) != TEAM_SUPER)
+				if(!SameTeam.test(i))
 					continue; // in different teams
 			}
 		}
@@ -888,7 +909,7 @@ void CGameTeams::RequestTeamSwap(CPlayer *pPlayer, CPlayer *pTargetPlayer, int T
 	{
 		for(int i = 0; i < MAX_CLIENTS; i++)
 		{
-			if(m_Core.Team(i) == Team && i != pTargetPlayer->GetCID() && i != pPlayer->GetCID())
+			if(m_aTeamMembers[Team].test(i) && i != pTargetPlayer->GetCID() && i != pPlayer->GetCID())
 			{
 				GameServer()->SendChatTarget(i, aBuf);
 			}
@@ -952,7 +973,9 @@ void CGameTeams::SwapTeamCharacters(CPlayer *pPrimaryPlayer, CPlayer *pTargetPla
 		}
 	}
 	std::swap(m_aTeeStarted[pPrimaryPlayer->GetCID()], m_aTeeStarted[pTargetPlayer->GetCID()]);
-	std::swap(m_aTeeFinished[pPrimaryPlayer->GetCID()], m_aTeeFinished[pTargetPlayer->GetCID()]);
+	bool PrimaryFinished = m_TeeFinished.test(pPrimaryPlayer->GetCID());
+	m_TeeFinished.set(pPrimaryPlayer->GetCID(), m_TeeFinished.test(pTargetPlayer->GetCID()));
+	m_TeeFinished.set(pTargetPlayer->GetCID(), PrimaryFinished);
 	std::swap(pPrimaryPlayer->GetCharacter()->GetRescueTeeRef(), pTargetPlayer->GetCharacter()->GetRescueTeeRef());
 
 	GameServer()->m_World.SwapClients(pPrimaryPlayer->GetCID(), pTargetPlayer->GetCID());
@@ -1173,7 +1196,7 @@ void CGameTeams::ResetSavedTeam(int ClientID, int Team)
 	{
 		for(int i = 0; i < MAX_CLIENTS; i++)
 		{
-			if(m_Core.Team(i) == Team && GameServer()->m_apPlayers[i])
+			if(m_aTeamMembers[Team].test(i) && GameServer()->m_apPlayers[i])
 			{
 				SetForceCharacterTeam(i, TEAM_FLOCK);
 			}
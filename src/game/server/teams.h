@@ -20,9 +20,15 @@ class CGameTeams
 	// start, go to the finish line, let the tee start and kill, allowing
 	// the team to finish instantly.
 	bool m_aTeeStarted[MAX_CLIENTS];
-	bool m_aTeeFinished[MAX_CLIENTS];
+	CClientMask m_TeeFinished;
 	int m_aLastChat[MAX_CLIENTS];
 
+	// `m_aTeamMembers` mirrors the team assignment stored in `m_Core` as
+	// one bitset per team. It is updated whenever a tee changes its team,
+	// so that counting and iterating team members as well as the team
+	// checks in `TeamMask` don't have to scan all clients.
+	CClientMask m_aTeamMembers[NUM_TEAMS];
+
 	int m_aTeamState[NUM_TEAMS];
 	bool m_aTeamLocked[NUM_TEAMS];
 	CClientMask m_aInvited[NUM_TEAMS];
@@ -46,6 +52,8 @@ class CGameTeams
 	*/
 	void KillTeam(int Team, int NewStrongID, int ExceptID = -1);
 	bool TeamFinished(int Team);
+	void RebuildTeamMembers();
+	void ValidateTeamMembers() const;
 	void OnTeamFinish(CPlayer **Players, unsigned int Size, float Time, const char *pTimestamp);
 	void OnFinish(CPlayer *Player, float Time, const char *pTimestamp);
 
@@ -99,6 +107,7 @@ public:
 	CClientMask TeamMask(int Team, int ExceptID = -1, int Asker = -1);
 
 	int Count(int Team) const;
+	const CClientMask &TeamMembers(int Team) const { return m_aTeamMembers[Team]; }
 
 	// need to be very careful using this method. SERIOUSLY...
 	void SetForceCharacterTeam(int ClientID, int Team);
@@ -133,7 +142,7 @@ public:
 
 	bool TeeFinished(int ClientID)
 	{
-		return m_aTeeFinished[ClientID];
+		return m_TeeFinished.test(ClientID);
 	}
 
 	int GetTeamState(int Team)
@@ -166,7 +175,7 @@ public:
 
 	void SetFinished(int ClientID, bool Finished)
 	{
-		m_aTeeFinished[ClientID] = Finished;
+		m_TeeFinished.set(ClientID, Finished);
 	}
 
 	void SetSaving(int TeamID, std::shared_ptr<CScoreSaveResult> &SaveResult)
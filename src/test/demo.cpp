@@ -0,0 +1,80 @@
+#include "test.h"
+#include <gtest/gtest.h>
+
+#include <engine/shared/demo.h>
+#include <engine/shared/network.h>
+#include <engine/shared/snapshot.h>
+#include <engine/storage.h>
+
+#include <cstddef>
+#include <memory>
+
+static void RecordTestDemo(IStorage *pStorage, const char *pFilename, bool Threaded)
+{
+	CSnapshotDelta SnapshotDelta;
+	CDemoRecorder Recorder(&SnapshotDelta, true, Threaded);
+	unsigned char aMapData[1] = {0};
+	ASSERT_EQ(Recorder.Start(pStorage, nullptr, pFilename, "0.6 626fce9a778df4d4", "test", SHA256_ZEROED, 0, "server", 0, aMapData), 0);
+	ASSERT_TRUE(Recorder.IsRecording());
+
+	CSnapshotBuilder Builder;
+	char aSnapshot[CSnapshot::MAX_SIZE];
+	for(int Tick = 100; Tick < 1100; Tick++)
+	{
+		// leave out some ticks to write full tick markers in between
+		if(Tick % 200 >= 150)
+			continue;
+
+		Builder.Init();
+		for(int i = 0; i < 16; i++)
+		{
+			int *pItem = (int *)Builder.NewItem(1 + i % 4, i, 8 * sizeof(int));
+			for(int j = 0; j < 8; j++)
+				pItem[j] = (i * 8 + j) * (Tick / (1 + i));
+		}
+		const int Size = Builder.Finish(aSnapshot);
+		// the server changes static sizes between the snapshots of its
+		// clients, the recorded delta must use the ones set when recording
+		SnapshotDelta.SetStaticsize(1, Tick % 3 == 0 ? 8 * sizeof(int) : 0);
+		Recorder.RecordSnapshot(Tick, aSnapshot, Size);
+		SnapshotDelta.SetStaticsize(1, Tick % 3 == 0 ? 0 : 8 * sizeof(int));
+
+		if(Tick % 7 == 0)
+		{
+			char aMessage[32];
+			str_format(aMessage, sizeof(aMessage), "message %d", Tick);
+			Recorder.RecordMessage(aMessage, str_length(aMessage) + 1);
+		}
+		if(Tick % 250 == 0)
+			Recorder.AddDemoMarker();
+	}
+	EXPECT_EQ(Recorder.Length(), (1099 - 100) / SERVER_TICK_SPEED);
+	EXPECT_EQ(Recorder.Stop(), 0);
+	EXPECT_FALSE(Recorder.IsRecording());
+}
+
+TEST(Demo, ThreadedRecordingIsIdentical)
+{
+	CNetBase::Init();
+	CTestInfo Info;
+	Info.m_DeleteTestStorageFilesOnSuccess = true;
+	auto pStorage = std::unique_ptr<IStorage>(Info.CreateTestStorage());
+	ASSERT_TRUE(pStorage);
+
+	RecordTestDemo(pStorage.get(), "sync.demo", false);
+	RecordTestDemo(pStorage.get(), "threaded.demo", true);
+
+	void *pSync, *pThreaded;
+	unsigned SyncSize, ThreadedSize;
+	ASSERT_TRUE(pStorage->ReadFile("sync.demo", IStorage::TYPE_SAVE, &pSync, &SyncSize));
+	ASSERT_TRUE(pStorage->ReadFile("threaded.demo", IStorage::TYPE_SAVE, &pThreaded, &ThreadedSize));
+	ASSERT_EQ(SyncSize, ThreadedSize);
+	ASSERT_GT(SyncSize, sizeof(CDemoHeader));
+
+	// only the recording time may differ
+	mem_zero((char *)pSync + offsetof(CDemoHeader, m_aTimestamp), sizeof(CDemoHeader::m_aTimestamp));
+	mem_zero((char *)pThreaded + offsetof(CDemoHeader, m_aTimestamp), sizeof(CDemoHeader::m_aTimestamp));
+	EXPECT_EQ(mem_comp(pSync, pThreaded, SyncSize), 0);
+	free(pSync);
+	free(pThreaded);
+}
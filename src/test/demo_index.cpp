@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+#include <memory>
+
+#include <engine/client/demo_index.h>
+#include <engine/console.h>
+#include <engine/engine.h>
+#include <engine/shared/config.h>
+#include <engine/storage.h>
+#include <test/test.h>
+
+static IDemoIndex::CEntry TestEntry(const char *pMapName)
+{
+	IDemoIndex::CEntry Entry;
+	mem_zero(&Entry, sizeof(Entry));
+	Entry.m_Valid = true;
+	mem_copy(Entry.m_Info.m_aMarker, gs_aHeaderMarker, sizeof(gs_aHeaderMarker));
+	Entry.m_Info.m_Version = 6;
+	str_copy(Entry.m_Info.m_aMapName, pMapName);
+	str_copy(Entry.m_MapInfo.m_aName, pMapName);
+	Entry.m_MapInfo.m_Crc = 0x12345678;
+	Entry.m_MapInfo.m_Size = 1234;
+	return Entry;
+}
+
+TEST(DemoIndex, StoreGet)
+{
+	CTestInfo Info;
+	Info.m_DeleteTestStorageFilesOnSuccess = true;
+
+	auto pConsole = CreateConsole(CFGFLAG_CLIENT);
+	auto pStorage = std::unique_ptr<IStorage>(Info.CreateTestStorage());
+	IDemoIndex::CEntry Entry;
+	{
+		auto pIndex = std::unique_ptr<IDemoIndex>(CreateDemoIndex(pConsole.get(), pStorage.get()));
+		EXPECT_FALSE(pIndex->Get("demos/a.demo", 100, 1000, &Entry));
+		pIndex->Store("demos/a.demo", 100, 1000, TestEntry("Kobra"));
+		pIndex->Store("demos/b.demo", 200, 2000, TestEntry("Tutorial"));
+		pIndex->Commit();
+		pIndex->Store("demos/b.demo", 300, 3000, TestEntry("Multeasymap"));
+		// uncommitted stores are committed on destruction
+	}
+
+	auto pIndex = std::unique_ptr<IDemoIndex>(CreateDemoIndex(pConsole.get(), pStorage.get()));
+	ASSERT_TRUE(pIndex->Get("demos/a.demo", 100, 1000, &Entry));
+	EXPECT_TRUE(Entry.m_Valid);
+	EXPECT_STREQ(Entry.m_Info.m_aMapName, "Kobra");
+	EXPECT_STREQ(Entry.m_MapInfo.m_aName, "Kobra");
+	EXPECT_EQ(Entry.m_MapInfo.m_Crc, 0x12345678u);
+	EXPECT_EQ(Entry.m_MapInfo.m_Size, 1234u);
+
+	// changed files aren't found
+	EXPECT_FALSE(pIndex->Get("demos/a.demo", 101, 1000, &Entry));
+	EXPECT_FALSE(pIndex->Get("demos/a.demo", 100, 1001, &Entry));
+	EXPECT_FALSE(pIndex->Get("demos/b.demo", 200, 2000, &Entry));
+	ASSERT_TRUE(pIndex->Get("demos/b.demo", 300, 3000, &Entry));
+	EXPECT_STREQ(Entry.m_Info.m_aMapName, "Multeasymap");
+}
+
+TEST(DemoIndex, Invalid)
+{
+	CTestInfo Info;
+	Info.m_DeleteTestStorageFilesOnSuccess = true;
+
+	auto pConsole = CreateConsole(CFGFLAG_CLIENT);
+	auto pStorage = std::unique_ptr<IStorage>(Info.CreateTestStorage());
+	auto pIndex = std::unique_ptr<IDemoIndex>(CreateDemoIndex(pConsole.get(), pStorage.get()));
+
+	// demos that failed to parse are remembered as well
+	IDemoIndex::CEntry Entry;
+	mem_zero(&Entry, sizeof(Entry));
+	pIndex->Store("demos/broken.demo", 10, 10, Entry);
+	pIndex->Commit();
+	Entry.m_Valid = true;
+	ASSERT_TRUE(pIndex->Get("demos/broken.demo", 10, 10, &Entry));
+	EXPECT_FALSE(Entry.m_Valid);
+}
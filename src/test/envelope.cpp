@@ -0,0 +1,176 @@
+#include <gtest/gtest.h>
+
+#include <base/math.h>
+
+#include <game/client/render.h>
+#include <game/mapitems.h>
+
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+class CTestEnvelopePoints : public IEnvelopePointAccess
+{
+public:
+	std::vector<CEnvPoint> m_vPoints;
+
+	void Add(int Time, int Curvetype, float Value)
+	{
+		CEnvPoint Point;
+		Point.m_Time = Time;
+		Point.m_Curvetype = Curvetype;
+		for(int c = 0; c < CEnvPoint::MAX_CHANNELS; c++)
+			Point.m_aValues[c] = f2fx(Value + c);
+		m_vPoints.push_back(Point);
+	}
+
+	int NumPoints() const override { return m_vPoints.size(); }
+	const CEnvPoint *GetPoint(int Index) const override { return &m_vPoints[Index]; }
+	const CEnvPointBezier *GetBezier(int Index) const override { return nullptr; }
+};
+
+// the linear search that RenderEvalEnvelope used before the binary search,
+// bezier curves fall back to linear without bezier data
+static ColorRGBA LinearEvalEnvelope(const CTestEnvelopePoints &Points, std::chrono::nanoseconds TimeNanos)
+{
+	const int NumPoints = Points.NumPoints();
+	const CEnvPoint *pLastPoint = Points.GetPoint(NumPoints - 1);
+	const int64_t MaxPointTime = (int64_t)pLastPoint->m_Time * std::chrono::nanoseconds(1ms).count();
+	if(MaxPointTime > 0)
+		TimeNanos = std::chrono::nanoseconds(TimeNanos.count() % MaxPointTime);
+	else
+		TimeNanos = decltype(TimeNanos)::zero();
+
+	const double TimeMillis = TimeNanos.count() / (double)std::chrono::nanoseconds(1ms).count();
+	ColorRGBA Result;
+	for(int i = 0; i < NumPoints - 1; i++)
+	{
+		const CEnvPoint *pCurrentPoint = Points.GetPoint(i);
+		const CEnvPoint *pNextPoint = Points.GetPoint(i + 1);
+		if(TimeMillis >= pCurrentPoint->m_Time && TimeMillis <= pNextPoint->m_Time)
+		{
+			const float Delta = pNextPoint->m_Time - pCurrentPoint->m_Time;
+			float a = (float)(TimeMillis - pCurrentPoint->m_Time) / Delta;
+			switch(pCurrentPoint->m_Curvetype)
+			{
+			case CURVETYPE_STEP:
+				a = 0.0f;
+				break;
+			case CURVETYPE_SLOW:
+				a = a * a * a;
+				break;
+			case CURVETYPE_FAST:
+				a = 1.0f - a;
+				a = 1.0f - a * a * a;
+				break;
+			case CURVETYPE_SMOOTH:
+				a = -2.0f * a * a * a + 3.0f * a * a;
+				break;
+			default:
+				break;
+			}
+			for(int c = 0; c < CEnvPoint::MAX_CHANNELS; c++)
+			{
+				const float v0 = fx2f(pCurrentPoint->m_aValues[c]);
+				const float v1 = fx2f(pNextPoint->m_aValues[c]);
+				Result[c] = v0 + (v1 - v0) * a;
+			}
+			return Result;
+		}
+	}
+	for(int c = 0; c < CEnvPoint::MAX_CHANNELS; c++)
+		Result[c] = fx2f(pLastPoint->m_aValues[c]);
+	return Result;
+}
+
+static void ExpectSameAsLinear(const CTestEnvelopePoints &Points)
+{
+	const int MaxTime = Points.m_vPoints.back().m_Time;
+	// quarter milliseconds hit the point times and the times between them,
+	// the second turn checks times past the last point
+	for(int64_t Quarters = 0; Quarters <= 8 * MaxTime + 4; Quarters++)
+	{
+		const std::chrono::nanoseconds Time(Quarters * 250us);
+		ColorRGBA Result;
+		CRenderTools::RenderEvalEnvelope(&Points, CEnvPoint::MAX_CHANNELS, Time, Result);
+		ColorRGBA Expected = LinearEvalEnvelope(Points, Time);
+		for(int c = 0; c < CEnvPoint::MAX_CHANNELS; c++)
+		{
+			// zero length segments at the start divide by zero in both
+			if(std::isnan(Expected[c]))
+				EXPECT_TRUE(std::isnan(Result[c])) << "time " << Time.count() << "ns, channel " << c;
+			else
+				EXPECT_EQ(Result[c], Expected[c]) << "time " << Time.count() << "ns, channel " << c;
+		}
+	}
+}
+
+TEST(Envelope, Linear)
+{
+	CTestEnvelopePoints Points;
+	Points.Add(0, CURVETYPE_LINEAR, 0.0f);
+	Points.Add(100, CURVETYPE_LINEAR, 1.0f);
+
+	ColorRGBA Result;
+	CRenderTools::RenderEvalEnvelope(&Points, CEnvPoint::MAX_CHANNELS, 50ms, Result);
+	EXPECT_FLOAT_EQ(Result.r, 0.5f);
+	EXPECT_FLOAT_EQ(Result.a, 3.5f);
+	// the time wraps around at the last point
+	CRenderTools::RenderEvalEnvelope(&Points, CEnvPoint::MAX_CHANNELS, 125ms, Result);
+	EXPECT_FLOAT_EQ(Result.r, 0.25f);
+	ExpectSameAsLinear(Points);
+}
+
+TEST(Envelope, CurveTypes)
+{
+	CTestEnvelopePoints Points;
+	Points.Add(0, CURVETYPE_STEP, 0.0f);
+	Points.Add(30, CURVETYPE_SLOW, 2.0f);
+	Points.Add(70, CURVETYPE_FAST, -1.0f);
+	Points.Add(110, CURVETYPE_SMOOTH, 4.0f);
+	Points.Add(150, CURVETYPE_BEZIER, 1.0f);
+	Points.Add(190, CURVETYPE_LINEAR, 3.0f);
+	Points.Add(230, CURVETYPE_LINEAR, 0.5f);
+	ExpectSameAsLinear(Points);
+}
+
+TEST(Envelope, DuplicateTimes)
+{
+	CTestEnvelopePoints Points;
+	Points.Add(0, CURVETYPE_LINEAR, 5.0f);
+	Points.Add(0, CURVETYPE_LINEAR, 0.0f);
+	Points.Add(40, CURVETYPE_SMOOTH, 1.0f);
+	Points.Add(40, CURVETYPE_LINEAR, 2.0f);
+	Points.Add(40, CURVETYPE_STEP, 3.0f);
+	Points.Add(80, CURVETYPE_LINEAR, 4.0f);
+	Points.Add(120, CURVETYPE_LINEAR, 0.0f);
+	Points.Add(120, CURVETYPE_LINEAR, 6.0f);
+	ExpectSameAsLinear(Points);
+}
+
+TEST(Envelope, StartAfterZero)
+{
+	// times before the first point evaluate to the last point
+	CTestEnvelopePoints Points;
+	Points.Add(60, CURVETYPE_LINEAR, 1.0f);
+	Points.Add(90, CURVETYPE_SLOW, 2.0f);
+	Points.Add(100, CURVETYPE_LINEAR, 0.0f);
+
+	ColorRGBA Result;
+	CRenderTools::RenderEvalEnvelope(&Points, CEnvPoint::MAX_CHANNELS, 30ms, Result);
+	EXPECT_FLOAT_EQ(Result.r, 0.0f);
+	ExpectSameAsLinear(Points);
+}
+
+TEST(Envelope, SinglePoint)
+{
+	CTestEnvelopePoints Points;
+	Points.Add(20, CURVETYPE_LINEAR, 0.75f);
+
+	ColorRGBA Result;
+	CRenderTools::RenderEvalEnvelope(&Points, CEnvPoint::MAX_CHANNELS, 123ms, Result);
+	EXPECT_FLOAT_EQ(Result.r, 0.75f);
+	EXPECT_FLOAT_EQ(Result.a, 3.75f);
+}
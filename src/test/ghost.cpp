@@ -0,0 +1,304 @@
+#include "test.h"
+#include <gtest/gtest.h>
+
+#include <base/system.h>
+
+#include <engine/client/ghost.h>
+#include <engine/console.h>
+#include <engine/kernel.h>
+#include <engine/shared/config.h>
+#include <engine/shared/network.h>
+#include <engine/storage.h>
+
+#include <memory>
+#include <vector>
+
+static const char *const MAP = "Kobra 4";
+static const int NUM_CHARACTERS = 1234;
+
+enum
+{
+	TYPE_SKIN = 0,
+	TYPE_CHARACTER = 2,
+	TYPE_START_TICK = 3,
+};
+
+struct CTestCharacter
+{
+	int m_X;
+	int m_Y;
+	int m_Tick;
+};
+
+static CTestCharacter TestCharacter(int Index)
+{
+	return CTestCharacter{Index * 7 % 100, -Index, 1000 + Index};
+}
+
+class Ghost : public ::testing::Test
+{
+protected:
+	CTestInfo m_Info;
+	std::unique_ptr<IKernel> m_pKernel;
+	std::unique_ptr<IConsole> m_pConsole;
+	std::unique_ptr<IStorage> m_pStorage;
+	CGhostRecorder m_Recorder;
+	CGhostLoader m_Loader;
+	SHA256_DIGEST m_MapSha256;
+
+	Ghost() :
+		m_pKernel(IKernel::Create()),
+		m_pConsole(CreateConsole(CFGFLAG_CLIENT)),
+		m_pStorage(m_Info.CreateTestStorage())
+	{
+		CNetBase::Init();
+		m_Info.m_DeleteTestStorageFilesOnSuccess = true;
+		m_MapSha256 = sha256(MAP, str_length(MAP));
+		m_pKernel->RegisterInterface(m_pConsole.get(), false);
+		m_pKernel->RegisterInterface(m_pStorage.get(), false);
+		m_pKernel->RegisterInterface(static_cast<IGhostRecorder *>(&m_Recorder), false);
+		m_pKernel->RegisterInterface(static_cast<IGhostLoader *>(&m_Loader), false);
+		m_Recorder.Init();
+		m_Loader.Init();
+	}
+
+	void Record(const char *pFilename)
+	{
+		ASSERT_EQ(m_Recorder.Start(pFilename, MAP, m_MapSha256, "nameless tee"), 0);
+		const int StartTick = 1000;
+		m_Recorder.WriteData(TYPE_START_TICK, &StartTick, sizeof(StartTick));
+		const int aSkin[4] = {1, 2, 3, 4};
+		m_Recorder.WriteData(TYPE_SKIN, aSkin, sizeof(aSkin));
+		for(int i = 0; i < NUM_CHARACTERS; i++)
+		{
+			const CTestCharacter Char = TestCharacter(i);
+			m_Recorder.WriteData(TYPE_CHARACTER, &Char, sizeof(Char));
+		}
+		ASSERT_EQ(m_Recorder.Stop(NUM_CHARACTERS, 12345), 0);
+	}
+
+	std::vector<unsigned char> ReadFile(const char *pFilename)
+	{
+		void *pData;
+		unsigned Size;
+		EXPECT_TRUE(m_pStorage->ReadFile(pFilename, IStorage::TYPE_SAVE, &pData, &Size));
+		std::vector<unsigned char> vData((unsigned char *)pData, (unsigned char *)pData + Size);
+		free(pData);
+		return vData;
+	}
+
+	void WriteFile(const char *pFilename, const unsigned char *pData, size_t Size)
+	{
+		IOHANDLE File = m_pStorage->OpenFile(pFilename, IOFLAG_WRITE, IStorage::TYPE_SAVE);
+		ASSERT_TRUE(File);
+		EXPECT_EQ(io_write(File, pData, Size), Size);
+		io_close(File);
+	}
+
+	int Load(const char *pFilename)
+	{
+		return m_Loader.Load(pFilename, MAP, m_MapSha256, 0);
+	}
+
+	// reads all items in order like the full load of ghosts without an index
+	void ExpectAllItems()
+	{
+		int NumCharacters = 0;
+		bool FoundSkin = false;
+		bool FoundStartTick = false;
+		int Type;
+		while(m_Loader.ReadNextType(&Type))
+		{
+			if(Type == TYPE_CHARACTER)
+			{
+				CTestCharacter Char;
+				ASSERT_TRUE(m_Loader.ReadData(Type, &Char, sizeof(Char)));
+				const CTestCharacter Expected = TestCharacter(NumCharacters);
+				EXPECT_EQ(Char.m_Tick, Expected.m_Tick);
+				EXPECT_EQ(Char.m_X, Expected.m_X);
+				EXPECT_EQ(Char.m_Y, Expected.m_Y);
+				NumCharacters++;
+			}
+			else if(Type == TYPE_SKIN)
+			{
+				int aSkin[4];
+				ASSERT_TRUE(m_Loader.ReadData(Type, aSkin, sizeof(aSkin)));
+				EXPECT_EQ(aSkin[3], 4);
+				FoundSkin = true;
+			}
+			else if(Type == TYPE_START_TICK)
+			{
+				int StartTick;
+				ASSERT_TRUE(m_Loader.ReadData(Type, &StartTick, sizeof(StartTick)));
+				EXPECT_EQ(StartTick, 1000);
+				FoundStartTick = true;
+			}
+		}
+		EXPECT_EQ(NumCharacters, NUM_CHARACTERS);
+		EXPECT_TRUE(FoundSkin);
+		EXPECT_TRUE(FoundStartTick);
+	}
+};
+
+TEST_F(Ghost, RoundTrip)
+{
+	Record("test.gho");
+	ASSERT_EQ(Load("test.gho"), 0);
+	EXPECT_TRUE(m_Loader.IsIndexed());
+	EXPECT_STREQ(m_Loader.GetInfo()->m_aOwner, "nameless tee");
+	EXPECT_EQ(m_Loader.GetInfo()->m_NumTicks, NUM_CHARACTERS);
+	EXPECT_EQ(m_Loader.GetInfo()->m_Time, 12345);
+	ExpectAllItems();
+	m_Loader.Close();
+
+	CGhostInfo Info;
+	EXPECT_TRUE(m_Loader.GetGhostInfo("test.gho", &Info, MAP, m_MapSha256, 0));
+	EXPECT_EQ(Info.m_NumTicks, NUM_CHARACTERS);
+}
+
+TEST_F(Ghost, SeekItem)
+{
+	Record("test.gho");
+	ASSERT_EQ(Load("test.gho"), 0);
+
+	// every chunk holds up to 50 items
+	for(int Index : {0, 49, 50, 51, 1000, 99, NUM_CHARACTERS - 1})
+	{
+		const int First = m_Loader.SeekItem(TYPE_CHARACTER, Index);
+		EXPECT_EQ(First, Index / 50 * 50) << Index;
+		int Type;
+		ASSERT_TRUE(m_Loader.ReadNextType(&Type));
+		ASSERT_EQ(Type, TYPE_CHARACTER);
+		for(int i = First; i <= Index; i++)
+		{
+			if(i != First)
+			{
+				ASSERT_TRUE(m_Loader.ReadNextType(&Type));
+				ASSERT_EQ(Type, TYPE_CHARACTER);
+			}
+			CTestCharacter Char;
+			ASSERT_TRUE(m_Loader.ReadData(Type, &Char, sizeof(Char)));
+			EXPECT_EQ(Char.m_Tick, TestCharacter(i).m_Tick);
+		}
+	}
+}
+
+TEST_F(Ghost, ItemWindow)
+{
+	Record("test.gho");
+	ASSERT_EQ(Load("test.gho"), 0);
+
+	// smaller than a chunk, so it slides across chunk boundaries
+	CGhostItemWindow Window;
+	Window.Init(&m_Loader, TYPE_CHARACTER, sizeof(CTestCharacter), NUM_CHARACTERS, 30);
+	EXPECT_EQ(Window.NumItems(), NUM_CHARACTERS);
+
+	for(int i = 0; i < NUM_CHARACTERS; i++)
+	{
+		const CTestCharacter *pChar = static_cast<const CTestCharacter *>(Window.Get(i));
+		ASSERT_TRUE(pChar) << i;
+		EXPECT_EQ(pChar->m_Tick, TestCharacter(i).m_Tick);
+		EXPECT_EQ(pChar->m_X, TestCharacter(i).m_X);
+		// the previous item stays in the window
+		if(i > 0)
+		{
+			pChar = static_cast<const CTestCharacter *>(Window.Get(i - 1));
+			ASSERT_TRUE(pChar) << i;
+			EXPECT_EQ(pChar->m_Tick, TestCharacter(i - 1).m_Tick);
+		}
+	}
+
+	// rewinding and jumping ahead seek through the index
+	for(int Index : {10, 1200, 49, 50, 700, 0, NUM_CHARACTERS - 1, 730})
+	{
+		const CTestCharacter *pChar = static_cast<const CTestCharacter *>(Window.Get(Index));
+		ASSERT_TRUE(pChar) << Index;
+		EXPECT_EQ(pChar->m_Tick, TestCharacter(Index).m_Tick);
+	}
+
+	EXPECT_EQ(Window.Get(-1), nullptr);
+	EXPECT_EQ(Window.Get(NUM_CHARACTERS), nullptr);
+}
+
+TEST_F(Ghost, Version6)
+{
+	Record("test.gho");
+	std::vector<unsigned char> vData = ReadFile("test.gho");
+	ASSERT_GE(vData.size(), sizeof(CGhostHeader));
+
+	// version 6 has no chunk index and the map crc instead of its offset
+	CGhostHeader Header;
+	mem_copy(&Header, vData.data(), sizeof(Header));
+	const unsigned IndexOffset = Header.GetIndexOffset();
+	ASSERT_GT(IndexOffset, sizeof(Header));
+	ASSERT_LT(IndexOffset, vData.size());
+	Header.m_Version = 6;
+	mem_zero(Header.m_aZeroes, sizeof(Header.m_aZeroes));
+	mem_copy(vData.data(), &Header, sizeof(Header));
+	WriteFile("test6.gho", vData.data(), IndexOffset);
+
+	ASSERT_EQ(Load("test6.gho"), 0);
+	EXPECT_FALSE(m_Loader.IsIndexed());
+	EXPECT_EQ(m_Loader.GetInfo()->m_NumTicks, NUM_CHARACTERS);
+	ExpectAllItems();
+
+	// without an index the window reads from the start
+	m_Loader.Close();
+	ASSERT_EQ(Load("test6.gho"), 0);
+	CGhostItemWindow Window;
+	Window.Init(&m_Loader, TYPE_CHARACTER, sizeof(CTestCharacter), NUM_CHARACTERS, 30);
+	for(int Index : {500, 100, NUM_CHARACTERS - 1})
+	{
+		const CTestCharacter *pChar = static_cast<const CTestCharacter *>(Window.Get(Index));
+		ASSERT_TRUE(pChar) << Index;
+		EXPECT_EQ(pChar->m_Tick, TestCharacter(Index).m_Tick);
+	}
+}
+
+TEST_F(Ghost, CorruptedIndex)
+{
+	Record("test.gho");
+	const std::vector<unsigned char> vData = ReadFile("test.gho");
+	CGhostHeader Header;
+	mem_copy(&Header, vData.data(), sizeof(Header));
+	const unsigned IndexOffset = Header.GetIndexOffset();
+
+	// index offset past the end of the file
+	{
+		std::vector<unsigned char> vCorrupted = vData;
+		uint_to_bytes_be(&vCorrupted[offsetof(CGhostHeader, m_aZeroes)], vData.size() + 100);
+		WriteFile("corrupted.gho", vCorrupted.data(), vCorrupted.size());
+		EXPECT_EQ(Load("corrupted.gho"), -1);
+	}
+
+	// more chunks than fit before the index
+	{
+		std::vector<unsigned char> vCorrupted = vData;
+		uint_to_bytes_be(&vCorrupted[IndexOffset], 0x7fffffff);
+		WriteFile("corrupted.gho", vCorrupted.data(), vCorrupted.size());
+		EXPECT_EQ(Load("corrupted.gho"), -1);
+	}
+
+	// truncated index
+	{
+		WriteFile("corrupted.gho", vData.data(), vData.size() - 3);
+		EXPECT_EQ(Load("corrupted.gho"), -1);
+	}
+
+	// chunk offset inside the index
+	{
+		std::vector<unsigned char> vCorrupted = vData;
+		uint_to_bytes_be(&vCorrupted[IndexOffset + sizeof(int32_t) + offsetof(CGhostChunkIndexEntry, m_aOffset)], IndexOffset + 1);
+		WriteFile("corrupted.gho", vCorrupted.data(), vCorrupted.size());
+		EXPECT_EQ(Load("corrupted.gho"), -1);
+	}
+
+	// chunks out of order
+	{
+		std::vector<unsigned char> vCorrupted = vData;
+		const int SecondEntry = IndexOffset + sizeof(int32_t) + sizeof(CGhostChunkIndexEntry);
+		uint_to_bytes_be(&vCorrupted[SecondEntry + offsetof(CGhostChunkIndexEntry, m_aOffset)], sizeof(CGhostHeader));
+		WriteFile("corrupted.gho", vCorrupted.data(), vCorrupted.size());
+		EXPECT_EQ(Load("corrupted.gho"), -1);
+	}
+}
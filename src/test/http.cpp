@@ -0,0 +1,222 @@
+#include <gtest/gtest.h>
+
+#include <base/system.h>
+#include <engine/shared/config.h>
+#include <engine/shared/http.h>
+#include <engine/shared/jobs.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+// Minimal HTTP/1.1 server answering every request with "ok" and keeping the
+// connection open, so tests can check whether connections are reused.
+class CTestHttpServer
+{
+	NETSOCKET m_Socket;
+	void *m_pThread = nullptr;
+	std::atomic<bool> m_Shutdown{false};
+
+	static void ThreadMain(void *pUser)
+	{
+		CTestHttpServer *pSelf = (CTestHttpServer *)pUser;
+		while(!pSelf->m_Shutdown)
+		{
+			if(net_socket_read_wait(pSelf->m_Socket, 10000) <= 0)
+				continue;
+			NETSOCKET Client;
+			NETADDR ClientAddr;
+			if(net_tcp_accept(pSelf->m_Socket, &Client, &ClientAddr) < 0)
+				continue;
+			pSelf->m_NumConnections++;
+			pSelf->Serve(Client);
+			net_tcp_close(Client);
+		}
+	}
+
+	void Serve(NETSOCKET Client)
+	{
+		char aRequest[1024];
+		int RequestLength = 0;
+		while(!m_Shutdown)
+		{
+			if(net_socket_read_wait(Client, 10000) <= 0)
+				continue;
+			int Received = net_tcp_recv(Client, aRequest + RequestLength, sizeof(aRequest) - RequestLength - 1);
+			if(Received <= 0)
+				return;
+			RequestLength += Received;
+			aRequest[RequestLength] = '\0';
+			if(!str_find(aRequest, "\r\n\r\n"))
+				continue;
+			m_NumRequests++;
+			static const char s_aResponse[] = "HTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\nok";
+			net_tcp_send(Client, s_aResponse, str_length(s_aResponse));
+			RequestLength = 0;
+		}
+	}
+
+public:
+	std::atomic<int> m_NumConnections{0};
+	std::atomic<int> m_NumRequests{0};
+	int m_Port;
+
+	CTestHttpServer()
+	{
+		NETADDR Bindaddr = {};
+		Bindaddr.type = NETTYPE_IPV4;
+		do
+		{
+			Bindaddr.port = secure_rand() % 64511 + 1024;
+		} while((m_Socket = net_tcp_create(Bindaddr)) == nullptr);
+		m_Port = Bindaddr.port;
+		net_tcp_listen(m_Socket, 8);
+		m_pThread = thread_init(ThreadMain, this, "http_test");
+	}
+
+	~CTestHttpServer()
+	{
+		m_Shutdown = true;
+		thread_wait(m_pThread);
+		net_tcp_close(m_Socket);
+	}
+
+	void Url(char *pBuf, int BufSize, const char *pPath) const
+	{
+		str_format(pBuf, BufSize, "http://127.0.0.1:%d%s", m_Port, pPath);
+	}
+};
+
+class Http : public ::testing::Test
+{
+protected:
+	CTestHttpServer m_Server;
+
+	Http()
+	{
+		g_Config.m_HttpAllowInsecure = 1;
+		HttpInit(nullptr);
+	}
+};
+
+TEST_F(Http, ReuseConnection)
+{
+	char aUrl[128];
+	for(int i = 0; i < 3; i++)
+	{
+		m_Server.Url(aUrl, sizeof(aUrl), i == 0 ? "/first" : "/next");
+		std::unique_ptr<CHttpRequest> pRequest = HttpGet(aUrl);
+		CJobPool::RunBlocking(pRequest.get());
+		ASSERT_EQ(pRequest->State(), HTTP_DONE);
+
+		unsigned char *pResult;
+		size_t ResultLength;
+		pRequest->Result(&pResult, &ResultLength);
+		ASSERT_EQ(ResultLength, 2u);
+		EXPECT_EQ(mem_comp(pResult, "ok", 2), 0);
+	}
+	EXPECT_EQ(m_Server.m_NumRequests, 3);
+	EXPECT_EQ(m_Server.m_NumConnections, 1);
+}
+
+TEST_F(Http, AbortBeforeRun)
+{
+	char aUrl[128];
+	m_Server.Url(aUrl, sizeof(aUrl), "/");
+	std::unique_ptr<CHttpRequest> pRequest = HttpGet(aUrl);
+	pRequest->Abort();
+	CJobPool::RunBlocking(pRequest.get());
+	EXPECT_EQ(pRequest->State(), HTTP_ABORTED);
+	EXPECT_EQ(m_Server.m_NumRequests, 0);
+}
+
+class CTestJob : public IJob
+{
+	void Run() override {}
+};
+
+TEST_F(Http, DoesNotBlockJobThread)
+{
+	// accepts connections through the backlog, but never answers
+	NETSOCKET Silent;
+	NETADDR Bindaddr = {};
+	Bindaddr.type = NETTYPE_IPV4;
+	do
+	{
+		Bindaddr.port = secure_rand() % 64511 + 1024;
+	} while((Silent = net_tcp_create(Bindaddr)) == nullptr);
+	net_tcp_listen(Silent, 8);
+
+	char aUrl[128];
+	str_format(aUrl, sizeof(aUrl), "http://127.0.0.1:%d/", Bindaddr.port);
+
+	CJobPool Pool;
+	Pool.Init(1);
+	std::shared_ptr<CHttpRequest> pRequest = HttpGet(aUrl);
+	std::shared_ptr<CTestJob> pJob = std::make_shared<CTestJob>();
+	Pool.Add(pRequest);
+	Pool.Add(pJob);
+
+	// the only job thread must be free again while the transfer is running
+	for(int i = 0; i < 1000 && pJob->Status() != IJob::STATE_DONE; i++)
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	EXPECT_EQ(pJob->Status(), IJob::STATE_DONE);
+	EXPECT_EQ(pRequest->Status(), IJob::STATE_RUNNING);
+	EXPECT_EQ(pRequest->State(), HTTP_RUNNING);
+
+	pRequest->Abort();
+	for(int i = 0; i < 1000 && pRequest->Status() != IJob::STATE_DONE; i++)
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	EXPECT_EQ(pRequest->Status(), IJob::STATE_DONE);
+	EXPECT_EQ(pRequest->State(), HTTP_ABORTED);
+
+	Pool.Destroy();
+	net_tcp_close(Silent);
+}
+
+class CSlowCompletionRequest : public CHttpRequest
+{
+	int OnCompletion(int State) override
+	{
+		m_InCompletion = true;
+		while(!m_Release)
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		return CHttpRequest::OnCompletion(State);
+	}
+
+public:
+	std::atomic<bool> m_InCompletion{false};
+	std::atomic<bool> m_Release{false};
+
+	CSlowCompletionRequest(const char *pUrl) :
+		CHttpRequest(pUrl) {}
+};
+
+TEST_F(Http, SlowCompletionDoesNotBlockTransfers)
+{
+	char aUrl[128];
+	m_Server.Url(aUrl, sizeof(aUrl), "/");
+
+	CJobPool Pool;
+	Pool.Init(2);
+	std::shared_ptr<CSlowCompletionRequest> pSlow = std::make_shared<CSlowCompletionRequest>(aUrl);
+	Pool.Add(pSlow);
+	for(int i = 0; i < 1000 && !pSlow->m_InCompletion; i++)
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	ASSERT_TRUE(pSlow->m_InCompletion);
+
+	// the HTTP thread keeps transferring while a completion handler runs
+	std::shared_ptr<CHttpRequest> pRequest = HttpGet(aUrl);
+	Pool.Add(pRequest);
+	for(int i = 0; i < 1000 && pRequest->Status() != IJob::STATE_DONE; i++)
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	EXPECT_EQ(pRequest->State(), HTTP_DONE);
+	EXPECT_EQ(pSlow->Status(), IJob::STATE_RUNNING);
+
+	pSlow->m_Release = true;
+	for(int i = 0; i < 1000 && pSlow->Status() != IJob::STATE_DONE; i++)
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	EXPECT_EQ(pSlow->State(), HTTP_DONE);
+
+	Pool.Destroy();
+}
@@ -78,3 +78,27 @@ TEST(Io, SyncWorks)
 	EXPECT_FALSE(io_close(File));
 	EXPECT_FALSE(fs_remove(Info.m_aFilename));
 }
+
+TEST(Io, MapFile)
+{
+	CTestInfo Info;
+	const void *pData;
+	unsigned Length;
+	EXPECT_FALSE(io_map_file(Info.m_aFilename, &pData, &Length));
+
+	IOHANDLE File = io_open(Info.m_aFilename, IOFLAG_WRITE);
+	ASSERT_TRUE(File);
+	EXPECT_FALSE(io_close(File));
+	EXPECT_FALSE(io_map_file(Info.m_aFilename, &pData, &Length));
+
+	File = io_open(Info.m_aFilename, IOFLAG_WRITE);
+	ASSERT_TRUE(File);
+	EXPECT_EQ(io_write(File, "abc\n", 4), 4);
+	EXPECT_FALSE(io_close(File));
+	ASSERT_TRUE(io_map_file(Info.m_aFilename, &pData, &Length));
+	ASSERT_EQ(Length, 4);
+	EXPECT_EQ(mem_comp(pData, "abc\n", 4), 0);
+	EXPECT_FALSE(fs_remove(Info.m_aFilename));
+	EXPECT_EQ(mem_comp(pData, "abc\n", 4), 0);
+	io_unmap_file(pData, Length);
+}
@@ -0,0 +1,239 @@
+#include <gtest/gtest.h>
+
+#include <base/logger.h>
+#include <base/system.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+static CLogMessage TestMessage(LEVEL Level, const char *pText)
+{
+	CLogMessage Msg;
+	Msg.m_Level = Level;
+	Msg.m_HaveColor = false;
+	Msg.m_Color = LOG_COLOR{0, 0, 0};
+	str_copy(Msg.m_aTimestamp, "2000-01-01 00:00:00");
+	Msg.m_TimestampLength = str_length(Msg.m_aTimestamp);
+	str_copy(Msg.m_aSystem, "test");
+	Msg.m_SystemLength = str_length(Msg.m_aSystem);
+	str_copy(Msg.m_aLine, pText);
+	Msg.m_LineMessageOffset = 0;
+	Msg.m_LineLength = str_length(Msg.m_aLine);
+	return Msg;
+}
+
+class CTestLogger : public ILogger
+{
+	CLock m_Lock;
+
+public:
+	std::vector<std::string> m_vLines GUARDED_BY(m_Lock);
+	std::atomic<bool> m_Finished{false};
+
+	void Log(const CLogMessage *pMessage) override REQUIRES(!m_Lock)
+	{
+		if(m_Filter.Filters(pMessage))
+			return;
+		const CLockScope LockScope(m_Lock);
+		m_vLines.emplace_back(pMessage->Message());
+	}
+	void GlobalFinish() override
+	{
+		m_Finished = true;
+	}
+	std::vector<std::string> Lines() REQUIRES(!m_Lock)
+	{
+		const CLockScope LockScope(m_Lock);
+		return m_vLines;
+	}
+};
+
+TEST(Log, QueueOrder)
+{
+	CLogQueue Queue(4);
+	for(int i = 0; i < 3; i++)
+	{
+		char aText[16];
+		str_format(aText, sizeof(aText), "%d", i);
+		const CLogMessage Msg = TestMessage(LEVEL_INFO, aText);
+		EXPECT_TRUE(Queue.Push(&Msg));
+	}
+	for(int i = 0; i < 3; i++)
+	{
+		char aText[16];
+		str_format(aText, sizeof(aText), "%d", i);
+		EXPECT_TRUE(Queue.Pop([&](const CLogMessage *pMessage) {
+			EXPECT_STREQ(pMessage->m_aLine, aText);
+			EXPECT_EQ(pMessage->m_LineLength, str_length(aText));
+		}));
+	}
+	EXPECT_FALSE(Queue.Pop([](const CLogMessage *pMessage) { FAIL(); }));
+	EXPECT_EQ(Queue.NumDropped(), 0);
+}
+
+TEST(Log, QueueFull)
+{
+	CLogQueue Queue(3);
+	const CLogMessage Msg = TestMessage(LEVEL_INFO, "full");
+	for(int i = 0; i < 4; i++)
+		EXPECT_TRUE(Queue.Push(&Msg));
+	EXPECT_FALSE(Queue.Push(&Msg));
+	EXPECT_FALSE(Queue.Push(&Msg));
+	EXPECT_EQ(Queue.NumDropped(), 2);
+
+	EXPECT_TRUE(Queue.Pop([](const CLogMessage *pMessage) {}));
+	EXPECT_TRUE(Queue.Push(&Msg));
+	int NumPopped = 0;
+	while(Queue.Pop([](const CLogMessage *pMessage) {}))
+		NumPopped++;
+	EXPECT_EQ(NumPopped, 4);
+}
+
+TEST(Log, QueueDroppedMessage)
+{
+	CLogQueue Queue(2);
+	const CLogMessage Msg = TestMessage(LEVEL_INFO, "full");
+	CLogMessage Dropped;
+	EXPECT_FALSE(Queue.DroppedMessage(&Dropped));
+	for(int i = 0; i < 5; i++)
+		Queue.Push(&Msg);
+	ASSERT_TRUE(Queue.DroppedMessage(&Dropped));
+	EXPECT_EQ(Dropped.m_Level, LEVEL_WARN);
+	EXPECT_STREQ(Dropped.m_aSystem, "logger");
+	EXPECT_STREQ(Dropped.Message(), "dropped 3 messages, the log queue was full");
+	EXPECT_FALSE(Queue.DroppedMessage(&Dropped));
+	Queue.Push(&Msg);
+	ASSERT_TRUE(Queue.DroppedMessage(&Dropped));
+	EXPECT_STREQ(Dropped.Message(), "dropped 1 messages, the log queue was full");
+}
+
+TEST(Log, QueueMultipleProducers)
+{
+	static const int NUM_THREADS = 4;
+	static const int NUM_MESSAGES = 10000;
+	CLogQueue Queue(64);
+	std::atomic<int> NumPushed{0};
+	std::vector<std::thread> vThreads;
+	for(int t = 0; t < NUM_THREADS; t++)
+	{
+		vThreads.emplace_back([&, t]() {
+			for(int i = 0; i < NUM_MESSAGES; i++)
+			{
+				char aText[32];
+				str_format(aText, sizeof(aText), "%d %d", t, i);
+				const CLogMessage Msg = TestMessage(LEVEL_INFO, aText);
+				if(Queue.Push(&Msg))
+					NumPushed++;
+			}
+		});
+	}
+
+	// messages of each thread must arrive in order and intact
+	int aLast[NUM_THREADS] = {-1, -1, -1, -1};
+	int NumPopped = 0;
+	const auto Check = [&](const CLogMessage *pMessage) {
+		int Thread, Index;
+		ASSERT_EQ(sscanf(pMessage->m_aLine, "%d %d", &Thread, &Index), 2);
+		ASSERT_GE(Thread, 0);
+		ASSERT_LT(Thread, NUM_THREADS);
+		EXPECT_GT(Index, aLast[Thread]);
+		aLast[Thread] = Index;
+		NumPopped++;
+	};
+	while(NumPopped + Queue.NumDropped() < NUM_THREADS * NUM_MESSAGES)
+	{
+		if(!Queue.Pop(Check))
+			std::this_thread::yield();
+	}
+	for(auto &Thread : vThreads)
+		Thread.join();
+	EXPECT_EQ(NumPopped, NumPushed);
+	EXPECT_FALSE(Queue.Pop(Check));
+}
+
+TEST(Log, QueueLogger)
+{
+	auto pInner = std::make_shared<CTestLogger>();
+	{
+		std::unique_ptr<ILogger> pLogger = log_logger_queue(pInner, 16);
+		pLogger->SetFilter(CLogFilter{LEVEL_INFO});
+		EXPECT_TRUE(pLogger->Enabled(LEVEL_INFO));
+		EXPECT_FALSE(pLogger->Enabled(LEVEL_DEBUG));
+
+		const CLogMessage First = TestMessage(LEVEL_INFO, "first");
+		const CLogMessage Debug = TestMessage(LEVEL_DEBUG, "debug");
+		const CLogMessage Second = TestMessage(LEVEL_WARN, "second");
+		pLogger->Log(&First);
+		pLogger->Log(&Debug);
+		pLogger->Log(&Second);
+		pLogger->GlobalFinish();
+		EXPECT_TRUE(pInner->m_Finished);
+
+		// ignored after finishing
+		pLogger->Log(&First);
+	}
+	const std::vector<std::string> vLines = pInner->Lines();
+	ASSERT_EQ(vLines.size(), 2u);
+	EXPECT_EQ(vLines[0], "first");
+	EXPECT_EQ(vLines[1], "second");
+}
+
+TEST(Log, QueueLoggerManyThreads)
+{
+	static const int NUM_THREADS = 4;
+	static const int NUM_MESSAGES = 1000;
+	auto pInner = std::make_shared<CTestLogger>();
+	{
+		std::unique_ptr<ILogger> pLogger = log_logger_queue(pInner, 8);
+		std::vector<std::thread> vThreads;
+		for(int t = 0; t < NUM_THREADS; t++)
+		{
+			vThreads.emplace_back([&]() {
+				const CLogMessage Msg = TestMessage(LEVEL_INFO, "message");
+				for(int i = 0; i < NUM_MESSAGES; i++)
+					pLogger->Log(&Msg);
+			});
+		}
+		for(auto &Thread : vThreads)
+			Thread.join();
+		pLogger->GlobalFinish();
+	}
+
+	// every message is either logged or counted in a report
+	int NumLogged = 0;
+	int NumReported = 0;
+	for(const std::string &Line : pInner->Lines())
+	{
+		int NumDropped;
+		if(Line == "message")
+			NumLogged++;
+		else if(sscanf(Line.c_str(), "dropped %d messages", &NumDropped) == 1)
+			NumReported += NumDropped;
+		else
+			ADD_FAILURE() << Line;
+	}
+	EXPECT_EQ(NumLogged + NumReported, NUM_THREADS * NUM_MESSAGES);
+}
+
+TEST(Log, CollectionEnabled)
+{
+	auto pInfo = std::make_shared<CTestLogger>();
+	pInfo->SetFilter(CLogFilter{LEVEL_INFO});
+	auto pWarn = std::make_shared<CTestLogger>();
+	pWarn->SetFilter(CLogFilter{LEVEL_WARN});
+	std::unique_ptr<ILogger> pCollection = log_logger_collection({pInfo, pWarn});
+	EXPECT_TRUE(pCollection->Enabled(LEVEL_WARN));
+	EXPECT_TRUE(pCollection->Enabled(LEVEL_INFO));
+	EXPECT_FALSE(pCollection->Enabled(LEVEL_DEBUG));
+
+	std::unique_ptr<ILogger> pEmpty = log_logger_collection({});
+	EXPECT_FALSE(pEmpty->Enabled(LEVEL_ERROR));
+
+	CFutureLogger Future;
+	EXPECT_TRUE(Future.Enabled(LEVEL_TRACE));
+	Future.Set(std::move(pCollection));
+	EXPECT_FALSE(Future.Enabled(LEVEL_DEBUG));
+}
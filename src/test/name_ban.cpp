@@ -1,7 +1,10 @@
 #include <gtest/gtest.h>
 
+#include <base/system.h>
 #include <engine/server/name_ban.h>
 
+#include <algorithm>
+
 TEST(NameBan, Empty)
 {
 	CNameBans Bans;
@@ -78,3 +81,134 @@ TEST(NameBan, UnbanNotFound)
 	CNameBans Bans;
 	Bans.Unban("abc");
 }
+
+TEST(NameBan, UpdateIndex)
+{
+	CNameBans Bans;
+	Bans.Ban("abcdefgh", "", 0, false);
+	EXPECT_TRUE(Bans.IsBanned("abcdefgh"));
+	EXPECT_FALSE(Bans.IsBanned("abcdefxx"));
+	EXPECT_FALSE(Bans.IsBanned("xxabcdefghxx"));
+
+	Bans.Ban("abcdefgh", "", 2, true);
+	EXPECT_TRUE(Bans.IsBanned("abcdefxx"));
+	EXPECT_TRUE(Bans.IsBanned("xxabcdefghxx"));
+
+	Bans.Ban("12345678", "", 0, false);
+	Bans.Unban("abcdefgh");
+	EXPECT_FALSE(Bans.IsBanned("abcdefgh"));
+	EXPECT_TRUE(Bans.IsBanned("12345678"));
+}
+
+TEST(NameBan, LastBanWins)
+{
+	CNameBans Bans;
+	Bans.Ban("abcdef", "first", 1, false);
+	Bans.Ban("abcxyz", "second", 3, false);
+	Bans.Ban("cde", "third", 0, true);
+	const CNameBan *pBan = Bans.IsBanned("abcdef");
+	ASSERT_TRUE(pBan);
+	EXPECT_STREQ(pBan->m_aReason, "third");
+	pBan = Bans.IsBanned("abcdeg");
+	ASSERT_TRUE(pBan);
+	EXPECT_STREQ(pBan->m_aReason, "third");
+	pBan = Bans.IsBanned("abcxyy");
+	ASSERT_TRUE(pBan);
+	EXPECT_STREQ(pBan->m_aReason, "second");
+}
+
+static void RandomName(char *pName, int NameSize, int MaxLength)
+{
+	// few different characters so names are often similar
+	static const char *const s_apChars[] = {"a", "b", "c", "A", "ä", "0", "O", " ", "l", "I"};
+	pName[0] = '\0';
+	const int Length = secure_rand_below(MaxLength + 1);
+	for(int i = 0; i < Length; i++)
+		str_append(pName, s_apChars[secure_rand_below(std::size(s_apChars))], NameSize);
+}
+
+// previous implementation, comparing the name to every ban
+static const CNameBan *IsBannedLinear(const std::vector<CNameBan> &vBans, const char *pName)
+{
+	char aTrimmed[MAX_NAME_LENGTH];
+	str_copy(aTrimmed, str_utf8_skip_whitespaces(pName));
+	str_utf8_trim_right(aTrimmed);
+
+	int aSkeleton[MAX_NAME_SKELETON_LENGTH];
+	int SkeletonLength = str_utf8_to_skeleton(aTrimmed, aSkeleton, std::size(aSkeleton));
+	int aBuffer[MAX_NAME_SKELETON_LENGTH * 2 + 2];
+
+	const CNameBan *pResult = nullptr;
+	for(const CNameBan &Ban : vBans)
+	{
+		int Distance = str_utf32_dist_buffer(aSkeleton, SkeletonLength, Ban.m_aSkeleton, Ban.m_SkeletonLength, aBuffer, std::size(aBuffer));
+		if(Distance <= Ban.m_Distance || (Ban.m_IsSubstring && str_utf8_find_nocase(pName, Ban.m_aName)))
+			pResult = &Ban;
+	}
+	return pResult;
+}
+
+TEST(NameBan, SameAsLinear)
+{
+	CNameBans Bans;
+	std::vector<CNameBan> vBans;
+	char aName[MAX_NAME_LENGTH];
+	for(int i = 0; i < 200; i++)
+	{
+		RandomName(aName, sizeof(aName), 8);
+		char aReason[16];
+		str_format(aReason, sizeof(aReason), "%d", i);
+		const int Distance = secure_rand_below(5) - 1;
+		const bool IsSubstring = secure_rand_below(4) == 0;
+		Bans.Ban(aName, aReason, Distance, IsSubstring);
+
+		auto Existing = std::find_if(vBans.begin(), vBans.end(), [&](const CNameBan &Ban) { return str_comp(Ban.m_aName, aName) == 0; });
+		if(Existing != vBans.end())
+			*Existing = CNameBan(aName, aReason, Distance, IsSubstring);
+		else
+			vBans.emplace_back(aName, aReason, Distance, IsSubstring);
+	}
+
+	for(int i = 0; i < 5000; i++)
+	{
+		RandomName(aName, sizeof(aName), 12);
+		const CNameBan *pExpected = IsBannedLinear(vBans, aName);
+		const CNameBan *pBan = Bans.IsBanned(aName);
+		ASSERT_EQ(pBan == nullptr, pExpected == nullptr) << aName;
+		if(pBan)
+		{
+			EXPECT_STREQ(pBan->m_aReason, pExpected->m_aReason) << aName;
+		}
+	}
+}
+
+// run with --gtest_also_run_disabled_tests to measure throughput
+TEST(NameBan, DISABLED_Benchmark)
+{
+	CNameBans Bans;
+	char aName[MAX_NAME_LENGTH];
+	const auto RandomLetters = [&]() {
+		const int Length = 4 + secure_rand_below(11);
+		for(int i = 0; i < Length; i++)
+			aName[i] = 'a' + secure_rand_below(26);
+		aName[Length] = '\0';
+	};
+	for(int i = 0; i < 50000; i++)
+	{
+		RandomLetters();
+		Bans.Ban(aName, "", str_length(aName) / 3, i % 100 == 0);
+	}
+
+	const int Iterations = 10000;
+	int NumBanned = 0;
+	int64_t Start = time_get();
+	for(int i = 0; i < Iterations; i++)
+	{
+		RandomLetters();
+		if(Bans.IsBanned(aName))
+			NumBanned++;
+	}
+	int64_t Time = time_get() - Start;
+
+	dbg_msg("name_ban", "%.0f checks/s, %d banned", Iterations / ((double)Time / time_freq()), NumBanned);
+}
@@ -1,6 +1,10 @@
 #include <gtest/gtest.h>
 
 #include <base/system.h>
+#include <engine/shared/network.h>
+
+#include <memory>
+#include <vector>
 
 TEST(Net, Ipv4AndIpv6Work)
 {
@@ -48,3 +52,183 @@ TEST(Net, Ipv4AndIpv6Work)
 	net_udp_close(Socket1);
 	net_udp_close(Socket2);
 }
+
+TEST(Net, SendMulti)
+{
+	NETADDR Bindaddr = {};
+	NETSOCKET Socket1;
+	NETSOCKET Socket2;
+
+	Bindaddr.type = NETTYPE_IPV4;
+	Socket2 = net_udp_create(Bindaddr);
+	do
+	{
+		Bindaddr.port = secure_rand() % 64511 + 1024;
+	} while(!(Socket1 = net_udp_create(Bindaddr)));
+
+	NETADDR Target;
+	ASSERT_FALSE(net_addr_from_str(&Target, "127.0.0.1"));
+	Target.port = Bindaddr.port;
+
+	// more packets than a single batch
+	const char *apPackets[20];
+	int aSizes[20];
+	char aaBuf[20][8];
+	for(int i = 0; i < 20; i++)
+	{
+		str_format(aaBuf[i], sizeof(aaBuf[i]), "p%d", i);
+		apPackets[i] = aaBuf[i];
+		aSizes[i] = str_length(aaBuf[i]);
+	}
+	EXPECT_EQ(net_udp_send_multi(Socket2, &Target, (const void *const *)apPackets, aSizes, 20), 20);
+
+	NETADDR Addr;
+	unsigned char *pData;
+	for(int i = 0; i < 20; i++)
+	{
+		// packets can already be buffered from an earlier receive
+		int Bytes;
+		while((Bytes = net_udp_recv(Socket1, &Addr, &pData)) <= 0)
+			ASSERT_EQ(net_socket_read_wait(Socket1, 10000000), 1);
+		ASSERT_EQ(Bytes, aSizes[i]);
+		EXPECT_EQ(mem_comp(pData, aaBuf[i], aSizes[i]), 0);
+	}
+
+	net_udp_close(Socket1);
+	net_udp_close(Socket2);
+}
+
+TEST(Net, SendConnlessInPlaceStopsAtTooBig)
+{
+	NETADDR Bindaddr = {};
+	ASSERT_FALSE(net_addr_from_str(&Bindaddr, "127.0.0.1"));
+	CNetServer Server;
+	ASSERT_TRUE(Server.Open(Bindaddr, nullptr, 1, 1));
+
+	NETSOCKET Receiver;
+	do
+	{
+		Bindaddr.port = secure_rand() % 64511 + 1024;
+	} while(!(Receiver = net_udp_create(Bindaddr)));
+
+	// 20 packets, the 18th is too big
+	std::vector<std::vector<unsigned char>> vvPackets(20);
+	unsigned char *apData[20];
+	int aSizes[20];
+	for(int i = 0; i < 20; i++)
+	{
+		aSizes[i] = i == 17 ? NET_MAX_PAYLOAD : 8;
+		vvPackets[i].resize(NET_CONNLESS_HEADER_SPACE + aSizes[i], (unsigned char)i);
+		apData[i] = vvPackets[i].data() + NET_CONNLESS_HEADER_SPACE;
+	}
+	EXPECT_EQ(Server.SendConnlessInPlace(&Bindaddr, apData, aSizes, 20), 17);
+
+	NETADDR Addr;
+	unsigned char *pData;
+	for(int i = 0; i < 17; i++)
+	{
+		int Bytes;
+		while((Bytes = net_udp_recv(Receiver, &Addr, &pData)) <= 0)
+			ASSERT_EQ(net_socket_read_wait(Receiver, 10000000), 1);
+		ASSERT_EQ(Bytes, 6 + aSizes[i]);
+		EXPECT_EQ(pData[6], i);
+	}
+
+	net_udp_close(Receiver);
+	Server.Close();
+}
+
+TEST(Net, RttFirstSample)
+{
+	const int64_t Ms = time_freq() / 1000;
+	CNetRttEstimator Rtt;
+	EXPECT_EQ(Rtt.SmoothedRtt(), -1);
+	EXPECT_EQ(Rtt.RetransmitTimeout(), time_freq());
+
+	Rtt.Update(100 * Ms);
+	EXPECT_EQ(Rtt.SmoothedRtt(), 100 * Ms);
+	EXPECT_EQ(Rtt.RttVariance(), 50 * Ms);
+	EXPECT_EQ(Rtt.RetransmitTimeout(), 300 * Ms);
+}
+
+TEST(Net, RttSmoothing)
+{
+	const int64_t Ms = time_freq() / 1000;
+	CNetRttEstimator Rtt;
+	Rtt.Update(100 * Ms);
+	Rtt.Update(180 * Ms);
+	EXPECT_EQ(Rtt.SmoothedRtt(), 110 * Ms);
+	EXPECT_EQ(Rtt.RttVariance(), 57500 * Ms / 1000);
+	EXPECT_EQ(Rtt.RetransmitTimeout(), 340 * Ms);
+
+	// converges to a stable round trip time
+	for(int i = 0; i < 100; i++)
+		Rtt.Update(120 * Ms);
+	EXPECT_NEAR(Rtt.SmoothedRtt(), 120 * Ms, Ms);
+	EXPECT_NEAR(Rtt.RttVariance(), 0, Ms);
+	EXPECT_EQ(Rtt.RetransmitTimeout(), 200 * Ms);
+}
+
+TEST(Net, RttClamp)
+{
+	const int64_t Ms = time_freq() / 1000;
+	CNetRttEstimator Rtt;
+	Rtt.Update(5 * Ms);
+	EXPECT_EQ(Rtt.RetransmitTimeout(), time_freq() / 5);
+
+	Rtt.Reset();
+	Rtt.Update(3000 * Ms);
+	EXPECT_EQ(Rtt.RetransmitTimeout(), time_freq());
+}
+
+TEST(Net, RttBackOff)
+{
+	const int64_t Ms = time_freq() / 1000;
+	CNetRttEstimator Rtt;
+	Rtt.Update(50 * Ms);
+	ASSERT_EQ(Rtt.RetransmitTimeout(), 200 * Ms);
+	EXPECT_EQ(Rtt.ChunkResendTimeout(0), 200 * Ms);
+	EXPECT_EQ(Rtt.ChunkResendTimeout(1), 400 * Ms);
+	EXPECT_EQ(Rtt.ChunkResendTimeout(2), 800 * Ms);
+	EXPECT_EQ(Rtt.ChunkResendTimeout(3), time_freq());
+	EXPECT_EQ(Rtt.ChunkResendTimeout(100), time_freq());
+}
+
+TEST(Net, RttIgnoresResentChunks)
+{
+	NETADDR Addr;
+	ASSERT_FALSE(net_addr_from_str(&Addr, "127.0.0.1:8303"));
+
+	// chunk 1 was resent, chunk 2 wasn't
+	const int64_t Now = time_get();
+	CStaticRingBuffer<CNetChunkResend, NET_CONN_BUFFERSIZE> ResendBuffer;
+	ResendBuffer.Init();
+	for(int Sequence = 1; Sequence <= 2; Sequence++)
+	{
+		CNetChunkResend *pResend = ResendBuffer.Allocate(sizeof(CNetChunkResend));
+		ASSERT_TRUE(pResend);
+		mem_zero(pResend, sizeof(*pResend));
+		pResend->m_Flags = NET_CHUNKFLAG_VITAL;
+		pResend->m_pData = (unsigned char *)(pResend + 1);
+		pResend->m_Sequence = Sequence;
+		pResend->m_NumResends = Sequence == 1 ? 1 : 0;
+		pResend->m_FirstSendTime = Now - time_freq();
+		pResend->m_LastSendTime = Now - time_freq() / 10;
+	}
+
+	auto pConn = std::make_unique<CNetConnection>();
+	pConn->Init(nullptr, false);
+	pConn->SetTimedOut(&Addr, 2, 0, NET_SECURITY_TOKEN_UNSUPPORTED, &ResendBuffer, false);
+
+	CNetPacketConstruct Packet;
+	mem_zero(&Packet, sizeof(Packet));
+	Packet.m_Ack = 1;
+	EXPECT_EQ(pConn->Feed(&Packet, &Addr), 1);
+	// the ack of a resent chunk could belong to any of its sends
+	EXPECT_EQ(pConn->SmoothedRtt(), -1);
+
+	Packet.m_Ack = 2;
+	EXPECT_EQ(pConn->Feed(&Packet, &Addr), 1);
+	EXPECT_GE(pConn->SmoothedRtt(), time_freq() / 10);
+	EXPECT_EQ(pConn->ResendBuffer()->First(), nullptr);
+}
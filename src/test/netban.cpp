@@ -0,0 +1,200 @@
+#include <gtest/gtest.h>
+
+#include <base/system.h>
+#include <engine/console.h>
+#include <engine/shared/config.h>
+#include <engine/shared/netban.h>
+
+class CTestNetBan : public CNetBan
+{
+public:
+	using CNetBan::RemoveExpired;
+};
+
+class NetBan : public ::testing::Test
+{
+protected:
+	std::unique_ptr<IConsole> m_pConsole;
+	CTestNetBan m_NetBan;
+
+	NetBan() :
+		m_pConsole(CreateConsole(CFGFLAG_SERVER))
+	{
+		m_NetBan.Init(m_pConsole.get(), nullptr);
+	}
+
+	bool IsBanned(const char *pAddr)
+	{
+		NETADDR Addr;
+		EXPECT_EQ(net_addr_from_str(&Addr, pAddr), 0) << pAddr;
+		char aReason[256];
+		return m_NetBan.IsBanned(&Addr, aReason, sizeof(aReason));
+	}
+
+	int BanAddr(const char *pAddr, int Seconds)
+	{
+		NETADDR Addr;
+		EXPECT_EQ(net_addr_from_str(&Addr, pAddr), 0) << pAddr;
+		return m_NetBan.BanAddr(&Addr, Seconds, "test");
+	}
+
+	static CNetRange Range(const char *pFirst, const char *pLast)
+	{
+		CNetRange Range;
+		EXPECT_EQ(net_addr_from_str(&Range.m_LB, pFirst), 0) << pFirst;
+		EXPECT_EQ(net_addr_from_str(&Range.m_UB, pLast), 0) << pLast;
+		return Range;
+	}
+};
+
+TEST_F(NetBan, Addr)
+{
+	EXPECT_EQ(BanAddr("1.2.3.4", 0), 0);
+	EXPECT_EQ(BanAddr("1.2.3.4", 60), 1);
+	EXPECT_TRUE(IsBanned("1.2.3.4"));
+	EXPECT_FALSE(IsBanned("1.2.3.5"));
+	EXPECT_FALSE(IsBanned("[::ffff:102:304]"));
+
+	NETADDR Addr;
+	net_addr_from_str(&Addr, "1.2.3.4");
+	EXPECT_EQ(m_NetBan.UnbanByAddr(&Addr), 0);
+	EXPECT_FALSE(IsBanned("1.2.3.4"));
+	EXPECT_EQ(m_NetBan.UnbanByAddr(&Addr), -1);
+}
+
+TEST_F(NetBan, Range)
+{
+	// not aligned to a prefix on either end
+	const CNetRange BanRange = Range("10.0.3.5", "10.1.4.7");
+	EXPECT_EQ(m_NetBan.BanRange(&BanRange, 0, "test"), 0);
+	EXPECT_FALSE(IsBanned("10.0.3.4"));
+	EXPECT_TRUE(IsBanned("10.0.3.5"));
+	EXPECT_TRUE(IsBanned("10.0.255.255"));
+	EXPECT_TRUE(IsBanned("10.1.0.0"));
+	EXPECT_TRUE(IsBanned("10.1.4.7"));
+	EXPECT_FALSE(IsBanned("10.1.4.8"));
+	EXPECT_FALSE(IsBanned("11.0.3.5"));
+
+	const CNetRange Invalid = Range("10.0.0.2", "10.0.0.1");
+	EXPECT_EQ(m_NetBan.BanRange(&Invalid, 0, "test"), -1);
+
+	EXPECT_EQ(m_NetBan.UnbanByRange(&BanRange), 0);
+	EXPECT_FALSE(IsBanned("10.0.3.5"));
+	EXPECT_FALSE(IsBanned("10.1.0.0"));
+}
+
+TEST_F(NetBan, RangeIpv6)
+{
+	const CNetRange BanRange = Range("[2001:db8::1]", "[2001:db8::1:0]");
+	EXPECT_EQ(m_NetBan.BanRange(&BanRange, 0, "test"), 0);
+	EXPECT_FALSE(IsBanned("[2001:db8::]"));
+	EXPECT_TRUE(IsBanned("[2001:db8::1]"));
+	EXPECT_TRUE(IsBanned("[2001:db8::ffff]"));
+	EXPECT_TRUE(IsBanned("[2001:db8::1:0]"));
+	EXPECT_FALSE(IsBanned("[2001:db8::1:1]"));
+	EXPECT_FALSE(IsBanned("0.0.0.1"));
+}
+
+TEST_F(NetBan, OverlappingRanges)
+{
+	const CNetRange Outer = Range("192.168.0.0", "192.168.255.255");
+	const CNetRange Inner = Range("192.168.1.0", "192.168.1.255");
+	EXPECT_EQ(m_NetBan.BanRange(&Outer, 0, "test"), 0);
+	EXPECT_EQ(m_NetBan.BanRange(&Inner, 0, "test"), 0);
+	EXPECT_TRUE(IsBanned("192.168.1.1"));
+
+	EXPECT_EQ(m_NetBan.UnbanByRange(&Outer), 0);
+	EXPECT_TRUE(IsBanned("192.168.1.1"));
+	EXPECT_FALSE(IsBanned("192.168.2.1"));
+
+	EXPECT_EQ(m_NetBan.BanRange(&Outer, 0, "test"), 0);
+	EXPECT_EQ(m_NetBan.UnbanByRange(&Inner), 0);
+	EXPECT_TRUE(IsBanned("192.168.1.1"));
+}
+
+TEST_F(NetBan, Many)
+{
+	// more than the old limit of 1024 entries per pool
+	char aAddr[NETADDR_MAXSTRSIZE], aLast[NETADDR_MAXSTRSIZE];
+	for(int i = 0; i < 5000; i++)
+	{
+		str_format(aAddr, sizeof(aAddr), "20.%d.%d.1", i / 256, i % 256);
+		ASSERT_EQ(BanAddr(aAddr, 0), 0);
+
+		str_format(aAddr, sizeof(aAddr), "30.%d.%d.10", i / 256, i % 256);
+		str_format(aLast, sizeof(aLast), "30.%d.%d.20", i / 256, i % 256);
+		const CNetRange BanRange = Range(aAddr, aLast);
+		ASSERT_EQ(m_NetBan.BanRange(&BanRange, 0, "test"), 0);
+	}
+	for(int i = 0; i < 5000; i++)
+	{
+		str_format(aAddr, sizeof(aAddr), "20.%d.%d.1", i / 256, i % 256);
+		EXPECT_TRUE(IsBanned(aAddr));
+		str_format(aAddr, sizeof(aAddr), "20.%d.%d.2", i / 256, i % 256);
+		EXPECT_FALSE(IsBanned(aAddr));
+		str_format(aAddr, sizeof(aAddr), "30.%d.%d.15", i / 256, i % 256);
+		EXPECT_TRUE(IsBanned(aAddr));
+		str_format(aAddr, sizeof(aAddr), "30.%d.%d.21", i / 256, i % 256);
+		EXPECT_FALSE(IsBanned(aAddr));
+	}
+
+	m_NetBan.UnbanAll();
+	EXPECT_FALSE(IsBanned("20.0.0.1"));
+	EXPECT_FALSE(IsBanned("30.0.0.15"));
+}
+
+TEST_F(NetBan, Expire)
+{
+	const int Now = time_timestamp();
+	EXPECT_EQ(BanAddr("1.1.1.1", 60), 0);
+	EXPECT_EQ(BanAddr("2.2.2.2", 2 * 60 * 60), 0);
+	EXPECT_EQ(BanAddr("3.3.3.3", 0), 0);
+	const CNetRange BanRange = Range("4.4.4.0", "4.4.4.9");
+	EXPECT_EQ(m_NetBan.BanRange(&BanRange, 60, "test"), 0);
+
+	m_NetBan.RemoveExpired(Now + 30);
+	EXPECT_TRUE(IsBanned("1.1.1.1"));
+	EXPECT_TRUE(IsBanned("4.4.4.4"));
+
+	m_NetBan.RemoveExpired(Now + 120);
+	EXPECT_FALSE(IsBanned("1.1.1.1"));
+	EXPECT_FALSE(IsBanned("4.4.4.4"));
+	EXPECT_TRUE(IsBanned("2.2.2.2"));
+
+	// further than a whole turn of the timer wheel
+	m_NetBan.RemoveExpired(Now + 3 * 60 * 60);
+	EXPECT_FALSE(IsBanned("2.2.2.2"));
+	EXPECT_TRUE(IsBanned("3.3.3.3"));
+}
+
+TEST_F(NetBan, ExpireAfterClockStepBack)
+{
+	const int Now = time_timestamp();
+	// the clock was ahead when the bans were last checked
+	m_NetBan.RemoveExpired(Now + 60 * 60);
+
+	EXPECT_EQ(BanAddr("1.1.1.1", 60), 0);
+	m_NetBan.RemoveExpired(Now + 30);
+	EXPECT_TRUE(IsBanned("1.1.1.1"));
+	m_NetBan.RemoveExpired(Now + 120);
+	EXPECT_FALSE(IsBanned("1.1.1.1"));
+}
+
+TEST_F(NetBan, UnbanByIndex)
+{
+	// entries are listed by expiry, permanent bans last
+	EXPECT_EQ(BanAddr("1.1.1.1", 0), 0);
+	EXPECT_EQ(BanAddr("2.2.2.2", 600), 0);
+	EXPECT_EQ(BanAddr("3.3.3.3", 60), 0);
+	const CNetRange BanRange = Range("4.4.4.0", "4.4.4.9");
+	EXPECT_EQ(m_NetBan.BanRange(&BanRange, 60, "test"), 0);
+
+	EXPECT_EQ(m_NetBan.UnbanByIndex(0), 0);
+	EXPECT_FALSE(IsBanned("3.3.3.3"));
+	EXPECT_EQ(m_NetBan.UnbanByIndex(1), 0);
+	EXPECT_FALSE(IsBanned("1.1.1.1"));
+	EXPECT_EQ(m_NetBan.UnbanByIndex(1), 0);
+	EXPECT_FALSE(IsBanned("4.4.4.4"));
+	EXPECT_EQ(m_NetBan.UnbanByIndex(1), -1);
+	EXPECT_TRUE(IsBanned("2.2.2.2"));
+}
@@ -0,0 +1,181 @@
+#include "test.h"
+#include <gtest/gtest.h>
+
+#include <base/system.h>
+#include <game/prng.h>
+#include <game/server/save.h>
+
+#include <memory>
+
+// a team of two tees with three switchers in the legacy text format
+static const char *const s_pSaveString =
+	"2\t2\t3\t1\t0\n"
+	"nameless tee\t1\t0\t0\t0\t0\t3\t10\t0\t1\t4\t10\t"
+	"0\t1\t5\t-1\t0\t0\t6\t-1\t0\t0\t7\t-1\t"
+	"0\t0\t8\t-1\t0\t0\t1\t-1\t0\t0\t0\t0\t"
+	"21\t0\t0\t1\t0\t1\t0\t0\t0\t300\t1003\t500\t"
+	"993\t500\t-1\t0\t1003\t500\t4.500000\t-0.250000\t1\t1\t2\t2\t"
+	"1200\t520\t0.600000\t-0.800000\t0\t0\t3\t0\t0\t0\t0\t0.000000\t"
+	"1.250000\t2.500000\t0.000000\t0.000000\t0.000000\t0.000000\t0.000000\t0.000000\t0.000000\t0.000000\t0.000000\t0.000000\t"
+	"0.000000\t0.000000\t0.000000\t0.000000\t0.000000\t0.000000\t0.000000\t0.000000\t0.000000\t0.000000\t0.000000\t0.000000\t"
+	"0\t0\t1\t0\t8d300ecf-5873-4297-bee5-95668fdff320\t1\t0\t-1\t1\t0\t1\t0\t"
+	"1\t0\t0.000000\t0.000000\t0\t0\t0\n"
+	"brainless tee\t1\t0\t0\t0\t0\t5\t10\t0\t1\t6\t10\t"
+	"0\t1\t7\t-1\t0\t0\t8\t-1\t0\t0\t9\t-1\t"
+	"0\t0\t10\t-1\t0\t0\t1\t-1\t0\t0\t0\t0\t"
+	"35\t0\t0\t1\t0\t1\t0\t0\t0\t500\t1005\t500\t"
+	"995\t500\t-1\t0\t1005\t500\t7.500000\t-0.250000\t1\t1\t2\t2\t"
+	"1200\t520\t0.600000\t-0.800000\t0\t0\t3\t0\t0\t0\t0\t0.000000\t"
+	"1.250000\t2.500000\t0.000000\t0.000000\t0.000000\t0.000000\t0.000000\t0.000000\t0.000000\t0.000000\t0.000000\t0.000000\t"
+	"0.000000\t0.000000\t0.000000\t0.000000\t0.000000\t0.000000\t0.000000\t0.000000\t0.000000\t0.000000\t0.000000\t0.000000\t"
+	"0\t0\t1\t0\t8d300ecf-5873-4297-bee5-95668fdff320\t-1\t0\t-1\t1\t0\t1\t0\t"
+	"1\t0\t0.000000\t0.000000\t0\t0\t0\n"
+	"1\t0\t0\n"
+	"0\t250\t2\n"
+	"1\t0\t1";
+
+static const char s_aaNames[][MAX_NAME_LENGTH] = {"nameless tee", "brainless tee"};
+static const int s_aClientIDs[] = {3, 7};
+
+static void LoadTeam(CSaveTeam *pTeam, const char *pString)
+{
+	ASSERT_EQ(pTeam->FromString(pString), 0);
+	char aMessage[128];
+	ASSERT_TRUE(pTeam->MatchPlayers(s_aaNames, s_aClientIDs, 2, aMessage, sizeof(aMessage))) << aMessage;
+}
+
+TEST(Save, TextRoundTrip)
+{
+	auto pTeam = std::make_unique<CSaveTeam>();
+	LoadTeam(pTeam.get(), s_pSaveString);
+	EXPECT_EQ(pTeam->GetMembersCount(), 2);
+	EXPECT_STREQ(pTeam->GetString(), s_pSaveString);
+}
+
+TEST(Save, BinaryRoundTrip)
+{
+	auto pTeam = std::make_unique<CSaveTeam>();
+	LoadTeam(pTeam.get(), s_pSaveString);
+
+	char *pBinary = pTeam->GetBinaryString();
+	ASSERT_TRUE(pBinary);
+	EXPECT_TRUE(str_startswith(pBinary, CSaveTeam::BINARY_PREFIX));
+	EXPECT_LT(str_length(pBinary), str_length(s_pSaveString));
+	std::string Binary = pBinary;
+
+	auto pLoaded = std::make_unique<CSaveTeam>();
+	LoadTeam(pLoaded.get(), Binary.c_str());
+	EXPECT_EQ(pLoaded->GetMembersCount(), 2);
+	EXPECT_STREQ(pLoaded->m_pSavedTees[0].GetName(), "nameless tee");
+	EXPECT_TRUE(pLoaded->m_pSavedTees[0].IsHooking() == pTeam->m_pSavedTees[0].IsHooking());
+	EXPECT_STREQ(pLoaded->GetBinaryString(), Binary.c_str());
+	EXPECT_STREQ(pLoaded->GetString(), s_pSaveString);
+}
+
+TEST(Save, BinaryInvalid)
+{
+	auto pTeam = std::make_unique<CSaveTeam>();
+	EXPECT_NE(pTeam->FromString("ddbin:"), 0);
+	EXPECT_NE(pTeam->FromString("ddbin:not base64"), 0);
+
+	unsigned char aData[] = {CSaveTeam::BINARY_VERSION + 1, 0, 0, 0, 0, 0};
+	EXPECT_NE(pTeam->FromBinary(aData, sizeof(aData)), 0);
+
+	// too many players
+	unsigned char aTooMany[] = {CSaveTeam::BINARY_VERSION, 0, 0x81, 0x01, 0, 0, 0};
+	EXPECT_NE(pTeam->FromBinary(aTooMany, sizeof(aTooMany)), 0);
+}
+
+TEST(Save, BinaryFuzz)
+{
+	auto pTeam = std::make_unique<CSaveTeam>();
+	LoadTeam(pTeam.get(), s_pSaveString);
+
+	static unsigned char s_aOriginal[CSaveTeam::MAX_BINARY_SIZE];
+	static unsigned char s_aMutated[CSaveTeam::MAX_BINARY_SIZE];
+	int Size = pTeam->GetBinary(s_aOriginal, sizeof(s_aOriginal));
+	ASSERT_GT(Size, 0);
+
+	CPrng Prng;
+	uint64_t aSeed[2] = {0x5a7e, 0x10ad};
+	Prng.Seed(aSeed);
+
+	auto pLoaded = std::make_unique<CSaveTeam>();
+	auto pReloaded = std::make_unique<CSaveTeam>();
+	for(int i = 0; i < 2000; i++)
+	{
+		mem_copy(s_aMutated, s_aOriginal, Size);
+		int MutatedSize = Size - Prng.RandomBits() % 4;
+		int NumFlips = 1 + Prng.RandomBits() % 8;
+		for(int j = 0; j < NumFlips; j++)
+			s_aMutated[Prng.RandomBits() % MutatedSize] ^= 1 << (Prng.RandomBits() % 8);
+
+		// corrupt data must either be rejected or survive another round trip
+		if(pLoaded->FromBinary(s_aMutated, MutatedSize) != 0)
+			continue;
+		// names might have been changed, assign client ids like `MatchPlayers`
+		for(int n = 0; n < pLoaded->GetMembersCount(); n++)
+			pLoaded->m_pSavedTees[n].SetClientID(n);
+		for(int n = 0; n < pLoaded->GetMembersCount(); n++)
+			pLoaded->m_pSavedTees[n].LoadHookedPlayer(pLoaded.get());
+		static unsigned char s_aReencoded[CSaveTeam::MAX_BINARY_SIZE];
+		int ReencodedSize = pLoaded->GetBinary(s_aReencoded, sizeof(s_aReencoded));
+		ASSERT_GT(ReencodedSize, 0);
+		ASSERT_EQ(pReloaded->FromBinary(s_aReencoded, ReencodedSize), 0);
+		for(int n = 0; n < pReloaded->GetMembersCount(); n++)
+			pReloaded->m_pSavedTees[n].SetClientID(n);
+		for(int n = 0; n < pReloaded->GetMembersCount(); n++)
+			pReloaded->m_pSavedTees[n].LoadHookedPlayer(pReloaded.get());
+		static unsigned char s_aReencoded2[CSaveTeam::MAX_BINARY_SIZE];
+		ASSERT_EQ(pReloaded->GetBinary(s_aReencoded2, sizeof(s_aReencoded2)), ReencodedSize);
+		ASSERT_EQ(mem_comp(s_aReencoded, s_aReencoded2, ReencodedSize), 0);
+	}
+}
+
+// run with --gtest_also_run_disabled_tests to measure throughput
+TEST(Save, DISABLED_Benchmark)
+{
+	auto pTeam = std::make_unique<CSaveTeam>();
+	LoadTeam(pTeam.get(), s_pSaveString);
+	std::string Binary = pTeam->GetBinaryString();
+
+	const int Iterations = 100000;
+	int64_t Start = time_get();
+	for(int i = 0; i < Iterations; i++)
+	{
+		pTeam->FromString(s_pSaveString);
+		pTeam->GetString();
+	}
+	int64_t TextTime = time_get() - Start;
+
+	Start = time_get();
+	for(int i = 0; i < Iterations; i++)
+	{
+		pTeam->FromString(Binary.c_str());
+		pTeam->GetBinaryString();
+	}
+	int64_t BinaryTime = time_get() - Start;
+
+	dbg_msg("save", "text: %.0f round trips/s, binary: %.0f round trips/s",
+		Iterations / ((double)TextTime / time_freq()), Iterations / ((double)BinaryTime / time_freq()));
+}
+
+TEST(Save, BinaryMaxSize)
+{
+	auto pTeam = std::make_unique<CSaveTeam>();
+	LoadTeam(pTeam.get(), s_pSaveString);
+	static unsigned char s_aData[CSaveTeam::MAX_BINARY_SIZE];
+	const int Size = pTeam->GetBinary(s_aData, sizeof(s_aData));
+	ASSERT_GT(Size, 0);
+	EXPECT_EQ(pTeam->GetBinary(s_aData, Size - 1), -1);
+
+	// a blob of the maximum size isn't truncated in the save string
+	for(int i = 0; i < CSaveTeam::MAX_BINARY_SIZE; i++)
+		s_aData[i] = i * 13;
+	static char s_aEncoded[CSaveTeam::STRING_SIZE];
+	const int PrefixLength = str_length(CSaveTeam::BINARY_PREFIX);
+	str_base64(s_aEncoded, sizeof(s_aEncoded) - PrefixLength, s_aData, CSaveTeam::MAX_BINARY_SIZE);
+	static unsigned char s_aDecoded[CSaveTeam::MAX_BINARY_SIZE];
+	ASSERT_EQ(str_base64_decode(s_aDecoded, sizeof(s_aDecoded), s_aEncoded), CSaveTeam::MAX_BINARY_SIZE);
+	EXPECT_EQ(mem_comp(s_aDecoded, s_aData, sizeof(s_aData)), 0);
+}
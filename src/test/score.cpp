@@ -1,3 +1,4 @@
+#include "test.h"
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
@@ -9,28 +10,13 @@
 
 #include <sqlite3.h>
 
+#include <chrono>
+#include <thread>
+
 #if defined(CONF_TEST_MYSQL)
 int DummyMysqlInit = (MysqlInit(), 1);
 #endif
 
-char *CSaveTeam::GetString()
-{
-	// Dummy implementation for testing
-	return nullptr;
-}
-
-int CSaveTeam::FromString(const char *)
-{
-	// Dummy implementation for testing
-	return 1;
-}
-
-bool CSaveTeam::MatchPlayers(const char (*paNames)[MAX_NAME_LENGTH], const int *pClientID, int NumPlayer, char *pMessage, int MessageLen)
-{
-	// Dummy implementation for testing
-	return false;
-}
-
 TEST(SQLite, Version)
 {
 	ASSERT_GE(sqlite3_libversion_number(), 3025000) << "SQLite >= 3.25.0 required for Window functions";
@@ -583,6 +569,156 @@ TEST_P(RandomMap, UnfinishedDoesntExist)
 	EXPECT_STREQ(m_pRandomMapResult->m_aMessage, "You have no more unfinished maps on this server!");
 }
 
+struct Transaction : public Score
+{
+	int NumRanks()
+	{
+		char aBuf[128];
+		str_format(aBuf, sizeof(aBuf), "SELECT COUNT(*) FROM %s_race", m_pConn->GetPrefix());
+		EXPECT_FALSE(m_pConn->PrepareStatement(aBuf, m_aError, sizeof(m_aError))) << m_aError;
+		bool End;
+		EXPECT_FALSE(m_pConn->Step(&End, m_aError, sizeof(m_aError))) << m_aError;
+		EXPECT_FALSE(End);
+		return End ? -1 : m_pConn->GetInt(1);
+	}
+};
+
+TEST_P(Transaction, Commit)
+{
+	ASSERT_FALSE(m_pConn->BeginTransaction(m_aError, sizeof(m_aError))) << m_aError;
+	InsertRank(100.0);
+	InsertRank(90.0);
+	ASSERT_FALSE(m_pConn->CommitTransaction(m_aError, sizeof(m_aError))) << m_aError;
+	EXPECT_EQ(NumRanks(), 2);
+}
+
+TEST_P(Transaction, Rollback)
+{
+	InsertRank(100.0);
+	ASSERT_FALSE(m_pConn->BeginTransaction(m_aError, sizeof(m_aError))) << m_aError;
+	InsertRank(90.0);
+	InsertRank(80.0);
+	ASSERT_FALSE(m_pConn->RollbackTransaction(m_aError, sizeof(m_aError))) << m_aError;
+	EXPECT_EQ(NumRanks(), 1);
+}
+
+struct CPoolTestResult : ISqlResult
+{
+	// calls in BACKUP_FIRST mode, which the backup thread executes
+	std::atomic_int m_NumBackupCalls{0};
+};
+
+struct CPoolTestData : ISqlData
+{
+	CPoolTestData(std::shared_ptr<CPoolTestResult> pResult, int Id, bool Fail) :
+		ISqlData(std::move(pResult)),
+		m_Id(Id),
+		m_Fail(Fail)
+	{
+	}
+	int m_Id;
+	bool m_Fail;
+};
+
+static CSemaphore s_PoolTestBlock;
+
+static bool PoolTestBlock(IDbConnection *pSqlServer, const ISqlData *pGameData, Write w, char *pError, int ErrorSize)
+{
+	// hold the backup thread until all following writes are queued
+	if(w == Write::BACKUP_FIRST)
+		s_PoolTestBlock.Wait();
+	return false;
+}
+
+static bool PoolTestWrite(IDbConnection *pSqlServer, const ISqlData *pGameData, Write w, char *pError, int ErrorSize)
+{
+	const CPoolTestData *pData = dynamic_cast<const CPoolTestData *>(pGameData);
+	if(w == Write::BACKUP_FIRST)
+		dynamic_cast<CPoolTestResult *>(pData->m_pResult.get())->m_NumBackupCalls++;
+	if(pData->m_Fail)
+	{
+		str_copy(pError, "failing on purpose", ErrorSize);
+		return true;
+	}
+	if(w == Write::NORMAL_SUCCEEDED || w == Write::NORMAL_FAILED)
+		return false;
+	if(pSqlServer->PrepareStatement("CREATE TABLE IF NOT EXISTS pool_test (Id INTEGER NOT NULL)", pError, ErrorSize))
+		return true;
+	int NumUpdated;
+	if(pSqlServer->ExecuteUpdate(&NumUpdated, pError, ErrorSize))
+		return true;
+	if(pSqlServer->PrepareStatement("INSERT INTO pool_test (Id) VALUES (?)", pError, ErrorSize))
+		return true;
+	pSqlServer->BindInt(1, pData->m_Id);
+	return pSqlServer->ExecuteUpdate(&NumUpdated, pError, ErrorSize);
+}
+
+static void ExpectPoolTestRows(const char *pFilename, int NumRows)
+{
+	auto pConn = CreateSqliteConnection(pFilename, false);
+	char aError[256] = {};
+	ASSERT_FALSE(pConn->Connect(aError, sizeof(aError))) << aError;
+	ASSERT_FALSE(pConn->PrepareStatement("SELECT COUNT(*), COUNT(DISTINCT Id) FROM pool_test", aError, sizeof(aError))) << aError;
+	bool End;
+	ASSERT_FALSE(pConn->Step(&End, aError, sizeof(aError))) << aError;
+	ASSERT_FALSE(End);
+	EXPECT_EQ(pConn->GetInt(1), NumRows);
+	EXPECT_EQ(pConn->GetInt(2), NumRows);
+	pConn->Disconnect();
+}
+
+TEST(ConnectionPool, BatchedWrites)
+{
+	CTestInfo Info;
+	char aWriteFile[64];
+	char aBackupFile[64];
+	Info.Filename(aWriteFile, sizeof(aWriteFile), "-write.sqlite");
+	Info.Filename(aBackupFile, sizeof(aBackupFile), "-backup.sqlite");
+
+	const int NUM_WRITES = 10;
+	const int FAIL_ID = 4;
+	std::vector<std::shared_ptr<CPoolTestResult>> vpResults;
+	{
+		CDbConnectionPool Pool;
+		Pool.RegisterSqliteDatabase(CDbConnectionPool::WRITE, aWriteFile);
+		Pool.RegisterSqliteDatabase(CDbConnectionPool::WRITE_BACKUP, aBackupFile);
+		Pool.ExecuteWrite(PoolTestBlock, std::make_unique<ISqlData>(nullptr), "block");
+		for(int i = 0; i < NUM_WRITES; i++)
+		{
+			vpResults.push_back(std::make_shared<CPoolTestResult>());
+			Pool.ExecuteWrite(PoolTestWrite, std::make_unique<CPoolTestData>(vpResults.back(), i, i == FAIL_ID), "pool test");
+		}
+		s_PoolTestBlock.Signal();
+
+		for(auto &pResult : vpResults)
+		{
+			while(!pResult->m_Completed.load())
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+	}
+
+	for(int i = 0; i < NUM_WRITES; i++)
+	{
+		EXPECT_EQ(vpResults[i]->m_Success, i != FAIL_ID) << i;
+		// all writes were queued at once, so the backup thread ran them in
+		// one batch that stopped at the failing write. The writes up to it
+		// were rolled back and retried one by one, the rest only ran alone.
+		EXPECT_EQ(vpResults[i]->m_NumBackupCalls.load(), i <= FAIL_ID ? 2 : 1) << i;
+	}
+	// nothing got lost or duplicated by the rollback
+	ExpectPoolTestRows(aBackupFile, NUM_WRITES - 1);
+
+	for(const char *pFile : {aWriteFile, aBackupFile})
+	{
+		char aBuf[128];
+		fs_remove(pFile);
+		str_format(aBuf, sizeof(aBuf), "%s-wal", pFile);
+		fs_remove(aBuf);
+		str_format(aBuf, sizeof(aBuf), "%s-shm", pFile);
+		fs_remove(aBuf);
+	}
+}
+
 auto g_pSqliteConn = CreateSqliteConnection(":memory:", true);
 #if defined(CONF_TEST_MYSQL)
 CMysqlConfig gMysqlConfig{
@@ -624,3 +760,4 @@ INSTANTIATE(MapInfo);
 INSTANTIATE(MapVote);
 INSTANTIATE(Points);
 INSTANTIATE(RandomMap);
+INSTANTIATE(Transaction);
@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+
+#include <game/server/snapinterest.h>
+
+static const int TICK_SPEED = 50;
+static const int RATE = 5;
+static const int SIZE = 40;
+static const int TYPE = 0;
+
+TEST(SnapInterest, HoldUntilUpdate)
+{
+	CSnapInterest Interest;
+	Interest.StartSnap(100, TICK_SPEED, RATE, 1000);
+	vec2 To(10, 10), From(0, 0);
+	EXPECT_TRUE(Interest.Filter(1, SIZE, false, TYPE, -1, &To, &From));
+	EXPECT_EQ(To, vec2(10, 10));
+
+	// the position of the first update is kept until the rate allows another one
+	for(int Tick = 101; Tick < 100 + RATE; Tick++)
+	{
+		Interest.StartSnap(Tick, TICK_SPEED, RATE, 1000);
+		To = vec2(Tick, Tick);
+		EXPECT_TRUE(Interest.Filter(1, SIZE, false, TYPE, -1, &To, &From));
+		EXPECT_EQ(To, vec2(10, 10));
+	}
+	Interest.StartSnap(100 + RATE, TICK_SPEED, RATE, 1000);
+	To = vec2(20, 20);
+	EXPECT_TRUE(Interest.Filter(1, SIZE, false, TYPE, -1, &To, &From));
+	EXPECT_EQ(To, vec2(20, 20));
+
+	EXPECT_EQ(Interest.Stats().m_NumUpdated, 2);
+	EXPECT_EQ(Interest.Stats().m_NumDeferred, RATE - 1);
+	EXPECT_EQ(Interest.Stats().m_NumCulled, 0);
+
+	// full interest objects follow the game again
+	Interest.Forget(1);
+	Interest.StartSnap(101 + RATE, TICK_SPEED, RATE, 1000);
+	To = vec2(30, 30);
+	EXPECT_TRUE(Interest.Filter(1, SIZE, false, TYPE, -1, &To, &From));
+	EXPECT_EQ(To, vec2(30, 30));
+}
+
+TEST(SnapInterest, Budget)
+{
+	CSnapInterest Interest;
+	Interest.StartSnap(0, TICK_SPEED, RATE, 2 * SIZE);
+	vec2 To(10, 10), From(0, 0);
+	EXPECT_TRUE(Interest.Filter(1, SIZE, false, TYPE, -1, &To, &From));
+	EXPECT_TRUE(Interest.Filter(2, SIZE, false, TYPE, -1, &To, &From));
+	// objects of other teams that were never sent are left out once the budget is used up
+	EXPECT_FALSE(Interest.Filter(3, SIZE, true, TYPE, -1, &To, &From));
+	EXPECT_EQ(Interest.Stats().m_NumCulled, 1);
+
+	// sent objects are held past the rate while there is no budget
+	Interest.StartSnap(RATE, TICK_SPEED, RATE, 0);
+	To = vec2(20, 20);
+	EXPECT_TRUE(Interest.Filter(1, SIZE, false, TYPE, -1, &To, &From));
+	EXPECT_EQ(To, vec2(10, 10));
+
+	// but not for longer than a second
+	Interest.StartSnap(TICK_SPEED, TICK_SPEED, RATE, 0);
+	To = vec2(30, 30);
+	EXPECT_TRUE(Interest.Filter(1, SIZE, false, TYPE, -1, &To, &From));
+	EXPECT_EQ(To, vec2(30, 30));
+
+	Interest.StartSnap(TICK_SPEED + 1, TICK_SPEED, RATE, SIZE);
+	EXPECT_TRUE(Interest.Filter(3, SIZE, true, TYPE, -1, &To, &From));
+	EXPECT_EQ(Interest.Stats().m_NumUpdated, 4);
+}
+
+TEST(SnapInterest, FirstAppearance)
+{
+	CSnapInterest Interest;
+	Interest.StartSnap(0, TICK_SPEED, RATE, SIZE);
+	vec2 To(10, 10), From(0, 0);
+	EXPECT_TRUE(Interest.Filter(1, SIZE, false, TYPE, -1, &To, &From));
+	// objects of the own team are sent when they appear, even without budget
+	EXPECT_TRUE(Interest.Filter(2, SIZE, false, TYPE, -1, &To, &From));
+	EXPECT_EQ(To, vec2(10, 10));
+	EXPECT_EQ(Interest.Stats().m_NumCulled, 0);
+	EXPECT_EQ(Interest.Stats().m_NumUpdated, 2);
+
+	// and use up the budget of the other objects
+	EXPECT_FALSE(Interest.Filter(3, 1, true, TYPE, -1, &To, &From));
+	EXPECT_EQ(Interest.Stats().m_NumCulled, 1);
+}
+
+TEST(SnapInterest, OtherLaserWithSameID)
+{
+	CSnapInterest Interest;
+	Interest.StartSnap(0, TICK_SPEED, RATE, 1000);
+	vec2 To(10, 10), From(0, 0);
+	EXPECT_TRUE(Interest.Filter(1, SIZE, false, TYPE, 3, &To, &From));
+
+	// the held positions belong to the beam of another character
+	Interest.StartSnap(1, TICK_SPEED, RATE, 1000);
+	To = vec2(20, 20);
+	EXPECT_TRUE(Interest.Filter(1, SIZE, false, TYPE, 4, &To, &From));
+	EXPECT_EQ(To, vec2(20, 20));
+
+	// and to a laser of another type
+	Interest.StartSnap(2, TICK_SPEED, RATE, 1000);
+	To = vec2(30, 30);
+	EXPECT_TRUE(Interest.Filter(1, SIZE, false, TYPE + 1, 4, &To, &From));
+	EXPECT_EQ(To, vec2(30, 30));
+	EXPECT_EQ(Interest.Stats().m_NumDeferred, 0);
+	EXPECT_EQ(Interest.Stats().m_NumUpdated, 3);
+}
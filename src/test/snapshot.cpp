@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+
+#include <base/math.h>
+#include <base/system.h>
+#include <engine/shared/snapshot.h>
+
+#include <vector>
+
+static int TestSnapshotSize(int Tick)
+{
+	// sizes vary so that the arena wraps at different offsets
+	return sizeof(int) * (16 + (Tick * 37) % 200);
+}
+
+static void FillTestSnapshot(std::vector<int> &vData, int Tick)
+{
+	vData.resize(TestSnapshotSize(Tick) / sizeof(int));
+	for(size_t i = 0; i < vData.size(); i++)
+		vData[i] = Tick * 1000 + i;
+}
+
+static void ExpectStored(CSnapshotStorage &Storage, int Tick)
+{
+	std::vector<int> vExpected;
+	FillTestSnapshot(vExpected, Tick);
+	int64_t Tagtime;
+	const CSnapshot *pData;
+	const CSnapshot *pAltData;
+	ASSERT_EQ(Storage.Get(Tick, &Tagtime, &pData, &pAltData), TestSnapshotSize(Tick)) << Tick;
+	EXPECT_EQ(Tagtime, Tick * 10);
+	EXPECT_EQ(pAltData, nullptr);
+	EXPECT_EQ(mem_comp(pData, vExpected.data(), TestSnapshotSize(Tick)), 0) << Tick;
+}
+
+TEST(SnapshotStorage, AddGetPurge)
+{
+	CSnapshotStorage Storage;
+	EXPECT_EQ(Storage.Get(0, nullptr, nullptr, nullptr), -1);
+
+	const int aData[] = {1, 2, 3, 4};
+	const int aAltData[] = {5, 6};
+	Storage.Add(10, 100, sizeof(aData), aData, sizeof(aAltData), aAltData);
+	Storage.Add(11, 110, sizeof(aData), aData, 0, nullptr);
+	Storage.Add(12, 120, sizeof(aData), aData, 0, nullptr);
+	ASSERT_TRUE(Storage.m_pFirst);
+	EXPECT_EQ(Storage.m_pFirst->m_Tick, 10);
+	EXPECT_EQ(Storage.m_pFirst->m_pNext->m_Tick, 11);
+	EXPECT_EQ(Storage.m_pLast->m_Tick, 12);
+	EXPECT_EQ(Storage.m_pLast->m_pPrev->m_Tick, 11);
+
+	const CSnapshot *pData;
+	const CSnapshot *pAltData;
+	int64_t Tagtime;
+	ASSERT_EQ(Storage.Get(10, &Tagtime, &pData, &pAltData), (int)sizeof(aData));
+	EXPECT_EQ(Tagtime, 100);
+	EXPECT_EQ(mem_comp(pData, aData, sizeof(aData)), 0);
+	ASSERT_TRUE(pAltData);
+	EXPECT_EQ(mem_comp(pAltData, aAltData, sizeof(aAltData)), 0);
+	EXPECT_EQ(Storage.m_pFirst->m_AltSnapSize, (int)sizeof(aAltData));
+
+	Storage.PurgeUntil(12);
+	EXPECT_EQ(Storage.Get(10, nullptr, nullptr, nullptr), -1);
+	EXPECT_EQ(Storage.Get(11, nullptr, nullptr, nullptr), -1);
+	EXPECT_EQ(Storage.Get(12, &Tagtime, nullptr, nullptr), (int)sizeof(aData));
+	EXPECT_EQ(Tagtime, 120);
+	EXPECT_EQ(Storage.m_pFirst, Storage.m_pLast);
+	EXPECT_EQ(Storage.m_pFirst->m_pPrev, nullptr);
+
+	Storage.PurgeUntil(100);
+	EXPECT_EQ(Storage.m_pFirst, nullptr);
+	EXPECT_EQ(Storage.m_pLast, nullptr);
+	EXPECT_EQ(Storage.Stats().m_UsedBytes, 0u);
+
+	Storage.Add(13, 130, sizeof(aData), aData, 0, nullptr);
+	Storage.PurgeAll();
+	EXPECT_EQ(Storage.Get(13, nullptr, nullptr, nullptr), -1);
+	EXPECT_EQ(Storage.m_pFirst, nullptr);
+}
+
+TEST(SnapshotStorage, Stress)
+{
+	// like the server: many clients keeping three seconds of snapshots
+	static const int NUM_STORAGES = 64;
+	static const int RETENTION = 150;
+	static const int NUM_TICKS = 5000;
+	std::vector<CSnapshotStorage> vStorages(NUM_STORAGES);
+	std::vector<int> vData;
+	int aNumArenaAllocations[NUM_STORAGES];
+	for(int Tick = 0; Tick < NUM_TICKS; Tick++)
+	{
+		if(Tick == 1000)
+		{
+			for(int i = 0; i < NUM_STORAGES; i++)
+				aNumArenaAllocations[i] = vStorages[i].Stats().m_NumArenaAllocations;
+		}
+
+		FillTestSnapshot(vData, Tick);
+		for(int i = 0; i < NUM_STORAGES; i++)
+		{
+			CSnapshotStorage &Storage = vStorages[i];
+			// clients acknowledge snapshots at different rates
+			if(Tick % (1 + i % 4) == 0)
+				Storage.PurgeUntil(Tick - RETENTION);
+			Storage.Add(Tick, Tick * 10, TestSnapshotSize(Tick), vData.data(), 0, nullptr);
+		}
+
+		if(Tick % 97 == 0)
+		{
+			for(CSnapshotStorage &Storage : vStorages)
+			{
+				ExpectStored(Storage, Tick);
+				ExpectStored(Storage, maximum(Tick - RETENTION + 4, 0));
+				if(Tick > RETENTION + 4)
+				{
+					EXPECT_EQ(Storage.Get(Tick - RETENTION - 4, nullptr, nullptr, nullptr), -1);
+				}
+			}
+		}
+	}
+
+	for(int i = 0; i < NUM_STORAGES; i++)
+	{
+		// the arenas stop growing once they fit the retention window
+		const CSnapshotStorage::CStats &Stats = vStorages[i].Stats();
+		EXPECT_EQ(Stats.m_NumArenaAllocations, aNumArenaAllocations[i]);
+		EXPECT_EQ(Stats.m_NumAdded, NUM_TICKS);
+		EXPECT_GE(Stats.m_ArenaBytes, Stats.m_PeakUsedBytes);
+		EXPECT_LE(Stats.m_ArenaBytes, 4 * Stats.m_PeakUsedBytes);
+	}
+}
+
+TEST(SnapshotStorage, IndexCollisions)
+{
+	// keep more ticks than the index has slots
+	CSnapshotStorage Storage;
+	std::vector<int> vData;
+	for(int Tick = 0; Tick < 1000; Tick++)
+	{
+		FillTestSnapshot(vData, Tick);
+		Storage.Add(Tick, Tick * 10, TestSnapshotSize(Tick), vData.data(), 0, nullptr);
+	}
+	for(int Tick = 0; Tick < 1000; Tick++)
+		ExpectStored(Storage, Tick);
+
+	Storage.PurgeUntil(900);
+	for(int Tick = 0; Tick < 900; Tick++)
+		EXPECT_EQ(Storage.Get(Tick, nullptr, nullptr, nullptr), -1);
+	for(int Tick = 900; Tick < 1000; Tick++)
+		ExpectStored(Storage, Tick);
+}
@@ -0,0 +1,126 @@
+#include "test.h"
+#include <gtest/gtest.h>
+
+#include <engine/gfx/texture_cache.h>
+#include <engine/storage.h>
+
+#include <memory>
+#include <vector>
+
+static CImageInfo TestImage(std::vector<uint8_t> &vData, int Width, int Height)
+{
+	vData.resize((size_t)Width * Height * 4);
+	for(size_t i = 0; i < vData.size(); i++)
+		vData[i] = i * 7;
+	CImageInfo Image;
+	Image.m_Width = Width;
+	Image.m_Height = Height;
+	Image.m_Format = CImageInfo::FORMAT_RGBA;
+	Image.m_pData = vData.data();
+	return Image;
+}
+
+static int RemoveCacheEntry(const char *pName, int IsDir, int StorageType, void *pUser)
+{
+	if(IsDir)
+		return 0;
+	char aPath[IO_MAX_PATH_LENGTH];
+	str_format(aPath, sizeof(aPath), "texturecache/%s", pName);
+	((IStorage *)pUser)->RemoveFile(aPath, IStorage::TYPE_SAVE);
+	return 0;
+}
+
+// the test storage cleanup doesn't remove sub folders
+static void RemoveCache(IStorage *pStorage)
+{
+	pStorage->ListDirectory(IStorage::TYPE_SAVE, "texturecache", RemoveCacheEntry, pStorage);
+	EXPECT_TRUE(pStorage->RemoveFolder("texturecache", IStorage::TYPE_SAVE));
+}
+
+TEST(TextureCache, StoreLoad)
+{
+	CTestInfo Info;
+	Info.m_DeleteTestStorageFilesOnSuccess = true;
+	auto pStorage = std::unique_ptr<IStorage>(Info.CreateTestStorage());
+	ASSERT_TRUE(pStorage);
+
+	CTextureCache Cache;
+	Cache.Init(pStorage.get(), 16);
+	ASSERT_TRUE(Cache.Enabled());
+
+	const SHA256_DIGEST FileHash = sha256("file", 4);
+	const SHA256_DIGEST Key = CTextureCache::Key(FileHash, "png");
+	EXPECT_NE(Key, CTextureCache::Key(FileHash, "masked"));
+
+	CTextureCache::CImage Loaded;
+	EXPECT_FALSE(Cache.Load(Key, &Loaded));
+
+	std::vector<uint8_t> vData;
+	const CImageInfo Image = TestImage(vData, 16, 8);
+	Cache.Store(Key, Image);
+
+	ASSERT_TRUE(Cache.Load(Key, &Loaded));
+	EXPECT_EQ(Loaded.m_Width, 16);
+	EXPECT_EQ(Loaded.m_Height, 8);
+	EXPECT_EQ(Loaded.m_Format, CImageInfo::FORMAT_RGBA);
+	EXPECT_EQ(mem_comp(Loaded.m_pData, vData.data(), vData.size()), 0);
+	Cache.Free(nullptr, &Loaded);
+	EXPECT_EQ(Loaded.m_pData, nullptr);
+
+	EXPECT_FALSE(Cache.Load(CTextureCache::Key(FileHash, "masked"), &Loaded));
+	RemoveCache(pStorage.get());
+}
+
+TEST(TextureCache, Disabled)
+{
+	CTestInfo Info;
+	Info.m_DeleteTestStorageFilesOnSuccess = true;
+	auto pStorage = std::unique_ptr<IStorage>(Info.CreateTestStorage());
+	ASSERT_TRUE(pStorage);
+
+	CTextureCache Cache;
+	Cache.Init(pStorage.get(), 0);
+	EXPECT_FALSE(Cache.Enabled());
+
+	const SHA256_DIGEST Key = CTextureCache::Key(sha256("file", 4), "png");
+	std::vector<uint8_t> vData;
+	Cache.Store(Key, TestImage(vData, 16, 16));
+	CTextureCache::CImage Loaded;
+	EXPECT_FALSE(Cache.Load(Key, &Loaded));
+}
+
+TEST(TextureCache, Prune)
+{
+	CTestInfo Info;
+	Info.m_DeleteTestStorageFilesOnSuccess = true;
+	auto pStorage = std::unique_ptr<IStorage>(Info.CreateTestStorage());
+	ASSERT_TRUE(pStorage);
+
+	CTextureCache Cache;
+	Cache.Init(pStorage.get(), 16);
+
+	// two entries of a bit more than 1 MiB each
+	const SHA256_DIGEST FirstKey = CTextureCache::Key(sha256("first", 5), "png");
+	const SHA256_DIGEST SecondKey = CTextureCache::Key(sha256("second", 6), "png");
+	std::vector<uint8_t> vData;
+	Cache.Store(FirstKey, TestImage(vData, 512, 512));
+	Cache.Store(SecondKey, TestImage(vData, 512, 512));
+
+	CTextureCache PrunedCache;
+	PrunedCache.Init(pStorage.get(), 3);
+	CTextureCache::CImage Loaded;
+	ASSERT_TRUE(PrunedCache.Load(FirstKey, &Loaded));
+	PrunedCache.Free(nullptr, &Loaded);
+	ASSERT_TRUE(PrunedCache.Load(SecondKey, &Loaded));
+	PrunedCache.Free(nullptr, &Loaded);
+
+	PrunedCache.Init(pStorage.get(), 2);
+	const bool FirstLoaded = PrunedCache.Load(FirstKey, &Loaded);
+	if(FirstLoaded)
+		PrunedCache.Free(nullptr, &Loaded);
+	const bool SecondLoaded = PrunedCache.Load(SecondKey, &Loaded);
+	if(SecondLoaded)
+		PrunedCache.Free(nullptr, &Loaded);
+	EXPECT_NE(FirstLoaded, SecondLoaded);
+	RemoveCache(pStorage.get());
+}
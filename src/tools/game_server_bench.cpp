@@ -0,0 +1,316 @@
+/* (c) DDNet developers. See licence.txt in the root of the distribution for more information. */
+/* If you are missing that file, acquire a complete release at teeworlds.com.                */
+#include <base/logger.h>
+#include <base/system.h>
+
+#include <engine/console.h>
+#include <engine/engine.h>
+#include <engine/map.h>
+#include <engine/server/antibot.h>
+#include <engine/server/databases/connection_pool.h>
+#include <engine/server/server.h>
+#include <engine/shared/config.h>
+#include <engine/storage.h>
+
+#include <game/server/entities/character.h>
+#include <game/server/gamecontext.h>
+#include <game/prng.h>
+#include <game/version.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+// Headless benchmark of the game server: loads a map into a real CServer and
+// CGameContext, fills it with debug dummies driven by deterministic
+// synthetic inputs and runs the same per tick steps as CServer::Run (input,
+// CGameContext::OnTick and CServer::DoSnapshot including delta and
+// compression) as fast as possible, without waiting for the tick time.
+// Snapshots are sent to the dummies' network slots, which aren't connected,
+// so nothing leaves the process.
+
+static const char *TOOL_NAME = "game-server-bench";
+
+bool IsInterrupted()
+{
+	return false;
+}
+
+// Counts heap allocations of the thread that set it, so only the measured
+// loop on the game thread is counted and not the job, sql or log threads.
+static thread_local int64_t *gs_pNumAllocations = nullptr;
+
+void *operator new(std::size_t Size)
+{
+	if(gs_pNumAllocations)
+		(*gs_pNumAllocations)++;
+	void *pPtr = malloc(Size);
+	dbg_assert(pPtr != nullptr, "out of memory");
+	return pPtr;
+}
+
+void operator delete(void *pPtr) noexcept
+{
+	free(pPtr);
+}
+
+void operator delete(void *pPtr, std::size_t Size) noexcept
+{
+	free(pPtr);
+}
+
+class CCountAllocations
+{
+public:
+	CCountAllocations(int64_t *pNumAllocations) { gs_pNumAllocations = pNumAllocations; }
+	~CCountAllocations() { gs_pNumAllocations = nullptr; }
+};
+
+// changes the input of a character every few ticks like a player would
+static void UpdateInput(CPrng *pPrng, CNetObj_PlayerInput *pInput)
+{
+	if(pPrng->RandomBits() % 16 != 0)
+		return;
+	pInput->m_Direction = (int)(pPrng->RandomBits() % 3) - 1;
+	pInput->m_Jump = pPrng->RandomBits() % 4 == 0;
+	pInput->m_Hook = pPrng->RandomBits() % 3 == 0;
+	pInput->m_Fire = pPrng->RandomBits() % 8 == 0 ? pInput->m_Fire + 1 : pInput->m_Fire;
+	pInput->m_WantedWeapon = pPrng->RandomBits() % 32 == 0 ? (int)(pPrng->RandomBits() % NUM_WEAPONS) + 1 : 0;
+	pInput->m_TargetX = (int)(pPrng->RandomBits() % 512) - 256;
+	pInput->m_TargetY = (int)(pPrng->RandomBits() % 512) - 256;
+	if(pInput->m_TargetX == 0 && pInput->m_TargetY == 0)
+		pInput->m_TargetY = -1;
+}
+
+class CServerBench
+{
+	CServer *m_pServer;
+	int m_NumCharacters;
+	CPrng m_Prng;
+	CNetObj_PlayerInput m_aInputs[MAX_CLIENTS];
+
+	std::chrono::nanoseconds m_TickTime = 0ns;
+	std::chrono::nanoseconds m_SnapTime = 0ns;
+	int m_NumSnaps = 0;
+	int64_t m_NumAllocations = 0;
+
+	static int ClientID(int Index) { return MAX_CLIENTS - Index - 1; }
+
+public:
+	CServerBench(CServer *pServer, int NumCharacters, uint64_t Seed) :
+		m_pServer(pServer), m_NumCharacters(NumCharacters)
+	{
+		uint64_t aSeed[2] = {Seed, Seed ^ 0x5bd1e9955bd1e995ull};
+		m_Prng.Seed(aSeed);
+		for(auto &Input : m_aInputs)
+		{
+			mem_zero(&Input, sizeof(Input));
+			Input.m_TargetY = -1;
+			Input.m_PlayerFlags = PLAYERFLAG_PLAYING;
+		}
+	}
+
+	bool Init(const char *pMap)
+	{
+		CServer *pServer = m_pServer;
+		pServer->m_RunServer = CServer::RUNNING;
+		if(!pServer->LoadMap(pMap))
+		{
+			dbg_msg(TOOL_NAME, "failed to load map '%s'", pMap);
+			return false;
+		}
+
+		// the dummies' slots need an open network server, but nothing
+		// connects to it
+		NETADDR BindAddr;
+		net_addr_from_str(&BindAddr, "127.0.0.1");
+		BindAddr.port = 0;
+		if(!pServer->m_NetServer.Open(BindAddr, &pServer->m_ServerBan, MAX_CLIENTS, MAX_CLIENTS))
+		{
+			dbg_msg(TOOL_NAME, "couldn't open socket");
+			return false;
+		}
+
+		pServer->Antibot()->Init();
+		pServer->GameServer()->OnInit(nullptr);
+		if(pServer->ErrorShutdown())
+			return false;
+		pServer->m_GameStartTime = time_get();
+
+		pServer->Config()->m_DbgDummies = m_NumCharacters;
+		pServer->UpdateDebugDummies(false);
+		for(int i = 0; i < m_NumCharacters; i++)
+		{
+			// snapshot the dummies like clients that receive every snapshot
+			pServer->m_aClients[ClientID(i)].m_SnapRate = CServer::CClient::SNAPRATE_FULL;
+		}
+		return true;
+	}
+
+	void Tick()
+	{
+		CServer *pServer = m_pServer;
+		for(int i = 0; i < m_NumCharacters; i++)
+		{
+			UpdateInput(&m_Prng, &m_aInputs[i]);
+			pServer->SetInput(ClientID(i), &m_aInputs[i]);
+		}
+
+		// same steps as a tick in CServer::Run
+		const std::chrono::nanoseconds Start = time_get_nanoseconds();
+		pServer->GameServer()->OnPreTickTeehistorian();
+		for(int c = 0; c < MAX_CLIENTS; c++)
+		{
+			if(pServer->m_aClients[c].m_State != CServer::CClient::STATE_INGAME)
+				continue;
+			pServer->GameServer()->OnClientPredictedEarlyInput(c, pServer->m_aClients[c].m_aInputs[0].m_aData);
+		}
+		pServer->m_CurrentGameTick++;
+		for(int c = 0; c < MAX_CLIENTS; c++)
+		{
+			if(pServer->m_aClients[c].m_State != CServer::CClient::STATE_INGAME)
+				continue;
+			pServer->GameServer()->OnClientPredictedInput(c, pServer->m_aClients[c].m_aInputs[0].m_aData);
+		}
+		pServer->GameServer()->OnTick();
+		const std::chrono::nanoseconds Ticked = time_get_nanoseconds();
+		m_TickTime += Ticked - Start;
+
+		if(pServer->Config()->m_SvHighBandwidth || (pServer->Tick() % 2) == 0)
+		{
+			pServer->DoSnapshot();
+			m_SnapTime += time_get_nanoseconds() - Ticked;
+			m_NumSnaps++;
+			// the dummies ack every snapshot right away, so the next one is a
+			// delta like for a client without packet loss
+			for(int i = 0; i < m_NumCharacters; i++)
+				pServer->m_aClients[ClientID(i)].m_LastAckedSnapshot = pServer->Tick();
+		}
+	}
+
+	void Run(int NumTicks)
+	{
+		{
+			CCountAllocations CountAllocations(&m_NumAllocations);
+			for(int i = 0; i < NumTicks; i++)
+				Tick();
+		}
+
+		// positions of all characters, to check that an optimization didn't
+		// change the simulation
+		CGameContext *pGameServer = static_cast<CGameContext *>(m_pServer->GameServer());
+		unsigned Checksum = 0;
+		int NumAlive = 0;
+		for(int i = 0; i < m_NumCharacters; i++)
+		{
+			CCharacter *pChr = pGameServer->GetPlayerChar(ClientID(i));
+			if(!pChr)
+				continue;
+			NumAlive++;
+			Checksum = Checksum * 31 + (unsigned)round_to_int(pChr->GetPos().x);
+			Checksum = Checksum * 31 + (unsigned)round_to_int(pChr->GetPos().y);
+		}
+
+		const std::chrono::nanoseconds Total = m_TickTime + m_SnapTime;
+		dbg_msg(TOOL_NAME, "map='%s' characters=%d ticks=%d", m_pServer->m_aCurrentMap, m_NumCharacters, NumTicks);
+		dbg_msg(TOOL_NAME, "ticks per second: %.0f", NumTicks / (Total.count() / 1e9));
+		dbg_msg(TOOL_NAME, "tick: %.3fus/tick", m_TickTime.count() / 1e3 / NumTicks);
+		dbg_msg(TOOL_NAME, "snap: %.3fus/snap, %d snaps", m_NumSnaps ? m_SnapTime.count() / 1e3 / m_NumSnaps : 0.0, m_NumSnaps);
+		dbg_msg(TOOL_NAME, "allocations: %.2f/tick", (double)m_NumAllocations / NumTicks);
+		dbg_msg(TOOL_NAME, "checksum: %08x (%d characters alive)", Checksum, NumAlive);
+	}
+
+	void Shutdown()
+	{
+		CServer *pServer = m_pServer;
+		pServer->UpdateDebugDummies(true);
+		pServer->GameServer()->OnShutdown(nullptr);
+		pServer->m_pMap->Unload();
+		pServer->DbPool()->OnShutdown();
+		pServer->m_NetServer.Close();
+	}
+};
+
+int main(int argc, const char **argv)
+{
+	CCmdlineFix CmdlineFix(&argc, &argv);
+	log_set_global_logger_default();
+
+	if(argc < 2 || argc > 5)
+	{
+		dbg_msg(TOOL_NAME, "Usage: %s <map> [characters=64] [ticks=15000] [seed=0]", TOOL_NAME);
+		return -1;
+	}
+	const char *pMap = argv[1];
+	const int NumCharacters = argc > 2 ? clamp(str_toint(argv[2]), 1, (int)MAX_CLIENTS) : MAX_CLIENTS;
+	const int NumTicks = argc > 3 ? maximum(str_toint(argv[3]), 1) : 15000;
+	const uint64_t Seed = argc > 4 ? str_toint(argv[4]) : 0;
+
+	if(secure_random_init() != 0)
+	{
+		dbg_msg(TOOL_NAME, "could not initialize secure RNG");
+		return -1;
+	}
+
+	CServer *pServer = CreateServer();
+	pServer->SetLoggers(std::make_shared<CFutureLogger>(), nullptr);
+
+	IKernel *pKernel = IKernel::Create();
+	pKernel->RegisterInterface(pServer);
+
+	IEngine *pEngine = CreateEngine(GAME_NAME, std::make_shared<CFutureLogger>(), 2 * std::thread::hardware_concurrency() + 2);
+	pKernel->RegisterInterface(pEngine);
+
+	// only pass the first argument, so that the remaining ones aren't
+	// interpreted as storage options
+	IStorage *pStorage = CreateStorage(IStorage::STORAGETYPE_SERVER, 1, argv);
+	if(!pStorage)
+	{
+		dbg_msg(TOOL_NAME, "error loading storage");
+		delete pKernel;
+		return -1;
+	}
+	pKernel->RegisterInterface(pStorage);
+
+	IConsole *pConsole = CreateConsole(CFGFLAG_SERVER | CFGFLAG_ECON).release();
+	pKernel->RegisterInterface(pConsole);
+
+	IConfigManager *pConfigManager = CreateConfigManager();
+	pKernel->RegisterInterface(pConfigManager);
+
+	IEngineMap *pEngineMap = CreateEngineMap();
+	pKernel->RegisterInterface(pEngineMap); // IEngineMap
+	pKernel->RegisterInterface(static_cast<IMap *>(pEngineMap), false);
+
+	IEngineAntibot *pEngineAntibot = CreateEngineAntibot();
+	pKernel->RegisterInterface(pEngineAntibot); // IEngineAntibot
+	pKernel->RegisterInterface(static_cast<IAntibot *>(pEngineAntibot), false);
+
+	IGameServer *pGameServer = CreateGameServer();
+	pKernel->RegisterInterface(pGameServer);
+
+	pEngine->Init();
+	pConsole->Init();
+	pConfigManager->Init();
+	pServer->RegisterCommands();
+
+	// no autoexec, so the results only depend on the arguments
+	pConsole->StoreCommands(false);
+
+	int Ret = -1;
+	CServerBench Bench(pServer, NumCharacters, Seed);
+	if(Bench.Init(pMap))
+	{
+		dbg_msg(TOOL_NAME, "seed=%d", (int)Seed);
+		Bench.Run(NumTicks);
+		Bench.Shutdown();
+		Ret = 0;
+	}
+
+	delete pKernel;
+	secure_random_uninit();
+	return Ret;
+}